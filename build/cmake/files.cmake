@@ -422,6 +422,7 @@ set(BASE_CMN_SRC
     src/common/dynload.cpp
     src/common/encconv.cpp
     src/common/evtloopcmn.cpp
+    src/common/evtprofiler.cpp
     src/common/extended.c
     src/common/ffile.cpp
     src/common/file.cpp
@@ -443,6 +444,7 @@ set(BASE_CMN_SRC
     src/common/languageinfo.cpp
     src/common/list.cpp
     src/common/log.cpp
+    src/common/logasync.cpp
     src/common/longlong.cpp
     src/common/mimecmn.cpp
     src/common/module.cpp
@@ -466,6 +468,7 @@ set(BASE_CMN_SRC
     src/common/tarstrm.cpp
     src/common/textbuf.cpp
     src/common/textfile.cpp
+    src/common/threadpool.cpp
     src/common/time.cpp
     src/common/timercmn.cpp
     src/common/timerimpl.cpp
@@ -541,6 +544,7 @@ set(BASE_CMN_HDR
     wx/eventfilter.h
     wx/evtloop.h
     wx/evtloopsrc.h
+    wx/evtprofiler.h
     wx/except.h
     wx/features.h
     wx/flags.h
@@ -572,6 +576,7 @@ set(BASE_CMN_HDR
     wx/list.h
     wx/listimpl.cpp
     wx/log.h
+    wx/logasync.h
     wx/longlong.h
     wx/math.h
     wx/memconf.h
@@ -789,6 +794,7 @@ set(GUI_CMN_SRC
     src/common/imagall.cpp
     src/common/imagbmp.cpp
     src/common/image.cpp
+    src/common/imagebatch.cpp
     src/common/imagfill.cpp
     src/common/imaggif.cpp
     src/common/imagiff.cpp
@@ -1105,6 +1111,7 @@ set(GUI_CMN_HDR
     wx/iconbndl.h
     wx/imagbmp.h
     wx/image.h
+    wx/imagebatch.h
     wx/imaggif.h
     wx/imagiff.h
     wx/imagjpeg.h
@@ -264,6 +264,10 @@ switches and options:
     containing class definitions for the windows defined by the XRC file (see
     special subsection).
 @li -u (\--uncompressed): Do not compress XML files (C++ only).
+@li -b (\--binary): Precompile XRC files to the binary format which can be
+    loaded without parsing XML, see wxXmlDocument::SaveBinary(). This makes
+    loading resources faster and is recommended for the applications with
+    many or big XRC files. This switch can be combined with all the others.
 @li -g (\--gettext): Output underscore-wrapped strings that poEdit or gettext
     can scan. Outputs to stdout, or a file if -o is used.
 @li -n (\--function) @<name@>: Specify C++ function name (use with -c).
@@ -278,6 +282,7 @@ For example:
 $ wxrc resource.xrc
 $ wxrc resource.xrc -o resource.xrs
 $ wxrc resource.xrc -v -c -o resource.cpp
+$ wxrc resource.xrc -b -o resource.xrs
 @endcode
 
 @note XRS file is essentially a renamed ZIP archive which means that you can
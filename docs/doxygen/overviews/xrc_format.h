@@ -1726,10 +1726,26 @@ pseudo-class.
     (default: none, mutually exclusive with @c bitmap, only if imagelist was set).}
 @row3col{selected, @ref overview_xrcformat_type_bool,
      Is the page selected initially (only one page can be selected; default: 0)?}
+@row3col{lazy, @ref overview_xrcformat_type_bool,
+     If 1, the page window is only created when the page is shown for the
+     first time (default: 0, unless wxXRC_LAZY_BOOK_PAGES flag is used).
+     See below for more details. @since 3.3.2}
 @endTable
 
 Each @c notebookpage has exactly one non-toplevel window as its child.
 
+Creating the pages lazily makes creating book controls with many pages, that
+may be never shown, much faster. When this is done, the page added to the book
+control is a plain wxPanel and the window defined in XRC is created as its
+child, filling all of it, the first time this page is shown. Before this
+happens, the page window and its children can't be found using XRCCTRL(),
+but they can be found normally afterwards, as they use the same IDs as when
+the page is created immediately. Note that the best size of the book control
+doesn't take the lazy pages into account, so it's recommended to specify its
+size explicitly and that wxXmlResource object used for creating the book
+control must remain alive until all lazy pages are created. This property is
+supported by all book controls using the page pseudo-classes described here.
+
 Example:
 @code
 <object class="wxNotebook">
@@ -36,6 +36,12 @@
 #include "wx/meta/convertible.h"
 #include "wx/meta/removeref.h"
 
+#if wxUSE_THREADS
+    #include <atomic>
+#endif
+
+#include <unordered_map>
+
 // This is now always defined, but keep it for backwards compatibility.
 #define wxHAS_CALL_AFTER
 
@@ -3769,6 +3775,19 @@ public:
     // buffer as other wxString objects in this thread.
     virtual void QueueEvent(wxEvent *event);
 
+    // Same as QueueEvent() but replaces the still pending event of the same
+    // type and with the same id, if there is one, instead of appending the
+    // new event to the queue. This is useful for the events posted at high
+    // frequency, e.g. progress notifications from the worker threads, when
+    // only the latest event matters.
+    void QueueOrReplaceEvent(wxEvent *event);
+
+    // Set whether the events of the given type should be always coalesced,
+    // i.e. if QueueEvent() should behave as QueueOrReplaceEvent() for them.
+    static void SetEventTypeCoalescing(wxEventType eventType,
+                                       bool coalesce = true);
+    static bool IsEventTypeCoalesced(wxEventType eventType);
+
     // Add an event to be processed later: notice that this function is not
     // safe to call from threads other than main, use QueueEvent()
     virtual void AddPendingEvent(const wxEvent& event)
@@ -4099,7 +4118,44 @@ protected:
 
     struct DynamicEvents
     {
+        // add a new entry to the end of m_entries
+        void Add(wxDynamicEventTableEntry* entry);
+
+        // mark the entry with the given index as removed
+        void Remove(size_t n);
+
+        // really remove the entries previously marked as removed
+        void Prune();
+
+        // (re)build m_index if there are enough entries to make it worthwhile
+        void BuildIndex();
+
+        // add the entry with the given index to m_index
+        void AddToIndex(size_t n);
+
+        // all entries in the order of their addition, with removed entries
+        // being null until Prune() is called
         wxVector<wxDynamicEventTableEntry*> m_entries;
+
+        // indices of the entries in m_entries for a single event type, in
+        // increasing order
+        struct IndexBucket
+        {
+            // entries for a single id
+            std::unordered_map<int, wxVector<size_t>> m_byId;
+
+            // all the other entries, i.e. for wxID_ANY or a range of ids
+            wxVector<size_t> m_others;
+        };
+
+        // index of the entries by event type, only used if m_indexed is true
+        std::unordered_map<wxEventType, IndexBucket> m_index;
+
+        // number of null entries in m_entries
+        size_t m_numRemoved = 0;
+
+        bool m_indexed = false;
+
         wxRecursionGuardFlag m_flag = 0;
     };
     // use wxSharedPtr so that SearchDynamicEventTable() can use another
@@ -4112,6 +4168,12 @@ protected:
 #if wxUSE_THREADS
     // critical section protecting m_pendingEvents
     wxCriticalSection m_pendingEventsLock;
+
+    // Events queued by QueueEvent() but not moved to m_pendingEvents yet, in
+    // the reverse order. This list is lock-free to allow posting events from
+    // multiple threads without contention, see QueueEvent().
+    struct QueuedEvent;
+    std::atomic<QueuedEvent*> m_queuedEvents;
 #endif // wxUSE_THREADS
 
     // Is event handler enabled?
@@ -4146,6 +4208,15 @@ private:
     // pass the event to wxTheApp instance, called from TryAfter()
     bool DoTryApp(wxEvent& event);
 
+    // common part of QueueEvent() and QueueOrReplaceEvent()
+    void DoQueueEvent(wxEvent *event, bool replace);
+
+#if wxUSE_THREADS
+    // move all events from m_queuedEvents to m_pendingEvents, must be called
+    // with m_pendingEventsLock locked
+    void MoveQueuedEvents();
+#endif // wxUSE_THREADS
+
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
@@ -4238,6 +4309,15 @@ inline void wxQueueEvent(wxEvtHandler *dest, wxEvent *event)
     dest->QueueEvent(event);
 }
 
+// Wrapper around wxEvtHandler::QueueOrReplaceEvent(): same as wxQueueEvent()
+// but replaces the pending event of the same type and id, if any
+inline void wxQueueOrReplaceEvent(wxEvtHandler *dest, wxEvent *event)
+{
+    wxCHECK_RET( dest, "need an object to queue event for" );
+
+    dest->QueueOrReplaceEvent(event);
+}
+
 typedef void (wxEvtHandler::*wxEventFunction)(wxEvent&);
 typedef void (wxEvtHandler::*wxIdleEventFunction)(wxIdleEvent&);
 typedef void (wxEvtHandler::*wxThreadEventFunction)(wxThreadEvent&);
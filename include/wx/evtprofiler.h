@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/evtprofiler.h
+// Purpose:     wxEventProfiler: collect event dispatching statistics
+// Author:      wxWidgets development team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_EVTPROFILER_H_
+#define _WX_EVTPROFILER_H_
+
+#include "wx/event.h"
+#include "wx/string.h"
+
+#include <atomic>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// wxEventProfiler records the time spent processing events by their type and
+// by the individual handlers, if enabled.
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxEventProfiler
+{
+public:
+    // Statistics common to the event types and handlers, all times are in
+    // nanoseconds.
+    struct Stats
+    {
+        unsigned long count = 0;
+        wxLongLong_t totalTime = 0;
+        wxLongLong_t maxTime = 0;
+    };
+
+    struct EventTypeStats : Stats
+    {
+        wxEventType eventType = wxEVT_NULL;
+
+        // name of the class of the last event of this type
+        wxString eventClass;
+    };
+
+    struct HandlerStats : Stats
+    {
+        wxEventType eventType = wxEVT_NULL;
+
+        // name of the class of the object handling the event
+        wxString handlerClass;
+
+        // the functor which was called, only useful for identifying the
+        // handler as it may not exist any more
+        const void* functor = nullptr;
+    };
+
+    // Start or stop collecting the statistics, this is disabled by default.
+    static void Enable(bool enable = true);
+    static bool IsEnabled()
+    {
+        return ms_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Forget all the statistics collected so far.
+    static void Reset();
+
+    // Return the statistics sorted by the total time in decreasing order.
+    static std::vector<EventTypeStats> GetEventTypeStats();
+    static std::vector<HandlerStats> GetHandlerStats();
+
+    // Return the report with all the collected statistics in human-readable
+    // or JSON format.
+    static wxString GetReport();
+    static wxString GetReportAsJSON();
+
+private:
+    // These functions are only called by wxEvtHandler when profiling is
+    // enabled to record the time taken by processing the given event and by
+    // calling the given handler for it.
+    static void AddEventTime(const wxEvent& event, wxLongLong_t time);
+    static void AddHandlerTime(const wxEvent& event,
+                               const wxChar* handlerClass,
+                               const wxEventFunctor* functor,
+                               wxLongLong_t time);
+
+    static std::atomic<bool> ms_enabled;
+
+    friend class wxEvtHandler;
+
+    wxDECLARE_NO_COPY_CLASS(wxEventProfiler);
+};
+
+#endif // _WX_EVTPROFILER_H_
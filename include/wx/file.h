@@ -77,6 +77,9 @@ public:
   bool ReadAll(wxString *str, const wxMBConv& conv = wxConvAuto());
     // returns number of bytes read or wxInvalidOffset on error
   ssize_t Read(void *pBuf, size_t nCount);
+    // read at the given offset, can be used from several threads at once;
+    // returns number of bytes read (0 at EOF) or wxInvalidOffset on error
+  ssize_t ReadAt(void *pBuf, size_t nCount, wxFileOffset ofs) const;
     // returns the number of bytes written
   size_t Write(const void *pBuf, size_t nCount);
     // returns true on success
@@ -235,8 +235,15 @@ private:
   // common part of from dtor and DeleteAll
   void CleanUp();
 
-  // parse the whole file
-  void Parse(const wxTextBuffer& buffer, bool bLocal);
+  // parse the whole file contents, name is only used in error messages
+  void Parse(const wxString& text, const wxString& name, bool bLocal);
+
+  // parse a single line of the file, n is its index
+  void ParseLine(wxString::const_iterator pLineStart,
+                 wxString::const_iterator pLineEnd,
+                 const wxString& name,
+                 size_t n,
+                 bool bLocal);
 
   // the same as SetPath("/")
   void SetRootPath();
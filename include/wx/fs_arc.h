@@ -34,8 +34,13 @@ public:
     void Cleanup();
     virtual ~wxArchiveFSHandler();
 
+    // Set the maximal total number of entries of the cached archives.
+    void SetMaxCachedEntries(size_t maxEntries);
+    size_t GetMaxCachedEntries() const { return m_maxCachedEntries; }
+
 private:
     class wxArchiveFSCache *m_cache;
+    size_t m_maxCachedEntries;
     wxFileSystem m_fs;
 
     // these vars are used by FindFirst/Next:
@@ -43,6 +43,11 @@
 #define wxIMAGE_OPTION_ORIGINAL_WIDTH        wxString(wxS("OriginalWidth"))
 #define wxIMAGE_OPTION_ORIGINAL_HEIGHT       wxString(wxS("OriginalHeight"))
 
+#define wxIMAGE_OPTION_REGION_X              wxString(wxS("RegionX"))
+#define wxIMAGE_OPTION_REGION_Y              wxString(wxS("RegionY"))
+#define wxIMAGE_OPTION_REGION_WIDTH          wxString(wxS("RegionWidth"))
+#define wxIMAGE_OPTION_REGION_HEIGHT         wxString(wxS("RegionHeight"))
+
 // constants used with wxIMAGE_OPTION_RESOLUTIONUNIT
 //
 // NB: don't change these values, they correspond to libjpeg constants
@@ -367,6 +372,10 @@ public:
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
 
+    // Gaussian blur with the given standard deviation.
+    wxImage GaussianBlur(double sigma) const;
+    void GaussianBlurInPlace(double sigma);
+
     wxImage ShrinkBy( int xFactor , int yFactor ) const ;
 
     // rescales the image in place
@@ -461,6 +470,13 @@ public:
     static void SetDefaultLoadFlags(int flags);
     static int GetDefaultLoadFlags();
 
+    // Set or get the maximal number of threads used by the CPU-intensive
+    // transformations such as Scale(), Blur() or Rotate(): 1 (default) means
+    // to not use any additional threads, 0 means to use as many threads as
+    // there are CPUs.
+    static void SetMaxThreads(int threads);
+    static int GetMaxThreads();
+
     void SetLoadFlags(int flags);
     int GetLoadFlags() const;
 
@@ -508,8 +524,13 @@ public:
     void SetData( unsigned char *data, int new_width, int new_height, bool static_data=false );
     void SetDataRGBA(const unsigned char* data);
 
+    // read-only access to the interleaved RGBA data, which is fast if the
+    // image is already stored in this format, e.g. after SetDataRGBA()
+    const unsigned char *GetDataRGBA();
+    bool HasRGBAStorage() const;
+
     unsigned char *GetAlpha() const;    // may return nullptr!
-    bool HasAlpha() const { return GetAlpha() != nullptr; }
+    bool HasAlpha() const;
     void SetAlpha(unsigned char *alpha = nullptr, bool static_data=false);
     void InitAlpha();
     void ClearAlpha();
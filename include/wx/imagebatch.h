@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imagebatch.h
+// Purpose:     wxImageBatchLoader: load several images concurrently
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_IMAGEBATCH_H_
+#define _WX_IMAGEBATCH_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE && wxUSE_STREAMS
+
+#include "wx/event.h"
+#include "wx/image.h"
+
+class WXDLLIMPEXP_FWD_BASE wxInputStream;
+class wxImageBatchLoaderImpl;
+
+// Event sent when all images have been loaded by wxImageBatchLoader::Start().
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CORE, wxEVT_IMAGE_BATCH_LOADED, wxThreadEvent);
+
+// ----------------------------------------------------------------------------
+// wxImageBatchLoader
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageBatchLoader
+{
+public:
+    wxImageBatchLoader();
+
+    // Waits until loading completes if it is still in progress.
+    ~wxImageBatchLoader();
+
+    // Add an image to load, these functions return the index of the image.
+    size_t AddFile(const wxString& filename,
+                   wxBitmapType type = wxBITMAP_TYPE_ANY,
+                   int index = -1);
+
+    // Takes ownership of the stream.
+    size_t AddStream(wxInputStream* stream,
+                     wxBitmapType type = wxBITMAP_TYPE_ANY,
+                     int index = -1);
+
+    // Set the option used for all images, e.g. wxIMAGE_OPTION_MAX_WIDTH.
+    void SetOption(const wxString& name, const wxString& value);
+    void SetOption(const wxString& name, int value);
+
+    // Set the maximal number of threads to use, 0 means one per CPU.
+    void SetMaxThreads(int maxThreads);
+
+    // Load all images and return only when done, return true if all of them
+    // were loaded successfully.
+    bool Load();
+
+    // Start loading images in the background and return immediately. If the
+    // handler is specified, wxEVT_IMAGE_BATCH_LOADED is queued to it when
+    // loading completes.
+    bool Start(wxEvtHandler* handler = nullptr, int id = wxID_ANY);
+
+    // Return true if Start() was called and loading is still in progress.
+    bool IsRunning() const;
+
+    // Wait until loading started by Start() completes and return true if all
+    // images were loaded successfully.
+    bool Wait();
+
+
+    // The functions below can only be called when loading is not running.
+
+    // Return the number of images added.
+    size_t GetCount() const;
+
+    // Return true if the image with the given index was loaded successfully.
+    bool IsOk(size_t n) const;
+
+    // Return the loaded image, which is invalid if loading it failed.
+    const wxImage& GetImage(size_t n) const;
+
+    // Return the error messages logged when loading the image, if any.
+    const wxString& GetError(size_t n) const;
+
+private:
+    wxImageBatchLoaderImpl* const m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageBatchLoader);
+};
+
+#endif // wxUSE_IMAGE && wxUSE_STREAMS
+
+#endif // _WX_IMAGEBATCH_H_
@@ -413,6 +413,11 @@ public:
     // parent component and to the default global log level if necessary
     static wxLogLevel GetComponentLevel(const wxString& component);
 
+    // faster overload for the components given as ASCII strings, such as
+    // wxLOG_COMPONENT, which doesn't lock or allocate unless the component
+    // levels changed since the last call with the same component
+    static wxLogLevel GetComponentLevel(const char* component);
+
 
     // is logging of messages from this component enabled at this level?
     //
@@ -422,6 +427,11 @@ public:
         return IsEnabled() && level <= GetComponentLevel(component);
     }
 
+    static bool IsLevelEnabled(wxLogLevel level, const char* component)
+    {
+        return IsEnabled() && level <= GetComponentLevel(component);
+    }
+
 
     // enable/disable messages at wxLOG_Verbose level (only relevant if the
     // current log level is greater or equal to it)
@@ -580,6 +590,12 @@ public:
     bool HasPendingMessages() const { return true; }
 
 protected:
+    // override this method to return true if this log target can be used
+    // directly from any thread: by default, the messages logged by the worker
+    // threads are buffered and only passed to the global log target from the
+    // main thread
+    virtual bool IsThreadSafe() const { return false; }
+
     // the logging functions that can be overridden: DoLogRecord() is called
     // for every "record", i.e. a unit of log output, to be logged and by
     // default formats the message and passes it to DoLogTextAtLevel() which in
@@ -629,9 +645,13 @@ private:
     // called from OnLog() if it's called from the main thread or if we have a
     // (presumably MT-safe) thread-specific logger and by FlushThreadMessages()
     // when it plays back the buffered messages logged from the other threads
+    //
+    // repetition counting is not thread-safe and so must be disabled when
+    // this is called for the global thread-safe log target from other threads
     void CallDoLogNow(wxLogLevel level,
                       const wxString& msg,
-                      const wxLogRecordInfo& info);
+                      const wxLogRecordInfo& info,
+                      bool countRepetitions = true);
 
 
     // variables
@@ -941,7 +961,7 @@ public:
     {
         // remember that fatal errors can't be disabled
         if ( m_level == wxLOG_FatalError ||
-                wxLog::IsLevelEnabled(m_level, wxASCII_STR(m_info.component)) )
+                wxLog::IsLevelEnabled(m_level, m_info.component) )
             DoCallOnLog(wxString::FormatV(format, argptr));
     }
 
@@ -1054,7 +1074,7 @@ public:
     template <typename... Targs>
     void LogAtLevel(wxLogLevel level, const wxString& format, Targs... args)
     {
-        if ( !wxLog::IsLevelEnabled(level, wxASCII_STR(m_info.component)) )
+        if ( !wxLog::IsLevelEnabled(level, m_info.component) )
             return;
 
         DoCallOnLog(level, wxString::Format(format, args...));
@@ -1062,7 +1082,7 @@ public:
 
     void LogAtLevel(wxLogLevel level, const wxString& s)
     {
-        if ( !wxLog::IsLevelEnabled(level, wxASCII_STR(m_info.component)) )
+        if ( !wxLog::IsLevelEnabled(level, m_info.component) )
             return;
 
         DoCallOnLog(level, s);
@@ -1189,7 +1209,7 @@ WXDLLIMPEXP_BASE wxString wxSysErrorMsgStr(unsigned long nErrCode = 0);
 
 // Macro evaluating to true if logging at the given level is enabled.
 #define wxLOG_IS_ENABLED(level) \
-    wxLog::IsLevelEnabled(wxLOG_##level, wxASCII_STR(wxLOG_COMPONENT))
+    wxLog::IsLevelEnabled(wxLOG_##level, wxLOG_COMPONENT)
 
 // Macro used to define most of the actual wxLogXXX() macros: just calls
 // wxLogger::Log(), if logging at the specified level is enabled.
@@ -0,0 +1,75 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/logasync.h
+// Purpose:     wxLogAsync: log target writing the records in another thread
+// Author:      wxWidgets development team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_LOGASYNC_H_
+#define _WX_LOGASYNC_H_
+
+#include "wx/log.h"
+
+#if wxUSE_LOG && wxUSE_THREADS
+
+class wxLogAsyncImpl;
+
+// What to do when logging a record while the buffer is full.
+enum wxLogAsyncOverflow
+{
+    // Wait until the background thread writes some records.
+    wxLOG_ASYNC_BLOCK,
+
+    // Drop the record.
+    wxLOG_ASYNC_DROP
+};
+
+// ----------------------------------------------------------------------------
+// wxLogAsync: log target which stores the records in a per-thread buffer and
+// passes them to the real target in a background thread
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxLogAsync : public wxLog
+{
+public:
+    // Takes ownership of the target, which must be usable from any thread.
+    //
+    // The capacity is the maximal number of records that can be buffered for
+    // each thread.
+    explicit wxLogAsync(wxLog* target,
+                        size_t capacity = 1024,
+                        wxLogAsyncOverflow overflow = wxLOG_ASYNC_BLOCK);
+
+    // Writes all the remaining records and deletes the target.
+    virtual ~wxLogAsync();
+
+    wxLog* GetTarget() const;
+
+    // Wake up the background thread, without waiting for it.
+    virtual void Flush() override;
+
+    // Wait until all the records logged so far are written and the target is
+    // flushed.
+    void Sync();
+
+    // Return the number of records dropped because the buffer was full.
+    size_t GetDroppedCount() const;
+
+protected:
+    virtual bool IsThreadSafe() const override { return true; }
+
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info) override;
+
+private:
+    wxLogAsyncImpl* const m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsync);
+};
+
+#endif // wxUSE_LOG && wxUSE_THREADS
+
+#endif // _WX_LOGASYNC_H_
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/imageload.h
+// Purpose:     Helpers for loading a region of the image at reduced size
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGELOAD_H_
+#define _WX_PRIVATE_IMAGELOAD_H_
+
+#include "wx/image.h"
+#include "wx/vector.h"
+
+// ----------------------------------------------------------------------------
+// wxImageLoadParams: part of the image to load and its size
+// ----------------------------------------------------------------------------
+
+// This class is used by the image handlers supporting decoding only the part
+// of the image specified by wxIMAGE_OPTION_REGION_XXX options and/or reducing
+// its size to fit into wxIMAGE_OPTION_MAX_WIDTH and wxIMAGE_OPTION_MAX_HEIGHT
+// during decoding, instead of loading the entire image at full size first.
+//
+// Handlers using it must set wxIMAGE_OPTION_ORIGINAL_WIDTH and HEIGHT options
+// by calling SetOriginalSize() to indicate that they did it, otherwise the
+// image is cropped and rescaled by wxImage itself after loading it.
+class WXDLLIMPEXP_CORE wxImageLoadParams
+{
+public:
+    // Get the options from the image: this must be done before destroying it,
+    // as handlers typically do.
+    explicit wxImageLoadParams(const wxImage& image);
+
+    // Return true if either the region or the maximal size was specified.
+    bool IsUsed() const { return m_hasRegion || m_maxWidth || m_maxHeight; }
+
+    // Return true if the region was specified.
+    bool HasRegion() const { return m_hasRegion; }
+
+    // Must be called once the size of the image is known to compute the
+    // region to decode, which is the entire image if no region was specified
+    // or if it doesn't intersect the image, and the scale factor.
+    void SetImageSize(int width, int height);
+
+    // The functions below can only be used after calling SetImageSize().
+
+    // Region of the original image to load.
+    const wxRect& GetRegion() const { return m_region; }
+
+    // Return the divisor used for the region size: this is always a power of
+    // 2 chosen to make the region fit into the maximal size, if any.
+    int GetScale() const { return m_scale; }
+
+    // Return the size of the image to create, i.e. the size of the region
+    // divided by scale and rounded up.
+    int GetOutputWidth() const { return (m_region.width + m_scale - 1) / m_scale; }
+    int GetOutputHeight() const { return (m_region.height + m_scale - 1) / m_scale; }
+
+    // Return true if the output image is different from the original one.
+    bool IsNeeded() const
+    {
+        return m_scale != 1 || m_region.GetSize() != m_size;
+    }
+
+    // Set the options indicating the original image size if necessary.
+    void SetOriginalSize(wxImage* image) const;
+
+private:
+    wxRect m_region;
+    wxSize m_size;
+    unsigned m_maxWidth,
+             m_maxHeight;
+    int m_scale = 1;
+    bool m_hasRegion;
+};
+
+// ----------------------------------------------------------------------------
+// wxImageRowAccumulator: downscales image rows during decoding
+// ----------------------------------------------------------------------------
+
+// This class can be used by the handlers decoding the images row by row: it
+// must be given all rows of the region to load, in order, and stores them
+// in the output image, averaging blocks of scale*scale pixels, using only a
+// single row of accumulators.
+class WXDLLIMPEXP_CORE wxImageRowAccumulator
+{
+public:
+    // The image must have been already created with the output size
+    // specified by the given parameters and must have alpha if the rows
+    // passed to AddRow() contain it.
+    wxImageRowAccumulator(wxImage* image, const wxImageLoadParams& params);
+
+    // Add the next row of the region, rgb points to the first pixel of the
+    // region in this row and each pixel uses the given number of bytes,
+    // which must be 3 (RGB) or 4 (RGBA, with non-premultiplied alpha).
+    void AddRow(const unsigned char* rgb, int bytesPerPixel);
+
+    // Return true if any of the pixels passed to AddRow() wasn't opaque.
+    bool HasTransparency() const { return m_hasTransparency; }
+
+private:
+    void FlushRow();
+
+    unsigned char* m_data;
+    unsigned char* m_alpha;
+    const int m_width;
+    const int m_regionWidth;
+    const int m_scale;
+
+    // Sums of the colour components, premultiplied by alpha if we have it,
+    // and alpha values for the pixels of the current output row.
+    wxVector<wxUint64> m_sums;
+
+    // Number of input rows accumulated so far for the current output row and
+    // the number of rows remaining to be added.
+    int m_rows = 0;
+    int m_rowsLeft;
+
+    bool m_hasTransparency = false;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageRowAccumulator);
+};
+
+#endif // _WX_PRIVATE_IMAGELOAD_H_
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/threadpool.h
+// Purpose:     wxThreadPool: pool of worker threads used by wx itself
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_THREADPOOL_H_
+#define _WX_PRIVATE_THREADPOOL_H_
+
+#include "wx/defs.h"
+
+#include <functional>
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: bounded pool of threads for parallelizing loops
+// ----------------------------------------------------------------------------
+
+// This class is used by wxWidgets to split CPU-intensive operations, such as
+// image transformations, in independent parts and run them concurrently.
+//
+// The pool is global and its threads are created on demand, when it's used
+// with more than one thread for the first time, and are destroyed when the
+// library is shut down.
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    // The function called for each part of the work: it gets the half-open
+    // range [from, to) of items to process.
+    using RangeFunc = std::function<void (int from, int to)>;
+
+    // Return the number of threads to use if the given number is specified
+    // by the user: this is the number itself if it's positive or the number
+    // of CPUs if it's 0 (or negative).
+    static int GetThreadCount(int threads);
+
+    // Call the given function for the consecutive, non overlapping, ranges
+    // covering [0, count) using up to maxThreads threads, including the
+    // calling one, and return only when all of them have completed.
+    //
+    // The ranges contain at least minItems items each (except, possibly, the
+    // last one), to avoid the overhead of using threads for small amounts of
+    // work.
+    //
+    // The function is called on the current thread for the entire range if
+    // maxThreads is 1, if there are not enough items, if the pool is already
+    // used by another thread or if this function is called recursively, i.e.
+    // from inside a job running on the pool, including the parts of it
+    // executed by the calling thread itself. As the function is called
+    // exactly once for each item in any case, the results don't depend on the
+    // number of threads actually used as long as the processing of different
+    // items is independent.
+    static void ParallelFor(int count,
+                            int maxThreads,
+                            const RangeFunc& func,
+                            int minItems = 1);
+
+private:
+    wxThreadPool() = delete;
+};
+
+#endif // _WX_PRIVATE_THREADPOOL_H_
@@ -104,6 +104,26 @@ public:
     wxCharBuffer
         cWC2MB(const wchar_t *in, size_t inLen, size_t *outLen) const;
 
+    // Return the upper bound for the value returned by ToWChar() or
+    // FromWChar() called with the same input or wxCONV_FAILED if it can't be
+    // determined without converting the input.
+    virtual size_t GetMaxWCharLen(const char *src,
+                                  size_t srcLen = wxNO_LEN) const;
+    virtual size_t GetMaxMBLen(const wchar_t *src,
+                               size_t srcLen = wxNO_LEN) const;
+
+    // Convert the input into the given buffer, which is reallocated to have
+    // exactly the size of the output, and return the same value as
+    // ToWChar() or FromWChar() would.
+    //
+    // If the upper bound for the output length is known, i.e. the function
+    // above doesn't return wxCONV_FAILED, the input is converted in a single
+    // pass, instead of computing the length of the output first.
+    size_t ToWCharBuffer(wxWCharBuffer& dst,
+                         const char *src, size_t srcLen = wxNO_LEN) const;
+    size_t FromWCharBuffer(wxCharBuffer& dst,
+                           const wchar_t *src, size_t srcLen = wxNO_LEN) const;
+
     // Obsolete convenience functions.
     wxWCharBuffer cMB2WX(const char *psz) const { return cMB2WC(psz); }
     wxCharBuffer cWX2MB(const wchar_t *psz) const { return cWC2MB(psz); }
@@ -341,6 +361,11 @@ public:
 
     virtual size_t GetMaxCharLen() const override { return 4; }
 
+    virtual size_t GetMaxWCharLen(const char *src,
+                                  size_t srcLen = wxNO_LEN) const override;
+    virtual size_t GetMaxMBLen(const wchar_t *src,
+                               size_t srcLen = wxNO_LEN) const override;
+
     wxNODISCARD virtual wxMBConv *Clone() const override { return new wxMBConvStrictUTF8(); }
 
     // NB: other mapping modes are not, strictly speaking, UTF-8, so we can't
@@ -367,6 +392,9 @@ public:
 
     virtual size_t GetMaxCharLen() const override { return 4; }
 
+    virtual size_t GetMaxWCharLen(const char *src,
+                                  size_t srcLen = wxNO_LEN) const override;
+
     wxNODISCARD virtual wxMBConv *Clone() const override { return new wxMBConvUTF8(m_options); }
 
     // NB: other mapping modes are not, strictly speaking, UTF-8, so we can't
@@ -388,6 +416,11 @@ public:
 
     virtual size_t GetMBNulLen() const override { return BYTES_PER_CHAR; }
 
+    virtual size_t GetMaxWCharLen(const char *src,
+                                  size_t srcLen = wxNO_LEN) const override;
+    virtual size_t GetMaxMBLen(const wchar_t *src,
+                               size_t srcLen = wxNO_LEN) const override;
+
 protected:
     // return the length of the buffer using srcLen if it's not wxNO_LEN and
     // computing the length ourselves if it is; also checks that the length is
@@ -437,6 +470,11 @@ public:
 
     virtual size_t GetMBNulLen() const override { return BYTES_PER_CHAR; }
 
+    virtual size_t GetMaxWCharLen(const char *src,
+                                  size_t srcLen = wxNO_LEN) const override;
+    virtual size_t GetMaxMBLen(const wchar_t *src,
+                               size_t srcLen = wxNO_LEN) const override;
+
 protected:
     // this is similar to wxMBConvUTF16Base method with the same name except
     // that, of course, it verifies that length is divisible by 4 if given and
@@ -499,6 +537,11 @@ public:
                              const wchar_t *src, size_t srcLen = wxNO_LEN) const override;
     virtual size_t GetMBNulLen() const override;
 
+    virtual size_t GetMaxWCharLen(const char *src,
+                                  size_t srcLen = wxNO_LEN) const override;
+    virtual size_t GetMaxMBLen(const wchar_t *src,
+                               size_t srcLen = wxNO_LEN) const override;
+
     virtual bool IsUTF8() const override;
 
     wxNODISCARD virtual wxMBConv *Clone() const override { return new wxCSConv(*this); }
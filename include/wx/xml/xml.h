@@ -35,6 +35,7 @@ class WXDLLIMPEXP_FWD_XML wxXmlNode;
 class WXDLLIMPEXP_FWD_XML wxXmlAttribute;
 class WXDLLIMPEXP_FWD_XML wxXmlDocument;
 class WXDLLIMPEXP_FWD_XML wxXmlIOHandler;
+class wxXmlArena;
 class WXDLLIMPEXP_FWD_BASE wxInputStream;
 class WXDLLIMPEXP_FWD_BASE wxOutputStream;
 
@@ -79,6 +80,10 @@ public:
     void SetValue(const wxString& value) { m_value = value; }
     void SetNext(wxXmlAttribute *next) { m_next = next; }
 
+    // allocate from the arena of the document being loaded if it uses one
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
+
 private:
     wxString m_name;
     wxString m_value;
@@ -167,6 +172,10 @@ public:
     bool GetNoConversion() const { return m_noConversion; }
     void SetNoConversion(bool noconversion) { m_noConversion = noconversion; }
 
+    // allocate from the arena of the document being loaded if it uses one
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
+
 private:
     wxXmlNodeType m_type;
     wxString m_name;
@@ -219,7 +228,8 @@ private:
 enum wxXmlDocumentLoadFlag
 {
     wxXMLDOC_NONE = 0,
-    wxXMLDOC_KEEP_WHITESPACE_NODES = 1
+    wxXMLDOC_KEEP_WHITESPACE_NODES = 1,
+    wxXMLDOC_USE_ARENA = 2
 };
 
 // Create an instance of this and pass it to wxXmlDocument::Load()
@@ -240,7 +250,7 @@ public:
     wxXmlDocument();
     wxXmlDocument(const wxString& filename);
     wxXmlDocument(wxInputStream& stream);
-    ~wxXmlDocument() = default;
+    ~wxXmlDocument();
 
     wxXmlDocument(const wxXmlDocument& doc);
     wxXmlDocument& operator=(const wxXmlDocument& doc);
@@ -254,6 +264,17 @@ public:
     virtual bool Save(const wxString& filename, int indentstep = 2) const;
     virtual bool Save(wxOutputStream& stream, int indentstep = 2) const;
 
+    // Loads and saves document in the compact binary format which can be
+    // loaded much faster than XML.
+    bool LoadBinary(const wxString& filename, int flags = wxXMLDOC_NONE);
+    bool LoadBinary(wxInputStream& stream, int flags = wxXMLDOC_NONE);
+    bool SaveBinary(const wxString& filename) const;
+    bool SaveBinary(wxOutputStream& stream) const;
+
+    // Returns true if the stream contents is in the binary format, without
+    // consuming any data from it.
+    static bool IsBinaryFormat(wxInputStream& stream);
+
     bool IsOk() const { return GetRoot() != nullptr; }
 
     // Returns root node of the document.
@@ -320,6 +341,8 @@ private:
     wxString   m_version;
     wxString   m_fileEncoding;
     wxXmlDoctype m_doctype;
+    // must be declared before m_docNode to be destroyed after it
+    std::unique_ptr<wxXmlArena> m_arena;
     std::unique_ptr<wxXmlNode> m_docNode;
     wxTextFileType m_fileType = wxTextFileType_Unix;
     wxString m_eol = wxS("\n");
@@ -329,6 +352,110 @@ private:
     wxDECLARE_CLASS(wxXmlDocument);
 };
 
+
+// ----------------------------------------------------------------------------
+// Streaming XML parsing
+// ----------------------------------------------------------------------------
+
+struct wxXmlReaderContext;
+
+// Element passed to wxXmlReaderHandler::OnStartElement(): it is only valid
+// during this call and its name and attributes are converted to strings only
+// when they're requested.
+class WXDLLIMPEXP_XML wxXmlReaderElement
+{
+public:
+    wxString GetName() const;
+
+    // Line number of the element start in the document.
+    int GetLineNumber() const { return m_lineNo; }
+
+    // Depth of the element, 0 for the root element.
+    int GetDepth() const { return m_depth; }
+
+    size_t GetAttributeCount() const;
+    wxString GetAttributeName(size_t n) const;
+    wxString GetAttributeValue(size_t n) const;
+
+    bool HasAttribute(const wxString& attrName) const;
+    bool GetAttribute(const wxString& attrName, wxString *value) const;
+    wxString GetAttribute(const wxString& attrName,
+                          const wxString& defaultVal = wxString()) const;
+
+    // Call this to get this element and all its contents as a wxXmlNode in
+    // wxXmlReaderHandler::OnSubtree() instead of getting the events for them.
+    void LoadSubtree() const { m_loadSubtree = true; }
+
+private:
+    wxXmlReaderElement(const char *name, const char **attrs,
+                       int lineNo, int depth)
+        : m_name(name), m_attrs(attrs), m_lineNo(lineNo), m_depth(depth)
+    {
+    }
+
+    // Returns the index of the attribute value in m_attrs or -1.
+    int FindAttribute(const wxString& attrName) const;
+
+    const char* const m_name;
+    const char** const m_attrs;
+    const int m_lineNo;
+    const int m_depth;
+    mutable bool m_loadSubtree = false;
+
+    friend struct wxXmlReaderContext;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReaderElement);
+};
+
+// Base class for the objects receiving the events from wxXmlReader. All the
+// functions return true to continue parsing or false to stop it.
+class WXDLLIMPEXP_XML wxXmlReaderHandler
+{
+public:
+    wxXmlReaderHandler() = default;
+    virtual ~wxXmlReaderHandler() = default;
+
+    virtual bool OnStartElement(const wxXmlReaderElement& WXUNUSED(element))
+        { return true; }
+    virtual bool OnEndElement(const wxString& WXUNUSED(name))
+        { return true; }
+
+    // Called with the entire contents of text or CDATA sections.
+    virtual bool OnText(const wxString& WXUNUSED(text))
+        { return true; }
+
+    // Called with the element for which LoadSubtree() was called once it
+    // ends, instead of OnEndElement().
+    virtual bool OnSubtree(std::unique_ptr<wxXmlNode> WXUNUSED(node))
+        { return true; }
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReaderHandler);
+};
+
+// Parses XML documents without loading them in memory, passing the elements
+// and text to the handler as they're found.
+class WXDLLIMPEXP_XML wxXmlReader
+{
+public:
+    // Flags are the same as for wxXmlDocument::Load().
+    explicit wxXmlReader(wxXmlReaderHandler& handler,
+                         int flags = wxXMLDOC_NONE)
+        : m_handler(handler), m_flags(flags)
+    {
+    }
+
+    // Returns false only if an error occurred, but not if parsing was stopped
+    // by the handler.
+    bool Parse(const wxString& filename, wxXmlParseError* err = nullptr);
+    bool Parse(wxInputStream& stream, wxXmlParseError* err = nullptr);
+
+private:
+    wxXmlReaderHandler& m_handler;
+    const int m_flags;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReader);
+};
+
 #endif // wxUSE_XML
 
 #endif // _WX_XML_H_
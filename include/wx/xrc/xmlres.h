@@ -75,7 +75,8 @@ enum wxXmlResourceFlags
     wxXRC_USE_LOCALE     = 1,
     wxXRC_NO_SUBCLASSING = 2,
     wxXRC_NO_RELOADING   = 4,
-    wxXRC_USE_ENVVARS    = 8
+    wxXRC_USE_ENVVARS    = 8,
+    wxXRC_LAZY_BOOK_PAGES = 16
 };
 
 // This class holds XML resources from one or more .xml files
@@ -97,6 +98,9 @@ public:
     //        wxXRC_USE_ENVVARS
     //              expand environment variables for paths
     //              (such as bitmaps or icons).
+    //        wxXRC_LAZY_BOOK_PAGES
+    //              create the contents of book control pages only when they
+    //              are shown for the first time
     wxXmlResource(int flags = wxXRC_USE_LOCALE,
                   const wxString& domain = wxEmptyString);
 
@@ -113,6 +117,9 @@ public:
     //        wxXRC_USE_ENVVARS
     //              expand environment variables for paths
     //              (such as bitmaps or icons).
+    //        wxXRC_LAZY_BOOK_PAGES
+    //              create the contents of book control pages only when they
+    //              are shown for the first time
     wxXmlResource(const wxString& filemask, int flags = wxXRC_USE_LOCALE,
                   const wxString& domain = wxEmptyString);
 
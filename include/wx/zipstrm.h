@@ -325,6 +325,11 @@ public:
     void SetFormat(wxZipArchiveFormat format)   { m_format = format; }
     wxZipArchiveFormat GetFormat() const        { return m_format; }
 
+    // Compress the entries data using several threads, see
+    // wxZlibOutputStream::EnableParallel().
+    void EnableParallel(unsigned numThreads = 0)
+        { m_parallel = true; m_parallelThreads = numThreads; }
+
 protected:
     virtual size_t WXZIPFIX OnSysWrite(const void *buffer, size_t size) override;
     virtual wxFileOffset OnSysTell() const override      { return m_entrySize; }
@@ -370,6 +375,8 @@ private:
     wxString m_Comment;
     bool m_endrecWritten;
     wxZipArchiveFormat m_format;
+    bool m_parallel;
+    unsigned m_parallelThreads;
 
     wxDECLARE_NO_COPY_CLASS(wxZipOutputStream);
 };
@@ -430,6 +437,10 @@ private:
     bool DoOpen(wxZipEntry *entry = nullptr, bool raw = false);
     bool OpenDecompressor(bool raw = false);
 
+    // Open an entry of the central directory read by another stream over the
+    // same file, used by wxZipFileReader.
+    bool OpenCatalogEntry(wxZipEntry& entry);
+
     class wxStoredInputStream *m_store;
     class wxZlibInputStream2 *m_inflate;
     class wxRawInputStream *m_rawin;
@@ -451,11 +462,53 @@ private:
                     wxZipEntry *entry, wxZipInputStream& inputStream);
     friend bool wxZipOutputStream::CopyArchiveMetaData(
                     wxZipInputStream& inputStream);
+    friend class wxZipFileReaderImpl;
 
     wxDECLARE_NO_COPY_CLASS(wxZipInputStream);
 };
 
 
+#if wxUSE_FILE
+
+/////////////////////////////////////////////////////////////////////////////
+// wxZipFileReader: random access to the entries of a zip file, allowing to
+// read several of them at once from different threads
+
+class wxZipFileReaderImpl;
+
+class WXDLLIMPEXP_BASE wxZipFileReader
+{
+public:
+    explicit wxZipFileReader(const wxString& filename,
+                             wxMBConv& conv = wxConvLocal);
+    ~wxZipFileReader();
+
+    bool IsOk() const;
+
+    // Access the entries of the central directory.
+    size_t GetEntryCount() const;
+    const wxZipEntry& GetEntry(size_t n) const;
+
+    // Return a new stream reading the data of the given entry, independent of
+    // all the other ones, or null on error. Can be called from any thread.
+    wxNODISCARD wxZipInputStream *OpenEntry(size_t n) const;
+
+    // Extract the given entries, or all of them, under the given directory
+    // using the given number of threads, or one per CPU if it is 0.
+    bool Extract(const wxString& dir,
+                 const std::vector<size_t>& entries,
+                 unsigned numThreads = 0) const;
+    bool ExtractAll(const wxString& dir, unsigned numThreads = 0) const;
+
+private:
+    wxZipFileReaderImpl* const m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipFileReader);
+};
+
+#endif // wxUSE_FILE
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
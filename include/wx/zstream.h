@@ -78,6 +78,11 @@ class WXDLLIMPEXP_BASE wxZlibOutputStream: public wxFilterOutputStream {
   bool SetDictionary(const char *data, size_t datalen);
   bool SetDictionary(const wxMemoryBuffer &buf);
 
+  // Compress the data in independent blocks of the given size using the
+  // given number of threads (one per CPU if 0), must be called before
+  // writing any data.
+  bool EnableParallel(unsigned numThreads = 0, size_t blockSize = 0);
+
  protected:
   size_t OnSysWrite(const void *buffer, size_t size) override;
   wxFileOffset OnSysTell() const override { return m_pos; }
@@ -92,6 +97,9 @@ class WXDLLIMPEXP_BASE wxZlibOutputStream: public wxFilterOutputStream {
   unsigned char *m_z_buffer;
   struct z_stream_s *m_deflate;
   wxFileOffset m_pos;
+  int m_level;
+  int m_flags;
+  class wxZlibParallelDeflate *m_parallel;
 
   wxDECLARE_NO_COPY_CLASS(wxZlibOutputStream);
 };
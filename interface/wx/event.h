@@ -455,9 +455,68 @@ public:
         @param event
             A heap-allocated event to be queued, QueueEvent() takes ownership
             of it. This parameter shouldn't be @NULL.
+
+        @see QueueOrReplaceEvent(), SetEventTypeCoalescing()
      */
     virtual void QueueEvent(wxEvent *event);
 
+    /**
+        Queue event for a later processing, replacing the pending event of
+        the same type and with the same ID, if any.
+
+        This method is similar to QueueEvent() and can be used from the
+        worker threads in the same way, but if there is an event with the
+        same type and ID as @a event still waiting to be processed by this
+        handler, it replaces the existing event instead of appending the new
+        one to the queue. The replaced event is deleted and the new one takes
+        its place in the queue, so that it is processed in the same order
+        relative to the other events as the original event would have been.
+
+        This is useful for the events posted at high frequency when only the
+        latest one matters, e.g. progress updates from a worker thread: if
+        the main thread can't keep up with them, the intermediate updates are
+        simply discarded instead of accumulating in the queue.
+
+        Note that, unlike QueueEvent(), this method always needs to lock the
+        queue of this handler, so it is a bit slower when the events don't
+        need to be replaced.
+
+        @since 3.3.2
+
+        @param event
+            A heap-allocated event to be queued, this function takes ownership
+            of it. This parameter shouldn't be @NULL.
+     */
+    void QueueOrReplaceEvent(wxEvent *event);
+
+    /**
+        Set whether the events of the given type are coalesced when queued.
+
+        If @a coalesce is @true, QueueEvent() behaves as QueueOrReplaceEvent()
+        for all the events of the given type, for all event handlers. This
+        allows enabling coalescing for the events posted by some code which
+        can't be modified to use QueueOrReplaceEvent() directly.
+
+        Calling this function with @a coalesce set to @false restores the
+        default behaviour of appending all the events to the queue.
+
+        This function is thread-safe, but it is recommended to call it during
+        the program initialization, before any events of this type are queued.
+
+        @since 3.3.2
+     */
+    static void SetEventTypeCoalescing(wxEventType eventType,
+                                       bool coalesce = true);
+
+    /**
+        Return @true if the events of the given type are coalesced.
+
+        @see SetEventTypeCoalescing()
+
+        @since 3.3.2
+     */
+    static bool IsEventTypeCoalesced(wxEventType eventType);
+
     /**
         Post an event to be processed later.
 
@@ -5353,6 +5412,25 @@ void wxPostEvent(wxEvtHandler* dest, const wxEvent& event);
  */
 void wxQueueEvent(wxEvtHandler* dest, wxEvent *event);
 
+/**
+    Queue an event for processing on the given object, replacing the pending
+    event of the same type and with the same ID, if any.
+
+    This is a wrapper around wxEvtHandler::QueueOrReplaceEvent(), see its
+    documentation for more details.
+
+    @header{wx/event.h}
+
+    @since 3.3.2
+
+    @param dest
+        The object to queue the event on, can't be @NULL.
+    @param event
+        The heap-allocated and non-null event to queue, the function takes
+        ownership of it.
+ */
+void wxQueueOrReplaceEvent(wxEvtHandler* dest, wxEvent *event);
+
 #endif // wxUSE_BASE
 
 #if wxUSE_GUI
@@ -0,0 +1,169 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        evtprofiler.h
+// Purpose:     interface of wxEventProfiler
+// Author:      wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxEventProfiler
+
+    Collects the statistics about the time spent processing events.
+
+    This class allows finding which events and event handlers make the
+    application slow. It is disabled by default and doesn't add any noticeable
+    overhead to the event processing unless it's enabled by calling Enable().
+    When enabled, it records the number of times and the total and maximal
+    time spent:
+
+    - processing each event type, which includes the time taken by all the
+      event handlers called for the event, as well as the time spent on
+      propagating it, e.g. to the parent windows;
+    - in each event handler, i.e. each function or functor used with
+      wxEvtHandler::Bind() or in the event tables, for each event type it
+      was called for. Note that if the event handler processes other events,
+      the time spent processing them is included as well.
+
+    The collected statistics can be retrieved using GetEventTypeStats() and
+    GetHandlerStats() or as a report suitable for logging using GetReport() or
+    GetReportAsJSON().
+
+    Example of using this class:
+    @code
+    bool MyApp::OnInit()
+    {
+        if ( wxGetEnv("MYAPP_PROFILE_EVENTS", nullptr) )
+            wxEventProfiler::Enable();
+
+        ...
+    }
+
+    int MyApp::OnExit()
+    {
+        if ( wxEventProfiler::IsEnabled() )
+        {
+            wxFFile file("events.json", "w");
+            file.Write(wxEventProfiler::GetReportAsJSON());
+        }
+
+        return wxApp::OnExit();
+    }
+    @endcode
+
+    All functions of this class are static and thread-safe.
+
+    @since 3.3.2
+
+    @library{wxbase}
+    @category{events}
+*/
+class wxEventProfiler
+{
+public:
+    /**
+        Statistics collected for an event type or an event handler.
+     */
+    struct Stats
+    {
+        /// Number of times the event was processed or the handler called.
+        unsigned long count;
+
+        /// Total time taken by processing, in nanoseconds.
+        wxLongLong_t totalTime;
+
+        /// Maximal time taken by a single call, in nanoseconds.
+        wxLongLong_t maxTime;
+    };
+
+    /**
+        Statistics collected for an event type.
+     */
+    struct EventTypeStats : Stats
+    {
+        /// The event type.
+        wxEventType eventType;
+
+        /// The name of the class of the event, e.g. "wxMouseEvent".
+        wxString eventClass;
+    };
+
+    /**
+        Statistics collected for an event handler.
+     */
+    struct HandlerStats : Stats
+    {
+        /// The type of the events processed by the handler.
+        wxEventType eventType;
+
+        /**
+            The name of the class of the event handler object.
+
+            Note that this is the name of the nearest class using
+            wxDECLARE_DYNAMIC_CLASS() or similar macro and so it may be the
+            name of a base class of the actual object, e.g. "wxEvtHandler".
+         */
+        wxString handlerClass;
+
+        /**
+            The address of the functor object used to call the handler.
+
+            This pointer is only useful to distinguish between the different
+            handlers for the same event type in the same class and must not be
+            dereferenced, as the handler could have been already unbound.
+         */
+        const void* functor;
+    };
+
+    /**
+        Start or stop collecting the statistics.
+
+        Stopping collecting the statistics doesn't reset them, call Reset()
+        to do it.
+     */
+    static void Enable(bool enable = true);
+
+    /**
+        Return @true if the statistics are being collected.
+     */
+    static bool IsEnabled();
+
+    /**
+        Forget all the statistics collected so far.
+     */
+    static void Reset();
+
+    /**
+        Return the statistics for all event types processed while the profiler
+        was enabled.
+
+        The returned vector is sorted in decreasing total time order.
+     */
+    static std::vector<EventTypeStats> GetEventTypeStats();
+
+    /**
+        Return the statistics for all event handlers called while the profiler
+        was enabled.
+
+        The returned vector is sorted in decreasing total time order.
+     */
+    static std::vector<HandlerStats> GetHandlerStats();
+
+    /**
+        Return the human-readable report with all the statistics.
+
+        The report contains two tables, for event types and event handlers,
+        with all times in microseconds.
+     */
+    static wxString GetReport();
+
+    /**
+        Return the report with all the statistics in JSON format.
+
+        The returned object has @c event_types and @c handlers fields
+        containing arrays of objects with @c type, @c class, @c count,
+        @c total_us, @c average_us and @c max_us fields, with the latter
+        three containing times in microseconds. The objects in the @c handlers
+        array also have @c functor field identifying the handler.
+     */
+    static wxString GetReportAsJSON();
+};
@@ -384,6 +384,29 @@ public:
     */
     ssize_t Read(void* buffer, size_t count);
 
+    /**
+        Reads from the given position in the file into a memory buffer.
+
+        Unlike Read(), this function doesn't use the current file position,
+        so it can be called concurrently from several threads using the same
+        wxFile object. It uses @c pread() under Unix and overlapped @c
+        ReadFile() under MSW, where it also changes the current position, so
+        it shouldn't be mixed with Read() and Seek() calls.
+
+        @param buffer
+           Buffer to write in
+        @param count
+           Bytes to read
+        @param ofs
+           Offset in the file to read at, must be non-negative.
+
+        @return The number of bytes read, which is 0 if @a ofs is at or after
+            the end of the file, or ::wxInvalidOffset on error.
+
+        @since 3.3.2
+    */
+    ssize_t ReadAt(void* buffer, size_t count, wxFileOffset ofs) const;
+
     /**
         Reads the entire contents of the file into a string.
 
@@ -10,6 +10,13 @@
     @class wxArchiveFSHandler
 
     A file system handler for accessing files inside of archives.
+
+    The catalog of each archive is read and indexed when any file inside it is
+    accessed for the first time, so that opening the other files in the same
+    archive later doesn't need to read the catalog again and takes the same
+    time for all files. The catalogs of the least recently used archives are
+    discarded when the total number of cached entries exceeds the limit set
+    by SetMaxCachedEntries().
 */
 class wxArchiveFSHandler : public wxFileSystemHandler
 {
@@ -17,6 +24,27 @@ public:
     wxArchiveFSHandler();
     virtual ~wxArchiveFSHandler();
     void Cleanup();
+
+    /**
+        Set the maximal total number of entries in the cached archive catalogs.
+
+        When this limit is exceeded, the catalogs of the least recently used
+        archives are discarded and will be read again if they are accessed
+        later. The catalog of the most recently used archive is always kept,
+        even if it contains more entries than this limit.
+
+        The default limit is 100000 entries.
+
+        @since 3.3.2
+    */
+    void SetMaxCachedEntries(size_t maxEntries);
+
+    /**
+        Return the limit set by SetMaxCachedEntries().
+
+        @since 3.3.2
+    */
+    size_t GetMaxCachedEntries() const;
 };
 
 
@@ -131,6 +131,10 @@ enum wxImagePNGType
 #define wxIMAGE_OPTION_MAX_HEIGHT                       wxString("MaxHeight")
 #define wxIMAGE_OPTION_ORIGINAL_WIDTH                   wxString("OriginalWidth")
 #define wxIMAGE_OPTION_ORIGINAL_HEIGHT                  wxString("OriginalHeight")
+#define wxIMAGE_OPTION_REGION_X                         wxString("RegionX")
+#define wxIMAGE_OPTION_REGION_Y                         wxString("RegionY")
+#define wxIMAGE_OPTION_REGION_WIDTH                     wxString("RegionWidth")
+#define wxIMAGE_OPTION_REGION_HEIGHT                    wxString("RegionHeight")
 
 #define wxIMAGE_OPTION_BMP_FORMAT                       wxString("wxBMP_FORMAT")
 #define wxIMAGE_OPTION_CUR_HOTSPOT_X                    wxString("HotSpotX")
@@ -192,6 +196,26 @@ enum
     @ref image_handlers in the wxImage class documentation.
 
 
+    @section imagehandler_threads Thread Safety
+
+    The list of handlers is global and is not protected by any lock, so
+    AddHandler(), InsertHandler(), RemoveHandler() and CleanUpHandlers() must
+    not be called while images are being loaded or saved, which is usually
+    achieved by only calling them during the application initialization.
+
+    Loading images (i.e. calling LoadFile(), CanRead() and GetImageCount()) is
+    reentrant for wxPNGHandler, wxJPEGHandler, wxTIFFHandler, wxGIFHandler and
+    wxWEBPHandler, which don't keep any state between calls and use separate
+    instances of the underlying libraries decoders for each call, so these
+    handlers can be used to load different images from different threads at
+    the same time, as done by wxImageBatchLoader. This is not the case for
+    saving images using wxGIFHandler, which uses the handler object itself to
+    store the encoder state, and is not guaranteed for the other handlers.
+
+    Note that the individual wxImage objects are still not thread-safe and
+    can't be used from multiple threads at once.
+
+
     @section imagehandler_note Note (Legal Issue)
 
     This software is based in part on the work of the Independent JPEG Group.
@@ -849,6 +873,40 @@ public:
     */
     wxImage BlurVertical(int blurRadius) const;
 
+    /**
+        Returns a copy of the image blurred using Gaussian blur with the given
+        standard deviation.
+
+        Unlike Blur(), which simply averages the pixels in a square, this
+        function produces a smooth, close approximation of the real Gaussian
+        blur, computed using several successive box filter passes. Its speed
+        doesn't depend on @a sigma value and, if the image has alpha channel,
+        the colours are premultiplied by alpha before blurring them, so that
+        the colours of the transparent pixels don't affect the result.
+
+        If @a sigma is not positive, the returned image is just a copy of this
+        one.
+
+        As with Blur(), this function should not be used when using a single
+        mask colour for transparency.
+
+        @see GaussianBlurInPlace()
+
+        @since 3.3.2
+    */
+    wxImage GaussianBlur(double sigma) const;
+
+    /**
+        Blurs this image using Gaussian blur with the given standard deviation.
+
+        This function is identical to GaussianBlur() but modifies the image
+        itself instead of returning a new one. It doesn't allocate any
+        temporary images, so it's preferable to use it for big images.
+
+        @since 3.3.2
+    */
+    void GaussianBlurInPlace(double sigma);
+
     /**
         Returns a mirrored copy of the image.
         The parameter @a horizontally indicates the orientation.
@@ -1235,6 +1293,9 @@ public:
         This pointer is @NULL for the images without the alpha channel. If the image
         does have it, this pointer may be used to directly manipulate the alpha values
         which are stored as the RGB ones.
+
+        Notice that the returned pointer is invalidated by calling
+        GetDataRGBA().
     */
     unsigned char* GetAlpha() const;
 
@@ -1249,9 +1310,61 @@ public:
         row, with second row following after it and so on.
 
         You should not delete the returned pointer nor pass it to SetData().
+        Notice that it is invalidated by calling GetDataRGBA().
     */
     unsigned char* GetData() const;
 
+    /**
+        Returns read-only pointer to the interleaved RGBA image data.
+
+        The returned data contains width*height*4 bytes with the pixels in the
+        same order as for GetData() and each pixel represented by its red,
+        green, blue and (non-premultiplied) alpha components, i.e. in the same
+        format as accepted by SetDataRGBA().
+
+        By default wxImage stores the RGB data and the alpha channel values
+        separately, as returned by GetData() and GetAlpha(). However it can
+        also store them in the interleaved format, which is done if the image
+        was created using SetDataRGBA() or when this function is called: in
+        this case it converts the existing data to this format. Calling any
+        function accessing the pixels of the image, including GetData() and
+        GetAlpha(), creates the data in the default format from it again, and
+        this data is used from then on. Notice that these conversions don't
+        change the image contents and take time proportional to the number of
+        pixels, so using this function is only advantageous if the image is
+        already stored in RGBA format, see HasRGBAStorage(), or if it is going
+        to be accessed via this function repeatedly, e.g. to draw the same
+        image multiple times.
+
+        The returned pointer must not be deleted. It remains valid when the
+        pixels are accessed using the const functions, such as GetData(),
+        GetAlpha(), GetRed() and the other per-pixel accessors, which also
+        means that these functions can be safely called from several threads
+        at once for the images sharing the same data. However the data it
+        points to is not updated if the image is modified, and the pointer
+        becomes invalid when this image is changed or destroyed, and may
+        become invalid when this function is called for it again. Calling this
+        function invalidates the pointers previously returned by GetData() and
+        GetAlpha() for this image, but not for its copies, as this function
+        un-shares the image data before converting it.
+
+        This function can only be called for images with alpha channel and
+        returns @NULL for the other ones.
+
+        @since 3.3.2
+    */
+    const unsigned char* GetDataRGBA();
+
+    /**
+        Returns @true if the image data is currently stored in RGBA format.
+
+        If this function returns @true, GetDataRGBA() returns the pointer to
+        the existing data and doesn't need to convert it.
+
+        @since 3.3.2
+    */
+    bool HasRGBAStorage() const;
+
     /**
         Return alpha value at given pixel location.
     */
@@ -1362,12 +1475,30 @@ public:
             vastly more efficient than loading the entire huge image and
             rescaling it later (if these options are not supported by the
             handler, this is still what happens however). These options must be
-            set before calling LoadFile() to have any effect.
+            set before calling LoadFile() to have any effect. Since wxWidgets
+            3.3.2 PNG (for non-interlaced images) and TIFF handlers also
+            support reducing the image size while decoding it.
+
+        @li @c wxIMAGE_OPTION_REGION_X, @c wxIMAGE_OPTION_REGION_Y,
+            @c wxIMAGE_OPTION_REGION_WIDTH and @c wxIMAGE_OPTION_REGION_HEIGHT:
+            If any of these options is specified, only the given rectangular
+            region of the image is loaded. Zero or unspecified width or height
+            means that the region extends up to the right or bottom edge of the
+            image, and the region is clipped to the image bounds. If it doesn't
+            intersect the image at all, these options are ignored. When used
+            together with @c wxIMAGE_OPTION_MAX_WIDTH or @c
+            wxIMAGE_OPTION_MAX_HEIGHT, the maximal size applies to the region.
+            JPEG, PNG (non-interlaced images only) and TIFF handlers decode only
+            the rows of the image intersecting the region, for the other
+            formats the entire image is loaded and then cropped. As with the
+            maximal size options, these options must be set before calling
+            LoadFile().
+            @since 3.3.2
 
         @li @c wxIMAGE_OPTION_ORIGINAL_WIDTH and @c wxIMAGE_OPTION_ORIGINAL_HEIGHT:
             These options will return the original size of the image if either
             @c wxIMAGE_OPTION_MAX_WIDTH or @c wxIMAGE_OPTION_MAX_HEIGHT is
-            specified.
+            specified (or, since wxWidgets 3.3.2, if the region options are).
             @since 2.9.3
 
         @li @c wxIMAGE_OPTION_QUALITY: JPEG quality used when saving. This is an
@@ -1801,8 +1932,8 @@ public:
         unexpected. Don't use this method if you aren't sure you know what you
         are doing.
 
-        Due to the internal data representation, wxImage will always create a
-        copy of the data.
+        wxImage always creates a copy of the data, but, since wxWidgets 3.3.2,
+        stores it in the same interleaved format, see GetDataRGBA().
 
         @since 3.3.0
     */
@@ -1823,6 +1954,35 @@ public:
      */
     static void SetDefaultLoadFlags(int flags);
 
+    /**
+        Sets the maximal number of threads used by image transformations.
+
+        By default, all wxImage methods perform all the work in the calling
+        thread. Calling this function with an argument greater than 1 allows
+        the CPU-intensive transformations, i.e. Scale() and Rescale(), Blur(),
+        BlurHorizontal() and BlurVertical(), Rotate(), ConvertToGreyscale(),
+        ChangeHSV() and the other functions changing the colours of all image
+        pixels, to split the image in bands of rows (or columns) and process
+        them concurrently using an internal pool of threads. Passing 0 uses as
+        many threads as there are CPUs in the system.
+
+        The results of these functions are exactly the same, whichever number
+        of threads is used. Small images are always processed in the calling
+        thread only, as using multiple threads wouldn't make sense for them,
+        and the pool is only used by one thread at a time: if another thread
+        is already using it, the image is processed in the calling thread too.
+
+        This setting is global and affects all the images.
+
+        @param threads Maximal number of threads to use, including the calling
+            one, or 0 to use wxThread::GetCPUCount() threads.
+
+        @see GetMaxThreads()
+
+        @since 3.3.2
+     */
+    static void SetMaxThreads(int threads);
+
     /**
         Sets the flags used for loading image files by this object.
 
@@ -2105,6 +2265,15 @@ public:
      */
     static int GetDefaultLoadFlags();
 
+    /**
+        Returns the maximal number of threads used by image transformations.
+
+        See SetMaxThreads() for more information.
+
+        @since 3.3.2
+     */
+    static int GetMaxThreads();
+
     ///@{
     /**
         If the image file contains more than one image and the image handler is
@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        imagebatch.h
+// Purpose:     interface of wxImageBatchLoader
+// Author:      wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxImageBatchLoader
+
+    Loads several images concurrently, using multiple threads.
+
+    This class is useful for loading a lot of images, e.g. thumbnails of all
+    images in a directory, as it uses all the available CPUs to decode them.
+    Each image is decoded by a single thread, so this relies on the image
+    handlers being reentrant, which is the case for PNG, JPEG, TIFF, GIF and
+    WebP handlers, see @ref imagehandler_threads. Note that the handlers must
+    be added before using this class and the list of handlers must not be
+    modified while it's loading images.
+
+    Example of using it to load the thumbnails asynchronously:
+    @code
+    MyFrame::MyFrame()
+    {
+        ...
+        Bind(wxEVT_IMAGE_BATCH_LOADED, &MyFrame::OnImagesLoaded, this);
+
+        m_loader.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 128);
+        m_loader.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, 128);
+        for ( const auto& file : files )
+            m_loader.AddFile(file);
+
+        m_loader.Start(this);
+    }
+
+    void MyFrame::OnImagesLoaded(wxThreadEvent& event)
+    {
+        for ( size_t n = 0; n < m_loader.GetCount(); n++ )
+        {
+            if ( m_loader.IsOk(n) )
+                AddThumbnail(m_loader.GetImage(n));
+            else
+                wxLogWarning("Failed to load image: %s", m_loader.GetError(n));
+        }
+    }
+    @endcode
+
+    Errors and warnings logged while loading the images are not shown to the
+    user but can be retrieved using GetError() instead.
+
+    @beginEventEmissionTable{wxThreadEvent}
+    @event{EVT_THREAD(id, func)}
+        Use Bind() with @c wxEVT_IMAGE_BATCH_LOADED to be notified when all
+        images are loaded after calling Start(). wxThreadEvent::GetInt()
+        returns the number of successfully loaded images.
+    @endEventTable
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage, wxImageHandler
+
+    @since 3.3.2
+*/
+class wxImageBatchLoader
+{
+public:
+    /**
+        Default constructor.
+
+        Call AddFile() or AddStream() to add images to load.
+     */
+    wxImageBatchLoader();
+
+    /**
+        Destructor waits until loading images completes if it's still in
+        progress.
+     */
+    ~wxImageBatchLoader();
+
+    /**
+        Add the file to load.
+
+        The parameters have the same meaning as for wxImage::LoadFile().
+
+        @return The index of the image, which can be passed to GetImage().
+     */
+    size_t AddFile(const wxString& filename,
+                   wxBitmapType type = wxBITMAP_TYPE_ANY,
+                   int index = -1);
+
+    /**
+        Add the stream to load the image from.
+
+        The parameters have the same meaning as for wxImage::LoadFile(), except
+        that this object takes ownership of the stream, which must not be
+        used by the application any more.
+
+        If the stream is seekable, it is rewound to its current position
+        before loading the image from it, so Load() or Start() may be called
+        more than once.
+
+        @return The index of the image, which can be passed to GetImage().
+     */
+    size_t AddStream(wxInputStream* stream,
+                     wxBitmapType type = wxBITMAP_TYPE_ANY,
+                     int index = -1);
+
+    /**
+        Set the option to use when loading all images.
+
+        This is typically used with @c wxIMAGE_OPTION_MAX_WIDTH and @c
+        wxIMAGE_OPTION_MAX_HEIGHT options to load thumbnails of the images,
+        see wxImage::GetOptionInt() for the list of all options.
+     */
+    void SetOption(const wxString& name, const wxString& value);
+
+    /// @overload
+    void SetOption(const wxString& name, int value);
+
+    /**
+        Set the maximal number of threads to use.
+
+        By default, or if @a maxThreads is 0, one thread per CPU is used.
+        Use 1 to load all images in the calling thread.
+     */
+    void SetMaxThreads(int maxThreads);
+
+    /**
+        Load all the images and wait until it is done.
+
+        The calling thread takes part in loading the images.
+
+        @return @true if all images were loaded successfully.
+     */
+    bool Load();
+
+    /**
+        Start loading the images in the background.
+
+        This function returns immediately and loads the images in another
+        thread. Use IsRunning() to check whether it's done or Wait() to wait
+        until it is, or pass a non-null @a handler to be notified about it by
+        @c wxEVT_IMAGE_BATCH_LOADED event with the given @a id.
+
+        The images must not be accessed and no new images may be added until
+        loading completes.
+
+        @return @true if loading was started, @false if it is already running.
+     */
+    bool Start(wxEvtHandler* handler = nullptr, int id = wxID_ANY);
+
+    /**
+        Return @true if loading started by Start() is still in progress.
+     */
+    bool IsRunning() const;
+
+    /**
+        Wait until loading started by Start() completes.
+
+        @return @true if all images were loaded successfully.
+     */
+    bool Wait();
+
+    /**
+        Return the number of the images added.
+     */
+    size_t GetCount() const;
+
+    /**
+        Return @true if the image with the given index was loaded successfully.
+     */
+    bool IsOk(size_t n) const;
+
+    /**
+        Return the image with the given index.
+
+        The returned image is invalid if loading it failed.
+     */
+    const wxImage& GetImage(size_t n) const;
+
+    /**
+        Return the errors that happened when loading the image.
+
+        The returned string is empty if the image was loaded successfully and
+        contains all error and warning messages, separated by new lines,
+        logged when loading it otherwise.
+     */
+    const wxString& GetError(size_t n) const;
+};
+
+wxEventType wxEVT_IMAGE_BATCH_LOADED;
@@ -331,6 +331,10 @@ public:
         active log target is set to @NULL a new default log target will be
         created when logging occurs.
 
+        This function must be called from the main thread only. If the
+        previous target is thread-safe, see IsThreadSafe(), this function
+        waits until it's not used by any other threads any more.
+
         @see SetThreadActiveTarget()
     */
     static wxLog* SetActiveTarget(wxLog* logtarget);
@@ -339,11 +343,16 @@ public:
         Sets a thread-specific log target.
 
         The log target passed to this function will be used for all messages
-        logged by the current thread using the usual wxLog functions. This
-        shouldn't be called from the main thread which never uses a thread-
-        specific log target but can be used for the other threads to handle
-        thread logging completely separately; instead of buffering thread log
-        messages in the main thread logger.
+        logged by the current thread using the usual wxLog functions. This can
+        be used for the other threads to handle thread logging completely
+        separately; instead of buffering thread log messages in the main thread
+        logger.
+
+        Since wxWidgets 3.3.2 this function can be called from the main thread
+        too, in which case the thread-specific target temporarily takes
+        precedence over the one set with SetActiveTarget() for the messages
+        logged by the main thread only, while the messages logged by the other
+        threads are still handled as usual.
 
         Notice that unlike for SetActiveTarget(), wxWidgets does not destroy
         the thread-specific log targets when the thread terminates so doing
@@ -436,6 +445,37 @@ public:
      */
     static bool IsLevelEnabled(wxLogLevel level, wxString component);
 
+    /**
+        Returns true if logging at this level is enabled for the given
+        component specified as an ASCII string.
+
+        This overload is used by all wxLogXXX() macros with @c wxLOG_COMPONENT
+        as the component and is more efficient than the one taking wxString
+        because it doesn't need to allocate any memory nor to lock anything,
+        unless the component levels have changed since the last time it was
+        called with the same component in the current thread. This makes
+        checking whether the log messages are disabled very cheap, even when
+        component levels are used.
+
+        @since 3.3.2
+     */
+    static bool IsLevelEnabled(wxLogLevel level, const char* component);
+
+    /**
+        Returns the effective log level for the given component.
+
+        This is the level set for this component or its nearest parent
+        component with SetComponentLevel() or the global log level if no
+        level was set for any of them.
+
+        The overload taking @c const @c char* is more efficient, see
+        IsLevelEnabled(), and is only available since wxWidgets 3.3.2.
+
+        @since 2.9.1
+     */
+    static wxLogLevel GetComponentLevel(const wxString& component);
+    static wxLogLevel GetComponentLevel(const char* component);
+
     /**
         Sets the log level for the given component.
 
@@ -689,6 +729,30 @@ protected:
     virtual void DoLogText(const wxString& msg);
 
     ///@}
+
+    /**
+        Return @true if this log target can be used from any thread.
+
+        By default, the messages logged from the threads other than the main
+        one are buffered and passed to the active log target only when
+        FlushActive() is called from the main thread, unless a thread-specific
+        log target was set with SetThreadActiveTarget(). Overriding this
+        function to return @true allows the global log target to be used by
+        all threads directly, i.e. its DoLogRecord() is called from the thread
+        logging the message. Note that repetition counting, see
+        SetRepetitionCounting(), is not performed for the messages logged
+        from the threads other than main in this case.
+
+        When such target is replaced by SetActiveTarget(), the latter waits
+        until all the other threads stop using it before returning it, so it
+        can be safely deleted after this even if the other threads are still
+        logging.
+
+        The base class version returns @false, wxLogAsync returns @true.
+
+        @since 3.3.2
+    */
+    virtual bool IsThreadSafe() const;
 };
 
 
@@ -0,0 +1,127 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        logasync.h
+// Purpose:     interface of wxLogAsync
+// Author:      wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    What wxLogAsync does when a record is logged while the buffer is full.
+
+    @since 3.3.2
+*/
+enum wxLogAsyncOverflow
+{
+    /// Wait until the background thread writes some records.
+    wxLOG_ASYNC_BLOCK,
+
+    /// Drop the record, see wxLogAsync::GetDroppedCount().
+    wxLOG_ASYNC_DROP
+};
+
+/**
+    @class wxLogAsync
+
+    Log target passing the log records to another target in a background
+    thread.
+
+    This class allows to avoid doing potentially slow output, e.g. writing to
+    a file, in the threads logging messages. Instead, the records are added to
+    a fixed size buffer, different for each thread logging them, which
+    doesn't require any locking in the common case, and a background thread
+    takes them from there and passes them to the real log target, which is
+    flushed after each batch of records.
+
+    Unlike the other log targets, this one is used by the threads other than
+    the main one directly instead of buffering their messages until they can
+    be logged from the main thread, see wxLog::IsThreadSafe(). This also means
+    that the records logged by different threads are passed to the real
+    target in the order in which they were logged, up to the timestamp
+    precision.
+
+    The memory used by this target is bounded by the buffer capacity, which
+    is the maximal number of records which can wait to be written for each
+    thread. When the buffer is full, the thread logging a record either waits
+    until the background thread writes some of them, which is the default, or
+    drops the record, depending on the overflow policy specified in the
+    constructor.
+
+    All the remaining records are written when this object is destroyed,
+    which happens when the program exits if it's used as the active log
+    target. Sync() can be used to wait until they are written before that.
+
+    Example of using it:
+    @code
+    bool MyApp::OnInit()
+    {
+        // Don't slow down the worker threads by writing to stderr in them.
+        delete wxLog::SetActiveTarget(new wxLogAsync(new wxLogStderr));
+
+        ...
+    }
+    @endcode
+
+    Note that the real log target is used from the background thread and so
+    it can't be a log target which must be used from the main thread only,
+    such as wxLogGui or wxLogTextCtrl.
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @since 3.3.2
+
+    @library{wxbase}
+    @category{logging}
+*/
+class wxLogAsync : public wxLog
+{
+public:
+    /**
+        Constructor takes the real log target and the buffer parameters.
+
+        @param target
+            The log target to pass the records to. This object takes ownership
+            of it and deletes it when it's destroyed. Must not be @NULL.
+        @param capacity
+            The maximal number of records buffered for each thread.
+        @param overflow
+            What to do when a record is logged while the buffer is full.
+    */
+    explicit wxLogAsync(wxLog* target,
+                        size_t capacity = 1024,
+                        wxLogAsyncOverflow overflow = wxLOG_ASYNC_BLOCK);
+
+    /**
+        Destructor writes all the remaining records, flushes and deletes the
+        real log target.
+    */
+    virtual ~wxLogAsync();
+
+    /**
+        Return the real log target.
+
+        Note that it must not be used while this object exists, as it is used
+        by the background thread.
+    */
+    wxLog* GetTarget() const;
+
+    /**
+        Wake up the background thread to write the buffered records.
+
+        Note that this function returns immediately, use Sync() to wait until
+        the records are actually written.
+    */
+    virtual void Flush();
+
+    /**
+        Wait until all the records logged so far are written to the real log
+        target and it is flushed.
+    */
+    void Sync();
+
+    /**
+        Return the number of records dropped because the buffer was full.
+
+        This is always 0 if the ::wxLOG_ASYNC_BLOCK overflow policy is used.
+    */
+    size_t GetDroppedCount() const;
+};
@@ -192,6 +192,70 @@ public:
     virtual size_t FromWChar(char* dst, size_t dstLen, const wchar_t* src,
                              size_t srcLen = wxNO_LEN) const;
 
+    /**
+        Returns the upper bound for the value returned by ToWChar() called
+        with the same input.
+
+        The default implementation returns @c wxCONV_FAILED, meaning that the
+        bound is unknown and the length of the output can only be determined
+        by converting the input. The conversions to and from UTF-8, UTF-16 and
+        UTF-32, as well as wxCSConv using one of them or ISO-8859-1, return the
+        real bound, which allows ToWCharBuffer() to convert the input in a
+        single pass.
+
+        Override this function in the derived classes if the maximal length
+        of the output can be computed from the length of the input.
+
+        @since 3.3.2
+    */
+    virtual size_t GetMaxWCharLen(const char* src,
+                                  size_t srcLen = wxNO_LEN) const;
+
+    /**
+        Returns the upper bound for the value returned by FromWChar() called
+        with the same input.
+
+        This is similar to GetMaxWCharLen(), but is used by FromWCharBuffer().
+
+        @since 3.3.2
+    */
+    virtual size_t GetMaxMBLen(const wchar_t* src,
+                               size_t srcLen = wxNO_LEN) const;
+
+    /**
+        Converts from multibyte encoding to Unicode into the given buffer.
+
+        The buffer is reallocated to have exactly the size of the output,
+        which is also returned, with the same meaning as the return value of
+        ToWChar(). In case of an error, @c wxCONV_FAILED is returned and the
+        buffer is not modified.
+
+        If GetMaxWCharLen() returns a valid value, the input is converted in a
+        single pass into a buffer of this size, otherwise ToWChar() is called
+        twice, first to compute the size of the output and then to actually
+        convert it.
+
+        cMB2WC() and the wxString constructors taking @c char pointers use
+        this function.
+
+        @since 3.3.2
+    */
+    size_t ToWCharBuffer(wxWCharBuffer& dst,
+                         const char* src, size_t srcLen = wxNO_LEN) const;
+
+    /**
+        Converts from Unicode to multibyte encoding into the given buffer.
+
+        This is the counterpart of ToWCharBuffer() using GetMaxMBLen() and
+        FromWChar(). Notice that the buffer contents is always followed by
+        GetMBNulLen() @c NUL bytes, which are included in its length only if
+        they are part of the output, i.e. if @a srcLen is @c wxNO_LEN.
+
+        @since 3.3.2
+    */
+    size_t FromWCharBuffer(wxCharBuffer& dst,
+                           const wchar_t* src, size_t srcLen = wxNO_LEN) const;
+
     /**
         Converts from multibyte encoding to Unicode by calling ToWChar() and
         allocating a temporary wxWCharBuffer to hold the result.
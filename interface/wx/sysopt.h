@@ -47,6 +47,14 @@
         This flag should be set very early during program startup, within
         the constructor of the wxApp derivative. This option has been added in
         wxWidgets 3.3.0.
+    @flag{image.no-simd}
+        If set to non-zero value, wxImage resampling functions used by
+        wxImage::Scale() and wxImage::Rescale() don't use SIMD instructions
+        even if they are available. This is mostly useful for comparing the
+        performance of the vectorized and scalar code, as both produce the
+        same results (on ARM platforms, colour values may differ by 1 due to
+        the differences in rounding). This option has been added in wxWidgets
+        3.3.2.
     @endFlagTable
 
     @section sysopt_win Windows
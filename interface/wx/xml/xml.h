@@ -553,7 +553,20 @@ public:
 enum wxXmlDocumentLoadFlag
 {
     wxXMLDOC_NONE,
-    wxXMLDOC_KEEP_WHITESPACE_NODES
+    wxXMLDOC_KEEP_WHITESPACE_NODES,
+
+    /**
+        Allocate all nodes and attributes of the loaded document from a memory
+        arena owned by the document.
+
+        This makes loading big documents faster and the memory used by them
+        is freed all at once when the document is destroyed or loaded again.
+        However, when using this flag, no nodes of the document, including
+        those detached from it, may be used after the document is destroyed.
+
+        @since 3.3.2
+    */
+    wxXMLDOC_USE_ARENA
 };
 
 
@@ -841,6 +854,10 @@ public:
         less memory however makes impossible to recreate exactly the loaded text with a
         Save() call later. Read the initial description of this class for more info.
 
+        If @a flags contains wxXMLDOC_USE_ARENA, the nodes are allocated from
+        a memory arena, see wxXmlDocumentLoadFlag for the restrictions this
+        entails.
+
         Create an wxXmlParseError object and pass it to this function to get more
         information if an error occurred during XML parsing (this parameter is
         only available since wxWidgets 3.3.0).
@@ -874,6 +891,61 @@ public:
     */
     virtual bool Save(wxOutputStream& stream, int indentstep = 2) const;
 
+    /**
+        Loads the document saved by SaveBinary() from the given file.
+
+        @since 3.3.2
+    */
+    bool LoadBinary(const wxString& filename, int flags = wxXMLDOC_NONE);
+
+    /**
+        Loads the document saved by SaveBinary() from the given stream.
+
+        Loading the document in binary format is much faster than parsing the
+        same document in XML format, as this doesn't require any parsing or
+        character set conversions. Note that, unlike Load(), this function
+        keeps the whitespace nodes if they were present in the saved document,
+        so the only flag that can be used in @a flags is wxXMLDOC_USE_ARENA.
+
+        Returns @true on success or @false if the stream contents is not in
+        the binary format or is corrupted.
+
+        @see IsBinaryFormat()
+
+        @since 3.3.2
+    */
+    bool LoadBinary(wxInputStream& stream, int flags = wxXMLDOC_NONE);
+
+    /**
+        Saves the document in binary format to the given file.
+
+        @since 3.3.2
+    */
+    bool SaveBinary(const wxString& filename) const;
+
+    /**
+        Saves the document in binary format to the given stream.
+
+        The binary format is specific to wxWidgets and is only meant to be
+        loaded by LoadBinary(). It preserves all the information about the
+        nodes, including their line numbers, as well as the document version,
+        encoding and doctype, so that the loaded document is the same as the
+        one that was saved.
+
+        @since 3.3.2
+    */
+    bool SaveBinary(wxOutputStream& stream) const;
+
+    /**
+        Returns @true if the stream contains the document in binary format.
+
+        This function doesn't consume any data from the stream, so it can be
+        used to determine whether Load() or LoadBinary() should be called.
+
+        @since 3.3.2
+    */
+    static bool IsBinaryFormat(wxInputStream& stream);
+
     /**
         Sets the document node of this document.
 
@@ -939,3 +1011,206 @@ public:
     */
     static wxVersionInfo GetLibraryVersionInfo();
 };
+
+
+/**
+    @class wxXmlReaderElement
+
+    Element passed to wxXmlReaderHandler::OnStartElement().
+
+    Objects of this class can't be created nor copied and are only valid
+    during the call to wxXmlReaderHandler::OnStartElement(). The element name
+    and attributes are only converted to strings when they are requested.
+
+    @since 3.3.2
+
+    @library{wxxml}
+    @category{xml}
+*/
+class wxXmlReaderElement
+{
+public:
+    /// Returns the element name.
+    wxString GetName() const;
+
+    /// Returns the line number of the element start in the document.
+    int GetLineNumber() const;
+
+    /// Returns the depth of the element, which is 0 for the root element.
+    int GetDepth() const;
+
+    /// Returns the number of attributes of this element.
+    size_t GetAttributeCount() const;
+
+    /// Returns the name of the attribute with the given index.
+    wxString GetAttributeName(size_t n) const;
+
+    /// Returns the value of the attribute with the given index.
+    wxString GetAttributeValue(size_t n) const;
+
+    /// Returns @true if the element has the attribute with the given name.
+    bool HasAttribute(const wxString& attrName) const;
+
+    /**
+        Gets the value of the attribute with the given name.
+
+        Returns @false if there is no such attribute.
+    */
+    bool GetAttribute(const wxString& attrName, wxString* value) const;
+
+    /**
+        Returns the value of the attribute with the given name or @a defaultVal
+        if there is no such attribute.
+    */
+    wxString GetAttribute(const wxString& attrName,
+                          const wxString& defaultVal = wxString()) const;
+
+    /**
+        Requests loading this element with all its contents as wxXmlNode.
+
+        If this function is called, wxXmlReaderHandler::OnSubtree() is called
+        with the node corresponding to this element once its end is reached
+        and no other handler functions are called for the elements and text
+        inside it.
+
+        This allows to use the convenient wxXmlNode API for processing the
+        interesting parts of the document while streaming the rest of it.
+    */
+    void LoadSubtree() const;
+};
+
+/**
+    @class wxXmlReaderHandler
+
+    Base class for handling the events generated by wxXmlReader.
+
+    All functions of this class do nothing by default, override the ones
+    corresponding to the events of interest in the derived class. Each of
+    them can return @false to stop parsing the document.
+
+    @since 3.3.2
+
+    @library{wxxml}
+    @category{xml}
+*/
+class wxXmlReaderHandler
+{
+public:
+    /// Default constructor.
+    wxXmlReaderHandler();
+
+    /// Trivial but virtual destructor.
+    virtual ~wxXmlReaderHandler();
+
+    /**
+        Called when an element starts.
+
+        The @a element object can only be used during this call.
+    */
+    virtual bool OnStartElement(const wxXmlReaderElement& element);
+
+    /**
+        Called when an element ends.
+
+        This function is not called for the elements for which
+        wxXmlReaderElement::LoadSubtree() was called, OnSubtree() is called
+        instead.
+    */
+    virtual bool OnEndElement(const wxString& name);
+
+    /**
+        Called with the text between the elements.
+
+        All consecutive text, including the entities and character
+        references, is passed in a single call, but the contents of CDATA
+        sections is passed separately.
+
+        Text containing only whitespace is ignored unless
+        wxXMLDOC_KEEP_WHITESPACE_NODES flag was passed to wxXmlReader.
+    */
+    virtual bool OnText(const wxString& text);
+
+    /**
+        Called with the element for which wxXmlReaderElement::LoadSubtree()
+        was called.
+
+        The node contains all the children of the element, including the
+        comments and processing instructions, and is owned by the handler.
+    */
+    virtual bool OnSubtree(std::unique_ptr<wxXmlNode> node);
+};
+
+/**
+    @class wxXmlReader
+
+    Streaming XML parser.
+
+    Unlike wxXmlDocument, this class doesn't load the entire document in
+    memory, but calls the functions of wxXmlReaderHandler for the elements and
+    text found in it as it is being parsed. The memory used doesn't depend on
+    the document size, making it suitable for processing very large documents.
+
+    Example of counting the elements with the given name:
+    @code
+    class CountingHandler : public wxXmlReaderHandler
+    {
+    public:
+        virtual bool OnStartElement(const wxXmlReaderElement& element) override
+        {
+            if ( element.GetName() == "item" )
+                m_count++;
+
+            return true;
+        }
+
+        int m_count = 0;
+    };
+
+    CountingHandler handler;
+    wxXmlReader reader(handler);
+    if ( reader.Parse("huge.xml") )
+        wxLogMessage("%d items found", handler.m_count);
+    @endcode
+
+    @since 3.3.2
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlDocument
+*/
+class wxXmlReader
+{
+public:
+    /**
+        Creates the reader using the given handler.
+
+        The handler must remain valid while this object is used.
+
+        @param handler
+            The object receiving the parsing events.
+        @param flags
+            Only wxXMLDOC_KEEP_WHITESPACE_NODES is supported here, with the
+            same meaning as for wxXmlDocument::Load().
+    */
+    explicit wxXmlReader(wxXmlReaderHandler& handler,
+                         int flags = wxXMLDOC_NONE);
+
+    /**
+        Parses the given file.
+
+        Returns @false if the file couldn't be opened or if an error occurred
+        while parsing it, in which case @a err is filled with the error
+        details if it is non-null. Note that stopping parsing by returning
+        @false from a wxXmlReaderHandler function is not considered to be an
+        error.
+    */
+    bool Parse(const wxString& filename, wxXmlParseError* err = nullptr);
+
+    /**
+        Parses the data from the given stream.
+
+        See Parse(const wxString&, wxXmlParseError*) for the return value.
+    */
+    bool Parse(wxInputStream& stream, wxXmlParseError* err = nullptr);
+};
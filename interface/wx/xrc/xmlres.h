@@ -25,7 +25,18 @@ enum wxXmlResourceFlags
 
         @since 3.1.3
     */
-    wxXRC_USE_ENVVARS    = 8
+    wxXRC_USE_ENVVARS    = 8,
+
+    /**
+        Create the contents of all book control pages only when they are
+        shown for the first time.
+
+        This is the same as using @c lazy property for all pages, see
+        @ref xrc_wxnotebook "wxNotebook" XRC documentation.
+
+        @since 3.3.2
+    */
+    wxXRC_LAZY_BOOK_PAGES = 16
 };
 
 
@@ -247,6 +258,10 @@ public:
         If you are sure that the argument is name of single XRC file (rather
         than an URL or a wildcard), use LoadFile() instead.
 
+        @note
+        Since wxWidgets 3.3.2, the files precompiled using @c wxrc @c \--binary
+        are supported too and are loaded without parsing XML.
+
         @see LoadFile(), LoadAllFiles()
     */
     bool Load(const wxString& filemask);
@@ -438,6 +438,122 @@ public:
 
 
 
+/**
+    @class wxZipFileReader
+
+    Provides random access to the entries of a zip file on disk.
+
+    Unlike wxZipInputStream, which reads all the entries using a single
+    parent stream and so allows reading only one of them at a time, this
+    class reads the central directory of the zip once and then opens a new,
+    independent stream for each entry. These streams use positional reads,
+    i.e. wxFile::ReadAt(), on the same file, so they can be used
+    concurrently from different threads, e.g. to decompress several entries
+    in parallel.
+
+    Extract() and ExtractAll() use this to extract the entries of the zip to
+    a directory using several threads:
+    @code
+    wxZipFileReader zip("assets.zip");
+    if ( !zip.IsOk() || !zip.ExtractAll(destDir) )
+        wxLogError("Failed to unpack the assets.");
+    @endcode
+
+    @since 3.3.2
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see wxZipInputStream, wxZipEntry
+*/
+class wxZipFileReader
+{
+public:
+    /**
+        Constructor opens the file and reads its central directory.
+
+        Use IsOk() to check if this succeeded.
+
+        @param filename
+            The name of the zip file.
+        @param conv
+            Used to translate the filename and comment fields of the entries,
+            as in wxZipInputStream constructor.
+     */
+    explicit wxZipFileReader(const wxString& filename,
+                             wxMBConv& conv = wxConvLocal);
+
+    /**
+        Returns @true if the zip file was read successfully.
+     */
+    bool IsOk() const;
+
+    /**
+        Returns the number of entries in the zip.
+     */
+    size_t GetEntryCount() const;
+
+    /**
+        Returns the entry with the given index.
+
+        @param n
+            Index of the entry, must be less than GetEntryCount().
+     */
+    const wxZipEntry& GetEntry(size_t n) const;
+
+    /**
+        Returns a new stream for reading the data of the given entry.
+
+        The returned stream is already opened and only allows reading the data
+        of this entry, it doesn't depend on any other stream returned by this
+        function and can be used from any thread, however it must be deleted
+        before this object itself.
+
+        This function itself can be called concurrently from several threads.
+
+        @param n
+            Index of the entry, must be less than GetEntryCount().
+        @return
+            The new stream which must be deleted by the caller or @NULL if the
+            entry couldn't be opened.
+     */
+    wxZipInputStream* OpenEntry(size_t n) const;
+
+    /**
+        Extracts the given entries under the specified directory.
+
+        The directories for all the entries are created first and then the
+        files are extracted using the given number of threads concurrently,
+        with each thread decompressing a different entry.
+
+        Entries with the names containing @c ".." path components are not
+        extracted and result in an error.
+
+        @param dir
+            The directory to extract the entries to, created if necessary.
+        @param entries
+            The indices of the entries to extract.
+        @param numThreads
+            The number of threads to use, including the calling one. By
+            default, the number of CPUs is used. If it is 1, or if threads
+            are not available, all entries are extracted by the calling thread.
+        @return
+            @true if all the entries were extracted successfully.
+     */
+    bool Extract(const wxString& dir,
+                 const std::vector<size_t>& entries,
+                 unsigned numThreads = 0) const;
+
+    /**
+        Extracts all entries under the specified directory.
+
+        This is the same as calling Extract() with the indices of all entries.
+     */
+    bool ExtractAll(const wxString& dir, unsigned numThreads = 0) const;
+};
+
+
+
 /**
     @class wxZipClassFactory
 
@@ -619,5 +735,20 @@ public:
         @since 3.1.1
     */
     wxZipArchiveFormat GetFormat() const;
+
+    /**
+        Compress the data of the entries using several threads.
+
+        This calls wxZlibOutputStream::EnableParallel() for the compressor
+        used for all the deflated entries added after calling it. Notice that
+        only the entries larger than the block size used by it, i.e. 128KiB,
+        benefit from this.
+
+        @param numThreads
+            The number of threads to use, one per CPU if 0.
+
+        @since 3.3.2
+    */
+    void EnableParallel(unsigned numThreads = 0);
 };
 
@@ -88,6 +88,44 @@ public:
     bool SetDictionary(const char *data, size_t datalen);
     bool SetDictionary(const wxMemoryBuffer &buf);
     ///@}
+
+    /**
+        Compress the data using several threads.
+
+        In this mode, the data written to the stream is split into blocks,
+        which are compressed independently, in batches of two blocks per
+        thread, by the pool of threads shared by wxWidgets, with the end of
+        the previous block used as dictionary for the next one to preserve
+        the compression ratio, and written to the parent stream in order. The compressed blocks end with a sync flush and so can be
+        concatenated into a single standard zlib, gzip or raw deflate stream,
+        which can be read by wxZlibInputStream or any other inflater. The
+        output is slightly larger than in the default single-threaded mode
+        and may differ from it, but compressing large amounts of data is
+        much faster on the systems with multiple CPUs.
+
+        The streams consisting of a single block are compressed by the
+        calling thread, so this doesn't have any overhead for them. This is
+        also the case if the thread pool is already busy, e.g. with another
+        stream being compressed in parallel by a different thread.
+
+        This function must be called before writing any data to the stream
+        and SetDictionary() can't be used in this mode.
+
+        @param numThreads
+            The number of threads to use, one per CPU if 0.
+        @param blockSize
+            The size of the blocks compressed by each thread, 128KiB by
+            default. Larger blocks result in better compression, but use more
+            memory, which is proportional to the block size multiplied by the
+            number of threads.
+
+        @return @true if parallel compression was enabled or @false if it is
+            not available, e.g. because wxWidgets was built without thread
+            support.
+
+        @since 3.3.2
+    */
+    bool EnableParallel(unsigned numThreads = 0, size_t blockSize = 0);
 };
 
 
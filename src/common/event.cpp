@@ -22,6 +22,7 @@
 #include "wx/event.h"
 #include "wx/eventfilter.h"
 #include "wx/evtloop.h"
+#include "wx/evtprofiler.h"
 
 #ifndef WX_PRECOMP
     #include "wx/list.h"
@@ -46,7 +47,11 @@
 #include "wx/private/safecall.h"
 
 #if wxUSE_BASE
+    #include <algorithm>
+    #include <atomic>
+    #include <chrono>
     #include <memory>
+    #include <vector>
 #endif // wxUSE_BASE
 
 #if wxUSE_GUI
@@ -1187,6 +1192,19 @@ void wxEventHashTable::GrowEventTypeTable()
 // wxEvtHandler
 // ----------------------------------------------------------------------------
 
+#if wxUSE_THREADS
+
+// Element of the lock-free singly linked list of queued events.
+struct wxEvtHandler::QueuedEvent
+{
+    explicit QueuedEvent(wxEvent* event_) : event(event_) { }
+
+    wxEvent* const event;
+    QueuedEvent* next = nullptr;
+};
+
+#endif // wxUSE_THREADS
+
 wxEvtHandler::wxEvtHandler()
 {
     m_nextHandler = nullptr;
@@ -1194,6 +1212,9 @@ wxEvtHandler::wxEvtHandler()
     m_enabled = true;
     m_dynamicEvents = nullptr;
     m_pendingEvents = nullptr;
+#if wxUSE_THREADS
+    m_queuedEvents = nullptr;
+#endif // wxUSE_THREADS
 
     // no client data (yet)
     m_clientData = nullptr;
@@ -1315,10 +1336,86 @@ bool wxEvtHandler::ProcessThreadEvent(const wxEvent& event)
 
 #endif // wxUSE_THREADS
 
+namespace
+{
+
+// Event types for which QueueEvent() replaces the pending events, this is
+// only modified by SetEventTypeCoalescing() which is supposed to be rarely
+// called, so just use a vector protected by a critical section for it.
+std::vector<wxEventType>& GetCoalescedEventTypes()
+{
+    static std::vector<wxEventType> s_eventTypes;
+    return s_eventTypes;
+}
+
+#if wxUSE_THREADS
+
+wxCriticalSection& GetCoalescedEventTypesLock()
+{
+    static wxCriticalSection s_cs;
+    return s_cs;
+}
+
+#endif // wxUSE_THREADS
+
+// This flag is checked by every QueueEvent() call before looking for the event
+// type in the vector above, so that it doesn't need to lock anything if there
+// are no coalesced event types at all, as is usually the case.
+std::atomic<bool> gs_hasCoalescedEventTypes(false);
+
+} // anonymous namespace
+
+/* static */
+void wxEvtHandler::SetEventTypeCoalescing(wxEventType eventType, bool coalesce)
+{
+    wxCRIT_SECT_LOCKER(lock, GetCoalescedEventTypesLock());
+
+    std::vector<wxEventType>& eventTypes = GetCoalescedEventTypes();
+    const auto it = std::find(eventTypes.begin(), eventTypes.end(), eventType);
+    if ( coalesce )
+    {
+        if ( it == eventTypes.end() )
+            eventTypes.push_back(eventType);
+    }
+    else
+    {
+        if ( it != eventTypes.end() )
+            eventTypes.erase(it);
+    }
+
+    gs_hasCoalescedEventTypes.store(!eventTypes.empty(),
+                                    std::memory_order_relaxed);
+}
+
+/* static */
+bool wxEvtHandler::IsEventTypeCoalesced(wxEventType eventType)
+{
+    if ( !gs_hasCoalescedEventTypes.load(std::memory_order_relaxed) )
+        return false;
+
+    wxCRIT_SECT_LOCKER(lock, GetCoalescedEventTypesLock());
+
+    const std::vector<wxEventType>& eventTypes = GetCoalescedEventTypes();
+    return std::find(eventTypes.begin(), eventTypes.end(), eventType)
+            != eventTypes.end();
+}
+
 void wxEvtHandler::QueueEvent(wxEvent *event)
 {
     wxCHECK_RET( event, "null event can't be posted" );
 
+    DoQueueEvent(event, IsEventTypeCoalesced(event->GetEventType()));
+}
+
+void wxEvtHandler::QueueOrReplaceEvent(wxEvent *event)
+{
+    wxCHECK_RET( event, "null event can't be posted" );
+
+    DoQueueEvent(event, true);
+}
+
+void wxEvtHandler::DoQueueEvent(wxEvent *event, bool replace)
+{
     if (!wxTheApp)
     {
         // we need an event loop which manages the list of event handlers with
@@ -1331,13 +1428,107 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
         return;
     }
 
+    if ( replace )
+    {
+        wxENTER_CRIT_SECT( m_pendingEventsLock );
+
+#if wxUSE_THREADS
+        // We need to look at all the events, including the ones queued by
+        // the other threads, but we can't modify the lock-free list, so move
+        // its contents to m_pendingEvents first. Notice that this doesn't
+        // invalidate the fast path in the code below: it won't be taken
+        // until we add a new event to the (now empty) list of queued events.
+        MoveQueuedEvents();
+#endif // wxUSE_THREADS
+
+        if ( m_pendingEvents )
+        {
+            // Search from the end as the most recently added event is the
+            // most likely to be still pending.
+            for ( wxList::compatibility_iterator node = m_pendingEvents->GetLast();
+                  node;
+                  node = node->GetPrevious() )
+            {
+                wxEvent* const pending = static_cast<wxEvent *>(node->GetData());
+                if ( pending->GetEventType() == event->GetEventType() &&
+                        pending->GetId() == event->GetId() )
+                {
+                    // This handler is already in the list of handlers with
+                    // pending events, so just replace the event, without
+                    // changing its position in the queue.
+                    node->SetData(event);
+
+                    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+                    delete pending;
+
+                    return;
+                }
+            }
+        }
+        else
+        {
+            m_pendingEvents = new wxList;
+        }
+
+        // Nothing to replace, append the new event directly: there is no
+        // need to use m_queuedEvents here, as we hold the lock anyhow.
+        m_pendingEvents->Append(event);
+
+        wxTheApp->AppendPendingEventHandler(this);
+
+        wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+        wxWakeUpIdle();
+
+        return;
+    }
+
+#if wxUSE_THREADS
+    // If there are already some queued events, this handler must be in the
+    // list of handlers with pending events and the main thread must have been
+    // already woken up, so we only need to add the event to the list of
+    // queued events. This doesn't require any locking, which is important
+    // when many threads post events to the same handler.
+    //
+    // Notice that this handler must not be used after successfully adding the
+    // event to the list, as it could be processed, and the handler destroyed
+    // by it, in the main thread at any moment after this.
+    QueuedEvent* const node = new QueuedEvent(event);
+
+    QueuedEvent* head = m_queuedEvents.load(std::memory_order_relaxed);
+    while ( head )
+    {
+        node->next = head;
+        if ( m_queuedEvents.compare_exchange_weak(head, node,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed) )
+            return;
+    }
+#endif // wxUSE_THREADS
+
     // 1) Add this event to our list of pending events
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
+#if wxUSE_THREADS
+    // Add it to the list of queued events even though we could add it to
+    // m_pendingEvents directly because this allows the other threads to take
+    // the fast path above. Also notice that the events queued by the other
+    // threads can't be moved to m_pendingEvents while we hold the lock, so
+    // the order of the events is preserved.
+    head = m_queuedEvents.load(std::memory_order_relaxed);
+    do
+    {
+        node->next = head;
+    } while ( !m_queuedEvents.compare_exchange_weak(head, node,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed) );
+#else // !wxUSE_THREADS
     if ( !m_pendingEvents )
         m_pendingEvents = new wxList;
 
     m_pendingEvents->Append(event);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
 
     // 2) Add this event handler to list of event handlers that
     //    have pending events.
@@ -1357,8 +1548,46 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
     wxWakeUpIdle();
 }
 
+#if wxUSE_THREADS
+
+void wxEvtHandler::MoveQueuedEvents()
+{
+    QueuedEvent* node = m_queuedEvents.exchange(nullptr,
+                                                std::memory_order_acquire);
+    if ( !node )
+        return;
+
+    // The list is in the reverse order of events, so reverse it first.
+    QueuedEvent* first = nullptr;
+    while ( node )
+    {
+        QueuedEvent* const next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    if ( !m_pendingEvents )
+        m_pendingEvents = new wxList;
+
+    while ( first )
+    {
+        m_pendingEvents->Append(first->event);
+
+        QueuedEvent* const next = first->next;
+        delete first;
+        first = next;
+    }
+}
+
+#endif // wxUSE_THREADS
+
 void wxEvtHandler::DeletePendingEvents()
 {
+#if wxUSE_THREADS
+    MoveQueuedEvents();
+#endif // wxUSE_THREADS
+
     if (m_pendingEvents)
         m_pendingEvents->DeleteContents(true);
     wxDELETE(m_pendingEvents);
@@ -1380,6 +1609,13 @@ void wxEvtHandler::ProcessPendingEvents()
 
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
+#if wxUSE_THREADS
+    // take all the events queued since the last call at once: notice that no
+    // new events can be queued until we release the lock, as the list of
+    // queued events is empty now, see QueueEvent()
+    MoveQueuedEvents();
+#endif // wxUSE_THREADS
+
     // this method is only called by wxApp if this handler does have
     // pending events
     wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
@@ -1438,6 +1674,21 @@ void wxEvtHandler::ProcessPendingEvents()
     // of this object any more
 }
 
+namespace
+{
+
+// Return the time elapsed since the given moment in nanoseconds, for
+// wxEventProfiler.
+wxLongLong_t GetNanosecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+           (
+            std::chrono::steady_clock::now() - start
+           ).count();
+}
+
+} // anonymous namespace
+
 /* static */
 bool wxEvtHandler::ProcessEventIfMatchesId(const wxEventTableEntryBase& entry,
                                            wxEvtHandler *handler,
@@ -1458,6 +1709,19 @@ bool wxEvtHandler::ProcessEventIfMatchesId(const wxEventTableEntryBase& entry,
         event.Skip(false);
         event.m_callbackUserData = entry.m_callbackUserData;
 
+        // Don't access the handler nor the entry after calling the handler if
+        // profiling, as the handler could unbind itself or even be destroyed.
+        const bool profile = wxEventProfiler::IsEnabled();
+        const wxChar* profiledClass = nullptr;
+        const wxEventFunctor* profiledFunctor = nullptr;
+        std::chrono::steady_clock::time_point profileStart;
+        if ( profile )
+        {
+            profiledClass = handler->GetClassInfo()->GetClassName();
+            profiledFunctor = entry.m_fn;
+            profileStart = std::chrono::steady_clock::now();
+        }
+
 #if wxUSE_EXCEPTIONS
         if ( wxTheApp )
         {
@@ -1472,6 +1736,12 @@ bool wxEvtHandler::ProcessEventIfMatchesId(const wxEventTableEntryBase& entry,
             (*entry.m_fn)(handler, event);
         }
 
+        if ( profile )
+        {
+            wxEventProfiler::AddHandlerTime(event, profiledClass, profiledFunctor,
+                                            GetNanosecondsSince(profileStart));
+        }
+
         if (!event.GetSkipped())
             return true;
     }
@@ -1548,6 +1818,24 @@ bool wxEvtHandler::ProcessEvent(wxEvent& event)
             }
             //else: proceed normally
         }
+
+        // If profiling is enabled, measure the total time taken by processing
+        // this event, including its propagation to the other handlers, here,
+        // as this is only done once for each event.
+        if ( wxEventProfiler::IsEnabled() )
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            // Note that calling this function recursively won't get here again
+            // as WasProcessed() returns true now and that we intentionally
+            // call our own version of it, even if it's overridden, as the
+            // derived class version must have been already called.
+            const bool processed = wxEvtHandler::ProcessEvent(event);
+
+            wxEventProfiler::AddEventTime(event, GetNanosecondsSince(start));
+
+            return processed;
+        }
     }
 
     // Short circuit the event processing logic if we're requested to process
@@ -1787,7 +2075,7 @@ void wxEvtHandler::DoBind(int id,
     // We prefer to push back the entry here and then iterate over the vector
     // in reverse direction in GetNextDynamicEntry() as it's more efficient
     // than inserting the element at the front.
-    m_dynamicEvents->m_entries.push_back(entry);
+    m_dynamicEvents->Add(entry);
 
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
@@ -1841,7 +2129,7 @@ wxEvtHandler::DoUnbind(int id,
             // Notice that we rely on "cookie" being just the index into the
             // vector, which is not guaranteed by our API, but here we can use
             // this implementation detail.
-            m_dynamicEvents->m_entries[cookie] = nullptr;
+            m_dynamicEvents->Remove(cookie);
 
             delete entry;
             return true;
@@ -1878,6 +2166,76 @@ wxEvtHandler::GetNextDynamicEntry(size_t& cookie) const
     return nullptr;
 }
 
+namespace
+{
+
+// Minimal number of dynamic event handlers for which we use the index by event
+// type: for fewer handlers, the linear search is as fast and uses less memory.
+const size_t DYNAMIC_EVENTS_INDEX_THRESHOLD = 16;
+
+} // anonymous namespace
+
+void wxEvtHandler::DynamicEvents::Add(wxDynamicEventTableEntry* entry)
+{
+    m_entries.push_back(entry);
+
+    if ( m_indexed )
+        AddToIndex(m_entries.size() - 1);
+    else if ( m_entries.size() >= DYNAMIC_EVENTS_INDEX_THRESHOLD )
+        BuildIndex();
+}
+
+void wxEvtHandler::DynamicEvents::Remove(size_t n)
+{
+    // Note that we don't update m_index here, it will be done by Prune()
+    // later: until then it just refers to a null entry.
+    m_entries[n] = nullptr;
+    m_numRemoved++;
+}
+
+void wxEvtHandler::DynamicEvents::Prune()
+{
+    size_t nNew = 0;
+    for ( size_t n = 0; n != m_entries.size(); n++ )
+    {
+        if ( m_entries[n] )
+            m_entries[nNew++] = m_entries[n];
+    }
+
+    wxASSERT( nNew == m_entries.size() - m_numRemoved );
+    m_entries.resize(nNew);
+    m_numRemoved = 0;
+
+    // The indices have changed, so the index needs to be recreated.
+    BuildIndex();
+}
+
+void wxEvtHandler::DynamicEvents::BuildIndex()
+{
+    m_index.clear();
+
+    m_indexed = m_entries.size() >= DYNAMIC_EVENTS_INDEX_THRESHOLD;
+    if ( !m_indexed )
+        return;
+
+    for ( size_t n = 0; n != m_entries.size(); n++ )
+    {
+        if ( m_entries[n] )
+            AddToIndex(n);
+    }
+}
+
+void wxEvtHandler::DynamicEvents::AddToIndex(size_t n)
+{
+    const wxDynamicEventTableEntry* const entry = m_entries[n];
+
+    IndexBucket& bucket = m_index[entry->m_eventType];
+    if ( entry->m_id != wxID_ANY && entry->m_lastId == wxID_ANY )
+        bucket.m_byId[entry->m_id].push_back(n);
+    else
+        bucket.m_others.push_back(n);
+}
+
 bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
 {
     wxCHECK_MSG( m_dynamicEvents, false,
@@ -1898,28 +2256,72 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
     DynamicEvents& dynamicEvents = *m_dynamicEvents;
 
     wxRecursionGuard guard(dynamicEvents.m_flag);
-    bool needToPruneDeleted = false;
+
+    const wxEventType eventType = event.GetEventType();
+
+    // If we have the index, only iterate over the entries for this event type
+    // which can match the event id: these are the entries for exactly this id
+    // and the entries for any id or a range of ids, which have to be merged
+    // to preserve the order in which they were bound.
+    //
+    // Notice that we must not keep any iterators or references to the
+    // elements of the vectors here, as the event handlers may bind more
+    // handlers and so reallocate them, but the vectors in the maps themselves
+    // remain valid because the index is only rebuilt by Prune() which is
+    // never called while we're iterating.
+    size_t numAll = 0,
+           numById = 0,
+           numOthers = 0;
+    const wxVector<size_t>* byId = nullptr;
+    const wxVector<size_t>* others = nullptr;
+    if ( dynamicEvents.m_indexed )
+    {
+        const auto it = dynamicEvents.m_index.find(eventType);
+        if ( it != dynamicEvents.m_index.end() )
+        {
+            const DynamicEvents::IndexBucket& bucket = it->second;
+
+            others = &bucket.m_others;
+            numOthers = others->size();
+
+            const auto itId = bucket.m_byId.find(event.GetId());
+            if ( itId != bucket.m_byId.end() )
+            {
+                byId = &itId->second;
+                numById = byId->size();
+            }
+        }
+    }
+    else
+    {
+        numAll = dynamicEvents.m_entries.size();
+    }
 
     // We can't use Get{First,Next}DynamicEntry() here as they hide the deleted
     // but not yet pruned entries from the caller, but here we do want to know
     // about them, so iterate directly. Remember to do it in the reverse order
     // to honour the order of handlers connection.
-    for ( size_t n = dynamicEvents.m_entries.size(); n; n-- )
+    for ( ;; )
     {
-        wxDynamicEventTableEntry* const entry = dynamicEvents.m_entries[n - 1];
+        size_t n;
+        if ( numAll )
+            n = --numAll;
+        else if ( numById &&
+                    (!numOthers || (*byId)[numById - 1] > (*others)[numOthers - 1]) )
+            n = (*byId)[--numById];
+        else if ( numOthers )
+            n = (*others)[--numOthers];
+        else
+            break;
 
+        wxDynamicEventTableEntry* const entry = dynamicEvents.m_entries[n];
+
+        // Skip the entries which were unbound at some time in the past, they
+        // will be really removed below, once we finish iterating.
         if ( !entry )
-        {
-            // This entry must have been unbound at some time in the past, so
-            // skip it now and really remove it from the vector below, once we
-            // finish iterating.
-            // N.B.:  If we are in a nested call, then we can't be done
-            // iterating during this call
-            needToPruneDeleted = !guard.IsInside();
             continue;
-        }
 
-        if ( event.GetEventType() == entry->m_eventType )
+        if ( eventType == entry->m_eventType )
         {
             wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
             if ( !handler )
@@ -1944,18 +2346,10 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
         }
     }
 
-    if ( needToPruneDeleted )
-    {
-        size_t nNew = 0;
-        for ( size_t n = 0; n != dynamicEvents.m_entries.size(); n++ )
-        {
-            if ( dynamicEvents.m_entries[n] )
-                dynamicEvents.m_entries[nNew++] = dynamicEvents.m_entries[n];
-        }
-
-        wxASSERT( nNew != dynamicEvents.m_entries.size() );
-        dynamicEvents.m_entries.resize(nNew);
-    }
+    // If we are in a nested call, then we can't be done iterating during this
+    // call, so leave pruning to the outermost one.
+    if ( dynamicEvents.m_numRemoved && !guard.IsInside() )
+        dynamicEvents.Prune();
 
     return false;
 }
@@ -2035,7 +2429,7 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
 
             // Just as in DoUnbind(), we use our knowledge of
             // GetNextDynamicEntry() implementation here.
-            m_dynamicEvents->m_entries[cookie] = nullptr;
+            m_dynamicEvents->Remove(cookie);
         }
     }
 }
@@ -0,0 +1,293 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/evtprofiler.cpp
+// Purpose:     wxEventProfiler implementation
+// Author:      wxWidgets development team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+
+#include "wx/evtprofiler.h"
+
+#include "wx/thread.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+// ----------------------------------------------------------------------------
+// private globals
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// All the statistics collected by the profiler: this is only accessed when
+// profiling is enabled, so we don't care about the cost of locking here.
+struct ProfilerData
+{
+    wxCRIT_SECT_DECLARE_MEMBER(cs);
+
+    std::unordered_map<wxEventType, wxEventProfiler::EventTypeStats> eventTypes;
+
+    // Handlers are identified by the functor, which may be reused after the
+    // handler is unbound, so use the event type and the class too to make it
+    // less likely to mix up the statistics for the different handlers.
+    typedef std::tuple<const void*, wxEventType, const wxChar*> HandlerKey;
+    std::map<HandlerKey, wxEventProfiler::HandlerStats> handlers;
+};
+
+ProfilerData& GetProfilerData()
+{
+    static ProfilerData s_data;
+    return s_data;
+}
+
+void UpdateStats(wxEventProfiler::Stats& stats, wxLongLong_t time)
+{
+    stats.count++;
+    stats.totalTime += time;
+    if ( time > stats.maxTime )
+        stats.maxTime = time;
+}
+
+template <typename T>
+void SortByTotalTime(std::vector<T>& stats)
+{
+    std::sort(stats.begin(), stats.end(),
+              [](const T& s1, const T& s2)
+              {
+                  return s1.totalTime > s2.totalTime;
+              });
+}
+
+// Format the given time in nanoseconds as microseconds.
+wxString FormatTime(wxLongLong_t time)
+{
+    return wxString::FromCDouble(static_cast<double>(time) / 1000, 3);
+}
+
+wxString FormatAverageTime(const wxEventProfiler::Stats& stats)
+{
+    return FormatTime(stats.count ? stats.totalTime / stats.count : 0);
+}
+
+wxString FormatStatsAsText(const wxEventProfiler::Stats& stats)
+{
+    return wxString::Format("%10lu %14s %12s %12s",
+                            stats.count,
+                            FormatTime(stats.totalTime),
+                            FormatAverageTime(stats),
+                            FormatTime(stats.maxTime));
+}
+
+wxString FormatStatsAsJSON(const wxEventProfiler::Stats& stats)
+{
+    return wxString::Format("\"count\": %lu, \"total_us\": %s, "
+                            "\"average_us\": %s, \"max_us\": %s",
+                            stats.count,
+                            FormatTime(stats.totalTime),
+                            FormatAverageTime(stats),
+                            FormatTime(stats.maxTime));
+}
+
+wxString QuoteJSON(const wxString& s)
+{
+    wxString quoted('"');
+    for ( wxString::const_iterator it = s.begin(); it != s.end(); ++it )
+    {
+        const wxUniChar ch = *it;
+        switch ( ch.GetValue() )
+        {
+            case '"':
+            case '\\':
+                quoted << '\\' << ch;
+                break;
+
+            default:
+                if ( ch.GetValue() < 0x20 )
+                    quoted << wxString::Format("\\u%04x", ch.GetValue());
+                else
+                    quoted << ch;
+        }
+    }
+
+    quoted << '"';
+
+    return quoted;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// wxEventProfiler implementation
+// ============================================================================
+
+std::atomic<bool> wxEventProfiler::ms_enabled(false);
+
+/* static */
+void wxEventProfiler::Enable(bool enable)
+{
+    ms_enabled.store(enable, std::memory_order_relaxed);
+}
+
+/* static */
+void wxEventProfiler::Reset()
+{
+    ProfilerData& data = GetProfilerData();
+    wxCRIT_SECT_LOCKER(lock, data.cs);
+
+    data.eventTypes.clear();
+    data.handlers.clear();
+}
+
+/* static */
+void wxEventProfiler::AddEventTime(const wxEvent& event, wxLongLong_t time)
+{
+    ProfilerData& data = GetProfilerData();
+    wxCRIT_SECT_LOCKER(lock, data.cs);
+
+    EventTypeStats& stats = data.eventTypes[event.GetEventType()];
+    if ( !stats.count )
+    {
+        stats.eventType = event.GetEventType();
+        stats.eventClass = event.GetClassInfo()->GetClassName();
+    }
+
+    UpdateStats(stats, time);
+}
+
+/* static */
+void wxEventProfiler::AddHandlerTime(const wxEvent& event,
+                                     const wxChar* handlerClass,
+                                     const wxEventFunctor* functor,
+                                     wxLongLong_t time)
+{
+    ProfilerData& data = GetProfilerData();
+    wxCRIT_SECT_LOCKER(lock, data.cs);
+
+    const ProfilerData::HandlerKey key(functor, event.GetEventType(), handlerClass);
+
+    HandlerStats& stats = data.handlers[key];
+    if ( !stats.count )
+    {
+        stats.eventType = event.GetEventType();
+        stats.handlerClass = handlerClass;
+        stats.functor = functor;
+    }
+
+    UpdateStats(stats, time);
+}
+
+/* static */
+std::vector<wxEventProfiler::EventTypeStats>
+wxEventProfiler::GetEventTypeStats()
+{
+    std::vector<EventTypeStats> stats;
+
+    {
+        ProfilerData& data = GetProfilerData();
+        wxCRIT_SECT_LOCKER(lock, data.cs);
+
+        stats.reserve(data.eventTypes.size());
+        for ( const auto& kv : data.eventTypes )
+            stats.push_back(kv.second);
+    }
+
+    SortByTotalTime(stats);
+
+    return stats;
+}
+
+/* static */
+std::vector<wxEventProfiler::HandlerStats>
+wxEventProfiler::GetHandlerStats()
+{
+    std::vector<HandlerStats> stats;
+
+    {
+        ProfilerData& data = GetProfilerData();
+        wxCRIT_SECT_LOCKER(lock, data.cs);
+
+        stats.reserve(data.handlers.size());
+        for ( const auto& kv : data.handlers )
+            stats.push_back(kv.second);
+    }
+
+    SortByTotalTime(stats);
+
+    return stats;
+}
+
+/* static */
+wxString wxEventProfiler::GetReport()
+{
+    const wxString header = wxString::Format("%10s %14s %12s %12s",
+                                             "Count", "Total (us)",
+                                             "Average (us)", "Max (us)");
+
+    wxString report;
+    report << "Event types:\n"
+           << wxString::Format("%8s ", "Type") << header << "  Event class\n";
+
+    for ( const EventTypeStats& stats : GetEventTypeStats() )
+    {
+        report << wxString::Format("%8d ", stats.eventType)
+               << FormatStatsAsText(stats)
+               << "  " << stats.eventClass << "\n";
+    }
+
+    report << "\nHandlers:\n"
+           << wxString::Format("%8s ", "Type") << header
+           << "  Handler class (functor)\n";
+
+    for ( const HandlerStats& stats : GetHandlerStats() )
+    {
+        report << wxString::Format("%8d ", stats.eventType)
+               << FormatStatsAsText(stats)
+               << "  " << stats.handlerClass
+               << wxString::Format(" (%p)", stats.functor) << "\n";
+    }
+
+    return report;
+}
+
+/* static */
+wxString wxEventProfiler::GetReportAsJSON()
+{
+    wxString report;
+    report << "{\n  \"event_types\": [";
+
+    bool first = true;
+    for ( const EventTypeStats& stats : GetEventTypeStats() )
+    {
+        report << (first ? "\n" : ",\n")
+               << "    { \"type\": " << stats.eventType
+               << ", \"class\": " << QuoteJSON(stats.eventClass)
+               << ", " << FormatStatsAsJSON(stats) << " }";
+        first = false;
+    }
+
+    report << "\n  ],\n  \"handlers\": [";
+
+    first = true;
+    for ( const HandlerStats& stats : GetHandlerStats() )
+    {
+        report << (first ? "\n" : ",\n")
+               << "    { \"type\": " << stats.eventType
+               << ", \"class\": " << QuoteJSON(stats.handlerClass)
+               << ", \"functor\": "
+               << QuoteJSON(wxString::Format("%p", stats.functor))
+               << ", " << FormatStatsAsJSON(stats) << " }";
+        first = false;
+    }
+
+    report << "\n  ]\n}\n";
+
+    return report;
+}
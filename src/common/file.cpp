@@ -42,6 +42,8 @@
 #define   NOCRYPT
 #define   NOMCX
 
+#include "wx/msw/wrapwin.h"
+
 #elif (defined(__UNIX__) || defined(__GNUWIN32__))
     #include  <unistd.h>
     #include  <time.h>
@@ -336,6 +338,45 @@ ssize_t wxFile::Read(void *pBuf, size_t nCount)
     return iRc;
 }
 
+// read at the given position
+ssize_t wxFile::ReadAt(void *pBuf, size_t nCount, wxFileOffset ofs) const
+{
+    if ( !nCount )
+        return 0;
+
+    wxCHECK( (pBuf != nullptr) && IsOpened() && ofs >= 0, wxInvalidOffset );
+
+#ifdef __WINDOWS__
+    OVERLAPPED ov = { 0 };
+    ov.Offset = static_cast<DWORD>(ofs & 0xffffffff);
+    ov.OffsetHigh = static_cast<DWORD>(static_cast<wxUint64>(ofs) >> 32);
+
+    HANDLE const handle = reinterpret_cast<HANDLE>(_get_osfhandle(m_fd));
+
+    DWORD nRead;
+    if ( !::ReadFile(handle, pBuf, static_cast<DWORD>(nCount), &nRead, &ov) )
+    {
+        if ( ::GetLastError() == ERROR_HANDLE_EOF )
+            return 0;
+
+        wxLogSysError(_("can't read from file descriptor %d"), m_fd);
+        return wxInvalidOffset;
+    }
+
+    return nRead;
+#else // !__WINDOWS__
+    ssize_t iRc = pread(m_fd, pBuf, nCount, ofs);
+
+    if ( CheckForError(iRc) )
+    {
+        wxLogSysError(_("can't read from file descriptor %d"), m_fd);
+        return wxInvalidOffset;
+    }
+
+    return iRc;
+#endif // __WINDOWS__/!__WINDOWS__
+}
+
 // write
 size_t wxFile::Write(const void *pBuf, size_t nCount)
 {
@@ -32,7 +32,6 @@
 
 #include  "wx/file.h"
 #include  "wx/textfile.h"
-#include  "wx/memtext.h"
 #include  "wx/config.h"
 #include  "wx/fileconf.h"
 #include  "wx/filefn.h"
@@ -48,6 +47,10 @@
 #include  <stdlib.h>
 #include  <ctype.h>
 
+#include  <algorithm>
+#include  <unordered_map>
+#include  <vector>
+
 // ----------------------------------------------------------------------------
 // constants
 // ----------------------------------------------------------------------------
@@ -62,6 +65,11 @@
 static int LINKAGEMODE CompareEntries(wxFileConfigEntry *p1, wxFileConfigEntry *p2);
 static int LINKAGEMODE CompareGroups(wxFileConfigGroup *p1, wxFileConfigGroup *p2);
 
+static int CompareItems(wxFileConfigEntry *p1, wxFileConfigEntry *p2)
+    { return CompareEntries(p1, p2); }
+static int CompareItems(wxFileConfigGroup *p1, wxFileConfigGroup *p2)
+    { return CompareGroups(p1, p2); }
+
 // filter strings
 static wxString FilterInValue(const wxString& str);
 static wxString FilterOutValue(const wxString& str);
@@ -74,18 +82,112 @@ static wxString FilterOutEntryName(const wxString& str);
 // ============================================================================
 
 // ----------------------------------------------------------------------------
-// "template" array types
+// wxFileConfigItems: container of the entries or subgroups of a group
 // ----------------------------------------------------------------------------
 
-#ifdef WXMAKINGDLL_BASE
-    WX_DEFINE_SORTED_USER_EXPORTED_ARRAY(wxFileConfigEntry *, ArrayEntries,
-                                         WXDLLIMPEXP_BASE);
-    WX_DEFINE_SORTED_USER_EXPORTED_ARRAY(wxFileConfigGroup *, ArrayGroups,
-                                         WXDLLIMPEXP_BASE);
+// hash and equality functors for the names of the entries and groups which
+// respect wxCONFIG_CASE_SENSITIVE
+struct wxFileConfigNameHash
+{
+    size_t operator()(const wxString& name) const
+    {
+#if wxCONFIG_CASE_SENSITIVE
+        return std::hash<wxString>()(name);
+#else
+        // FNV-1a hash of the lower case characters
+        size_t hash = 2166136261u;
+        for ( wxString::const_iterator it = name.begin(); it != name.end(); ++it )
+        {
+            hash ^= static_cast<size_t>(wxTolower(*it).GetValue());
+            hash *= 16777619u;
+        }
+
+        return hash;
+#endif
+    }
+};
+
+struct wxFileConfigNameEqual
+{
+    bool operator()(const wxString& name1, const wxString& name2) const
+    {
+#if wxCONFIG_CASE_SENSITIVE
+        return name1 == name2;
 #else
-    WX_DEFINE_SORTED_ARRAY(wxFileConfigEntry *, ArrayEntries);
-    WX_DEFINE_SORTED_ARRAY(wxFileConfigGroup *, ArrayGroups);
+        return name1.CmpNoCase(name2) == 0;
 #endif
+    }
+};
+
+// The items are indexed by name to make finding them by name, which is done
+// for every read and write, fast even for the groups with many items.
+//
+// They're also stored in an array which is used for enumerating them in
+// alphabetical order, but it's only sorted when it's used, as sorting it on
+// every insertion would make adding many items quadratic.
+template <typename T>
+class wxFileConfigItems
+{
+public:
+    wxFileConfigItems() = default;
+
+    size_t GetCount() const { return m_items.size(); }
+    bool IsEmpty() const { return m_items.empty(); }
+
+    T *operator[](size_t n) const
+    {
+        if ( !m_sorted )
+        {
+            std::sort(m_items.begin(), m_items.end(),
+                      [](T *p1, T *p2) { return CompareItems(p1, p2) < 0; });
+            m_sorted = true;
+        }
+
+        return m_items[n];
+    }
+
+    T *Find(const wxString& name) const
+    {
+        const auto it = m_index.find(name);
+        return it == m_index.end() ? nullptr : it->second;
+    }
+
+    void Add(T *item)
+    {
+        m_index.emplace(item->Name(), item);
+
+        // keep the array sorted if possible, which is the case when the items
+        // are added in alphabetical order, e.g. when reading a file written
+        // by us
+        if ( m_sorted && !m_items.empty() &&
+                CompareItems(m_items.back(), item) > 0 )
+            m_sorted = false;
+
+        m_items.push_back(item);
+    }
+
+    void Remove(T *item)
+    {
+        m_index.erase(item->Name());
+
+        // removing an item doesn't change the order of the other ones
+        const auto it = std::find(m_items.begin(), m_items.end(), item);
+        if ( it != m_items.end() )
+            m_items.erase(it);
+    }
+
+private:
+    mutable std::vector<T *> m_items;
+    mutable bool m_sorted = true;
+
+    std::unordered_map<wxString, T *,
+                       wxFileConfigNameHash, wxFileConfigNameEqual> m_index;
+
+    wxDECLARE_NO_COPY_TEMPLATE_CLASS(wxFileConfigItems, T);
+};
+
+typedef wxFileConfigItems<wxFileConfigEntry> ArrayEntries;
+typedef wxFileConfigItems<wxFileConfigGroup> ArrayGroups;
 
 // ----------------------------------------------------------------------------
 // wxFileConfigLineList
@@ -435,6 +537,19 @@ wxFileConfig::MigrateLocalFile(const wxString& name, int newStyle, int oldStyle)
 // ----------------------------------------------------------------------------
 // ctor
 // ----------------------------------------------------------------------------
+
+// read the entire file in memory at once
+static bool ReadFileContents(const wxString& path,
+                             const wxMBConv& conv,
+                             wxString& text)
+{
+    wxFile file;
+    if ( !file.Open(path) )
+        return false;
+
+    return file.ReadAll(&text, conv);
+}
+
 wxIMPLEMENT_ABSTRACT_CLASS(wxFileConfig, wxConfigBase);
 
 void wxFileConfig::Init()
@@ -450,11 +565,11 @@ void wxFileConfig::Init()
     // parse the global file
     if ( m_fnGlobalFile.IsOk() && m_fnGlobalFile.FileExists() )
     {
-        wxTextFile fileGlobal(m_fnGlobalFile.GetFullPath());
-
-        if ( fileGlobal.Open(*m_conv/*ignored in ANSI build*/) )
+        const wxString path = m_fnGlobalFile.GetFullPath();
+        wxString text;
+        if ( ReadFileContents(path, *m_conv, text) )
         {
-            Parse(fileGlobal, false /* global */);
+            Parse(text, path, false /* global */);
             SetRootPath();
         }
         else
@@ -466,15 +581,15 @@ void wxFileConfig::Init()
     // parse the local file
     if ( m_fnLocalFile.IsOk() && m_fnLocalFile.FileExists() )
     {
-        wxTextFile fileLocal(m_fnLocalFile.GetFullPath());
-        if ( fileLocal.Open(*m_conv/*ignored in ANSI build*/) )
+        const wxString path = m_fnLocalFile.GetFullPath();
+        wxString text;
+        if ( ReadFileContents(path, *m_conv, text) )
         {
-            Parse(fileLocal, true /* local */);
+            Parse(text, path, true /* local */);
             SetRootPath();
         }
         else
         {
-            const wxString path = m_fnLocalFile.GetFullPath();
             wxLogWarning(_("can't open user configuration file '%s'."),
                          path);
 
@@ -586,42 +701,20 @@ wxFileConfig::wxFileConfig(wxInputStream &inStream, const wxMBConv& conv)
     }
     while ( !inStream.Eof() );
 
+    // the data read from the stream is not NUL-terminated
+    const size_t dataLen = buf.GetDataLen();
+    buf.AppendByte('\0');
+
     size_t len;
-    cbuf = conv.cMB2WC((char *)buf.GetData(), buf.GetDataLen() + 1, &len);
-    if ( !len && buf.GetDataLen() )
+    cbuf = conv.cMB2WC((char *)buf.GetData(), dataLen + 1, &len);
+    if ( !len && dataLen )
     {
         wxLogError(_("Failed to read config options."));
     }
 
     // parse the input contents if there is anything to parse
     if ( cbuf )
-    {
-        // now break it into lines
-        wxMemoryText memText;
-        for ( const wxChar *s = cbuf; ; ++s )
-        {
-            const wxChar *e = s;
-            while ( *e != '\0' && *e != '\n' && *e != '\r' )
-                ++e;
-
-            // notice that we throw away the original EOL kind here, maybe we
-            // should preserve it?
-            if ( e != s )
-                memText.AddLine(wxString(s, e));
-
-            if ( *e == '\0' )
-                break;
-
-            // skip the second EOL byte if it's a DOS one
-            if ( *e == '\r' && e[1] == '\n' )
-                ++e;
-
-            s = e;
-        }
-
-        // Finally we can parse it all.
-        Parse(memText, true /* local */);
-    }
+        Parse(wxString(cbuf.data()), wxString(), true /* local */);
 
     SetRootPath();
     ResetDirty();
@@ -655,58 +748,78 @@ wxFileConfig::~wxFileConfig()
 // parse a config file
 // ----------------------------------------------------------------------------
 
-void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
+void wxFileConfig::Parse(const wxString& text, const wxString& name, bool bLocal)
 {
+  // Lines are split in place: we only create strings for the lines stored in
+  // the lines list, which is only done for the local file, and for the names
+  // and values of the entries.
+  const wxString::const_iterator end = text.end();
 
-  size_t nLineCount = buffer.GetLineCount();
-
-  for ( size_t n = 0; n < nLineCount; n++ )
+  size_t n = 0;
+  for ( wxString::const_iterator pLineStart = text.begin();
+        pLineStart != end;
+        n++ )
   {
-    wxString strLine = buffer[n];
-    // FIXME-UTF8: rewrite using iterators
-    wxWCharBuffer buf(strLine.c_str());
-    const wxChar *pStart;
-    const wxChar *pEnd;
+    wxString::const_iterator pLineEnd = pLineStart;
+    while ( pLineEnd != end && *pLineEnd != wxT('\n') && *pLineEnd != wxT('\r') )
+      ++pLineEnd;
+
+    ParseLine(pLineStart, pLineEnd, name, n, bLocal);
+
+    // go to the start of the next line, skipping the second character of
+    // DOS EOL
+    pLineStart = pLineEnd;
+    if ( pLineStart != end )
+    {
+      if ( *pLineStart++ == wxT('\r') && pLineStart != end &&
+              *pLineStart == wxT('\n') )
+        ++pLineStart;
+    }
+  }
+}
+
+void wxFileConfig::ParseLine(wxString::const_iterator pLineStart,
+                             wxString::const_iterator pLineEnd,
+                             const wxString& name,
+                             size_t n,
+                             bool bLocal)
+{
+    wxString::const_iterator pStart;
+    wxString::const_iterator pEnd;
 
     // add the line to linked list
     if ( bLocal )
-      LineListAppend(strLine);
+      LineListAppend(wxString(pLineStart, pLineEnd));
 
 
     // skip leading spaces
-    for ( pStart = buf; wxIsspace(*pStart); pStart++ )
+    for ( pStart = pLineStart; pStart != pLineEnd && wxIsspace(*pStart); pStart++ )
       ;
 
     // skip blank/comment lines
-    if ( *pStart == wxT('\0')|| *pStart == wxT(';') || *pStart == wxT('#') )
-      continue;
+    if ( pStart == pLineEnd || *pStart == wxT(';') || *pStart == wxT('#') )
+      return;
 
     if ( *pStart == wxT('[') ) {          // a new group
-      pEnd = pStart;
-
-      while ( *++pEnd != wxT(']') ) {
+      for ( pEnd = pStart + 1; pEnd != pLineEnd && *pEnd != wxT(']'); pEnd++ ) {
         if ( *pEnd == wxT('\\') ) {
             // the next char is escaped, so skip it even if it is ']'
-            pEnd++;
-        }
-
-        if ( *pEnd == wxT('\n') || *pEnd == wxT('\0') ) {
-            // we reached the end of line, break out of the loop
-            break;
+            if ( ++pEnd == pLineEnd )
+              break;
         }
       }
 
-      if ( *pEnd != wxT(']') ) {
-        wxLogError(_("file '%s': unexpected character %c at line %zu."),
-                   buffer.GetName(), *pEnd, n + 1);
-        continue; // skip this line
+      if ( pEnd == pLineEnd ) {
+        wxLogError(_("file '%s', line %zu: unexpected end of line, ']' expected."),
+                   name, n + 1);
+        return; // skip this line
       }
 
       // group name here is always considered as abs path
       wxString strGroup;
       pStart++;
       strGroup << wxCONFIG_PATH_SEPARATOR
-               << FilterInEntryName(wxString(pStart, pEnd - pStart));
+               << FilterInEntryName(wxString(pStart, pEnd));
 
       // will create it if doesn't yet exist
       SetPath(strGroup);
@@ -720,8 +833,8 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
       // check that there is nothing except comments left on this line
       bool bCont = true;
-      while ( *++pEnd != wxT('\0') && bCont ) {
-        switch ( *pEnd ) {
+      while ( ++pEnd != pLineEnd && bCont ) {
+        switch ( (*pEnd).GetValue() ) {
           case wxT('#'):
           case wxT(';'):
             bCont = false;
@@ -734,19 +847,18 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
           default:
             wxLogWarning(_("file '%s', line %zu: '%s' ignored after group header."),
-                         buffer.GetName(), n + 1, pEnd);
+                         name, n + 1, wxString(pEnd, pLineEnd));
             bCont = false;
         }
       }
     }
     else {                        // a key
       pEnd = pStart;
-      while ( *pEnd && *pEnd != wxT('=') /* && !wxIsspace(*pEnd)*/ ) {
+      while ( pEnd != pLineEnd && *pEnd != wxT('=') /* && !wxIsspace(*pEnd)*/ ) {
         if ( *pEnd == wxT('\\') ) {
           // next character may be space or not - still take it because it's
           // quoted (unless there is nothing)
-          pEnd++;
-          if ( !*pEnd ) {
+          if ( ++pEnd == pLineEnd ) {
             // the error message will be given below anyhow
             break;
           }
@@ -758,12 +870,12 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
       wxString strKey(FilterInEntryName(wxString(pStart, pEnd).Trim()));
 
       // skip whitespace
-      while ( wxIsspace(*pEnd) )
+      while ( pEnd != pLineEnd && wxIsspace(*pEnd) )
         pEnd++;
 
-      if ( *pEnd++ != wxT('=') ) {
+      if ( pEnd == pLineEnd || *pEnd++ != wxT('=') ) {
         wxLogError(_("file '%s', line %zu: '=' expected."),
-                   buffer.GetName(), n + 1);
+                   name, n + 1);
       }
       else {
         wxFileConfigEntry *pEntry = m_pCurrentGroup->FindEntry(strKey);
@@ -776,8 +888,8 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           if ( bLocal && pEntry->IsImmutable() ) {
             // immutable keys can't be changed by user
             wxLogWarning(_("file '%s', line %zu: value for immutable key '%s' ignored."),
-                         buffer.GetName(), n + 1, strKey);
-            continue;
+                         name, n + 1, strKey);
+            return;
           }
           // the condition below catches the cases (a) and (b) but not (c):
           //  (a) global key found second time in global file
@@ -786,7 +898,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           // which is exactly what we want.
           else if ( !bLocal || pEntry->IsLocal() ) {
             wxLogWarning(_("file '%s', line %zu: key '%s' was first found at line %d."),
-                         buffer.GetName(), n + 1, strKey, pEntry->Line());
+                         name, n + 1, strKey, pEntry->Line());
 
           }
         }
@@ -795,17 +907,16 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           pEntry->SetLine(m_linesTail);
 
         // skip whitespace
-        while ( wxIsspace(*pEnd) )
+        while ( pEnd != pLineEnd && wxIsspace(*pEnd) )
           pEnd++;
 
-        wxString value = pEnd;
+        wxString value(pEnd, pLineEnd);
         if ( !(GetStyle() & wxCONFIG_USE_NO_ESCAPE_CHARACTERS) )
             value = FilterInValue(value);
 
         pEntry->SetValue(value, false);
       }
     }
-  }
 }
 
 // ----------------------------------------------------------------------------
@@ -1480,9 +1591,7 @@ bool wxFileConfig::LineListIsEmpty()
 wxFileConfigGroup::wxFileConfigGroup(wxFileConfigGroup *pParent,
                                        const wxString& strName,
                                        wxFileConfig *pConfig)
-                         : m_aEntries(CompareEntries),
-                           m_aSubgroups(CompareGroups),
-                           m_strName(strName)
+                         : m_strName(strName)
 {
   m_pConfig = pConfig;
   m_pParent = pParent;
@@ -1703,67 +1812,16 @@ wxString wxFileConfigGroup::GetFullName() const
 // find an item
 // ----------------------------------------------------------------------------
 
-// use binary search because the array is sorted
 wxFileConfigEntry *
 wxFileConfigGroup::FindEntry(const wxString& name) const
 {
-  size_t
-       lo = 0,
-       hi = m_aEntries.GetCount();
-  wxFileConfigEntry *pEntry;
-
-  while ( lo < hi ) {
-    size_t i;
-    i = (lo + hi)/2;
-    pEntry = m_aEntries[i];
-
-    int res;
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pEntry->Name().compare(name);
-    #else
-      res = pEntry->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pEntry;
-  }
-
-  return nullptr;
+  return m_aEntries.Find(name);
 }
 
 wxFileConfigGroup *
 wxFileConfigGroup::FindSubgroup(const wxString& name) const
 {
-  size_t
-       lo = 0,
-       hi = m_aSubgroups.GetCount();
-  wxFileConfigGroup *pGroup;
-
-  while ( lo < hi ) {
-    size_t i;
-    i = (lo + hi)/2;
-    pGroup = m_aSubgroups[i];
-
-    int res;
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pGroup->Name().compare(name);
-    #else
-      res = pGroup->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pGroup;
-  }
-
-  return nullptr;
+  return m_aSubgroups.Find(name);
 }
 
 // ----------------------------------------------------------------------------
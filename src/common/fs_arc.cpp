@@ -8,7 +8,10 @@
 
 #include "wx/wxprec.h"
 
+#include <list>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #if wxUSE_FS_ARCHIVE
 
@@ -28,14 +31,18 @@
 // Holds the catalog of an archive file, and if it is being read from a
 // non-seekable stream, a copy of its backing file.
 //
+// The full catalog is read when the archive is opened and indexed by the
+// entry names, so that looking up any entry doesn't need to read the archive
+// again.
+//
 // This class is actually the reference counted implementation for the
 // wxArchiveFSCacheData class below. It was done that way to allow sharing
-// between instances of wxFileSystem, though that's a feature not used in this
-// version.
+// between instances of wxFileSystem and to keep the catalog alive while it is
+// being iterated over by wxArchiveFSHandler::FindNext(), even if it is removed
+// from the cache in the meanwhile.
 //---------------------------------------------------------------------------
 
-using wxArchiveFSEntryHash =
-    std::unordered_map<wxString, std::unique_ptr<wxArchiveEntry>>;
+using wxArchiveFSEntryHash = std::unordered_map<wxString, wxArchiveEntry*>;
 
 struct wxArchiveFSEntry
 {
@@ -56,104 +63,83 @@ public:
     void Release() { if (--m_refcount == 0) delete this; }
     wxArchiveFSCacheDataImpl *AddRef() { m_refcount++; return this; }
 
-    wxArchiveEntry *Get(const wxString& name);
+    wxArchiveEntry *Get(const wxString& name) const;
     wxInputStream *NewStream() const;
 
     wxArchiveFSEntry *GetNext(wxArchiveFSEntry *fse);
 
+    size_t GetCount() const { return m_entries.size(); }
+
 private:
-    // Takes ownership of "entry".
-    wxArchiveFSEntry *AddToCache(wxArchiveEntry *entry);
-    void CloseStreams();
+    void ReadCatalog(const wxArchiveClassFactory& factory,
+                     wxInputStream& stream);
 
     int m_refcount;
 
     wxArchiveFSEntryHash m_hash;
-    wxArchiveFSEntry *m_begin;
-    wxArchiveFSEntry **m_endptr;
+    std::vector<wxArchiveFSEntry> m_entries;
 
     wxBackingFile m_backer;
-    wxInputStream *m_stream;
-    wxArchiveInputStream *m_archive;
 };
 
 wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
         const wxArchiveClassFactory& factory,
         const wxBackingFile& backer)
  :  m_refcount(1),
-    m_begin(nullptr),
-    m_endptr(&m_begin),
-    m_backer(backer),
-    m_stream(new wxBackedInputStream(backer)),
-    m_archive(factory.NewStream(*m_stream))
+    m_backer(backer)
 {
+    wxBackedInputStream stream(backer);
+    ReadCatalog(factory, stream);
 }
 
 wxArchiveFSCacheDataImpl::wxArchiveFSCacheDataImpl(
         const wxArchiveClassFactory& factory,
         wxInputStream *stream)
- :  m_refcount(1),
-    m_begin(nullptr),
-    m_endptr(&m_begin),
-    m_stream(stream),
-    m_archive(factory.NewStream(*m_stream))
+ :  m_refcount(1)
 {
+    std::unique_ptr<wxInputStream> owner(stream);
+    ReadCatalog(factory, *stream);
 }
 
 wxArchiveFSCacheDataImpl::~wxArchiveFSCacheDataImpl()
 {
-    wxArchiveFSEntry *entry = m_begin;
-
-    while (entry)
-    {
-        wxArchiveFSEntry *next = entry->next;
-        delete entry;
-        entry = next;
-    }
-
-    CloseStreams();
+    for (const wxArchiveFSEntry& fse : m_entries)
+        delete fse.entry;
 }
 
-wxArchiveFSEntry *wxArchiveFSCacheDataImpl::AddToCache(wxArchiveEntry *entry)
-{
-    m_hash[entry->GetName(wxPATH_UNIX)] = std::unique_ptr<wxArchiveEntry>(entry);
-    wxArchiveFSEntry *fse = new wxArchiveFSEntry;
-    *m_endptr = fse;
-    (*m_endptr)->entry = entry;
-    (*m_endptr)->next = nullptr;
-    m_endptr = &(*m_endptr)->next;
-    return fse;
-}
-
-void wxArchiveFSCacheDataImpl::CloseStreams()
-{
-    wxDELETE(m_archive);
-    wxDELETE(m_stream);
-}
-
-wxArchiveEntry *wxArchiveFSCacheDataImpl::Get(const wxString& name)
+void wxArchiveFSCacheDataImpl::ReadCatalog(
+        const wxArchiveClassFactory& factory,
+        wxInputStream& stream)
 {
-    const auto it = m_hash.find(name);
-
-    if (it != m_hash.end())
-        return it->second.get();
-
-    if (!m_archive)
-        return nullptr;
+    std::unique_ptr<wxArchiveInputStream> archive(factory.NewStream(stream));
+    if (!archive)
+        return;
 
     wxArchiveEntry *entry;
-
-    while ((entry = m_archive->GetNextEntry()) != nullptr)
+    while ((entry = archive->GetNextEntry()) != nullptr)
     {
-        AddToCache(entry);
+        // Keep the first entry if there are several ones with the same name,
+        // as it is the one which used to be found by reading the archive.
+        if (!m_hash.emplace(entry->GetName(wxPATH_UNIX), entry).second)
+        {
+            delete entry;
+            continue;
+        }
 
-        if (entry->GetName(wxPATH_UNIX) == name)
-            return entry;
+        m_entries.push_back({ entry, nullptr });
     }
 
-    CloseStreams();
+    // Link the entries only now, when the vector won't be reallocated any
+    // more.
+    for (size_t n = 1; n < m_entries.size(); n++)
+        m_entries[n - 1].next = &m_entries[n];
+}
 
-    return nullptr;
+wxArchiveEntry *wxArchiveFSCacheDataImpl::Get(const wxString& name) const
+{
+    const auto it = m_hash.find(name);
+
+    return it != m_hash.end() ? it->second : nullptr;
 }
 
 wxInputStream* wxArchiveFSCacheDataImpl::NewStream() const
@@ -166,19 +152,10 @@ wxInputStream* wxArchiveFSCacheDataImpl::NewStream() const
 
 wxArchiveFSEntry *wxArchiveFSCacheDataImpl::GetNext(wxArchiveFSEntry *fse)
 {
-    wxArchiveFSEntry *next = fse ? fse->next : m_begin;
+    if (fse)
+        return fse->next;
 
-    if (!next && m_archive)
-    {
-        wxArchiveEntry *entry = m_archive->GetNextEntry();
-
-        if (entry)
-            next = AddToCache(entry);
-        else
-            CloseStreams();
-    }
-
-    return next;
+    return m_entries.empty() ? nullptr : &m_entries[0];
 }
 
 //---------------------------------------------------------------------------
@@ -207,6 +184,7 @@ public:
     wxInputStream *NewStream() const { return m_impl->NewStream(); }
     wxArchiveFSEntry *GetNext(wxArchiveFSEntry *fse)
         { return m_impl->GetNext(fse); }
+    size_t GetCount() const { return m_impl ? m_impl->GetCount() : 0; }
 
 private:
     wxArchiveFSCacheDataImpl *m_impl;
@@ -254,16 +232,17 @@ wxArchiveFSCacheData& wxArchiveFSCacheData::operator=(
 // wxArchiveFSCacheData caches a single archive, and this class holds a
 // collection of them to cache all the archives accessed by this instance
 // of wxFileSystem.
+//
+// To bound the memory used when many archives are accessed, the least
+// recently used archives are removed from the cache when the total number of
+// the entries in their catalogs exceeds the limit. The most recently used
+// archive is always kept, however big it is.
 //---------------------------------------------------------------------------
 
-using wxArchiveFSCacheDataHash =
-    std::unordered_map<wxString, wxArchiveFSCacheData>;
-
 class wxArchiveFSCache
 {
 public:
-    wxArchiveFSCache() { }
-    ~wxArchiveFSCache() { }
+    explicit wxArchiveFSCache(size_t maxEntries) : m_maxEntries(maxEntries) { }
 
     wxArchiveFSCacheData* Add(const wxString& name,
                               const wxArchiveClassFactory& factory,
@@ -271,8 +250,29 @@ public:
 
     wxArchiveFSCacheData *Get(const wxString& name);
 
+    void SetMaxEntries(size_t maxEntries);
+
 private:
-    wxArchiveFSCacheDataHash m_hash;
+    // Remove the least recently used archives until the total number of the
+    // cached entries doesn't exceed the limit.
+    void Trim();
+
+    // Names of the cached archives, most recently used first.
+    using NamesList = std::list<wxString>;
+
+    struct Item
+    {
+        wxArchiveFSCacheData data;
+        NamesList::iterator lruPos;
+    };
+
+    std::unordered_map<wxString, Item> m_hash;
+    NamesList m_lru;
+
+    size_t m_maxEntries;
+    size_t m_numEntries = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxArchiveFSCache);
 };
 
 wxArchiveFSCacheData* wxArchiveFSCache::Add(
@@ -280,30 +280,74 @@ wxArchiveFSCacheData* wxArchiveFSCache::Add(
         const wxArchiveClassFactory& factory,
         wxInputStream *stream)
 {
-    wxArchiveFSCacheData& data = m_hash[name];
+    Item& item = m_hash[name];
+
+    if (item.data.GetCount() != 0)
+    {
+        // Replacing an existing archive, forget about its entries.
+        m_numEntries -= item.data.GetCount();
+        m_lru.erase(item.lruPos);
+    }
 
     if (stream->IsSeekable())
-        data = wxArchiveFSCacheData(factory, stream);
+        item.data = wxArchiveFSCacheData(factory, stream);
     else
-        data = wxArchiveFSCacheData(factory, wxBackingFile(stream));
+        item.data = wxArchiveFSCacheData(factory, wxBackingFile(stream));
+
+    m_lru.push_front(name);
+    item.lruPos = m_lru.begin();
+    m_numEntries += item.data.GetCount();
+
+    Trim();
 
-    return &data;
+    return &item.data;
 }
 
 wxArchiveFSCacheData *wxArchiveFSCache::Get(const wxString& name)
 {
     const auto it = m_hash.find(name);
 
-    if (it != m_hash.end())
-        return &it->second;
+    if (it == m_hash.end())
+        return nullptr;
+
+    Item& item = it->second;
+    m_lru.splice(m_lru.begin(), m_lru, item.lruPos);
+
+    return &item.data;
+}
 
-    return nullptr;
+void wxArchiveFSCache::SetMaxEntries(size_t maxEntries)
+{
+    m_maxEntries = maxEntries;
+
+    Trim();
+}
+
+void wxArchiveFSCache::Trim()
+{
+    while (m_numEntries > m_maxEntries && m_lru.size() > 1)
+    {
+        const auto it = m_hash.find(m_lru.back());
+        m_numEntries -= it->second.data.GetCount();
+        m_hash.erase(it);
+        m_lru.pop_back();
+    }
 }
 
 //----------------------------------------------------------------------------
 // wxArchiveFSHandler
 //----------------------------------------------------------------------------
 
+namespace
+{
+
+// Default limit on the total number of the cached archive entries: this is
+// big enough to not limit any normal use but prevents the cache from growing
+// indefinitely when many different archives are accessed.
+const size_t DEFAULT_MAX_CACHED_ENTRIES = 100000;
+
+} // anonymous namespace
+
 wxIMPLEMENT_DYNAMIC_CLASS(wxArchiveFSHandler, wxFileSystemHandler);
 
 wxArchiveFSHandler::wxArchiveFSHandler()
@@ -314,6 +358,7 @@ wxArchiveFSHandler::wxArchiveFSHandler()
     m_AllowDirs = m_AllowFiles = true;
     m_DirsFound = nullptr;
     m_cache = nullptr;
+    m_maxCachedEntries = DEFAULT_MAX_CACHED_ENTRIES;
 }
 
 wxArchiveFSHandler::~wxArchiveFSHandler()
@@ -325,6 +370,16 @@ wxArchiveFSHandler::~wxArchiveFSHandler()
 void wxArchiveFSHandler::Cleanup()
 {
     wxDELETE(m_DirsFound);
+    wxDELETE(m_Archive);
+    m_FindEntry = nullptr;
+}
+
+void wxArchiveFSHandler::SetMaxCachedEntries(size_t maxEntries)
+{
+    m_maxCachedEntries = maxEntries;
+
+    if (m_cache)
+        m_cache->SetMaxEntries(maxEntries);
 }
 
 bool wxArchiveFSHandler::CanOpen(const wxString& location)
@@ -353,7 +408,7 @@ wxFSFile* wxArchiveFSHandler::OpenFile(
     if (!right.empty() && right.GetChar(0) == wxT('/')) right = right.Mid(1);
 
     if (!m_cache)
-        m_cache = new wxArchiveFSCache;
+        m_cache = new wxArchiveFSCache(m_maxCachedEntries);
 
     const wxArchiveClassFactory *factory;
     factory = wxArchiveClassFactory::Find(protocol);
@@ -416,23 +471,28 @@ wxString wxArchiveFSHandler::FindFirst(const wxString& spec, int flags)
     if (!right.empty() && right.Last() == wxT('/')) right.RemoveLast();
 
     if (!m_cache)
-        m_cache = new wxArchiveFSCache;
+        m_cache = new wxArchiveFSCache(m_maxCachedEntries);
 
     const wxArchiveClassFactory *factory;
     factory = wxArchiveClassFactory::Find(protocol);
     if (!factory)
         return wxEmptyString;
 
-    m_Archive = m_cache->Get(key);
-    if (!m_Archive)
+    wxArchiveFSCacheData *cached = m_cache->Get(key);
+    if (!cached)
     {
         wxFSFile *leftFile = m_fs.OpenFile(left);
         if (!leftFile)
             return wxEmptyString;
-        m_Archive = m_cache->Add(key, *factory, leftFile->DetachStream());
+        cached = m_cache->Add(key, *factory, leftFile->DetachStream());
         delete leftFile;
     }
 
+    // Keep our own reference to the archive catalog, as it could be removed
+    // from the cache before we finish iterating over it.
+    delete m_Archive;
+    m_Archive = new wxArchiveFSCacheData(*cached);
+
     m_FindEntry = nullptr;
 
     switch (flags)
@@ -483,8 +543,7 @@ wxString wxArchiveFSHandler::DoFind()
 
         if (!m_FindEntry)
         {
-            m_Archive = nullptr;
-            m_FindEntry = nullptr;
+            wxDELETE(m_Archive);
             break;
         }
         namestr = m_FindEntry->entry->GetName(wxPATH_UNIX);
@@ -26,10 +26,16 @@
 
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
+#include "wx/sysopt.h"
+#include "wx/thread.h"
+
+#include "wx/private/imageload.h"
+#include "wx/private/threadpool.h"
 
 // For memcpy
 #include <string.h>
 
+#include <atomic>
 #include <unordered_set>
 
 // make the code compile with either wxFile*Stream or wxFFile*Stream:
@@ -56,6 +62,11 @@ IMPLEMENT_VARIANT_OBJECT_EXPORTED_SHALLOWCMP(wxImage,WXDLLEXPORT)
 wxList wxImage::sm_handlers;
 wxImage wxNullImage;
 
+// Maximal number of threads used by the image transformations, see
+// wxImage::SetMaxThreads(). This is atomic as it can be changed while the
+// images are being processed by the other threads.
+static std::atomic<int> gs_imageMaxThreads{1};
+
 //-----------------------------------------------------------------------------
 // wxImageRefData
 //-----------------------------------------------------------------------------
@@ -66,6 +77,35 @@ public:
     wxImageRefData();
     virtual ~wxImageRefData();
 
+    // Return the image data ensuring that m_data and m_alpha can be used,
+    // i.e. unpacking m_rgba if necessary.
+    static wxImageRefData* GetUnpacked(wxObjectRefData* refData)
+    {
+        wxImageRefData* const data = static_cast<wxImageRefData*>(refData);
+        if ( data && data->IsPacked() )
+            data->UnpackRGBA();
+
+        return data;
+    }
+
+    // Return true if the pixels are only stored in m_rgba, i.e. m_data and
+    // m_alpha are not available.
+    bool IsPacked() const
+    {
+        return m_rgba && !m_unpacked.load(std::memory_order_acquire);
+    }
+
+    // Store the pixels in m_rgba, reusing it if it already exists, and free
+    // m_data and m_alpha. This can only be used for images with alpha and
+    // only if the data is not shared with any other images.
+    void PackRGBA();
+
+    // Create m_data and m_alpha from m_rgba. This is done when accessing the
+    // pixels from const functions, which may be called for the data shared
+    // by several images from several threads at once, so it is thread-safe
+    // and keeps m_rgba, as the pointers to it may still be used.
+    void UnpackRGBA();
+
     int             m_width;
     int             m_height;
     wxBitmapType    m_type;
@@ -77,6 +117,15 @@ public:
     // alpha channel data, may be null for the formats without alpha support
     unsigned char  *m_alpha;
 
+    // interleaved RGBA data: if this pointer is non-null and m_unpacked is
+    // false, it's used instead of both m_data and m_alpha, which are null in
+    // this case
+    unsigned char  *m_rgba;
+
+    // true if m_data and m_alpha were created from m_rgba: they are used from
+    // then on and m_rgba is only kept alive, but may be out of date
+    std::atomic<bool> m_unpacked{false};
+
     bool            m_ok;
 
     // if true, m_data is pointer to static data and shouldn't be freed
@@ -108,7 +157,8 @@ wxImageRefData::wxImageRefData()
     m_height = 0;
     m_type = wxBITMAP_TYPE_INVALID;
     m_data =
-    m_alpha = (unsigned char *) nullptr;
+    m_alpha =
+    m_rgba = (unsigned char *) nullptr;
 
     m_maskRed = 0;
     m_maskGreen = 0;
@@ -128,6 +178,68 @@ wxImageRefData::~wxImageRefData()
         free( m_data );
     if ( !m_staticAlpha )
         free( m_alpha );
+    free( m_rgba );
+}
+
+// Used to prevent several threads from unpacking the same data at once.
+static wxCriticalSection gs_csUnpackRGBA;
+
+void wxImageRefData::PackRGBA()
+{
+    const size_t numPixels = static_cast<size_t>(m_width)*m_height;
+
+    if ( !m_rgba )
+        m_rgba = (unsigned char*)malloc(4*numPixels);
+
+    const unsigned char* rgb = m_data;
+    const unsigned char* alpha = m_alpha;
+    unsigned char* rgba = m_rgba;
+    for ( size_t n = 0; n < numPixels; n++, rgb += 3, rgba += 4 )
+    {
+        rgba[0] = rgb[0];
+        rgba[1] = rgb[1];
+        rgba[2] = rgb[2];
+        rgba[3] = *alpha++;
+    }
+
+    if ( !m_static )
+        free( m_data );
+    if ( !m_staticAlpha )
+        free( m_alpha );
+
+    m_data =
+    m_alpha = nullptr;
+    m_static =
+    m_staticAlpha = false;
+
+    m_unpacked = false;
+}
+
+void wxImageRefData::UnpackRGBA()
+{
+    wxCriticalSectionLocker lock(gs_csUnpackRGBA);
+
+    // Another thread could have done it while we were waiting for the lock.
+    if ( m_unpacked.load(std::memory_order_relaxed) )
+        return;
+
+    const size_t numPixels = static_cast<size_t>(m_width)*m_height;
+
+    m_data = (unsigned char*)malloc(3*numPixels);
+    m_alpha = (unsigned char*)malloc(numPixels);
+
+    const unsigned char* rgba = m_rgba;
+    unsigned char* rgb = m_data;
+    unsigned char* alpha = m_alpha;
+    for ( size_t n = 0; n < numPixels; n++, rgb += 3, rgba += 4 )
+    {
+        rgb[0] = rgba[0];
+        rgb[1] = rgba[1];
+        rgb[2] = rgba[2];
+        *alpha++ = rgba[3];
+    }
+
+    m_unpacked.store(true, std::memory_order_release);
 }
 
 
@@ -135,7 +247,12 @@ wxImageRefData::~wxImageRefData()
 // wxImage
 //-----------------------------------------------------------------------------
 
-#define M_IMGDATA static_cast<wxImageRefData*>(m_refData)
+// Use this macro for accessing the image pixels, i.e. m_data and m_alpha: it
+// unpacks them if the image data is currently stored in the RGBA format.
+#define M_IMGDATA wxImageRefData::GetUnpacked(m_refData)
+
+// And this one for accessing all the other fields, without any overhead.
+#define M_IMGINFO static_cast<wxImageRefData*>(m_refData)
 
 wxIMPLEMENT_DYNAMIC_CLASS(wxImage, wxObject);
 
@@ -254,14 +371,24 @@ wxObjectRefData* wxImage::CloneRefData(const wxObjectRefData* that) const
     refData_new->m_hasMask = refData->m_hasMask;
     refData_new->m_ok = true;
     unsigned size = unsigned(refData->m_width) * unsigned(refData->m_height);
-    if (refData->m_alpha != nullptr)
+    if (refData->IsPacked())
     {
-        refData_new->m_alpha = (unsigned char*)malloc(size);
-        memcpy(refData_new->m_alpha, refData->m_alpha, size);
+        // Preserve the storage format of the original image.
+        size *= 4;
+        refData_new->m_rgba = (unsigned char*)malloc(size);
+        memcpy(refData_new->m_rgba, refData->m_rgba, size);
+    }
+    else
+    {
+        if (refData->m_alpha != nullptr)
+        {
+            refData_new->m_alpha = (unsigned char*)malloc(size);
+            memcpy(refData_new->m_alpha, refData->m_alpha, size);
+        }
+        size *= 3;
+        refData_new->m_data = (unsigned char*)malloc(size);
+        memcpy(refData_new->m_data, refData->m_data, size);
     }
-    size *= 3;
-    refData_new->m_data = (unsigned char*)malloc(size);
-    memcpy(refData_new->m_data, refData->m_data, size);
 #if wxUSE_PALETTE
     refData_new->m_palette = refData->m_palette;
 #endif
@@ -278,8 +405,8 @@ wxImage wxImage::MakeEmptyClone(int flags) const
 
     wxCHECK_MSG( IsOk(), image, wxS("invalid image") );
 
-    long height = M_IMGDATA->m_height;
-    long width  = M_IMGDATA->m_width;
+    long height = M_IMGINFO->m_height;
+    long width  = M_IMGINFO->m_width;
 
     if ( flags & Clone_SwapOrientation )
         wxSwap( width, height );
@@ -290,18 +417,18 @@ wxImage wxImage::MakeEmptyClone(int flags) const
         return image;
     }
 
-    if ( M_IMGDATA->m_alpha )
+    if ( HasAlpha() )
     {
         image.SetAlpha();
         wxCHECK2_MSG( image.GetAlpha(), return wxImage(),
                       wxS("unable to create alpha channel") );
     }
 
-    if ( M_IMGDATA->m_hasMask )
+    if ( M_IMGINFO->m_hasMask )
     {
-        image.SetMaskColour( M_IMGDATA->m_maskRed,
-                             M_IMGDATA->m_maskGreen,
-                             M_IMGDATA->m_maskBlue );
+        image.SetMaskColour( M_IMGINFO->m_maskRed,
+                             M_IMGINFO->m_maskGreen,
+                             M_IMGINFO->m_maskBlue );
     }
 
     return image;
@@ -533,6 +660,32 @@ wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
     return image;
 }
 
+// ----------------------------------------------------------------------------
+// Helpers for multi-threaded image processing
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Don't use threads for processing fewer pixels than this, as the overhead of
+// using them would outweigh any gains.
+constexpr int MIN_PIXELS_PER_THREAD = 16384;
+
+// Call the given function for the ranges of items covering [0, count),
+// possibly concurrently if using multiple threads is enabled. The items are
+// typically image rows but may also be columns or individual pixels: in any
+// case, the processing of different items must be completely independent.
+void
+ForEachRange(int count, int pixelsPerItem, const wxThreadPool::RangeFunc& func)
+{
+    wxThreadPool::ParallelFor(count,
+                              wxThreadPool::GetThreadCount(gs_imageMaxThreads),
+                              func,
+                              MIN_PIXELS_PER_THREAD / wxMax(pixelsPerItem, 1) + 1);
+}
+
+} // anonymous namespace
+
 wxImage wxImage::ResampleNearest(int width, int height) const
 {
     wxImage image;
@@ -577,34 +730,185 @@ wxImage wxImage::ResampleNearest(int width, int height) const
     const wxUIntPtr x_delta = (old_width  << 16) / width;
     const wxUIntPtr y_delta = (old_height << 16) / height;
 
-    unsigned char* dest_pixel = target_data;
-
-    wxUIntPtr y = y_delta / 2;
-    for (int j = 0; j < height; j++)
+    ForEachRange(height, width, [&](int yFrom, int yTo)
     {
-        const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
-        const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : nullptr ;
+        unsigned char* dest_pixel = target_data + yFrom * width * 3;
+        unsigned char* dest_alpha = target_alpha ? target_alpha + yFrom * width
+                                                 : nullptr;
 
-        wxUIntPtr x = x_delta / 2;
-        for (int i = 0; i < width; i++)
+        wxUIntPtr y = y_delta / 2 + yFrom * y_delta;
+        for (int j = yFrom; j < yTo; j++)
         {
-            const unsigned char* src_pixel = &src_line[(x>>16)*3];
-            const unsigned char* src_alpha_pixel = source_alpha ? &src_alpha_line[(x>>16)] : nullptr ;
-            dest_pixel[0] = src_pixel[0];
-            dest_pixel[1] = src_pixel[1];
-            dest_pixel[2] = src_pixel[2];
-            dest_pixel += 3;
-            if ( source_alpha )
-                *(target_alpha++) = *src_alpha_pixel ;
-            x += x_delta;
+            const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
+            const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : nullptr ;
+
+            wxUIntPtr x = x_delta / 2;
+            for (int i = 0; i < width; i++)
+            {
+                const unsigned char* src_pixel = &src_line[(x>>16)*3];
+                const unsigned char* src_alpha_pixel = source_alpha ? &src_alpha_line[(x>>16)] : nullptr ;
+                dest_pixel[0] = src_pixel[0];
+                dest_pixel[1] = src_pixel[1];
+                dest_pixel[2] = src_pixel[2];
+                dest_pixel += 3;
+                if ( source_alpha )
+                    *(dest_alpha++) = *src_alpha_pixel ;
+                x += x_delta;
+            }
+
+            y += y_delta;
         }
+    });
+
+    return image;
+}
+
+// ----------------------------------------------------------------------------
+// Helpers for vectorizing the resampling code
+// ----------------------------------------------------------------------------
+
+// All resampling functions below accumulate the weighted sums of all 4 pixel
+// channels (R, G, B and alpha) as doubles. When SSE2 (which is always
+// available under x86-64) or NEON (always available under ARM64) can be used,
+// we perform the same operations for all channels at once, otherwise only the
+// scalar code is used.
+//
+// Note that vectorized code performs exactly the same IEEE 754 operations, in
+// the same order, as the scalar one, so the results are bit-identical. The
+// only exception is that the compiler may contract multiplications and
+// additions into FMA instructions differently in the scalar and NEON code
+// (this is not done by default for x86), which may change the rounding of the
+// resulting channel values by 1.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define wxIMAGE_RESAMPLE_USE_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define wxIMAGE_RESAMPLE_USE_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(wxIMAGE_RESAMPLE_USE_SSE2) || defined(wxIMAGE_RESAMPLE_USE_NEON)
+    #define wxIMAGE_RESAMPLE_USE_SIMD
+#endif
+
+namespace
+{
 
-        y += y_delta;
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+
+// Weighted values of all channels of a pixel or sums of them.
+class PixelSums
+{
+public:
+    // Construct the object with all channels set to 0.
+    PixelSums()
+    {
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+        m_rg =
+        m_ba = _mm_setzero_pd();
+#else
+        m_rg =
+        m_ba = vdupq_n_f64(0.0);
+#endif
     }
 
-    return image;
+    // Return the object with the values of the given RGB pixel and the given
+    // alpha value, which is typically 0 or 1 if the image doesn't have alpha
+    // or if alpha is not used directly.
+    static PixelSums Load(const unsigned char* rgb, unsigned char a)
+    {
+        PixelSums p;
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+        const double* const values = GetByteValues();
+        p.m_rg = _mm_loadh_pd(_mm_load_sd(values + rgb[0]), values + rgb[1]);
+        p.m_ba = _mm_loadh_pd(_mm_load_sd(values + rgb[2]), values + a);
+#else
+        const double rg[2] = { double(rgb[0]), double(rgb[1]) };
+        const double ba[2] = { double(rgb[2]), double(a) };
+        p.m_rg = vld1q_f64(rg);
+        p.m_ba = vld1q_f64(ba);
+#endif
+        return p;
+    }
+
+    PixelSums operator*(double w) const
+    {
+        PixelSums p;
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+        const __m128d wv = _mm_set1_pd(w);
+        p.m_rg = _mm_mul_pd(m_rg, wv);
+        p.m_ba = _mm_mul_pd(m_ba, wv);
+#else
+        p.m_rg = vmulq_n_f64(m_rg, w);
+        p.m_ba = vmulq_n_f64(m_ba, w);
+#endif
+        return p;
+    }
+
+    PixelSums operator+(const PixelSums& other) const
+    {
+        PixelSums p;
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+        p.m_rg = _mm_add_pd(m_rg, other.m_rg);
+        p.m_ba = _mm_add_pd(m_ba, other.m_ba);
+#else
+        p.m_rg = vaddq_f64(m_rg, other.m_rg);
+        p.m_ba = vaddq_f64(m_ba, other.m_ba);
+#endif
+        return p;
+    }
+
+    PixelSums& operator+=(const PixelSums& other)
+    {
+        *this = *this + other;
+        return *this;
+    }
+
+    // Store the channel values in the provided array in R, G, B, A order.
+    void Get(double values[4]) const
+    {
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+        _mm_storeu_pd(values, m_rg);
+        _mm_storeu_pd(values + 2, m_ba);
+#else
+        vst1q_f64(values, m_rg);
+        vst1q_f64(values + 2, m_ba);
+#endif
+    }
+
+private:
+    static const double* GetByteValues()
+    {
+        static const struct ByteValues
+        {
+            ByteValues() { for ( int n = 0; n < 256; n++ ) values[n] = n; }
+            double values[256];
+        } s_byteValues;
+        return s_byteValues.values;
+    }
+
+#ifdef wxIMAGE_RESAMPLE_USE_SSE2
+    __m128d m_rg,
+            m_ba;
+#else
+    float64x2_t m_rg,
+                m_ba;
+#endif
+};
+
+// Return true if the vectorized code should be used: this is the case by
+// default, but can be disabled by setting the "image.no-simd" system option,
+// which is mostly useful for comparing the results and performance of the
+// vectorized and scalar versions.
+bool UseVectorizedResample()
+{
+    return !wxSystemOptions::GetOptionInt(wxS("image.no-simd"));
 }
 
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
+
+} // anonymous namespace
+
 namespace
 {
 
@@ -657,6 +961,82 @@ void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
     }
 }
 
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+
+// Vectorized version of the main loop of ResampleBox(), see the comments there.
+void DoResampleBoxSIMD(const unsigned char* src_data,
+                       const unsigned char* src_alpha,
+                       int srcWidth,
+                       const wxVector<BoxPrecalc>& vPrecalcs,
+                       const wxVector<BoxPrecalc>& hPrecalcs,
+                       int yFrom,
+                       int yTo,
+                       unsigned char* dst_data,
+                       unsigned char* dst_alpha)
+{
+    const int width = hPrecalcs.size();
+
+    double sum[4];
+
+    for ( int y = yFrom; y < yTo; y++ )
+    {
+        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+
+        for ( int x = 0; x < width; x++ )
+        {
+            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+
+            const int averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
+                                        * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+
+            // As all the values here are integers, the sums are computed
+            // exactly and the order of operations doesn't matter.
+            PixelSums sums;
+            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            {
+                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                {
+                    const int src_pixel_index = j * srcWidth + i;
+                    const unsigned char* const rgb = src_data + src_pixel_index * 3;
+
+                    if ( src_alpha )
+                        sums += PixelSums::Load(rgb, 1) * src_alpha[src_pixel_index];
+                    else
+                        sums += PixelSums::Load(rgb, 0);
+                }
+            }
+
+            sums.Get(sum);
+
+            if ( src_alpha )
+            {
+                if ( sum[3] != 0 )
+                {
+                    dst_data[0] = (unsigned char)(sum[0] / sum[3]);
+                    dst_data[1] = (unsigned char)(sum[1] / sum[3]);
+                    dst_data[2] = (unsigned char)(sum[2] / sum[3]);
+                }
+                else
+                {
+                    dst_data[0] = 0;
+                    dst_data[1] = 0;
+                    dst_data[2] = 0;
+                }
+                *dst_alpha++ = (unsigned char)(sum[3] / averaged_pixels);
+            }
+            else
+            {
+                dst_data[0] = (unsigned char)(sum[0] / averaged_pixels);
+                dst_data[1] = (unsigned char)(sum[1] / averaged_pixels);
+                dst_data[2] = (unsigned char)(sum[2] / averaged_pixels);
+            }
+            dst_data += 3;
+        }
+    }
+}
+
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
+
 } // anonymous namespace
 
 wxImage wxImage::ResampleBox(int width, int height) const
@@ -690,73 +1070,95 @@ wxImage wxImage::ResampleBox(int width, int height) const
         dst_alpha = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+    if ( UseVectorizedResample() )
+    {
+        ForEachRange(height, width, [&](int yFrom, int yTo)
+        {
+            DoResampleBoxSIMD(src_data, src_alpha, M_IMGDATA->m_width,
+                              vPrecalcs, hPrecalcs, yFrom, yTo,
+                              dst_data + yFrom * width * 3,
+                              dst_alpha ? dst_alpha + yFrom * width : nullptr);
+        });
+        return ret_image;
+    }
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
+
+    const int src_width = M_IMGDATA->m_width;
 
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
+    ForEachRange(height, width, [&](int yFrom, int yTo)
     {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+        unsigned char* dst = dst_data + yFrom * width * 3;
+        unsigned char* dst_a = dst_alpha ? dst_alpha + yFrom * width : nullptr;
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
-        {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+        int averaged_pixels, src_pixel_index;
+        double sum_r, sum_g, sum_b, sum_a;
 
-            // Box of pixels to average
-            averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
-                                * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+        for ( int y = yFrom; y < yTo; y++ )         // Destination image - Y direction
+        {
+            // Source pixel in the Y direction
+            const BoxPrecalc& vPrecalc = vPrecalcs[y];
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            for ( int x = 0; x < width; x++ )      // Destination image - X direction
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                // Source pixel in the X direction
+                const BoxPrecalc& hPrecalc = hPrecalcs[x];
+
+                // Box of pixels to average
+                averaged_pixels = (vPrecalc.boxEnd - vPrecalc.boxStart + 1)
+                                    * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+                sum_r = sum_g = sum_b = sum_a = 0.0;
+
+                for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
                 {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+                    for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
+                    {
+                        // Calculate the actual index in our source pixels
+                        src_pixel_index = j * src_width + i;
+
+                        if (src_alpha)
+                        {
+                            sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
+                            sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
+                            sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
+                            sum_a += src_alpha[src_pixel_index];
+                        }
+                        else
+                        {
+                            sum_r += src_data[src_pixel_index * 3 + 0];
+                            sum_g += src_data[src_pixel_index * 3 + 1];
+                            sum_b += src_data[src_pixel_index * 3 + 2];
+                        }
+                    }
+                }
 
-                    if (src_alpha)
+                // Calculate the average from the sum and number of averaged pixels
+                if (src_alpha)
+                {
+                    if (sum_a != 0)
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
+                        dst[0] = (unsigned char)(sum_r / sum_a);
+                        dst[1] = (unsigned char)(sum_g / sum_a);
+                        dst[2] = (unsigned char)(sum_b / sum_a);
                     }
                     else
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
                     }
-                }
-            }
-
-            // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
-            {
-                if (sum_a != 0)
-                {
-                    dst_data[0] = (unsigned char)(sum_r / sum_a);
-                    dst_data[1] = (unsigned char)(sum_g / sum_a);
-                    dst_data[2] = (unsigned char)(sum_b / sum_a);
+                    *dst_a++ = (unsigned char)(sum_a / averaged_pixels);
                 }
                 else
                 {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
+                    dst[0] = (unsigned char)(sum_r / averaged_pixels);
+                    dst[1] = (unsigned char)(sum_g / averaged_pixels);
+                    dst[2] = (unsigned char)(sum_b / averaged_pixels);
                 }
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
+                dst += 3;
             }
-            dst_data += 3;
         }
-    }
+    });
 
     return ret_image;
 }
@@ -819,6 +1221,105 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+
+// Compute the horizontally interpolated values of all pixels of the given
+// source row.
+void DoResampleBilinearRowSIMD(const unsigned char* src_data,
+                               const unsigned char* src_alpha,
+                               const wxVector<BilinearPrecalc>& hPrecalcs,
+                               PixelSums* line)
+{
+    const int width = hPrecalcs.size();
+    for ( int dstx = 0; dstx < width; dstx++ )
+    {
+        const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+
+        const int x_offset1 = hPrecalc.offset1;
+        const int x_offset2 = hPrecalc.offset2;
+
+        const PixelSums p1 = PixelSums::Load(src_data + x_offset1 * 3,
+                                             src_alpha ? src_alpha[x_offset1] : 0);
+        const PixelSums p2 = PixelSums::Load(src_data + x_offset2 * 3,
+                                             src_alpha ? src_alpha[x_offset2] : 0);
+
+        line[dstx] = p1 * hPrecalc.dd1 + p2 * hPrecalc.dd;
+    }
+}
+
+// Vectorized version of the main loop of ResampleBilinear().
+//
+// Unlike the scalar version, it computes the horizontal interpolation only
+// once for each source row and reuses it for all the destination rows using
+// it, which is especially advantageous when enlarging the image.
+void DoResampleBilinearSIMD(const unsigned char* src_data,
+                            const unsigned char* src_alpha,
+                            int srcWidth,
+                            const wxVector<BilinearPrecalc>& vPrecalcs,
+                            const wxVector<BilinearPrecalc>& hPrecalcs,
+                            int yFrom,
+                            int yTo,
+                            unsigned char* dst_data,
+                            unsigned char* dst_alpha)
+{
+    const int width = hPrecalcs.size();
+
+    // Cache of the interpolated rows and the source rows they correspond to.
+    wxVector<PixelSums> lines[2] = { wxVector<PixelSums>(width),
+                                     wxVector<PixelSums>(width) };
+    int linesRow[2] = { -1, -1 };
+
+    const auto getLine = [&](int row, int otherRow) -> const PixelSums*
+    {
+        int n;
+        if ( linesRow[0] == row )
+            n = 0;
+        else if ( linesRow[1] == row )
+            n = 1;
+        else
+        {
+            // Don't overwrite the other row we need.
+            n = linesRow[0] == otherRow ? 1 : 0;
+
+            DoResampleBilinearRowSIMD(src_data + row * srcWidth * 3,
+                                      src_alpha ? src_alpha + row * srcWidth
+                                                : nullptr,
+                                      hPrecalcs,
+                                      &lines[n][0]);
+            linesRow[n] = row;
+        }
+
+        return &lines[n][0];
+    };
+
+    double res[4];
+
+    for ( int dsty = yFrom; dsty < yTo; dsty++ )
+    {
+        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
+        const double dy = vPrecalc.dd;
+        const double dy1 = vPrecalc.dd1;
+
+        const PixelSums* const line1 = getLine(vPrecalc.offset1, vPrecalc.offset2);
+        const PixelSums* const line2 = getLine(vPrecalc.offset2, vPrecalc.offset1);
+
+        for ( int dstx = 0; dstx < width; dstx++ )
+        {
+            (line1[dstx] * dy1 + line2[dstx] * dy).Get(res);
+
+            dst_data[0] = static_cast<unsigned char>(res[0] + .5);
+            dst_data[1] = static_cast<unsigned char>(res[1] + .5);
+            dst_data[2] = static_cast<unsigned char>(res[2] + .5);
+            dst_data += 3;
+
+            if ( src_alpha )
+                *dst_alpha++ = static_cast<unsigned char>(res[3] + .5);
+        }
+    }
+}
+
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
+
 } // anonymous namespace
 
 wxImage wxImage::ResampleBilinear(int width, int height) const
@@ -845,61 +1346,83 @@ wxImage wxImage::ResampleBilinear(int width, int height) const
     ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+    if ( UseVectorizedResample() )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
-
-
-        for ( int dstx = 0; dstx < width; dstx++ )
+        ForEachRange(height, width, [&](int yFrom, int yTo)
         {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
+            DoResampleBilinearSIMD(src_data, src_alpha, M_IMGDATA->m_width,
+                                   vPrecalcs, hPrecalcs, yFrom, yTo,
+                                   dst_data + yFrom * width * 3,
+                                   dst_alpha ? dst_alpha + yFrom * width : nullptr);
+        });
+        return ret_image;
+    }
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
 
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
+    const int src_width = M_IMGDATA->m_width;
 
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
+    ForEachRange(height, width, [&](int yFrom, int yTo)
+    {
+        unsigned char* dst = dst_data + yFrom * width * 3;
+        unsigned char* dst_a = dst_alpha ? dst_alpha + yFrom * width : nullptr;
 
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+        // initialize alpha values to avoid g++ warnings about possibly
+        // uninitialized variables
+        double r1, g1, b1, a1 = 0;
+        double r2, g2, b2, a2 = 0;
 
-            // result lines
+        for ( int dsty = yFrom; dsty < yTo; dsty++ )
+        {
+            // We need to calculate the source pixel to interpolate from - Y-axis
+            const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
+            const int y_offset1 = vPrecalc.offset1;
+            const int y_offset2 = vPrecalc.offset2;
+            const double dy = vPrecalc.dd;
+            const double dy1 = vPrecalc.dd1;
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+            for ( int dstx = 0; dstx < width; dstx++ )
+            {
+                // X-axis of pixel to interpolate from
+                const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
+
+                const int x_offset1 = hPrecalc.offset1;
+                const int x_offset2 = hPrecalc.offset2;
+                const double dx = hPrecalc.dd;
+                const double dx1 = hPrecalc.dd1;
+
+                int src_pixel_index00 = y_offset1 * src_width + x_offset1;
+                int src_pixel_index01 = y_offset1 * src_width + x_offset2;
+                int src_pixel_index10 = y_offset2 * src_width + x_offset1;
+                int src_pixel_index11 = y_offset2 * src_width + x_offset2;
+
+                // first line
+                r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
+                g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
+                b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
+                if ( src_alpha )
+                    a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
+
+                // second line
+                r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
+                g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
+                b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
+                if ( src_alpha )
+                    a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+
+                // result lines
+
+                dst[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
+                dst[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
+                dst[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
+                dst += 3;
+
+                if ( src_alpha )
+                    *dst_a++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
+            }
         }
-    }
+    });
 
     return ret_image;
 }
@@ -973,6 +1496,86 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
     }
 }
 
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+
+// Vectorized version of the main loop of ResampleBicubic().
+void DoResampleBicubicSIMD(const unsigned char* src_data,
+                           const unsigned char* src_alpha,
+                           int srcWidth,
+                           const wxVector<BicubicPrecalc>& vPrecalcs,
+                           const wxVector<BicubicPrecalc>& hPrecalcs,
+                           int yFrom,
+                           int yTo,
+                           unsigned char* dst_data,
+                           unsigned char* dst_alpha)
+{
+    const int width = hPrecalcs.size();
+
+    double sum[4];
+
+    for ( int dsty = yFrom; dsty < yTo; dsty++ )
+    {
+        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+
+        for ( int dstx = 0; dstx < width; dstx++ )
+        {
+            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+
+            PixelSums sums;
+            for ( int k = 0; k < 4; k++ )
+            {
+                const int y_offset = vPrecalc.offset[k] * srcWidth;
+
+                for ( int i = 0; i < 4; i++ )
+                {
+                    const int src_pixel_index = y_offset + hPrecalc.offset[i];
+                    const unsigned char* const rgb = src_data + src_pixel_index * 3;
+
+                    const double
+                        pixel_weight = vPrecalc.weight[k] * hPrecalc.weight[i];
+
+                    // Note that using 1 for the alpha channel here results in
+                    // alpha sum being computed as the sum of a * pixel_weight,
+                    // exactly as it is done in the scalar code.
+                    if ( src_alpha )
+                        sums += PixelSums::Load(rgb, 1) * pixel_weight
+                                    * src_alpha[src_pixel_index];
+                    else
+                        sums += PixelSums::Load(rgb, 0) * pixel_weight;
+                }
+            }
+
+            sums.Get(sum);
+
+            if ( src_alpha )
+            {
+                if ( sum[3] != 0 )
+                {
+                    dst_data[0] = (unsigned char)(sum[0] / sum[3] + 0.5);
+                    dst_data[1] = (unsigned char)(sum[1] / sum[3] + 0.5);
+                    dst_data[2] = (unsigned char)(sum[2] / sum[3] + 0.5);
+                }
+                else
+                {
+                    dst_data[0] = 0;
+                    dst_data[1] = 0;
+                    dst_data[2] = 0;
+                }
+                *dst_alpha++ = (unsigned char)sum[3];
+            }
+            else
+            {
+                dst_data[0] = (unsigned char)(sum[0] + 0.5);
+                dst_data[1] = (unsigned char)(sum[1] + 0.5);
+                dst_data[2] = (unsigned char)(sum[2] + 0.5);
+            }
+            dst_data += 3;
+        }
+    }
+}
+
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
+
 } // anonymous namespace
 
 // This is the bicubic resampling algorithm
@@ -1030,91 +1633,407 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+#ifdef wxIMAGE_RESAMPLE_USE_SIMD
+    if ( UseVectorizedResample() )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
-
-        for ( int dstx = 0; dstx < width; dstx++ )
+        ForEachRange(height, width, [&](int yFrom, int yTo)
         {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+            DoResampleBicubicSIMD(src_data, src_alpha, M_IMGDATA->m_width,
+                                  vPrecalcs, hPrecalcs, yFrom, yTo,
+                                  dst_data + yFrom * width * 3,
+                                  dst_alpha ? dst_alpha + yFrom * width : nullptr);
+        });
+        return ret_image;
+    }
+#endif // wxIMAGE_RESAMPLE_USE_SIMD
+
+    const int src_width = M_IMGDATA->m_width;
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+    ForEachRange(height, width, [&](int yFrom, int yTo)
+    {
+        unsigned char* dst = dst_data + yFrom * width * 3;
+        unsigned char* dst_a = dst_alpha ? dst_alpha + yFrom * width : nullptr;
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+        for ( int dsty = yFrom; dsty < yTo; dsty++ )
+        {
+            // We need to calculate the source pixel to interpolate from - Y-axis
+            const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+
+            for ( int dstx = 0; dstx < width; dstx++ )
             {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+                // X-axis of pixel to interpolate from
+                const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
+                // Sums for each color channel
+                double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
 
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
+                // Here we actually determine the RGBA values for the destination pixel
+                for ( int k = -1; k <= 2; k++ )
+                {
+                    // Y offset
+                    const int y_offset = vPrecalc.offset[k + 1];
 
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
+                    // Loop across the X axis
+                    for ( int i = -1; i <= 2; i++ )
+                    {
+                        // X offset
+                        const int x_offset = hPrecalc.offset[i + 1];
+
+                        // Calculate the exact position where the source data
+                        // should be pulled from based on the x_offset and y_offset
+                        int src_pixel_index = y_offset*src_width + x_offset;
+
+                        // Calculate the weight for the specified pixel according
+                        // to the bicubic b-spline kernel we're using for
+                        // interpolation
+                        const double
+                            pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
+
+                        // Create a sum of all values for each color channel
+                        // adjusted for the pixel's calculated weight
+                        if ( src_alpha )
+                        {
+                            const unsigned char a = src_alpha[src_pixel_index];
+                            sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
+                            sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
+                            sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
+                            sum_a += a * pixel_weight;
+                        }
+                        else
+                        {
+                            sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
+                            sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
+                            sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
+                        }
+                    }
+                }
 
-                    // Create a sum of all values for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
+                // Put the data into the destination image.  The summed values are
+                // of double data type and are rounded here for accuracy
+                if ( src_alpha )
+                {
+                    if (sum_a != 0)
                     {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
+                         dst[0] = (unsigned char)(sum_r / sum_a + 0.5);
+                         dst[1] = (unsigned char)(sum_g / sum_a + 0.5);
+                         dst[2] = (unsigned char)(sum_b / sum_a + 0.5);
                     }
                     else
                     {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
                     }
-                }
-            }
-
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
-            {
-                if (sum_a != 0)
-                {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
+                    *dst_a++ = (unsigned char)sum_a;
                 }
                 else
                 {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
+                    dst[0] = (unsigned char)(sum_r + 0.5);
+                    dst[1] = (unsigned char)(sum_g + 0.5);
+                    dst[2] = (unsigned char)(sum_b + 0.5);
                 }
-                *dst_alpha++ = (unsigned char)sum_a;
+                dst += 3;
             }
-            else
+        }
+    });
+
+    return ret_image;
+}
+
+// ----------------------------------------------------------------------------
+// Blurring
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Maximal number of box filter passes used for approximating Gaussian blur.
+constexpr int MAX_BOX_PASSES = 3;
+
+// Number of columns processed together when blurring in vertical direction:
+// this allows to still access the image memory sequentially while keeping the
+// size of the temporary buffers small.
+constexpr int BLUR_TILE_WIDTH = 16;
+
+// Parameters of the box filter passes applied by BoxBlurRows() and
+// BoxBlurColumns().
+struct BoxBlurParams
+{
+    int radii[MAX_BOX_PASSES];
+    int numPasses;
+
+    // If true, round the averages to the nearest integer, otherwise truncate
+    // them, as the original blur implementation did.
+    bool round;
+
+    // If true, blur the colours premultiplied by alpha, as otherwise the
+    // colours of the transparent pixels bleed into the neighbouring opaque
+    // ones. This is only done in the temporary buffers, the image itself
+    // always contains the colours which are not premultiplied.
+    bool premultiply;
+};
+
+// Apply the box filter with the given radius to count items, consisting of
+// nch channels each and separated by stride, starting at src and write the
+// result, using the same layout, to dst. The items beyond the edges are taken
+// to be equal to the edge items.
+//
+// As this uses a running sum, it takes constant time per item independently
+// of the radius.
+void
+BoxBlurLine(const int* src, int* dst, int count, int nch, int stride,
+            int radius, bool round)
+{
+    const int size = 2*radius + 1;
+    const wxLongLong_t bias = round ? size / 2 : 0;
+    const int last = count - 1;
+
+    for ( int c = 0; c < nch; c++ )
+    {
+        const int* const s = src + c;
+        int* const d = dst + c;
+
+        // The window centered on the first item contains radius + 1 copies of
+        // it, the following items and, if it extends beyond the last item,
+        // the copies of the last one.
+        const int right = wxMin(radius, last);
+        wxLongLong_t sum = static_cast<wxLongLong_t>(s[0]) * (radius + 1);
+        for ( int k = 1; k <= right; k++ )
+            sum += s[k*stride];
+        sum += static_cast<wxLongLong_t>(s[last*stride]) * (radius - right);
+
+        for ( int x = 0; ; )
+        {
+            d[x*stride] = static_cast<int>((sum + bias) / size);
+
+            if ( ++x == count )
+                break;
+
+            sum -= s[wxMax(x - radius - 1, 0)*stride];
+            sum += s[wxMin(x + radius, last)*stride];
+        }
+    }
+}
+
+// Apply all box filter passes to the numLines lines starting at buf and
+// separated by lineOffset, using tmp buffer of the same size as temporary
+// storage, and return the buffer containing the result.
+int*
+BoxBlurLines(int* buf, int* tmp, int numLines, int lineOffset,
+             int count, int nch, int stride, const BoxBlurParams& params)
+{
+    for ( int n = 0; n < params.numPasses; n++ )
+    {
+        for ( int line = 0; line < numLines; line++ )
+        {
+            BoxBlurLine(buf + line*lineOffset, tmp + line*lineOffset,
+                        count, nch, stride, params.radii[n], params.round);
+        }
+
+        wxSwap(buf, tmp);
+    }
+
+    return buf;
+}
+
+// Copy count consecutive pixels to or from the temporary buffer with nch
+// channels per pixel, which are the RGB components followed by alpha, if any.
+//
+// If premultiply is true and the image has alpha, the buffer contains the
+// colour components multiplied by alpha and alpha itself multiplied by 255,
+// so that all channels use the same scale and the averages of a uniform
+// colour remain exactly proportional to the averages of alpha.
+void
+LoadPixels(const unsigned char* rgb, const unsigned char* alpha,
+           int count, int nch, bool premultiply, int* buf)
+{
+    if ( alpha && premultiply )
+    {
+        for ( int x = 0; x < count; x++, rgb += 3, buf += nch )
+        {
+            const int a = alpha[x];
+            buf[0] = rgb[0]*a;
+            buf[1] = rgb[1]*a;
+            buf[2] = rgb[2]*a;
+            buf[3] = a*255;
+        }
+
+        return;
+    }
+
+    for ( int x = 0; x < count; x++, rgb += 3, buf += nch )
+    {
+        buf[0] = rgb[0];
+        buf[1] = rgb[1];
+        buf[2] = rgb[2];
+        if ( alpha )
+            buf[3] = alpha[x];
+    }
+}
+
+void
+StorePixels(const int* buf, int count, int nch, bool premultiply,
+            unsigned char* rgb, unsigned char* alpha)
+{
+    if ( alpha && premultiply )
+    {
+        for ( int x = 0; x < count; x++, rgb += 3, buf += nch )
+        {
+            const unsigned a = buf[3];
+            for ( int c = 0; c < 3; c++ )
             {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
+                rgb[c] = a ? static_cast<unsigned char>(
+                                wxMin((buf[c]*255u + a/2) / a, 255u))
+                           : 0;
             }
-            dst_data += 3;
+
+            alpha[x] = static_cast<unsigned char>((a + 127) / 255);
         }
+
+        return;
     }
 
-    return ret_image;
+    for ( int x = 0; x < count; x++, rgb += 3, buf += nch )
+    {
+        rgb[0] = static_cast<unsigned char>(buf[0]);
+        rgb[1] = static_cast<unsigned char>(buf[1]);
+        rgb[2] = static_cast<unsigned char>(buf[2]);
+        if ( alpha )
+            alpha[x] = static_cast<unsigned char>(buf[3]);
+    }
+}
+
+// Blur the image in place in the horizontal direction: this only needs a
+// temporary buffer for a single row (per thread).
+void BoxBlurRows(wxImage& image, const BoxBlurParams& params)
+{
+    const int width = image.GetWidth();
+    unsigned char* const data = image.GetData();
+    unsigned char* const alpha = image.GetAlpha();
+    const int nch = alpha ? 4 : 3;
+
+    ForEachRange(image.GetHeight(), width, [=, &params](int yFrom, int yTo)
+    {
+        wxVector<int> buf(width*nch),
+                      tmp(width*nch);
+
+        for ( int y = yFrom; y < yTo; y++ )
+        {
+            const size_t offset = static_cast<size_t>(y)*width;
+            unsigned char* const rgbRow = data + 3*offset;
+            unsigned char* const alphaRow = alpha ? alpha + offset : nullptr;
+
+            LoadPixels(rgbRow, alphaRow, width, nch, params.premultiply,
+                       &buf[0]);
+
+            const int* const res = BoxBlurLines(&buf[0], &tmp[0], 1, 0,
+                                                width, nch, nch, params);
+
+            StorePixels(res, width, nch, params.premultiply, rgbRow, alphaRow);
+        }
+    });
+}
+
+// Blur the image in place in the vertical direction: this is done for the
+// tiles of BLUR_TILE_WIDTH columns at once, so that the memory is accessed
+// sequentially, and only needs a buffer for a single tile (per thread).
+void BoxBlurColumns(wxImage& image, const BoxBlurParams& params)
+{
+    const int width = image.GetWidth();
+    const int height = image.GetHeight();
+    unsigned char* const data = image.GetData();
+    unsigned char* const alpha = image.GetAlpha();
+    const int nch = alpha ? 4 : 3;
+
+    const int numTiles = (width + BLUR_TILE_WIDTH - 1) / BLUR_TILE_WIDTH;
+
+    ForEachRange(numTiles, BLUR_TILE_WIDTH*height,
+                 [=, &params](int tileFrom, int tileTo)
+    {
+        wxVector<int> buf(BLUR_TILE_WIDTH*nch*height),
+                      tmp(BLUR_TILE_WIDTH*nch*height);
+
+        for ( int tile = tileFrom; tile < tileTo; tile++ )
+        {
+            const int x0 = tile*BLUR_TILE_WIDTH;
+            const int tileWidth = wxMin(BLUR_TILE_WIDTH, width - x0);
+            const int lineSize = tileWidth*nch;
+
+            for ( int y = 0; y < height; y++ )
+            {
+                const size_t offset = static_cast<size_t>(y)*width + x0;
+                LoadPixels(data + 3*offset, alpha ? alpha + offset : nullptr,
+                           tileWidth, nch, params.premultiply,
+                           &buf[y*lineSize]);
+            }
+
+            // Each column of the tile is a "line" for the box filter here.
+            const int* const res = BoxBlurLines(&buf[0], &tmp[0],
+                                                tileWidth, nch,
+                                                height, nch, lineSize,
+                                                params);
+
+            for ( int y = 0; y < height; y++ )
+            {
+                const size_t offset = static_cast<size_t>(y)*width + x0;
+                StorePixels(res + y*lineSize, tileWidth, nch, params.premultiply,
+                            data + 3*offset, alpha ? alpha + offset : nullptr);
+            }
+        }
+    });
+}
+
+// Parameters used by the original blur functions: a single box filter pass
+// truncating the averages.
+BoxBlurParams MakeSimpleBlurParams(int blurRadius)
+{
+    BoxBlurParams params;
+    params.radii[0] = blurRadius;
+    params.numPasses = 1;
+    params.round = false;
+    params.premultiply = false;
+    return params;
+}
+
+// Parameters approximating Gaussian blur with the given standard deviation
+// by successive box filter passes, see "Fast Almost-Gaussian Filtering" by
+// Peter Kovesi for the explanation of the formulas used here.
+BoxBlurParams MakeGaussianBlurParams(double sigma)
+{
+    const int n = MAX_BOX_PASSES;
+
+    // Ideal width of the box filter, if we could use the same (odd) width for
+    // all passes, and the largest odd width not greater than it.
+    const double wIdeal = sqrt(12*sigma*sigma/n + 1);
+    int wl = static_cast<int>(floor(wIdeal));
+    if ( wl % 2 == 0 )
+        wl--;
+
+    // Number of passes using wl, the remaining ones use wl + 2.
+    const double mIdeal = (12*sigma*sigma - n*wl*wl - 4*n*wl - 3*n)/(-4*wl - 4);
+    const int m = wxRound(mIdeal);
+
+    BoxBlurParams params;
+    for ( int i = 0; i < n; i++ )
+        params.radii[i] = (i < m ? wl - 1 : wl + 1) / 2;
+    params.numPasses = n;
+    params.round = true;
+    params.premultiply = true;
+    return params;
+}
+
+// Copy the pixel values of the image of the same size.
+void CopyPixels(const wxImage& src, wxImage& dst)
+{
+    const size_t numPixels = static_cast<size_t>(src.GetWidth())*src.GetHeight();
+
+    memcpy(dst.GetData(), src.GetData(), 3*numPixels);
+    if ( src.HasAlpha() )
+        memcpy(dst.GetAlpha(), src.GetAlpha(), numPixels);
 }
 
+} // anonymous namespace
+
 // Blur in the horizontal direction
 wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
@@ -1122,216 +2041,74 @@ wxImage wxImage::BlurHorizontal(int blurRadius) const
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+    CopyPixels(*this, ret_image);
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
+    BoxBlurRows(ret_image, MakeSimpleBlurParams(blurRadius));
 
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+    return ret_image;
+}
 
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+// Blur in the vertical direction
+wxImage wxImage::BlurVertical(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
 
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+    wxCHECK( ret_image.IsOk(), ret_image );
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    CopyPixels(*this, ret_image);
 
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    BoxBlurColumns(ret_image, MakeSimpleBlurParams(blurRadius));
 
     return ret_image;
 }
 
-// Blur in the vertical direction
-wxImage wxImage::BlurVertical(int blurRadius) const
+// The new blur function
+wxImage wxImage::Blur(int blurRadius) const
 {
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
+    CopyPixels(*this, ret_image);
 
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
+    // Blur the image in each direction, modifying it in place.
+    const BoxBlurParams params = MakeSimpleBlurParams(blurRadius);
+    BoxBlurRows(ret_image, params);
+    BoxBlurColumns(ret_image, params);
 
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
+    return ret_image;
+}
 
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+wxImage wxImage::GaussianBlur(double sigma) const
+{
+    wxImage ret_image(MakeEmptyClone());
 
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+    wxCHECK( ret_image.IsOk(), ret_image );
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    CopyPixels(*this, ret_image);
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    ret_image.GaussianBlurInPlace(sigma);
 
     return ret_image;
 }
 
-// The new blur function
-wxImage wxImage::Blur(int blurRadius) const
+void wxImage::GaussianBlurInPlace(double sigma)
 {
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+    wxCHECK_RET( IsOk(), wxS("invalid image") );
 
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+    if ( sigma <= 0 )
+        return;
 
-    return ret_image;
+    // Blurring with larger sigma would result in (almost) uniform colour
+    // anyhow, so limit it to avoid overflows in MakeGaussianBlurParams().
+    sigma = wxMin(sigma, static_cast<double>(wxMax(M_IMGDATA->m_width,
+                                                   M_IMGDATA->m_height)));
+
+    AllocExclusive();
+
+    const BoxBlurParams params = MakeGaussianBlurParams(sigma);
+    BoxBlurRows(*this, params);
+    BoxBlurColumns(*this, params);
 }
 
 wxImage wxImage::Rotate90( bool clockwise ) const
@@ -1951,21 +2728,21 @@ int wxImage::GetWidth() const
 {
     wxCHECK_MSG( IsOk(), 0, wxT("invalid image") );
 
-    return M_IMGDATA->m_width;
+    return M_IMGINFO->m_width;
 }
 
 int wxImage::GetHeight() const
 {
     wxCHECK_MSG( IsOk(), 0, wxT("invalid image") );
 
-    return M_IMGDATA->m_height;
+    return M_IMGINFO->m_height;
 }
 
 wxBitmapType wxImage::GetType() const
 {
     wxCHECK_MSG( IsOk(), wxBITMAP_TYPE_INVALID, wxT("invalid image") );
 
-    return M_IMGDATA->m_type;
+    return M_IMGINFO->m_type;
 }
 
 void wxImage::SetType(wxBitmapType type)
@@ -1975,16 +2752,16 @@ void wxImage::SetType(wxBitmapType type)
     // type can be wxBITMAP_TYPE_INVALID to reset the image type to default
     wxASSERT_MSG( type != wxBITMAP_TYPE_MAX, "invalid bitmap type" );
 
-    M_IMGDATA->m_type = type;
+    M_IMGINFO->m_type = type;
 }
 
 long wxImage::XYToIndex(int x, int y) const
 {
     if ( IsOk() &&
             x >= 0 && y >= 0 &&
-                x < M_IMGDATA->m_width && y < M_IMGDATA->m_height )
+                x < M_IMGINFO->m_width && y < M_IMGINFO->m_height )
     {
-        return y*M_IMGDATA->m_width + x;
+        return y*M_IMGINFO->m_width + x;
     }
 
     return -1;
@@ -2076,7 +2853,7 @@ bool wxImage::IsOk() const
 {
     // image of 0 width or height can't be considered ok - at least because it
     // causes crashes in ConvertToBitmap() if we don't catch it in time
-    wxImageRefData *data = M_IMGDATA;
+    wxImageRefData *data = M_IMGINFO;
     return data && data->m_ok && data->m_width && data->m_height;
 }
 
@@ -2143,27 +2920,20 @@ void wxImage::SetDataRGBA(const unsigned char* data)
 
     wxImageRefData* newRefData = new wxImageRefData();
 
-    newRefData->m_width = M_IMGDATA->m_width;
-    newRefData->m_height = M_IMGDATA->m_height;
-
-    size_t pixel_count = (size_t)newRefData->m_width * (size_t)newRefData->m_height;
-    newRefData->m_data = (unsigned char*)malloc(3 * pixel_count);
-    newRefData->m_alpha = (unsigned char*)malloc(pixel_count);
+    newRefData->m_width = M_IMGINFO->m_width;
+    newRefData->m_height = M_IMGINFO->m_height;
 
-    size_t rgba_index = 0, rgb_index = 0, alpha_index = 0;
-    for (size_t pixel_counter = 0; pixel_counter < pixel_count; pixel_counter++)
-    {
-        newRefData->m_data[rgb_index++] = data[rgba_index++]; // R
-        newRefData->m_data[rgb_index++] = data[rgba_index++]; // G
-        newRefData->m_data[rgb_index++] = data[rgba_index++]; // B
-        newRefData->m_alpha[alpha_index++] = data[rgba_index++]; // A
-    }
+    // Just keep the data in the same format, it will be converted to RGB and
+    // alpha planes only if (and when) needed.
+    size_t size = 4 * (size_t)newRefData->m_width * (size_t)newRefData->m_height;
+    newRefData->m_rgba = (unsigned char*)malloc(size);
+    memcpy(newRefData->m_rgba, data, size);
 
     newRefData->m_ok = true;
-    newRefData->m_maskRed = M_IMGDATA->m_maskRed;
-    newRefData->m_maskGreen = M_IMGDATA->m_maskGreen;
-    newRefData->m_maskBlue = M_IMGDATA->m_maskBlue;
-    newRefData->m_hasMask = M_IMGDATA->m_hasMask;
+    newRefData->m_maskRed = M_IMGINFO->m_maskRed;
+    newRefData->m_maskGreen = M_IMGINFO->m_maskGreen;
+    newRefData->m_maskBlue = M_IMGINFO->m_maskBlue;
+    newRefData->m_hasMask = M_IMGINFO->m_hasMask;
     newRefData->m_static = false;
     newRefData->m_staticAlpha = false;
 
@@ -2172,6 +2942,28 @@ void wxImage::SetDataRGBA(const unsigned char* data)
     m_refData = newRefData;
 }
 
+const unsigned char* wxImage::GetDataRGBA()
+{
+    wxCHECK_MSG( HasAlpha(), nullptr, wxT("image must have alpha") );
+
+    if ( !M_IMGINFO->IsPacked() )
+    {
+        // Converting the storage frees the planar data and updates m_rgba,
+        // which may still be used by the other images sharing them, so make
+        // a copy first.
+        AllocExclusive();
+
+        M_IMGINFO->PackRGBA();
+    }
+
+    return M_IMGINFO->m_rgba;
+}
+
+bool wxImage::HasRGBAStorage() const
+{
+    return IsOk() && M_IMGINFO->IsPacked();
+}
+
 // ----------------------------------------------------------------------------
 // alpha channel support
 // ----------------------------------------------------------------------------
@@ -2248,6 +3040,14 @@ unsigned char *wxImage::GetAlpha() const
     return M_IMGDATA->m_alpha;
 }
 
+bool wxImage::HasAlpha() const
+{
+    wxCHECK_MSG( IsOk(), false, wxT("invalid image") );
+
+    // Check for the packed data first, m_alpha may be being created from it.
+    return M_IMGINFO->IsPacked() || M_IMGINFO->m_alpha;
+}
+
 void wxImage::InitAlpha()
 {
     wxCHECK_RET( IsOk(), wxT("invalid image") );
@@ -2309,10 +3109,10 @@ void wxImage::SetMaskColour( unsigned char r, unsigned char g, unsigned char b )
 
     AllocExclusive();
 
-    M_IMGDATA->m_maskRed = r;
-    M_IMGDATA->m_maskGreen = g;
-    M_IMGDATA->m_maskBlue = b;
-    M_IMGDATA->m_hasMask = true;
+    M_IMGINFO->m_maskRed = r;
+    M_IMGINFO->m_maskGreen = g;
+    M_IMGINFO->m_maskBlue = b;
+    M_IMGINFO->m_hasMask = true;
 }
 
 bool wxImage::GetOrFindMaskColour( unsigned char *r, unsigned char *g, unsigned char *b ) const
@@ -2337,21 +3137,21 @@ unsigned char wxImage::GetMaskRed() const
 {
     wxCHECK_MSG( IsOk(), 0, wxT("invalid image") );
 
-    return M_IMGDATA->m_maskRed;
+    return M_IMGINFO->m_maskRed;
 }
 
 unsigned char wxImage::GetMaskGreen() const
 {
     wxCHECK_MSG( IsOk(), 0, wxT("invalid image") );
 
-    return M_IMGDATA->m_maskGreen;
+    return M_IMGINFO->m_maskGreen;
 }
 
 unsigned char wxImage::GetMaskBlue() const
 {
     wxCHECK_MSG( IsOk(), 0, wxT("invalid image") );
 
-    return M_IMGDATA->m_maskBlue;
+    return M_IMGINFO->m_maskBlue;
 }
 
 void wxImage::SetMask( bool mask )
@@ -2360,14 +3160,14 @@ void wxImage::SetMask( bool mask )
 
     AllocExclusive();
 
-    M_IMGDATA->m_hasMask = mask;
+    M_IMGINFO->m_hasMask = mask;
 }
 
 bool wxImage::HasMask() const
 {
     wxCHECK_MSG( IsOk(), false, wxT("invalid image") );
 
-    return M_IMGDATA->m_hasMask;
+    return M_IMGINFO->m_hasMask;
 }
 
 bool wxImage::IsTransparent(int x, int y, unsigned char threshold) const
@@ -2515,14 +3315,14 @@ bool wxImage::HasPalette() const
     if (!IsOk())
         return false;
 
-    return M_IMGDATA->m_palette.IsOk();
+    return M_IMGINFO->m_palette.IsOk();
 }
 
 const wxPalette& wxImage::GetPalette() const
 {
     wxCHECK_MSG( IsOk(), wxNullPalette, wxT("invalid image") );
 
-    return M_IMGDATA->m_palette;
+    return M_IMGINFO->m_palette;
 }
 
 void wxImage::SetPalette(const wxPalette& palette)
@@ -2531,7 +3331,7 @@ void wxImage::SetPalette(const wxPalette& palette)
 
     AllocExclusive();
 
-    M_IMGDATA->m_palette = palette;
+    M_IMGINFO->m_palette = palette;
 }
 
 #endif // wxUSE_PALETTE
@@ -2544,16 +3344,16 @@ void wxImage::SetOption(const wxString& name, const wxString& value)
 {
     AllocExclusive();
 
-    int idx = M_IMGDATA->m_optionNames.Index(name, false);
+    int idx = M_IMGINFO->m_optionNames.Index(name, false);
     if ( idx == wxNOT_FOUND )
     {
-        M_IMGDATA->m_optionNames.Add(name);
-        M_IMGDATA->m_optionValues.Add(value);
+        M_IMGINFO->m_optionNames.Add(name);
+        M_IMGINFO->m_optionValues.Add(value);
     }
     else
     {
-        M_IMGDATA->m_optionNames[idx] = name;
-        M_IMGDATA->m_optionValues[idx] = value;
+        M_IMGINFO->m_optionNames[idx] = name;
+        M_IMGINFO->m_optionValues[idx] = value;
     }
 }
 
@@ -2566,14 +3366,14 @@ void wxImage::SetOption(const wxString& name, int value)
 
 wxString wxImage::GetOption(const wxString& name) const
 {
-    if ( !M_IMGDATA )
+    if ( !M_IMGINFO )
         return wxEmptyString;
 
-    int idx = M_IMGDATA->m_optionNames.Index(name, false);
+    int idx = M_IMGINFO->m_optionNames.Index(name, false);
     if ( idx == wxNOT_FOUND )
         return wxEmptyString;
     else
-        return M_IMGDATA->m_optionValues[idx];
+        return M_IMGINFO->m_optionValues[idx];
 }
 
 int wxImage::GetOptionInt(const wxString& name) const
@@ -2583,7 +3383,7 @@ int wxImage::GetOptionInt(const wxString& name) const
 
 bool wxImage::HasOption(const wxString& name) const
 {
-    return M_IMGDATA ? M_IMGDATA->m_optionNames.Index(name, false) != wxNOT_FOUND
+    return M_IMGINFO ? M_IMGINFO->m_optionNames.Index(name, false) != wxNOT_FOUND
                      : false;
 }
 
@@ -2603,16 +3403,28 @@ int wxImage::GetDefaultLoadFlags()
     return wxImageRefData::sm_defaultLoadFlags;
 }
 
+/* static */
+void wxImage::SetMaxThreads(int threads)
+{
+    gs_imageMaxThreads = threads;
+}
+
+/* static */
+int wxImage::GetMaxThreads()
+{
+    return gs_imageMaxThreads;
+}
+
 void wxImage::SetLoadFlags(int flags)
 {
     AllocExclusive();
 
-    M_IMGDATA->m_loadFlags = flags;
+    M_IMGINFO->m_loadFlags = flags;
 }
 
 int wxImage::GetLoadFlags() const
 {
-    return M_IMGDATA ? M_IMGDATA->m_loadFlags : wxImageRefData::sm_defaultLoadFlags;
+    return M_IMGINFO ? M_IMGINFO->m_loadFlags : wxImageRefData::sm_defaultLoadFlags;
 }
 
 // Under Windows we can load wxImage not only from files but also from
@@ -2889,12 +3701,179 @@ int wxImage::GetImageCount( wxInputStream &stream, wxBitmapType type )
     }
 }
 
+// ----------------------------------------------------------------------------
+// wxImageLoadParams
+// ----------------------------------------------------------------------------
+
+wxImageLoadParams::wxImageLoadParams(const wxImage& image)
+{
+    m_maxWidth = image.GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH);
+    m_maxHeight = image.GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+
+    m_hasRegion = image.HasOption(wxIMAGE_OPTION_REGION_X) ||
+                    image.HasOption(wxIMAGE_OPTION_REGION_Y) ||
+                        image.HasOption(wxIMAGE_OPTION_REGION_WIDTH) ||
+                            image.HasOption(wxIMAGE_OPTION_REGION_HEIGHT);
+    if ( m_hasRegion )
+    {
+        m_region.x = image.GetOptionInt(wxIMAGE_OPTION_REGION_X);
+        m_region.y = image.GetOptionInt(wxIMAGE_OPTION_REGION_Y);
+        m_region.width = image.GetOptionInt(wxIMAGE_OPTION_REGION_WIDTH);
+        m_region.height = image.GetOptionInt(wxIMAGE_OPTION_REGION_HEIGHT);
+    }
+}
+
+void wxImageLoadParams::SetImageSize(int width, int height)
+{
+    m_size.Set(width, height);
+
+    const wxRect all(m_size);
+    if ( m_hasRegion )
+    {
+        // Zero width or height means that the region extends up to the edge.
+        if ( !m_region.width )
+            m_region.width = width - m_region.x;
+        if ( !m_region.height )
+            m_region.height = height - m_region.y;
+
+        m_region.Intersect(all);
+        if ( m_region.IsEmpty() )
+            m_region = all;
+    }
+    else
+    {
+        m_region = all;
+    }
+
+    // Use the smallest power of 2 making the output image fit.
+    m_scale = 1;
+    while ( (m_maxWidth && unsigned(GetOutputWidth()) > m_maxWidth) ||
+                (m_maxHeight && unsigned(GetOutputHeight()) > m_maxHeight) )
+    {
+        m_scale *= 2;
+    }
+}
+
+void wxImageLoadParams::SetOriginalSize(wxImage* image) const
+{
+    if ( IsNeeded() )
+    {
+        image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, m_size.x);
+        image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, m_size.y);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// wxImageRowAccumulator
+// ----------------------------------------------------------------------------
+
+wxImageRowAccumulator::wxImageRowAccumulator(wxImage* image,
+                                             const wxImageLoadParams& params)
+    : m_data(image->GetData()),
+      m_alpha(image->GetAlpha()),
+      m_width(image->GetWidth()),
+      m_regionWidth(params.GetRegion().width),
+      m_scale(params.GetScale()),
+      m_rowsLeft(params.GetRegion().height)
+{
+    wxASSERT_MSG( m_width == params.GetOutputWidth() &&
+                  image->GetHeight() == params.GetOutputHeight(),
+                  "image must have the output size" );
+
+    if ( m_scale != 1 )
+        m_sums.resize(4*m_width);
+}
+
+void wxImageRowAccumulator::AddRow(const unsigned char* rgb, int bytesPerPixel)
+{
+    wxCHECK_RET( m_rowsLeft > 0, "too many rows" );
+
+    const bool hasAlpha = bytesPerPixel == 4;
+
+    if ( m_scale == 1 )
+    {
+        // Just copy the data directly.
+        for ( int x = 0; x < m_width; x++, rgb += bytesPerPixel )
+        {
+            *m_data++ = rgb[0];
+            *m_data++ = rgb[1];
+            *m_data++ = rgb[2];
+
+            const unsigned char a = hasAlpha ? rgb[3] : 0xff;
+            if ( a != 0xff )
+                m_hasTransparency = true;
+
+            if ( m_alpha )
+                *m_alpha++ = a;
+        }
+
+        m_rowsLeft--;
+        return;
+    }
+
+    // Accumulate the colours premultiplied by alpha, so that transparent
+    // pixels don't affect the result, and alpha itself.
+    for ( int x = 0; x < m_regionWidth; x++, rgb += bytesPerPixel )
+    {
+        const unsigned a = hasAlpha ? rgb[3] : 0xff;
+        if ( a != 0xff )
+            m_hasTransparency = true;
+
+        wxUint64* const sums = &m_sums[4*(x / m_scale)];
+        sums[0] += rgb[0]*a;
+        sums[1] += rgb[1]*a;
+        sums[2] += rgb[2]*a;
+        sums[3] += a;
+    }
+
+    m_rowsLeft--;
+    if ( ++m_rows == m_scale || !m_rowsLeft )
+        FlushRow();
+}
+
+void wxImageRowAccumulator::FlushRow()
+{
+    for ( int x = 0; x < m_width; x++ )
+    {
+        wxUint64* const sums = &m_sums[4*x];
+
+        // The last block may be incomplete.
+        const int cols = wxMin(m_scale, m_regionWidth - x*m_scale);
+        const wxUint64 count = static_cast<wxUint64>(cols)*m_rows;
+
+        const wxUint64 sumA = sums[3];
+        for ( int c = 0; c < 3; c++ )
+        {
+            *m_data++ = sumA ? static_cast<unsigned char>((sums[c] + sumA/2) / sumA)
+                             : 0;
+        }
+
+        if ( m_alpha )
+            *m_alpha++ = static_cast<unsigned char>((sumA + count/2) / count);
+
+        sums[0] =
+        sums[1] =
+        sums[2] =
+        sums[3] = 0;
+    }
+
+    m_rows = 0;
+}
+
+// ----------------------------------------------------------------------------
+// loading images
+// ----------------------------------------------------------------------------
+
 bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
 {
     // save the options values which can be clobbered by the handler (e.g. many
     // of them call Destroy() before trying to load the file)
     const unsigned maxWidth = GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
                    maxHeight = GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+    wxImageLoadParams params(*this);
+
+    // the load flags are reset by Destroy() too
+    const int loadFlags = GetLoadFlags();
 
     // Preserve the original stream position if possible to rewind back to it
     // if we failed to load the file -- maybe the next handler that we try can
@@ -2904,7 +3883,7 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
         posOld = stream.TellI();
 
     if ( !handler.LoadFile(this, stream,
-                           (M_IMGDATA->m_loadFlags & Load_Verbose) != 0, index) )
+                           (loadFlags & Load_Verbose) != 0, index) )
     {
         if ( posOld != wxInvalidOffset )
             stream.SeekI(posOld);
@@ -2912,6 +3891,38 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
         return false;
     }
 
+    // crop the image to the specified region if the handler didn't do it
+    // (handlers doing it set the original size options)
+    if ( params.HasRegion() && !HasOption(wxIMAGE_OPTION_ORIGINAL_WIDTH) )
+    {
+        const int widthOrig = GetWidth(),
+                  heightOrig = GetHeight();
+
+        params.SetImageSize(widthOrig, heightOrig);
+
+        const wxRect& region = params.GetRegion();
+        if ( region.GetSize() != GetSize() )
+        {
+            // GetSubImage() doesn't copy the options, but we need to preserve
+            // those set by the handler, e.g. the resolution, as well as the
+            // original load flags.
+            wxImage cropped = GetSubImage(region);
+            wxImageRefData* const
+                refCropped = static_cast<wxImageRefData*>(cropped.m_refData);
+            refCropped->m_optionNames = M_IMGINFO->m_optionNames;
+            refCropped->m_optionValues = M_IMGINFO->m_optionValues;
+            refCropped->m_loadFlags = loadFlags;
+#if wxUSE_PALETTE
+            refCropped->m_palette = M_IMGINFO->m_palette;
+#endif // wxUSE_PALETTE
+
+            *this = cropped;
+
+            SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, widthOrig);
+            SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, heightOrig);
+        }
+    }
+
     // rescale the image to the specified size if needed
     if ( maxWidth || maxHeight )
     {
@@ -2942,8 +3953,9 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
         }
     }
 
-    // Set this after Rescale, which currently does not preserve it
-    M_IMGDATA->m_type = handler.GetType();
+    // Set these after Rescale, which currently does not preserve them
+    M_IMGINFO->m_type = handler.GetType();
+    M_IMGINFO->m_loadFlags = loadFlags;
 
     return true;
 }
@@ -3730,11 +4742,12 @@ wxImage wxImage::Rotate(double angle,
         *offset_after_rotation = wxPoint (x1a, y1a);
     }
 
-    // the rotated (destination) image is always accessed sequentially via this
-    // pointer, there is no need for pointer-based arrays here
-    unsigned char *dst = rotated.GetData();
+    // the rotated (destination) image is always accessed sequentially (inside
+    // each range of rows processed by ForEachRange() below), there is no need
+    // for pointer-based arrays here
+    unsigned char* const dst_data = rotated.GetData();
 
-    unsigned char *alpha_dst = has_alpha ? rotated.GetAlpha() : nullptr;
+    unsigned char* const dst_alpha = has_alpha ? rotated.GetAlpha() : nullptr;
 
     // if the original image has a mask, use its RGB values as the blank pixel,
     // else, fall back to default (black).
@@ -3761,183 +4774,197 @@ wxImage wxImage::Rotate(double angle,
     // only once, instead of repeating it for each pixel.
     if (interpolating)
     {
-        for (int y = 0; y < rH; y++)
+        ForEachRange(rH, rW, [&](int yFrom, int yTo)
         {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+            unsigned char* dst = dst_data + yFrom * rW * 3;
+            unsigned char* alpha_dst = has_alpha ? dst_alpha + yFrom * rW
+                                                 : nullptr;
 
-                if (-0.25 < src.x && src.x < w - 0.75 &&
-                    -0.25 < src.y && src.y < h - 0.75)
+            for (int y = yFrom; y < yTo; y++)
+            {
+                for (int x = 0; x < rW; x++)
                 {
-                    // interpolate using the 4 enclosing grid-points.  Those
-                    // points can be obtained using floor and ceiling of the
-                    // exact coordinates of the point
-                    int x1, y1, x2, y2;
+                    wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
 
-                    if (0 < src.x && src.x < w - 1)
-                    {
-                        x1 = (int) floor(src.x);
-                        x2 = (int) ceil(src.x);
-                    }
-                    else    // else means that x is near one of the borders (0 or width-1)
+                    if (-0.25 < src.x && src.x < w - 0.75 &&
+                        -0.25 < src.y && src.y < h - 0.75)
                     {
-                        x1 = x2 = wxRound (src.x);
-                    }
+                        // interpolate using the 4 enclosing grid-points.  Those
+                        // points can be obtained using floor and ceiling of the
+                        // exact coordinates of the point
+                        int x1, y1, x2, y2;
 
-                    if (0 < src.y && src.y < h - 1)
-                    {
-                        y1 = (int) floor(src.y);
-                        y2 = (int) ceil(src.y);
-                    }
-                    else
-                    {
-                        y1 = y2 = wxRound (src.y);
-                    }
+                        if (0 < src.x && src.x < w - 1)
+                        {
+                            x1 = (int) floor(src.x);
+                            x2 = (int) ceil(src.x);
+                        }
+                        else    // else means that x is near one of the borders (0 or width-1)
+                        {
+                            x1 = x2 = wxRound (src.x);
+                        }
 
-                    // get four points and the distances (square of the distance,
-                    // for efficiency reasons) for the interpolation formula
+                        if (0 < src.y && src.y < h - 1)
+                        {
+                            y1 = (int) floor(src.y);
+                            y2 = (int) ceil(src.y);
+                        }
+                        else
+                        {
+                            y1 = y2 = wxRound (src.y);
+                        }
 
-                    // GRG: Do not calculate the points until they are
-                    //      really needed -- this way we can calculate
-                    //      just one, instead of four, if d1, d2, d3
-                    //      or d4 are < wxROTATE_EPSILON
+                        // get four points and the distances (square of the distance,
+                        // for efficiency reasons) for the interpolation formula
 
-                    const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
-                    const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
-                    const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
-                    const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
+                        // GRG: Do not calculate the points until they are
+                        //      really needed -- this way we can calculate
+                        //      just one, instead of four, if d1, d2, d3
+                        //      or d4 are < wxROTATE_EPSILON
 
-                    // Now interpolate as a weighted average of the four surrounding
-                    // points, where the weights are the distances to each of those points
+                        const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
+                        const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
+                        const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
+                        const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
 
-                    // If the point is exactly at one point of the grid of the source
-                    // image, then don't interpolate -- just assign the pixel
+                        // Now interpolate as a weighted average of the four surrounding
+                        // points, where the weights are the distances to each of those points
 
-                    // d1,d2,d3,d4 are positive -- no need for abs()
-                    if (d1 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        // If the point is exactly at one point of the grid of the source
+                        // image, then don't interpolate -- just assign the pixel
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x1);
-                    }
-                    else if (d2 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                        // d1,d2,d3,d4 are positive -- no need for abs()
+                        if (d1 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y1] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x2);
-                    }
-                    else if (d3 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y1] + x1);
+                        }
+                        else if (d2 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y1] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x2);
-                    }
-                    else if (d4 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y1] + x2);
+                        }
+                        else if (d3 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y2] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x1);
-                    }
-                    else
-                    {
-                        // weights for the weighted average are proportional to the inverse of the distance
-                        unsigned char *v1 = data[y1] + (3 * x1);
-                        unsigned char *v2 = data[y1] + (3 * x2);
-                        unsigned char *v3 = data[y2] + (3 * x2);
-                        unsigned char *v4 = data[y2] + (3 * x1);
-
-                        const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
-
-                        // GRG: Unrolled.
-
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *v1 + w2 * *v2 +
-                               w3 * *v3 + w4 * *v4) /
-                              (w1 + w2 + w3 + w4) );
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y2] + x2);
+                        }
+                        else if (d4 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = data[y2] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
 
-                        if (has_alpha)
+                            if (has_alpha)
+                                *(alpha_dst++) = *(alpha[y2] + x1);
+                        }
+                        else
                         {
-                            v1 = alpha[y1] + (x1);
-                            v2 = alpha[y1] + (x2);
-                            v3 = alpha[y2] + (x2);
-                            v4 = alpha[y2] + (x1);
+                            // weights for the weighted average are proportional to the inverse of the distance
+                            unsigned char *v1 = data[y1] + (3 * x1);
+                            unsigned char *v2 = data[y1] + (3 * x2);
+                            unsigned char *v3 = data[y2] + (3 * x2);
+                            unsigned char *v4 = data[y2] + (3 * x1);
+
+                            const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
 
-                            *(alpha_dst++) = (unsigned char)
+                            // GRG: Unrolled.
+
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
                                 ( (w1 * *v1 + w2 * *v2 +
                                    w3 * *v3 + w4 * *v4) /
                                   (w1 + w2 + w3 + w4) );
+
+                            if (has_alpha)
+                            {
+                                v1 = alpha[y1] + (x1);
+                                v2 = alpha[y1] + (x2);
+                                v3 = alpha[y2] + (x2);
+                                v4 = alpha[y2] + (x1);
+
+                                *(alpha_dst++) = (unsigned char)
+                                    ( (w1 * *v1 + w2 * *v2 +
+                                       w3 * *v3 + w4 * *v4) /
+                                      (w1 + w2 + w3 + w4) );
+                            }
                         }
                     }
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+                    else
+                    {
+                        *(dst++) = blank_r;
+                        *(dst++) = blank_g;
+                        *(dst++) = blank_b;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = 0;
+                        if (has_alpha)
+                            *(alpha_dst++) = 0;
+                    }
                 }
             }
-        }
+        });
     }
     else // not interpolating
     {
-        for (int y = 0; y < rH; y++)
+        ForEachRange(rH, rW, [&](int yFrom, int yTo)
         {
-            for (int x = 0; x < rW; x++)
+            unsigned char* dst = dst_data + yFrom * rW * 3;
+            unsigned char* alpha_dst = has_alpha ? dst_alpha + yFrom * rW
+                                                 : nullptr;
+
+            for (int y = yFrom; y < yTo; y++)
             {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+                for (int x = 0; x < rW; x++)
+                {
+                    wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
 
-                const int xs = wxRound (src.x);      // wxRound rounds to the
-                const int ys = wxRound (src.y);      // closest integer
+                    const int xs = wxRound (src.x);      // wxRound rounds to the
+                    const int ys = wxRound (src.y);      // closest integer
 
-                if (0 <= xs && xs < w && 0 <= ys && ys < h)
-                {
-                    unsigned char *p = data[ys] + (3 * xs);
-                    *(dst++) = *(p++);
-                    *(dst++) = *(p++);
-                    *(dst++) = *p;
+                    if (0 <= xs && xs < w && 0 <= ys && ys < h)
+                    {
+                        unsigned char *p = data[ys] + (3 * xs);
+                        *(dst++) = *(p++);
+                        *(dst++) = *(p++);
+                        *(dst++) = *p;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = *(alpha[ys] + (xs));
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+                        if (has_alpha)
+                            *(alpha_dst++) = *(alpha[ys] + (xs));
+                    }
+                    else
+                    {
+                        *(dst++) = blank_r;
+                        *(dst++) = blank_g;
+                        *(dst++) = blank_b;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = 255;
+                        if (has_alpha)
+                            *(alpha_dst++) = 255;
+                    }
                 }
             }
-        }
+        });
     }
 
     delete [] data;
@@ -3952,13 +4979,16 @@ void wxImage::ApplyToAllPixels(const F& func)
 {
     AllocExclusive();
 
-    const size_t size = GetWidth() * GetHeight();
-    unsigned char *data = GetData();
+    unsigned char* const data = GetData();
 
-    for ( size_t i = 0; i < size; i++, data += 3 )
+    ForEachRange(GetWidth() * GetHeight(), 1, [data, &func](int from, int to)
     {
-        func(data);
-    }
+        unsigned char* rgb = data + 3 * static_cast<size_t>(from);
+        for ( int i = from; i < to; i++, rgb += 3 )
+        {
+            func(rgb);
+        }
+    });
 }
 
 // A module to allow wxImage initialization/cleanup
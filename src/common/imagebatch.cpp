@@ -0,0 +1,414 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/imagebatch.cpp
+// Purpose:     wxImageBatchLoader implementation
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+
+#if wxUSE_IMAGE && wxUSE_STREAMS
+
+#include "wx/imagebatch.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/intl.h"
+    #include "wx/log.h"
+#endif
+
+#include "wx/stream.h"
+#include "wx/thread.h"
+
+#include "wx/private/threadpool.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+wxDEFINE_EVENT(wxEVT_IMAGE_BATCH_LOADED, wxThreadEvent);
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// ImageLoadLogCollector: collects the messages logged while loading an image
+// ----------------------------------------------------------------------------
+
+// The messages are collected instead of being shown to the user because they
+// may be logged from several threads at once, for different images, and
+// wouldn't be very useful without knowing which image they are about.
+class ImageLoadLogCollector : public wxLog
+{
+public:
+    ImageLoadLogCollector()
+    {
+        // Use a thread-specific target even in the main thread, to avoid
+        // replacing the global one while the other threads may be logging.
+#if wxUSE_THREADS
+        m_logOld = SetThreadActiveTarget(this);
+#else // !wxUSE_THREADS
+        m_logOld = SetActiveTarget(this);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+    }
+
+    virtual ~ImageLoadLogCollector()
+    {
+#if wxUSE_THREADS
+        SetThreadActiveTarget(m_logOld);
+#else // !wxUSE_THREADS
+        SetActiveTarget(m_logOld);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+    }
+
+    const wxString& GetMessages() const { return m_messages; }
+
+protected:
+    virtual void DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& WXUNUSED(info)) override
+    {
+        // Only keep the messages about errors.
+        if ( level > wxLOG_Warning )
+            return;
+
+        if ( !m_messages.empty() )
+            m_messages += '\n';
+        m_messages += msg;
+    }
+
+private:
+    wxLog* m_logOld;
+    wxString m_messages;
+
+    wxDECLARE_NO_COPY_CLASS(ImageLoadLogCollector);
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxImageBatchLoaderImpl
+// ----------------------------------------------------------------------------
+
+class wxImageBatchLoaderImpl
+{
+public:
+    struct Item
+    {
+        wxString filename;
+        std::unique_ptr<wxInputStream> stream;
+        wxFileOffset streamStart = wxInvalidOffset;
+        wxBitmapType type;
+        int index;
+
+        wxImage image;
+        wxString error;
+    };
+
+    wxImageBatchLoaderImpl() = default;
+
+    ~wxImageBatchLoaderImpl()
+    {
+        Wait();
+    }
+
+    size_t AddItem(const wxString& filename,
+                   wxInputStream* stream,
+                   wxBitmapType type,
+                   int index)
+    {
+        wxASSERT_MSG( !IsRunning(), "can't add images while loading" );
+
+        m_items.emplace_back(new Item);
+
+        Item& item = *m_items.back();
+        item.filename = filename;
+        item.stream.reset(stream);
+        if ( stream && stream->IsSeekable() )
+            item.streamStart = stream->TellI();
+        item.type = type;
+        item.index = index;
+
+        return m_items.size() - 1;
+    }
+
+    // Load all the images, return the number of successfully loaded ones.
+    size_t LoadAll();
+
+    bool IsRunning() const { return m_running; }
+
+    // Wait for the background thread, if any, and return the number of
+    // successfully loaded images.
+    size_t Wait();
+
+    bool Start(wxEvtHandler* handler, int id);
+
+    const Item& GetItem(size_t n) const
+    {
+        wxASSERT_MSG( !IsRunning(), "can't access images while loading" );
+
+        return *m_items.at(n);
+    }
+
+    std::vector<std::unique_ptr<Item>> m_items;
+
+    // Options set for all images.
+    wxArrayString m_optionNames,
+                  m_optionValues;
+
+    int m_maxThreads = 0;
+
+private:
+    void LoadItem(Item& item) const;
+
+#if wxUSE_THREADS
+    class LoaderThread : public wxThread
+    {
+    public:
+        LoaderThread(wxImageBatchLoaderImpl& impl, wxEvtHandler* handler, int id)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_impl(impl),
+              m_handler(handler),
+              m_id(id)
+        {
+        }
+
+    protected:
+        virtual void* Entry() override
+        {
+            const size_t numOk = m_impl.LoadAll();
+
+            m_impl.m_running = false;
+
+            if ( m_handler )
+            {
+                wxThreadEvent* const event =
+                    new wxThreadEvent(wxEVT_IMAGE_BATCH_LOADED, m_id);
+                event->SetInt(static_cast<int>(numOk));
+                wxQueueEvent(m_handler, event);
+            }
+
+            return nullptr;
+        }
+
+    private:
+        wxImageBatchLoaderImpl& m_impl;
+        wxEvtHandler* const m_handler;
+        const int m_id;
+    };
+
+    std::unique_ptr<LoaderThread> m_thread;
+#endif // wxUSE_THREADS
+
+    std::atomic<bool> m_running{false};
+
+    size_t m_numOk = 0;
+};
+
+void wxImageBatchLoaderImpl::LoadItem(Item& item) const
+{
+    item.image = wxImage();
+    item.error.clear();
+
+    for ( size_t n = 0; n < m_optionNames.size(); n++ )
+        item.image.SetOption(m_optionNames[n], m_optionValues[n]);
+
+    ImageLoadLogCollector log;
+
+    bool ok;
+    if ( item.stream )
+    {
+        // Rewind the stream in case we had already loaded it before.
+        if ( item.streamStart != wxInvalidOffset )
+            item.stream->SeekI(item.streamStart);
+
+        ok = item.image.LoadFile(*item.stream, item.type, item.index);
+    }
+    else
+        ok = item.image.LoadFile(item.filename, item.type, item.index);
+
+    if ( !ok )
+    {
+        item.image = wxImage();
+
+        item.error = log.GetMessages();
+        if ( item.error.empty() )
+            item.error = _("Failed to load image.");
+    }
+}
+
+size_t wxImageBatchLoaderImpl::LoadAll()
+{
+    std::atomic<size_t> numOk{0};
+
+    // Each image is loaded by a single thread, so only the handlers need to
+    // be reentrant, see the documentation of wxImageHandler.
+    wxThreadPool::ParallelFor
+    (
+        static_cast<int>(m_items.size()),
+        wxThreadPool::GetThreadCount(m_maxThreads),
+        [this, &numOk](int from, int to)
+        {
+            for ( int n = from; n < to; n++ )
+            {
+                Item& item = *m_items[n];
+                LoadItem(item);
+                if ( item.image.IsOk() )
+                    numOk++;
+            }
+        }
+    );
+
+    m_numOk = numOk;
+
+    return m_numOk;
+}
+
+bool wxImageBatchLoaderImpl::Start(wxEvtHandler* handler, int id)
+{
+    wxCHECK_MSG( !IsRunning(), false, "already loading" );
+
+    // Join the previous thread, if any.
+    Wait();
+
+#if wxUSE_THREADS
+    m_running = true;
+
+    m_thread.reset(new LoaderThread(*this, handler, id));
+    if ( m_thread->Run() == wxTHREAD_NO_ERROR )
+        return true;
+
+    m_thread.reset();
+    m_running = false;
+#endif // wxUSE_THREADS
+
+    // Load the images synchronously if we can't use a background thread.
+    const size_t numOk = LoadAll();
+
+    if ( handler )
+    {
+        wxThreadEvent* const event = new wxThreadEvent(wxEVT_IMAGE_BATCH_LOADED, id);
+        event->SetInt(static_cast<int>(numOk));
+        wxQueueEvent(handler, event);
+    }
+
+    return true;
+}
+
+size_t wxImageBatchLoaderImpl::Wait()
+{
+#if wxUSE_THREADS
+    if ( m_thread )
+    {
+        m_thread->Wait();
+        m_thread.reset();
+    }
+#endif // wxUSE_THREADS
+
+    return m_numOk;
+}
+
+// ============================================================================
+// wxImageBatchLoader implementation
+// ============================================================================
+
+wxImageBatchLoader::wxImageBatchLoader()
+    : m_impl(new wxImageBatchLoaderImpl)
+{
+}
+
+wxImageBatchLoader::~wxImageBatchLoader()
+{
+    delete m_impl;
+}
+
+size_t
+wxImageBatchLoader::AddFile(const wxString& filename,
+                            wxBitmapType type,
+                            int index)
+{
+    return m_impl->AddItem(filename, nullptr, type, index);
+}
+
+size_t
+wxImageBatchLoader::AddStream(wxInputStream* stream,
+                              wxBitmapType type,
+                              int index)
+{
+    wxCHECK_MSG( stream, static_cast<size_t>(-1), "null stream" );
+
+    return m_impl->AddItem(wxString(), stream, type, index);
+}
+
+void wxImageBatchLoader::SetOption(const wxString& name, const wxString& value)
+{
+    const int n = m_impl->m_optionNames.Index(name, false /* case-insensitive */);
+    if ( n == wxNOT_FOUND )
+    {
+        m_impl->m_optionNames.push_back(name);
+        m_impl->m_optionValues.push_back(value);
+    }
+    else
+    {
+        m_impl->m_optionValues[n] = value;
+    }
+}
+
+void wxImageBatchLoader::SetOption(const wxString& name, int value)
+{
+    SetOption(name, wxString::Format("%d", value));
+}
+
+void wxImageBatchLoader::SetMaxThreads(int maxThreads)
+{
+    m_impl->m_maxThreads = maxThreads;
+}
+
+bool wxImageBatchLoader::Load()
+{
+    wxCHECK_MSG( !m_impl->IsRunning(), false, "already loading" );
+
+    m_impl->Wait();
+
+    return m_impl->LoadAll() == m_impl->m_items.size();
+}
+
+bool wxImageBatchLoader::Start(wxEvtHandler* handler, int id)
+{
+    return m_impl->Start(handler, id);
+}
+
+bool wxImageBatchLoader::IsRunning() const
+{
+    return m_impl->IsRunning();
+}
+
+bool wxImageBatchLoader::Wait()
+{
+    return m_impl->Wait() == m_impl->m_items.size();
+}
+
+size_t wxImageBatchLoader::GetCount() const
+{
+    return m_impl->m_items.size();
+}
+
+bool wxImageBatchLoader::IsOk(size_t n) const
+{
+    return m_impl->GetItem(n).image.IsOk();
+}
+
+const wxImage& wxImageBatchLoader::GetImage(size_t n) const
+{
+    return m_impl->GetItem(n).image;
+}
+
+const wxString& wxImageBatchLoader::GetError(size_t n) const
+{
+    return m_impl->GetItem(n).error;
+}
+
+#endif // wxUSE_IMAGE && wxUSE_STREAMS
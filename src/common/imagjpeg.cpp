@@ -40,6 +40,8 @@
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 
+#include "wx/private/imageload.h"
+
 // For memcpy
 #include <string.h>
 // For JPEG library error handling
@@ -239,8 +241,7 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     unsigned char *ptr;
 
     // save this before calling Destroy()
-    const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
-                   maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
+    wxImageLoadParams params(*image);
     image->Destroy();
 
     cinfo.err = jpeg_std_error( &jerr );
@@ -280,44 +281,74 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         bytesPerPixel = 3;
     }
 
-    // scale the picture to fit in the specified max size if necessary
-    if ( maxWidth > 0 || maxHeight > 0 )
-    {
-        unsigned& scale = cinfo.scale_denom;
-        while ( (maxWidth && (cinfo.image_width / scale > maxWidth)) ||
-                    (maxHeight && (cinfo.image_height / scale > maxHeight)) )
-        {
-            scale *= 2;
-        }
-    }
+    // scale the picture to fit in the specified max size if necessary: note
+    // that libjpeg doesn't support scaling by more than 8, so we may still need
+    // to rescale it after loading, this is done by wxImage itself
+    params.SetImageSize(cinfo.image_width, cinfo.image_height);
+    cinfo.scale_denom = wxMin(params.GetScale(), 8);
+    jpeg_calc_output_dimensions( &cinfo );
+
+    // compute the part of the scaled image corresponding to the region
+    const wxRect& region = params.GetRegion();
+    const unsigned
+        x1 = static_cast<wxUint64>(region.x) * cinfo.output_width / cinfo.image_width,
+        y1 = static_cast<wxUint64>(region.y) * cinfo.output_height / cinfo.image_height,
+        x2 = (static_cast<wxUint64>(region.GetRight() + 1) * cinfo.output_width +
+                cinfo.image_width - 1) / cinfo.image_width,
+        y2 = (static_cast<wxUint64>(region.GetBottom() + 1) * cinfo.output_height +
+                cinfo.image_height - 1) / cinfo.image_height;
 
     jpeg_start_decompress( &cinfo );
 
-    image->Create( cinfo.output_width, cinfo.output_height );
+    image->Create( x2 - x1, y2 - y1 );
     if (!image->IsOk()) {
-        jpeg_finish_decompress( &cinfo );
+        jpeg_abort_decompress( &cinfo );
         jpeg_destroy_decompress( &cinfo );
         return false;
     }
     image->SetMask( false );
     ptr = image->GetData();
 
+    // offset of the first column of the region in the decoded rows
+    unsigned xoffset = x1;
+
+#ifdef LIBJPEG_TURBO_VERSION_NUMBER
+    // libjpeg-turbo can avoid decoding the columns and rows outside of the
+    // region entirely, although it can only crop at iMCU boundaries
+    if ( x2 - x1 != cinfo.output_width )
+    {
+        JDIMENSION cropX = x1,
+                   cropWidth = x2 - x1;
+        jpeg_crop_scanline( &cinfo, &cropX, &cropWidth );
+        xoffset = x1 - cropX;
+    }
+
+    if ( y1 )
+        jpeg_skip_scanlines( &cinfo, y1 );
+#endif // LIBJPEG_TURBO_VERSION_NUMBER
+
     unsigned stride = cinfo.output_width * bytesPerPixel;
     JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
                             ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
 
-    while ( cinfo.output_scanline < cinfo.output_height )
+    const unsigned width = x2 - x1;
+    while ( cinfo.output_scanline < y2 )
     {
+        const bool skip = cinfo.output_scanline < y1;
         jpeg_read_scanlines( &cinfo, tempbuf, 1 );
+        if ( skip )
+            continue;
+
+        const unsigned char* inptr = (const unsigned char*) tempbuf[0] +
+                                        xoffset * bytesPerPixel;
         if (cinfo.out_color_space == JCS_RGB)
         {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
+            memcpy( ptr, inptr, width * 3 );
+            ptr += width * 3;
         }
         else // CMYK
         {
-            const unsigned char* inptr = (const unsigned char*) tempbuf[0];
-            for (size_t i = 0; i < cinfo.output_width; i++)
+            for (size_t i = 0; i < width; i++)
             {
                 wx_cmyk_to_rgb(ptr, inptr);
                 ptr += 3;
@@ -337,14 +368,15 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, cinfo.density_unit);
     }
 
-    if ( cinfo.image_width != cinfo.output_width || cinfo.image_height != cinfo.output_height )
-    {
-        // save the original image size
-        image->SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, cinfo.image_width);
-        image->SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, cinfo.image_height);
-    }
+    // save the original image size
+    params.SetOriginalSize(image);
 
-    jpeg_finish_decompress( &cinfo );
+    // there is no need to decode the rest of the image if we only needed a
+    // part of it
+    if ( cinfo.output_scanline < cinfo.output_height )
+        jpeg_abort_decompress( &cinfo );
+    else
+        jpeg_finish_decompress( &cinfo );
     jpeg_destroy_decompress( &cinfo );
     return true;
 }
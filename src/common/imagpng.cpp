@@ -30,11 +30,14 @@
     #include "wx/stream.h"
 #endif
 
+#include "wx/private/imageload.h"
+
 #include "png.h"
 
 // For memcpy
 #include <string.h>
 
+#include <memory>
 #include <unordered_map>
 
 #define wxIMAGE_OPTION_PNG_DESCRIPTION_KEY "Description"
@@ -157,6 +160,13 @@ struct wxPNGImageData
 
     void DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo);
 
+    // Read just the rows of the image needed for the region and scale
+    // specified by m_params, return false if this can't be done.
+    bool ReadRegion(wxImage* image, png_uint_32 width, bool hasAlpha);
+
+    std::unique_ptr<wxImageLoadParams> m_params;
+    std::unique_ptr<wxImageRowAccumulator> m_accumulator;
+
     unsigned char** lines;
     unsigned char* m_buf;
     png_infop info_ptr;
@@ -300,6 +310,8 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     png_uint_32 width, height = 0;
     int bit_depth, color_type;
 
+    m_params.reset(new wxImageLoadParams(*image));
+
     image->Destroy();
 
     png_ptr = png_create_read_struct
@@ -331,19 +343,33 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     png_set_strip_16( png_ptr );
     png_set_packing( png_ptr );
 
-    image->Create((int)width, (int)height, (bool) false /* no need to init pixels */);
-
-    if (!image->IsOk())
-        return;
-
     const bool needCopy =
         (color_type & PNG_COLOR_MASK_ALPHA) ||
         png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
-    if (!Alloc(width, height, needCopy ? nullptr : image->GetData()))
-        return;
+    // Only the rows of non-interlaced images can be decoded one by one.
+    m_params->SetImageSize(width, height);
+    const bool readRegion =
+        m_params->IsNeeded() &&
+            png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE;
 
-    png_read_image( png_ptr, lines );
+    if ( readRegion )
+    {
+        if ( !ReadRegion(image, width, needCopy) )
+            return;
+    }
+    else
+    {
+        image->Create((int)width, (int)height, (bool) false /* no need to init pixels */);
+
+        if (!image->IsOk())
+            return;
+
+        if (!Alloc(width, height, needCopy ? nullptr : image->GetData()))
+            return;
+
+        png_read_image( png_ptr, lines );
+    }
 
     // load "Description" text chunk
     png_textp text_ptr;
@@ -378,7 +404,11 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
         }
     }
 
-    png_read_end( png_ptr, info_ptr );
+    // Note that if we only read a part of the image, we can't read the chunks
+    // following the image data without decoding all of it, which we want to
+    // avoid, so just skip them.
+    if ( !readRegion || m_params->GetRegion().GetBottom() + 1 == (int)height )
+        png_read_end( png_ptr, info_ptr );
 
 #if wxUSE_PALETTE
     if (color_type == PNG_COLOR_TYPE_PALETTE)
@@ -448,13 +478,51 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
 
 
     // loaded successfully, now init wxImage with this data
-    if (needCopy)
+    if ( readRegion )
+        m_params->SetOriginalSize(image);
+    else if (needCopy)
         CopyDataFromPNG(image, lines, width, height);
 
     // This will indicate to the caller that loading succeeded.
     ok = true;
 }
 
+bool
+wxPNGImageData::ReadRegion(wxImage* image, png_uint_32 width, bool hasAlpha)
+{
+    image->Create(m_params->GetOutputWidth(), m_params->GetOutputHeight(),
+                  false /* no need to init pixels */);
+    if ( !image->IsOk() )
+        return false;
+
+    if ( hasAlpha )
+        image->SetAlpha();
+
+    const int bytesPerPixel = hasAlpha ? 4 : 3;
+
+    m_buf = static_cast<unsigned char*>(malloc(width * bytesPerPixel));
+    if ( !m_buf )
+        return false;
+
+    m_accumulator.reset(new wxImageRowAccumulator(image, *m_params));
+
+    const wxRect& region = m_params->GetRegion();
+    const unsigned char* const regionStart = m_buf + region.x*bytesPerPixel;
+    for ( int y = 0; y <= region.GetBottom(); y++ )
+    {
+        png_read_row( png_ptr, m_buf, nullptr );
+
+        if ( y >= region.y )
+            m_accumulator->AddRow(regionStart, bytesPerPixel);
+    }
+
+    // As in CopyDataFromPNG(), only keep alpha if we really need it.
+    if ( hasAlpha && !m_accumulator->HasTransparency() )
+        image->ClearAlpha();
+
+    return true;
+}
+
 bool
 wxPNGHandler::LoadFile(wxImage *image,
                        wxInputStream& stream,
@@ -40,6 +40,10 @@ extern "C"
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 
+#include "wx/private/imageload.h"
+
+#include <vector>
+
 #ifndef TIFFLINKAGEMODE
     #define TIFFLINKAGEMODE LINKAGEMODE
 #endif
@@ -288,11 +292,173 @@ TIFFwxOpen(wxOutputStream &stream, const char* name, const char* mode)
     return tif;
 }
 
+// Decode only the given region of the image, possibly downscaling it, without
+// reading the entire image in memory.
+static bool
+LoadTIFFRegion(TIFF* tif, wxImage* image, const wxImageLoadParams& params,
+               bool hasAlpha)
+{
+    char msg[1024] = "";
+    TIFFRGBAImage img;
+    if ( !TIFFRGBAImageBegin(&img, tif, 0, msg) )
+        return false;
+
+    const wxRect& region = params.GetRegion();
+
+    image->Create(params.GetOutputWidth(), params.GetOutputHeight(),
+                  false /* no need to init pixels */);
+    if ( !image->IsOk() )
+    {
+        TIFFRGBAImageEnd(&img);
+        return false;
+    }
+
+    if ( hasAlpha )
+        image->SetAlpha();
+
+    // Decode the image in bands of a whole number of strips or tiles, to
+    // avoid decoding them more than once.
+    wxUint32 bandHeight = 0;
+    if ( TIFFIsTiled(tif) )
+        TIFFGetField(tif, TIFFTAG_TILELENGTH, &bandHeight);
+    else
+        TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &bandHeight);
+
+    if ( !bandHeight || bandHeight > (wxUint32)region.height )
+        bandHeight = region.height;
+
+    std::vector<wxUint32> raster((size_t)region.width * bandHeight);
+    std::vector<unsigned char> row(4 * (size_t)region.width);
+
+    wxImageRowAccumulator accumulator(image, params);
+
+    img.req_orientation = ORIENTATION_TOPLEFT;
+    img.col_offset = region.x;
+
+    bool ok = true;
+    for ( int y = 0; y < region.height && ok; y += bandHeight )
+    {
+        const wxUint32 rows = wxMin(bandHeight, (wxUint32)(region.height - y));
+
+        img.row_offset = region.y + y;
+        if ( !TIFFRGBAImageGet(&img, &raster[0], region.width, rows) )
+        {
+            ok = false;
+            break;
+        }
+
+        const wxUint32* src = &raster[0];
+        for ( wxUint32 n = 0; n < rows; n++ )
+        {
+            unsigned char* dst = &row[0];
+            for ( int x = 0; x < region.width; x++, src++ )
+            {
+                *dst++ = (unsigned char)TIFFGetR(*src);
+                *dst++ = (unsigned char)TIFFGetG(*src);
+                *dst++ = (unsigned char)TIFFGetB(*src);
+                *dst++ = (unsigned char)TIFFGetA(*src);
+            }
+
+            accumulator.AddRow(&row[0], 4);
+        }
+    }
+
+    TIFFRGBAImageEnd(&img);
+
+    return ok;
+}
+
+// Set the image options from the TIFF tags.
+static void
+SetImageOptionsFromTIFF(TIFF* tif,
+                        wxImage* image,
+                        wxUint16 photometric,
+                        wxUint16 samplesPerPixel,
+                        wxUint16 bitsPerSample)
+{
+    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+
+    wxUint16 compression;
+    /*
+    Copy some baseline TIFF tags which helps when re-saving a TIFF
+    to be similar to the original image.
+    */
+    if (samplesPerPixel)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
+    }
+
+    if (bitsPerSample)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
+    }
+
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
+    }
+
+    // Set the resolution unit.
+    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
+    wxUint16 tiffRes;
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
+    {
+        switch (tiffRes)
+        {
+            default:
+                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
+                    tiffRes);
+                wxFALLTHROUGH;
+
+            case RESUNIT_NONE:
+                resUnit = wxIMAGE_RESOLUTION_NONE;
+                break;
+
+            case RESUNIT_INCH:
+                resUnit = wxIMAGE_RESOLUTION_INCHES;
+                break;
+
+            case RESUNIT_CENTIMETER:
+                resUnit = wxIMAGE_RESOLUTION_CM;
+                break;
+        }
+    }
+
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+
+    /*
+    Set the image resolution if it's available. Resolution tag is not
+    dependent on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
+    */
+    float resX, resY;
+
+    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
+    {
+        /*
+        Use a string value to not lose precision.
+        rounding to int as cm and then converting to inch may
+        result in whole integer rounding error, eg. 201 instead of 200 dpi.
+        If an app wants an int, GetOptionInt will convert and round down.
+        */
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
+            wxString::FromCDouble((double) resX));
+    }
+
+    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    {
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
+            wxString::FromCDouble((double) resY));
+    }
+}
+
 bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
 {
     if (index == -1)
         index = 0;
 
+    // save this before calling Destroy()
+    wxImageLoadParams params(*image);
+
     image->Destroy();
 
     TIFF *tif = TIFFwxOpen( stream, "image", "r" );
@@ -348,6 +514,44 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         || (extraSamples == 0 && samplesPerPixel == 4
             && photometric == PHOTOMETRIC_RGB);
 
+    wxUint16 planarConfig = PLANARCONFIG_CONTIG;
+    (void) TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
+
+    char msg[1024] = "";
+    const bool readScanlines =
+        (planarConfig == PLANARCONFIG_CONTIG && samplesPerPixel == 2
+            && extraSamples == 1)
+        &&
+        (
+            ( !TIFFRGBAImageOK(tif, msg) )
+            || (bitsPerSample == 8)
+        );
+
+    // decode just the part of the image we need if possible
+    params.SetImageSize(w, h);
+    if ( params.IsNeeded() && !readScanlines )
+    {
+        if ( !LoadTIFFRegion(tif, image, params, hasAlpha) )
+        {
+            if (verbose)
+            {
+                wxLogError( _("TIFF: Error reading image.") );
+            }
+
+            image->Destroy();
+            TIFFClose( tif );
+
+            return false;
+        }
+
+        params.SetOriginalSize(image);
+        SetImageOptionsFromTIFF(tif, image, photometric, samplesPerPixel, bitsPerSample);
+
+        TIFFClose( tif );
+
+        return true;
+    }
+
     // guard against integer overflow during multiplication which could result
     // in allocating a too small buffer and then overflowing it
     const double bytesNeeded = (double)w * (double)h * sizeof(wxUint32);
@@ -394,21 +598,8 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     if ( hasAlpha )
         image->SetAlpha();
 
-    wxUint16 planarConfig = PLANARCONFIG_CONTIG;
-    (void) TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &planarConfig);
-
     bool ok = true;
-    char msg[1024] = "";
-    if
-    (
-        (planarConfig == PLANARCONFIG_CONTIG && samplesPerPixel == 2
-            && extraSamples == 1)
-        &&
-        (
-            ( !TIFFRGBAImageOK(tif, msg) )
-            || (bitsPerSample == 8)
-        )
-    )
+    if ( readScanlines )
     {
         const bool isGreyScale = (bitsPerSample == 8);
         unsigned char *buf = (unsigned char *)_TIFFmalloc(TIFFScanlineSize(tif));
@@ -499,79 +690,7 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     }
 
 
-    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
-
-    wxUint16 compression;
-    /*
-    Copy some baseline TIFF tags which helps when re-saving a TIFF
-    to be similar to the original image.
-    */
-    if (samplesPerPixel)
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
-    }
-
-    if (bitsPerSample)
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
-    }
-
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
-    {
-        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
-    }
-
-    // Set the resolution unit.
-    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
-    wxUint16 tiffRes;
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
-    {
-        switch (tiffRes)
-        {
-            default:
-                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
-                    tiffRes);
-                wxFALLTHROUGH;
-
-            case RESUNIT_NONE:
-                resUnit = wxIMAGE_RESOLUTION_NONE;
-                break;
-
-            case RESUNIT_INCH:
-                resUnit = wxIMAGE_RESOLUTION_INCHES;
-                break;
-
-            case RESUNIT_CENTIMETER:
-                resUnit = wxIMAGE_RESOLUTION_CM;
-                break;
-        }
-    }
-
-    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
-
-    /*
-    Set the image resolution if it's available. Resolution tag is not
-    dependent on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
-    */
-    float resX, resY;
-
-    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
-    {
-        /*
-        Use a string value to not lose precision.
-        rounding to int as cm and then converting to inch may
-        result in whole integer rounding error, eg. 201 instead of 200 dpi.
-        If an app wants an int, GetOptionInt will convert and round down.
-        */
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
-            wxString::FromCDouble((double) resX));
-    }
-
-    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
-    {
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
-            wxString::FromCDouble((double) resY));
-    }
+    SetImageOptionsFromTIFF(tif, image, photometric, samplesPerPixel, bitsPerSample);
 
     _TIFFfree( raster );
 
@@ -49,6 +49,10 @@
 
 #include <stdlib.h>
 
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
 #if defined(__WINDOWS__)
     // This header includes <windows.h> and declares wxMSWFormatMessage().
     #include "wx/msw/private.h"
@@ -103,6 +107,71 @@ thread_local wxLog* wxPerThreadLogger = nullptr;
 
 thread_local bool wxPerThreadLoggingDisabled = false;
 
+// The global log target if it can be used from the other threads directly,
+// i.e. if its IsThreadSafe() returns true, or null otherwise.
+std::atomic<wxLog*> gs_threadSafeLogger{nullptr};
+
+// The threads using gs_threadSafeLogger are counted in one of these counters,
+// selected by the current epoch. Changing the target switches the epoch, so
+// that the threads starting to use the new target are counted separately and
+// we can wait until all the threads still using the old one are done with it
+// before returning it from SetActiveTarget(), as it can be deleted then.
+std::atomic<int> gs_threadSafeLoggerUsers[2];
+std::atomic<int> gs_threadSafeLoggerEpoch{0};
+
+// Helper used by the other threads to get gs_threadSafeLogger and prevent it
+// from being destroyed while this object exists.
+class ThreadSafeLoggerUser
+{
+public:
+    ThreadSafeLoggerUser()
+    {
+        for ( ;; )
+        {
+            m_epoch = gs_threadSafeLoggerEpoch;
+            ++gs_threadSafeLoggerUsers[m_epoch];
+
+            // If the epoch changed in the meanwhile, the thread changing the
+            // target might not have seen our counter update, so retry.
+            if ( gs_threadSafeLoggerEpoch == m_epoch )
+                break;
+
+            --gs_threadSafeLoggerUsers[m_epoch];
+        }
+
+        m_logger = gs_threadSafeLogger;
+    }
+
+    ~ThreadSafeLoggerUser()
+    {
+        --gs_threadSafeLoggerUsers[m_epoch];
+    }
+
+    wxLog* Get() const { return m_logger; }
+
+private:
+    int m_epoch;
+    wxLog* m_logger;
+
+    wxDECLARE_NO_COPY_CLASS(ThreadSafeLoggerUser);
+};
+
+// Set gs_threadSafeLogger to the given logger, which must be either null or
+// thread-safe, and wait until no other threads use the previous one any more.
+//
+// This must be called from the main thread only.
+void SetThreadSafeLogger(wxLog* logger)
+{
+    if ( !gs_threadSafeLogger.exchange(logger) )
+        return;
+
+    const int epoch = gs_threadSafeLoggerEpoch;
+    gs_threadSafeLoggerEpoch = 1 - epoch;
+
+    while ( gs_threadSafeLoggerUsers[epoch] )
+        wxThread::Yield();
+}
+
 } // anonymous namespace
 
 #endif // wxUSE_THREADS
@@ -162,6 +231,79 @@ inline ComponentLevelsMap& GetComponentLevels()
     return s_componentLevels;
 }
 
+// set to true once any component level is set, this allows to avoid looking
+// up the components at all in the common case when they're not used
+std::atomic<bool> gs_hasComponentLevels{false};
+
+// incremented whenever any component level changes to invalidate the levels
+// cached by GetCachedComponentLevel()
+std::atomic<unsigned> gs_componentLevelsVersion{1};
+
+// special value used for the components without their own level
+const wxLogLevel wxLOG_UseGlobalLevel = static_cast<wxLogLevel>(-1);
+
+// return the level explicitly set for this component or its nearest parent
+// or wxLOG_UseGlobalLevel if none
+wxLogLevel DoGetComponentLevel(wxString component)
+{
+    wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
+
+    const auto& componentLevels = GetComponentLevels();
+    while ( !component.empty() )
+    {
+        const auto it = componentLevels.find(component);
+        if ( it != componentLevels.end() )
+            return it->second;
+
+        component = component.BeforeLast('/');
+    }
+
+    return wxLOG_UseGlobalLevel;
+}
+
+// Per-thread cache of the component levels: components are almost always
+// string literals, so use their address as the key, but also store the
+// string itself to guard against the same address being reused for another
+// component.
+struct ComponentLevelCacheEntry
+{
+    std::string component;
+    unsigned version = 0;
+    wxLogLevel level = wxLOG_UseGlobalLevel;
+};
+
+// don't let the cache grow indefinitely if the components are not literals
+const size_t MAX_CACHED_COMPONENTS = 256;
+
+thread_local std::unordered_map<const char*, ComponentLevelCacheEntry>
+    gs_componentLevelsCache;
+
+wxLogLevel GetCachedComponentLevel(const char* component)
+{
+    const unsigned version =
+        gs_componentLevelsVersion.load(std::memory_order_acquire);
+
+    auto& cache = gs_componentLevelsCache;
+    auto it = cache.find(component);
+    if ( it == cache.end() )
+    {
+        if ( cache.size() >= MAX_CACHED_COMPONENTS )
+            cache.clear();
+
+        it = cache.emplace(component, ComponentLevelCacheEntry()).first;
+    }
+
+    ComponentLevelCacheEntry& entry = it->second;
+    if ( entry.version != version || entry.component != component )
+    {
+        entry.component = component;
+        entry.level = DoGetComponentLevel(wxString::FromAscii(component));
+        entry.version = version;
+    }
+
+    return entry.level;
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -366,31 +508,37 @@ wxLog::OnLog(wxLogLevel level,
     wxLog *logger;
 
 #if wxUSE_THREADS
-    if ( !wxThread::IsMain() )
+    // a thread-specific logger takes precedence in any thread, including the
+    // main one
+    logger = wxPerThreadLogger;
+    if ( !logger && !wxThread::IsMain() )
     {
-        logger = wxPerThreadLogger;
-        if ( !logger )
+        // check if the global logger can be used from this thread
+        // directly, this also ensures that it's not destroyed while we
+        // use it
+        const ThreadSafeLoggerUser threadSafeLogger;
+        if ( threadSafeLogger.Get() )
         {
-            if ( ms_pLogger )
-            {
-                // buffer the messages until they can be shown from the main
-                // thread
-                wxCriticalSectionLocker lock(GetBackgroundLogCS());
-
-                gs_bufferedLogRecords.push_back(wxLogRecord(level, msg, info));
+            threadSafeLogger.Get()->CallDoLogNow(level, msg, info, false);
+        }
+        else if ( ms_pLogger )
+        {
+            // buffer the messages until they can be shown from the main
+            // thread
+            wxCriticalSectionLocker lock(GetBackgroundLogCS());
 
-                // ensure that our Flush() will be called soon
-                wxWakeUpIdle();
-            }
-            //else: we don't have any logger at all, there is no need to log
-            //      anything
+            gs_bufferedLogRecords.push_back(wxLogRecord(level, msg, info));
 
-            return;
+            // ensure that our Flush() will be called soon
+            wxWakeUpIdle();
         }
-        //else: we have a thread-specific logger, we can send messages to it
-        //      directly
+        //else: we don't have any logger at all, there is no need to log
+        //      anything
+
+        return;
     }
-    else
+
+    if ( !logger )
 #endif // wxUSE_THREADS
     {
         logger = GetMainThreadActiveTarget();
@@ -404,9 +552,10 @@ wxLog::OnLog(wxLogLevel level,
 void
 wxLog::CallDoLogNow(wxLogLevel level,
                     const wxString& msg,
-                    const wxLogRecordInfo& info)
+                    const wxLogRecordInfo& info,
+                    bool countRepetitions)
 {
-    if ( GetRepetitionCounting() )
+    if ( countRepetitions && GetRepetitionCounting() )
     {
         if ( msg == gs_prevLog.msg )
         {
@@ -483,16 +632,16 @@ void wxLog::DoLogText(const wxString& WXUNUSED(msg))
 wxLog *wxLog::GetActiveTarget()
 {
 #if wxUSE_THREADS
+    // check if we have a thread-specific log target
+    wxLog * const logger = wxPerThreadLogger;
+    if ( logger )
+        return logger;
+
+    // the code below should be only executed for the main thread as
+    // CreateLogTarget() is not meant for auto-creating log targets for
+    // worker threads so skip it in any case
     if ( !wxThread::IsMain() )
-    {
-        // check if we have a thread-specific log target
-        wxLog * const logger = wxPerThreadLogger;
-
-        // the code below should be only executed for the main thread as
-        // CreateLogTarget() is not meant for auto-creating log targets for
-        // worker threads so skip it in any case
-        return logger ? logger : ms_pLogger;
-    }
+        return ms_pLogger;
 #endif // wxUSE_THREADS
 
     return GetMainThreadActiveTarget();
@@ -511,6 +660,11 @@ wxLog *wxLog::GetMainThreadActiveTarget()
             // ask the application to create a log target for us
             ms_pLogger = wxApp::GetValidTraits().CreateLogTarget();
 
+#if wxUSE_THREADS
+            if ( ms_pLogger && ms_pLogger->IsThreadSafe() )
+                SetThreadSafeLogger(ms_pLogger);
+#endif // wxUSE_THREADS
+
             s_bInGetActiveTarget = false;
         }
     }
@@ -539,6 +693,11 @@ wxLog *wxLog::SetActiveTarget(wxLog *pLogger)
     wxLog *pOldLogger = ms_pLogger;
     ms_pLogger = pLogger;
 
+#if wxUSE_THREADS
+    // this waits until the old logger is not used by any threads any more
+    SetThreadSafeLogger(pLogger && pLogger->IsThreadSafe() ? pLogger : nullptr);
+#endif // wxUSE_THREADS
+
     return pOldLogger;
 }
 
@@ -546,8 +705,6 @@ wxLog *wxLog::SetActiveTarget(wxLog *pLogger)
 /* static */
 wxLog *wxLog::SetThreadActiveTarget(wxLog *logger)
 {
-    wxASSERT_MSG( !wxThread::IsMain(), "use SetActiveTarget() for main thread" );
-
     wxLog * const oldLogger = wxPerThreadLogger;
     if ( oldLogger )
         oldLogger->Flush();
@@ -589,28 +746,33 @@ void wxLog::SetComponentLevel(const wxString& component, wxLogLevel level)
         wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
 
         GetComponentLevels()[component] = level;
+
+        gs_hasComponentLevels.store(true, std::memory_order_release);
+        gs_componentLevelsVersion.fetch_add(1, std::memory_order_acq_rel);
     }
 }
 
 /* static */
-wxLogLevel wxLog::GetComponentLevel(const wxString& componentOrig)
+wxLogLevel wxLog::GetComponentLevel(const wxString& component)
 {
-    wxCRIT_SECT_LOCKER(lock, GetLevelsCS());
+    if ( !gs_hasComponentLevels.load(std::memory_order_acquire) )
+        return GetLogLevel();
 
-    // Make a copy before modifying it in the loop.
-    wxString component = componentOrig;
+    const wxLogLevel level = DoGetComponentLevel(component);
 
-    const auto& componentLevels = GetComponentLevels();
-    while ( !component.empty() )
-    {
-        const auto it = componentLevels.find(component);
-        if ( it != componentLevels.end() )
-            return it->second;
+    return level == wxLOG_UseGlobalLevel ? GetLogLevel() : level;
+}
 
-        component = component.BeforeLast('/');
-    }
+/* static */
+wxLogLevel wxLog::GetComponentLevel(const char* component)
+{
+    if ( !gs_hasComponentLevels.load(std::memory_order_acquire) ||
+            !component || !*component )
+        return GetLogLevel();
+
+    const wxLogLevel level = GetCachedComponentLevel(component);
 
-    return GetLogLevel();
+    return level == wxLOG_UseGlobalLevel ? GetLogLevel() : level;
 }
 
 // ----------------------------------------------------------------------------
@@ -800,7 +962,9 @@ void wxLog::FlushActive()
     if ( log )
     {
 #if wxUSE_THREADS
-        if ( wxThread::IsMain() )
+        // don't divert the messages logged by the other threads to a
+        // thread-specific target which may be active in the main thread
+        if ( wxThread::IsMain() && !wxPerThreadLogger )
             log->FlushThreadMessages();
 #endif // wxUSE_THREADS
 
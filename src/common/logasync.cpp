@@ -0,0 +1,562 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/logasync.cpp
+// Purpose:     wxLogAsync implementation
+// Author:      wxWidgets development team
+// Created:     2026-10-18
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+
+#include "wx/logasync.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/utils.h"
+#endif // WX_PRECOMP
+
+#if wxUSE_LOG && wxUSE_THREADS
+
+#include "wx/thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// RecordsRing: fixed size buffer of log records
+// ----------------------------------------------------------------------------
+
+// This is a single producer, single consumer lock-free queue: records are only
+// added to it by the thread owning it and only taken from it by the writer
+// thread.
+class RecordsRing
+{
+public:
+    struct Record
+    {
+        wxLogLevel level = 0;
+        wxString msg;
+        wxLogRecordInfo info;
+    };
+
+    explicit RecordsRing(size_t capacity)
+        : m_records(capacity)
+    {
+    }
+
+    bool IsEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) ==
+                    m_tail.load(std::memory_order_acquire);
+    }
+
+    bool IsFull() const
+    {
+        return m_head.load(std::memory_order_acquire) -
+                    m_tail.load(std::memory_order_acquire) == m_records.size();
+    }
+
+    // Called by the producer thread when it stops using this ring, either
+    // because it exits or because it logs to another wxLogAsync, after which
+    // the ring can be deleted as soon as it becomes empty.
+    void SetAbandoned()
+    {
+        m_abandoned.store(true, std::memory_order_release);
+    }
+
+    // Called with the owning logger mutex locked when the ring is reused by
+    // the producer thread.
+    void ResetAbandoned()
+    {
+        m_abandoned.store(false, std::memory_order_relaxed);
+    }
+
+    bool IsAbandoned() const
+    {
+        return m_abandoned.load(std::memory_order_acquire);
+    }
+
+    // Called by the producer thread only.
+    bool TryPush(wxLogLevel level,
+                 const wxString& msg,
+                 const wxLogRecordInfo& info)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if ( head - m_tail.load(std::memory_order_acquire) == m_records.size() )
+            return false;
+
+        Record& record = m_records[head % m_records.size()];
+        record.level = level;
+        record.msg = msg;
+        record.info = info;
+
+        m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Called by the writer thread only: move all the records to the provided
+    // vector, freeing the space in the ring.
+    void PopAll(std::vector<Record>& records)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        for ( ; tail != head; tail++ )
+        {
+            Record& record = m_records[tail % m_records.size()];
+
+            records.emplace_back();
+            Record& out = records.back();
+            out.level = record.level;
+            out.msg.swap(record.msg);
+            out.info = record.info;
+
+            m_tail.store(tail + 1, std::memory_order_release);
+        }
+    }
+
+private:
+    std::vector<Record> m_records;
+
+    // Index of the next record to write and read, only the remainders of
+    // their division by the capacity are used for indexing.
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+
+    std::atomic<bool> m_abandoned{false};
+
+    wxDECLARE_NO_COPY_CLASS(RecordsRing);
+};
+
+// Used to give unique ids to all wxLogAsyncImpl objects ever created.
+std::atomic<unsigned> gs_lastLoggerId{0};
+
+// Ring of the current thread for the logger with the given id: this allows to
+// avoid locking when logging, except for the first time.
+//
+// The ring is shared with the logger, so that it remains valid even if the
+// logger is destroyed before the thread exits.
+struct ThreadRingCache
+{
+    ~ThreadRingCache()
+    {
+        // Allow the logger to delete the ring of this thread once it writes
+        // out all the records remaining in it.
+        if ( ring )
+            ring->SetAbandoned();
+    }
+
+    unsigned loggerId = 0;
+    std::shared_ptr<RecordsRing> ring;
+};
+
+thread_local ThreadRingCache gs_threadRing;
+
+// Set in the writer threads.
+thread_local bool gs_isWriterThread = false;
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxLogAsyncImpl: the real implementation of wxLogAsync
+// ----------------------------------------------------------------------------
+
+class wxLogAsyncImpl
+{
+public:
+    wxLogAsyncImpl(wxLog* target, size_t capacity, wxLogAsyncOverflow overflow)
+        : m_target(target),
+          m_capacity(capacity),
+          m_overflow(overflow),
+          m_id(++gs_lastLoggerId),
+          m_condWork(m_mutex),
+          m_condDone(m_mutex)
+    {
+        m_thread = new Writer(*this);
+        if ( m_thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete m_thread;
+            m_thread = nullptr;
+        }
+    }
+
+    ~wxLogAsyncImpl()
+    {
+        if ( m_thread )
+        {
+            {
+                wxMutexLocker lock(m_mutex);
+                m_stop = true;
+                m_condWork.Signal();
+            }
+
+            m_thread->Wait();
+            delete m_thread;
+        }
+
+        if ( m_target )
+        {
+            m_target->Flush();
+            delete m_target;
+        }
+    }
+
+    wxLog* GetTarget() const { return m_target; }
+
+    size_t GetDroppedCount() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    void Log(wxLogLevel level, const wxString& msg, const wxLogRecordInfo& info);
+
+    void WakeUp();
+
+    void Sync();
+
+private:
+    class Writer : public wxThread
+    {
+    public:
+        explicit Writer(wxLogAsyncImpl& impl)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_impl(impl)
+        {
+        }
+
+    protected:
+        virtual void* Entry() override
+        {
+            gs_isWriterThread = true;
+
+            m_impl.WriterLoop();
+
+            return nullptr;
+        }
+
+    private:
+        wxLogAsyncImpl& m_impl;
+    };
+
+    // Return the ring for the current thread, creating it if necessary.
+    RecordsRing& GetThreadRing();
+
+    // Return true if any ring has any records, must be called with m_mutex
+    // locked.
+    bool HasRecords() const;
+
+    // Write all the records currently in the rings.
+    void WriteRecords();
+
+    // Delete the rings which are empty and not used by any thread any more.
+    void DeleteAbandonedRings();
+
+    void WriterLoop();
+
+
+    wxLog* const m_target;
+    const size_t m_capacity;
+    const wxLogAsyncOverflow m_overflow;
+    const unsigned m_id;
+
+    // Written by the threads logging the records and read by the writer.
+    std::atomic<size_t> m_dropped{0};
+
+    // Set by the writer thread while it's waiting for more records.
+    std::atomic<bool> m_sleeping{false};
+
+    wxThread* m_thread = nullptr;
+
+    // Protects all the fields below.
+    wxMutex m_mutex;
+
+    // Signalled when there are new records to write or the writer thread
+    // should stop.
+    wxCondition m_condWork;
+
+    // Signalled when the writer thread has written all the records.
+    wxCondition m_condDone;
+
+    // Rings of all the threads which have logged anything and still exist or
+    // whose records haven't been written yet.
+    std::unordered_map<wxThreadIdType,
+                       std::shared_ptr<RecordsRing>> m_threadRings;
+
+    // Incremented by Sync() and set to the value of m_syncRequested by the
+    // writer thread once it has written all the records.
+    unsigned m_syncRequested = 0;
+    unsigned m_syncDone = 0;
+
+    bool m_stop = false;
+
+    wxDECLARE_NO_COPY_CLASS(wxLogAsyncImpl);
+};
+
+RecordsRing& wxLogAsyncImpl::GetThreadRing()
+{
+    if ( gs_threadRing.loggerId != m_id )
+    {
+        // This thread doesn't use the ring of the other logger any more.
+        if ( gs_threadRing.ring )
+            gs_threadRing.ring->SetAbandoned();
+
+        wxMutexLocker lock(m_mutex);
+
+        // Reuse the ring of this thread, if it used this logger before, or of
+        // the thread that used to have the same id, if any, as that thread
+        // can't be logging anything any more, if it hasn't been deleted yet.
+        std::shared_ptr<RecordsRing>& ring =
+            m_threadRings[wxThread::GetCurrentId()];
+        if ( ring )
+            ring->ResetAbandoned();
+        else
+            ring = std::make_shared<RecordsRing>(m_capacity);
+
+        gs_threadRing.loggerId = m_id;
+        gs_threadRing.ring = ring;
+    }
+
+    return *gs_threadRing.ring;
+}
+
+bool wxLogAsyncImpl::HasRecords() const
+{
+    for ( const auto& it : m_threadRings )
+    {
+        if ( !it.second->IsEmpty() )
+            return true;
+    }
+
+    return false;
+}
+
+void wxLogAsyncImpl::DeleteAbandonedRings()
+{
+    wxMutexLocker lock(m_mutex);
+
+    for ( auto it = m_threadRings.begin(); it != m_threadRings.end(); )
+    {
+        // Notice that the order of checks matters: if the ring is abandoned,
+        // no more records can be added to it, so if it's empty after this,
+        // it will remain empty.
+        if ( it->second->IsAbandoned() && it->second->IsEmpty() )
+            it = m_threadRings.erase(it);
+        else
+            ++it;
+    }
+}
+
+void
+wxLogAsyncImpl::Log(wxLogLevel level,
+                    const wxString& msg,
+                    const wxLogRecordInfo& info)
+{
+    // Log synchronously if we can't use the background thread, including
+    // when logging from the writer thread itself, e.g. if the target logs an
+    // error, as it could deadlock otherwise.
+    if ( !m_thread || gs_isWriterThread )
+    {
+        m_target->LogRecord(level, msg, info);
+        return;
+    }
+
+    RecordsRing& ring = GetThreadRing();
+    while ( !ring.TryPush(level, msg, info) )
+    {
+        if ( m_overflow == wxLOG_ASYNC_DROP )
+        {
+            m_dropped++;
+            return;
+        }
+
+        // Wait until the writer thread frees some space: notice that we need
+        // to check if the ring is still full after locking the mutex, as the
+        // writer could have emptied it in the meanwhile and it only signals
+        // m_condDone with the mutex locked.
+        wxMutexLocker lock(m_mutex);
+        m_condWork.Signal();
+        if ( ring.IsFull() )
+            m_condDone.Wait();
+    }
+
+    // Wake up the writer thread if it's waiting: the fence ensures that it
+    // either sees the new record or that we see it sleeping, see WriterLoop().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ( m_sleeping.load(std::memory_order_relaxed) )
+        WakeUp();
+}
+
+void wxLogAsyncImpl::WakeUp()
+{
+    wxMutexLocker lock(m_mutex);
+    m_condWork.Signal();
+}
+
+void wxLogAsyncImpl::Sync()
+{
+    if ( !m_thread || gs_isWriterThread )
+    {
+        m_target->Flush();
+        return;
+    }
+
+    wxMutexLocker lock(m_mutex);
+
+    const unsigned request = ++m_syncRequested;
+    m_condWork.Signal();
+
+    while ( static_cast<int>(m_syncDone - request) < 0 )
+        m_condDone.Wait();
+}
+
+void wxLogAsyncImpl::WriteRecords()
+{
+    // Only this thread deletes the rings, so it's safe to use the pointers
+    // to them without holding the lock.
+    std::vector<RecordsRing*> rings;
+    {
+        wxMutexLocker lock(m_mutex);
+        for ( const auto& it : m_threadRings )
+            rings.push_back(it.second.get());
+    }
+
+    std::vector<RecordsRing::Record> records;
+    for ( RecordsRing* ring : rings )
+        ring->PopAll(records);
+
+    // Restore the chronological order of the records from different threads.
+    if ( rings.size() > 1 )
+    {
+        std::stable_sort(records.begin(), records.end(),
+                         [](const RecordsRing::Record& r1,
+                            const RecordsRing::Record& r2)
+                         {
+                             return r1.info.timestampMS < r2.info.timestampMS;
+                         });
+    }
+
+    for ( const auto& record : records )
+        m_target->LogRecord(record.level, record.msg, record.info);
+
+    m_target->Flush();
+
+    DeleteAbandonedRings();
+}
+
+void wxLogAsyncImpl::WriterLoop()
+{
+    for ( ;; )
+    {
+        unsigned request;
+        bool stop;
+        {
+            wxMutexLocker lock(m_mutex);
+            for ( ;; )
+            {
+                request = m_syncRequested;
+                stop = m_stop;
+                if ( stop || request != m_syncDone )
+                    break;
+
+                // Tell the logging threads to wake us up before checking for
+                // the records for the last time, see the end of Log().
+                m_sleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if ( HasRecords() )
+                {
+                    m_sleeping.store(false, std::memory_order_relaxed);
+                    break;
+                }
+
+                m_condWork.Wait();
+
+                m_sleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        WriteRecords();
+
+        {
+            wxMutexLocker lock(m_mutex);
+            m_syncDone = request;
+
+            // Wake up both the threads waiting for the free space and for the
+            // records to be written.
+            m_condDone.Broadcast();
+        }
+
+        if ( stop )
+            break;
+    }
+}
+
+// ============================================================================
+// wxLogAsync implementation
+// ============================================================================
+
+wxLogAsync::wxLogAsync(wxLog* target,
+                       size_t capacity,
+                       wxLogAsyncOverflow overflow)
+    : m_impl(new wxLogAsyncImpl(target, wxMax(capacity, 1), overflow))
+{
+    wxASSERT_MSG( target, "log target must be specified" );
+}
+
+wxLogAsync::~wxLogAsync()
+{
+    // Make sure the last repeated message, if any, is written too.
+    wxLog::Flush();
+
+    delete m_impl;
+}
+
+wxLog* wxLogAsync::GetTarget() const
+{
+    return m_impl->GetTarget();
+}
+
+void wxLogAsync::Flush()
+{
+    wxLog::Flush();
+
+    m_impl->WakeUp();
+}
+
+void wxLogAsync::Sync()
+{
+    wxLog::Flush();
+
+    m_impl->Sync();
+}
+
+size_t wxLogAsync::GetDroppedCount() const
+{
+    return m_impl->GetDroppedCount();
+}
+
+void wxLogAsync::DoLogRecord(wxLogLevel level,
+                             const wxString& msg,
+                             const wxLogRecordInfo& info)
+{
+    if ( m_impl->GetTarget() )
+        m_impl->Log(level, msg, info);
+}
+
+#endif // wxUSE_LOG && wxUSE_THREADS
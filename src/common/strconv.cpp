@@ -385,33 +385,113 @@ size_t wxMBConv::WC2MB(char *outBuff, const wchar_t *inBuff, size_t outLen) cons
     return rc;
 }
 
+size_t
+wxMBConv::GetMaxWCharLen(const char *WXUNUSED(src),
+                         size_t WXUNUSED(srcLen)) const
+{
+    return wxCONV_FAILED;
+}
+
+size_t
+wxMBConv::GetMaxMBLen(const wchar_t *WXUNUSED(src),
+                      size_t WXUNUSED(srcLen)) const
+{
+    return wxCONV_FAILED;
+}
+
+size_t
+wxMBConv::ToWCharBuffer(wxWCharBuffer& dst,
+                        const char *src, size_t srcLen) const
+{
+    size_t dstLen = GetMaxWCharLen(src, srcLen);
+    const bool singlePass = dstLen != wxCONV_FAILED;
+    if ( !singlePass )
+    {
+        dstLen = ToWChar(nullptr, 0, src, srcLen);
+        if ( dstLen == wxCONV_FAILED )
+            return wxCONV_FAILED;
+    }
+
+    // Notice that this always allocates space for one more character, so the
+    // buffer is NUL-terminated even if the input isn't.
+    wxWCharBuffer buf(dstLen);
+    dstLen = ToWChar(buf.data(), dstLen, src, srcLen);
+    if ( dstLen == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    // Release the unused memory if we had to allocate more than needed.
+    if ( singlePass && !buf.extend(dstLen) )
+        return wxCONV_FAILED;
+
+    dst = buf;
+
+    return dstLen;
+}
+
+size_t
+wxMBConv::FromWCharBuffer(wxCharBuffer& dst,
+                          const wchar_t *src, size_t srcLen) const
+{
+    size_t dstLen = GetMaxMBLen(src, srcLen);
+    const bool singlePass = dstLen != wxCONV_FAILED;
+    if ( !singlePass )
+    {
+        dstLen = FromWChar(nullptr, 0, src, srcLen);
+        if ( dstLen == wxCONV_FAILED )
+            return wxCONV_FAILED;
+    }
+
+    // Notice that this must be only called after FromWChar() for the
+    // converters, such as wxConvAuto, which determine the encoding on the
+    // first use.
+    const size_t nulLen = GetMBNulLen();
+
+    // As above, ensure that the buffer is always NUL-terminated, even if the
+    // input is not, but here we may need more than one NUL.
+    wxCharBuffer buf(dstLen + nulLen - 1);
+    memset(buf.data() + dstLen, 0, nulLen);
+
+    // Notice that the return value of FromWChar() here may be different from
+    // the one above, even when not using a single pass, as it could have
+    // overestimated the space needed, while what we get here is the exact
+    // length.
+    dstLen = FromWChar(buf.data(), dstLen, src, srcLen);
+    if ( dstLen == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    if ( singlePass && !buf.extend(dstLen + nulLen - 1) )
+        return wxCONV_FAILED;
+
+    // Keep all the trailing NULs, but don't count them in the buffer length.
+    memset(buf.data() + dstLen, 0, nulLen);
+    buf.shrink(dstLen);
+
+    dst = buf;
+
+    return dstLen;
+}
+
 wxWCharBuffer
 wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 {
-    const size_t dstLen = ToWChar(nullptr, 0, inBuff, inLen);
+    wxWCharBuffer wbuf;
+    size_t dstLen = ToWCharBuffer(wbuf, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
-        // notice that we allocate space for dstLen+1 wide characters here
-        // because we want the buffer to always be NUL-terminated, even if the
-        // input isn't (as otherwise the caller has no way to know its length)
-        wxWCharBuffer wbuf(dstLen);
-        if ( ToWChar(wbuf.data(), dstLen, inBuff, inLen) != wxCONV_FAILED )
+        if ( outLen )
         {
-            if ( outLen )
-            {
-                *outLen = dstLen;
-
-                // we also need to handle NUL-terminated input strings
-                // specially: for them the output is the length of the string
-                // excluding the trailing NUL, however if we're asked to
-                // convert a specific number of characters we return the length
-                // of the resulting output even if it's NUL-terminated
-                if ( inLen == wxNO_LEN )
-                    (*outLen)--;
-            }
+            // we also need to handle NUL-terminated input strings specially:
+            // for them the output is the length of the string excluding the
+            // trailing NUL, however if we're asked to convert a specific
+            // number of characters we return the length of the resulting
+            // output even if it's NUL-terminated
+            if ( inLen == wxNO_LEN )
+                dstLen--;
 
-            return wbuf;
+            *outLen = dstLen;
         }
+
+        return wbuf;
     }
 
     if ( outLen )
@@ -423,36 +503,32 @@ wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 wxCharBuffer
 wxMBConv::cWC2MB(const wchar_t *inBuff, size_t inLen, size_t *outLen) const
 {
-    size_t dstLen = FromWChar(nullptr, 0, inBuff, inLen);
+    wxCharBuffer buf;
+    size_t dstLen = FromWCharBuffer(buf, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
+        // for compatibility, the length of the returned buffer includes all
+        // the trailing NULs except the last one, as it always did
         const size_t nulLen = GetMBNulLen();
-
-        // as above, ensure that the buffer is always NUL-terminated, even if
-        // the input is not
-        wxCharBuffer buf(dstLen + nulLen - 1);
-        memset(buf.data() + dstLen, 0, nulLen);
-
-        // Notice that return value of the call to FromWChar() here may be
-        // different from the one above as it could have overestimated the
-        // space needed, while what we get here is the exact length.
-        dstLen = FromWChar(buf.data(), dstLen, inBuff, inLen);
-        if ( dstLen != wxCONV_FAILED )
+        if ( nulLen > 1 && !buf.extend(dstLen + nulLen - 1) )
         {
             if ( outLen )
-            {
-                *outLen = dstLen;
+                *outLen = 0;
 
-                if ( inLen == wxNO_LEN )
-                {
-                    // in this case both input and output are NUL-terminated
-                    // and we're not supposed to count NUL
-                    *outLen -= nulLen;
-                }
-            }
+            return wxCharBuffer();
+        }
 
-            return buf;
+        if ( outLen )
+        {
+            // in this case both input and output are NUL-terminated and
+            // we're not supposed to count NUL
+            if ( inLen == wxNO_LEN )
+                dstLen -= nulLen;
+
+            *outLen = dstLen;
         }
+
+        return buf;
     }
 
     if ( outLen )
@@ -469,21 +545,17 @@ wxWCharBuffer wxMBConv::DoConvertMB2WC(const char* buf, size_t srcLen) const
     // come from wxScopedCharBuffer.
     if ( srcLen && buf )
     {
-        const size_t dstLen = ToWChar(nullptr, 0, buf, srcLen);
+        wxWCharBuffer wbuf;
+        const size_t dstLen = ToWCharBuffer(wbuf, buf, srcLen);
         if ( dstLen != wxCONV_FAILED )
         {
-            wxWCharBuffer wbuf(dstLen);
-            wbuf.data()[dstLen] = L'\0';
-            if ( ToWChar(wbuf.data(), dstLen, buf, srcLen) != wxCONV_FAILED )
-            {
-                // If the input string was NUL-terminated, we shouldn't include
-                // the length of the trailing NUL into the length of the return
-                // value.
-                if ( srcLen == wxNO_LEN )
-                    wbuf.shrink(dstLen - 1);
+            // If the input string was NUL-terminated, we shouldn't include
+            // the length of the trailing NUL into the length of the return
+            // value.
+            if ( srcLen == wxNO_LEN )
+                wbuf.shrink(dstLen - 1);
 
-                return wbuf;
-            }
+            return wbuf;
         }
     }
 
@@ -494,20 +566,16 @@ wxCharBuffer wxMBConv::DoConvertWC2MB(const wchar_t* wbuf, size_t srcLen) const
 {
     if ( srcLen && wbuf )
     {
-        const size_t dstLen = FromWChar(nullptr, 0, wbuf, srcLen);
+        wxCharBuffer buf;
+        const size_t dstLen = FromWCharBuffer(buf, wbuf, srcLen);
         if ( dstLen != wxCONV_FAILED )
         {
-            wxCharBuffer buf(dstLen);
-            buf.data()[dstLen] = '\0';
-            if ( FromWChar(buf.data(), dstLen, wbuf, srcLen) != wxCONV_FAILED )
-            {
-                // As above, in DoConvertMB2WC(), except that the length of the
-                // trailing NUL is variable in this case.
-                if ( srcLen == wxNO_LEN )
-                    buf.shrink(dstLen - GetMBNulLen());
+            // As above, in DoConvertMB2WC(), except that the length of the
+            // trailing NUL is variable in this case.
+            if ( srcLen == wxNO_LEN )
+                buf.shrink(dstLen - GetMBNulLen());
 
-                return buf;
-            }
+            return buf;
         }
     }
 
@@ -943,6 +1011,207 @@ extern const unsigned char tableUtf8Lengths[256] = {
                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0   // F5..FF
 };
 
+// Runs of ASCII characters are very common in UTF-8 strings and are handled
+// separately, several characters at once. SSE2 is always available under
+// x86-64 and NEON under ARM64, so we don't need to check for them at run-time.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define wxSTRCONV_USE_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define wxSTRCONV_USE_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+
+// Convert the initial run of ASCII characters of src, which is at most maxLen
+// bytes long, to dst, if it's non-null, and return the length of this run.
+size_t ConvertASCIIToWChar(const char *src, size_t maxLen, wchar_t *dst)
+{
+    size_t n = 0;
+
+#if defined(wxSTRCONV_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; n + 16 <= maxLen; n += 16 )
+    {
+        const __m128i
+            bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n));
+        if ( _mm_movemask_epi8(bytes) )
+            break;
+
+        if ( dst )
+        {
+            const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+            __m128i* const out = reinterpret_cast<__m128i*>(dst + n);
+#ifdef WC_UTF16
+            _mm_storeu_si128(out, lo);
+            _mm_storeu_si128(out + 1, hi);
+#else
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+#endif
+        }
+    }
+#elif defined(wxSTRCONV_USE_NEON)
+    for ( ; n + 16 <= maxLen; n += 16 )
+    {
+        const uint8x16_t
+            bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(src + n));
+        if ( vmaxvq_u8(bytes) >= 0x80 )
+            break;
+
+        if ( dst )
+        {
+            const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t hi = vmovl_high_u8(bytes);
+
+#ifdef WC_UTF16
+            uint16_t* const out = reinterpret_cast<uint16_t*>(dst + n);
+            vst1q_u16(out, lo);
+            vst1q_u16(out + 8, hi);
+#else
+            uint32_t* const out = reinterpret_cast<uint32_t*>(dst + n);
+            vst1q_u32(out, vmovl_u16(vget_low_u16(lo)));
+            vst1q_u32(out + 4, vmovl_high_u16(lo));
+            vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+            vst1q_u32(out + 12, vmovl_high_u16(hi));
+#endif
+        }
+    }
+#else // no SIMD
+    // Check 8 bytes at once, but convert them one by one.
+    for ( ; n + 8 <= maxLen; n += 8 )
+    {
+        wxUint64 bytes;
+        memcpy(&bytes, src + n, sizeof(bytes));
+        if ( bytes & wxULL(0x8080808080808080) )
+            break;
+
+        if ( dst )
+        {
+            for ( size_t i = n; i < n + 8; i++ )
+                dst[i] = static_cast<unsigned char>(src[i]);
+        }
+    }
+#endif // SIMD
+
+    // Deal with the remaining characters, including any characters in the
+    // last chunk before the first non-ASCII one.
+    for ( ; n < maxLen; n++ )
+    {
+        const unsigned char c = src[n];
+        if ( c >= 0x80 )
+            break;
+
+        if ( dst )
+            dst[n] = c;
+    }
+
+    return n;
+}
+
+// Convert the initial run of ASCII characters of src, which is at most maxLen
+// characters long, to dst, if it's non-null, and return the length of this
+// run.
+size_t ConvertASCIIFromWChar(const wchar_t *src, size_t maxLen, char *dst)
+{
+    size_t n = 0;
+
+#if defined(wxSTRCONV_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; n + 16 <= maxLen; n += 16 )
+    {
+        const __m128i* const in = reinterpret_cast<const __m128i*>(src + n);
+#ifdef WC_UTF16
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+
+        const __m128i high = _mm_and_si128(_mm_or_si128(a, b),
+                                           _mm_set1_epi16(~0x7F));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF )
+            break;
+
+        if ( dst )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n),
+                             _mm_packus_epi16(a, b));
+        }
+#else
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+        const __m128i c = _mm_loadu_si128(in + 2);
+        const __m128i d = _mm_loadu_si128(in + 3);
+
+        const __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b),
+                                                        _mm_or_si128(c, d)),
+                                           _mm_set1_epi32(~0x7F));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF )
+            break;
+
+        if ( dst )
+        {
+            // All values are less than 0x80, so saturation never happens.
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n),
+                             _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                              _mm_packs_epi32(c, d)));
+        }
+#endif
+    }
+#elif defined(wxSTRCONV_USE_NEON)
+    for ( ; n + 16 <= maxLen; n += 16 )
+    {
+#ifdef WC_UTF16
+        const uint16_t* const in = reinterpret_cast<const uint16_t*>(src + n);
+        const uint16x8_t a = vld1q_u16(in);
+        const uint16x8_t b = vld1q_u16(in + 8);
+        if ( vmaxvq_u16(vorrq_u16(a, b)) >= 0x80 )
+            break;
+
+        const uint16x8_t ab = a;
+        const uint16x8_t cd = b;
+#else
+        const uint32_t* const in = reinterpret_cast<const uint32_t*>(src + n);
+        const uint32x4_t a = vld1q_u32(in);
+        const uint32x4_t b = vld1q_u32(in + 4);
+        const uint32x4_t c = vld1q_u32(in + 8);
+        const uint32x4_t d = vld1q_u32(in + 12);
+        if ( vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80 )
+            break;
+
+        const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+        const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+#endif
+
+        if ( dst )
+        {
+            vst1q_u8(reinterpret_cast<uint8_t*>(dst + n),
+                     vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+        }
+    }
+#endif // SIMD
+
+    for ( ; n < maxLen; n++ )
+    {
+        // Note that the cast ensures that negative values are not considered
+        // to be ASCII.
+        const wxUint32 c = static_cast<wxUint32>(src[n]);
+        if ( c >= 0x80 )
+            break;
+
+        if ( dst )
+            dst[n] = static_cast<char>(c);
+    }
+
+    return n;
+}
+
+} // anonymous namespace
+
 size_t
 wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
                             const char *src, size_t srcLen) const
@@ -955,6 +1224,27 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
 
     for ( const char *p = src; ; p++ )
     {
+        if ( srcLen && static_cast<unsigned char>(*p) < 0x80 )
+        {
+            const size_t run = ConvertASCIIToWChar(p,
+                                                   out ? wxMin(srcLen, dstLen)
+                                                       : srcLen,
+                                                   out);
+            if ( run > 1 )
+            {
+                // Leave the last character of the run to the code below, to
+                // let it check for the end of the output buffer as usual.
+                p += run - 1;
+                srcLen -= run - 1;
+                written += run - 1;
+                if ( out )
+                {
+                    out += run - 1;
+                    dstLen -= run - 1;
+                }
+            }
+        }
+
         if ( (srcLen == wxNO_LEN ? !*p : !srcLen) )
         {
             // all done successfully, just add the trailing NUL if we are not
@@ -1065,10 +1355,27 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     char *out = dstLen ? dst : nullptr;
     size_t written = 0;
 
-    const wchar_t* const end = srcLen == wxNO_LEN ? nullptr : src + srcLen;
+    const wchar_t* const end = src + (srcLen == wxNO_LEN ? wxWcslen(src)
+                                                         : srcLen);
     for ( const wchar_t *wp = src; ; )
     {
-        if ( end ? wp == end : !*wp )
+        if ( wp != end && static_cast<wxUint32>(*wp) < 0x80 )
+        {
+            size_t maxRun = end - wp;
+            if ( out && dstLen < maxRun )
+                maxRun = dstLen;
+
+            const size_t run = ConvertASCIIFromWChar(wp, maxRun, out);
+            wp += run;
+            written += run;
+            if ( out )
+            {
+                out += run;
+                dstLen -= run;
+            }
+        }
+
+        if ( wp == end )
         {
             // all done successfully, just add the trailing NUL if we are not
             // using explicit length
@@ -1095,7 +1402,7 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
         if ( IsSurrogate(code) )
         {
             // Check that we have the second part of the surrogate pair.
-            if ( end ? wp == end : !*wp )
+            if ( wp == end )
                 return wxCONV_FAILED;
 
             code = EncodeSurrogate(code, *wp++);
@@ -1178,6 +1485,28 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     return wxCONV_FAILED;
 }
 
+size_t
+wxMBConvStrictUTF8::GetMaxWCharLen(const char *src, size_t srcLen) const
+{
+    // Each byte is converted to at most one character, as even in UTF-16 the
+    // surrogates are only used for 4 byte sequences.
+    return srcLen == wxNO_LEN ? strlen(src) + 1 : srcLen;
+}
+
+size_t
+wxMBConvStrictUTF8::GetMaxMBLen(const wchar_t *src, size_t srcLen) const
+{
+    if ( srcLen == wxNO_LEN )
+        srcLen = wxWcslen(src) + 1;
+
+#ifdef WC_UTF16
+    // Surrogate pairs use 4 bytes, all the other characters at most 3.
+    return 3*srcLen;
+#else
+    return 4*srcLen;
+#endif
+}
+
 size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
                              const char *psz, size_t srcLen) const
 {
@@ -1189,6 +1518,12 @@ size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
     // The length can be either given explicitly or computed implicitly for the
     // NUL-terminated strings.
     const bool isNulTerminated = srcLen == wxNO_LEN;
+    const char* const srcEnd = psz + (isNulTerminated ? strlen(psz) : srcLen);
+
+    // Runs of ASCII characters can be converted at once, unless backslashes
+    // need to be escaped.
+    const bool convertASCIIRuns = !(m_options & MAP_INVALID_UTF8_TO_OCTAL);
+
     while ((isNulTerminated ? *psz : srcLen--) && ((!buf) || (len < n)))
     {
         const char *opsz = psz;
@@ -1204,6 +1539,21 @@ size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
                 *buf++ = cc;
             len++;
 
+            if (convertASCIIRuns)
+            {
+                size_t maxRun = srcEnd - psz;
+                if (buf && n - len < maxRun)
+                    maxRun = n - len;
+
+                const size_t run = ConvertASCIIToWChar(psz, maxRun, buf);
+                psz += run;
+                if (!isNulTerminated)
+                    srcLen -= run;
+                if (buf)
+                    buf += run;
+                len += run;
+            }
+
             // escape the escape character for octal escapes
             if ((m_options & MAP_INVALID_UTF8_TO_OCTAL)
                     && cc == '\\' && (!buf || len < n))
@@ -1346,6 +1696,24 @@ size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
     return len;
 }
 
+size_t wxMBConvUTF8::GetMaxWCharLen(const char *src, size_t srcLen) const
+{
+    // Each invalid byte is converted to 4 characters when using octal
+    // escapes, so don't even try to estimate the length of the result.
+    if ( m_options & MAP_INVALID_UTF8_TO_OCTAL )
+        return wxCONV_FAILED;
+
+    size_t maxLen = wxMBConvStrictUTF8::GetMaxWCharLen(src, srcLen);
+
+#ifdef WC_UTF16
+    // The PUA characters used for the invalid bytes need surrogate pairs.
+    if ( m_options & MAP_INVALID_UTF8_TO_PUA )
+        maxLen *= 2;
+#endif
+
+    return maxLen;
+}
+
 static inline bool isoctal(wchar_t wch)
 {
     return L'0' <= wch && wch <= L'7';
@@ -1541,6 +1909,30 @@ size_t wxMBConvUTF16Base::GetLength(const char *src, size_t srcLen)
     return srcLen;
 }
 
+size_t
+wxMBConvUTF16Base::GetMaxWCharLen(const char *src, size_t srcLen) const
+{
+    srcLen = GetLength(src, srcLen);
+    if ( srcLen == wxNO_LEN )
+        return wxCONV_FAILED;
+
+    return srcLen / BYTES_PER_CHAR;
+}
+
+size_t
+wxMBConvUTF16Base::GetMaxMBLen(const wchar_t *src, size_t srcLen) const
+{
+    if ( srcLen == wxNO_LEN )
+        srcLen = wxWcslen(src) + 1;
+
+#ifdef WC_UTF16
+    return srcLen*BYTES_PER_CHAR;
+#else
+    // Characters outside of BMP need surrogate pairs.
+    return srcLen*2*BYTES_PER_CHAR;
+#endif
+}
+
 // case when in-memory representation is UTF-16 too
 #ifdef WC_UTF16
 
@@ -1886,6 +2278,30 @@ size_t wxMBConvUTF32Base::GetLength(const char *src, size_t srcLen)
     return srcLen;
 }
 
+size_t
+wxMBConvUTF32Base::GetMaxWCharLen(const char *src, size_t srcLen) const
+{
+    srcLen = GetLength(src, srcLen);
+    if ( srcLen == wxNO_LEN )
+        return wxCONV_FAILED;
+
+#ifdef WC_UTF16
+    // Characters outside of BMP need surrogate pairs.
+    return 2*(srcLen / BYTES_PER_CHAR);
+#else
+    return srcLen / BYTES_PER_CHAR;
+#endif
+}
+
+size_t
+wxMBConvUTF32Base::GetMaxMBLen(const wchar_t *src, size_t srcLen) const
+{
+    if ( srcLen == wxNO_LEN )
+        srcLen = wxWcslen(src) + 1;
+
+    return srcLen*BYTES_PER_CHAR;
+}
+
 // case when in-memory representation is UTF-16
 #ifdef WC_UTF16
 
@@ -3319,6 +3735,23 @@ size_t wxCSConv::GetMBNulLen() const
     return 1;
 }
 
+size_t wxCSConv::GetMaxWCharLen(const char *src, size_t srcLen) const
+{
+    if ( m_convReal )
+        return m_convReal->GetMaxWCharLen(src, srcLen);
+
+    // otherwise, we are ISO-8859-1
+    return srcLen == wxNO_LEN ? strlen(src) + 1 : srcLen;
+}
+
+size_t wxCSConv::GetMaxMBLen(const wchar_t *src, size_t srcLen) const
+{
+    if ( m_convReal )
+        return m_convReal->GetMaxMBLen(src, srcLen);
+
+    return srcLen == wxNO_LEN ? wxWcslen(src) + 1 : srcLen;
+}
+
 bool wxCSConv::IsUTF8() const
 {
     if ( m_convReal )
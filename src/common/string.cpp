@@ -511,22 +511,53 @@ const char *wxString::AsChar(const wxMBConv& conv) const
     const size_t lenWC = m_impl.length();
 #endif // wxUSE_UNICODE_UTF8/wxUSE_UNICODE_WCHAR
 
+    ConvertedBuffer<char>& converted =
+        const_cast<wxString *>(this)->m_convertedToChar;
+
+    // If we know the maximal size of the result, we can convert the string
+    // in a single pass, instead of computing the size of the result first.
+    // But don't do it if we already have a buffer which is too small for the
+    // longest possible result, as we want to keep using it if the size of the
+    // result doesn't change, for the same reasons as in AsWChar().
+    const size_t maxLenMB = conv.GetMaxMBLen(strWC, lenWC);
+    if ( maxLenMB != wxCONV_FAILED &&
+            (!converted.m_str || converted.m_len >= maxLenMB) )
+    {
+        const bool allocated = !converted.m_str;
+        if ( allocated && !converted.Extend(maxLenMB) )
+            return nullptr;
+
+        const size_t lenMB = conv.FromWChar(converted.m_str, maxLenMB,
+                                            strWC, lenWC);
+        if ( lenMB == wxCONV_FAILED )
+            return nullptr;
+
+        // Don't waste the memory not used by the result.
+        if ( allocated && !converted.Extend(lenMB) )
+            return nullptr;
+
+        converted.m_len = lenMB;
+        converted.m_str[lenMB] = '\0';
+
+        return converted.m_str;
+    }
+
     const size_t lenMB = conv.FromWChar(nullptr, 0, strWC, lenWC);
     if ( lenMB == wxCONV_FAILED )
         return nullptr;
 
-    if ( !m_convertedToChar.m_str || lenMB != m_convertedToChar.m_len )
+    if ( !converted.m_str || lenMB != converted.m_len )
     {
-        if ( !const_cast<wxString *>(this)->m_convertedToChar.Extend(lenMB) )
+        if ( !converted.Extend(lenMB) )
             return nullptr;
     }
 
-    m_convertedToChar.m_str[lenMB] = '\0';
-    if ( conv.FromWChar(m_convertedToChar.m_str, lenMB,
+    converted.m_str[lenMB] = '\0';
+    if ( conv.FromWChar(converted.m_str, lenMB,
                         strWC, lenWC) == wxCONV_FAILED )
         return nullptr;
 
-    return m_convertedToChar.m_str;
+    return converted.m_str;
 }
 
 // ---------------------------------------------------------------------------
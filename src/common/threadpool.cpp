@@ -0,0 +1,370 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool implementation
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+
+#ifndef WX_PRECOMP
+    #include "wx/module.h"
+    #include "wx/utils.h"
+#endif // WX_PRECOMP
+
+#include "wx/thread.h"
+
+#include "wx/private/threadpool.h"
+
+#include <vector>
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolImpl: the actual pool implementation
+// ----------------------------------------------------------------------------
+
+// Set to true in the pool threads and in the thread calling ParallelFor()
+// while it runs, used to detect recursive calls to it.
+thread_local bool gs_isPoolThread = false;
+
+class wxThreadPoolImpl
+{
+public:
+    wxThreadPoolImpl()
+        : m_condTask(m_mutex),
+          m_condDone(m_mutex)
+    {
+    }
+
+    ~wxThreadPoolImpl()
+    {
+        Stop();
+    }
+
+    static wxThreadPoolImpl& Get()
+    {
+        static wxThreadPoolImpl s_pool;
+        return s_pool;
+    }
+
+    // Try to start executing the given job, return false if another one is
+    // already running.
+    bool Run(int count, int maxThreads, int numParts,
+             const wxThreadPool::RangeFunc& func);
+
+    // Stop and delete all the threads, the pool can't be used after this.
+    void Stop();
+
+private:
+    class Worker : public wxThread
+    {
+    public:
+        Worker(wxThreadPoolImpl& pool, size_t index, unsigned generation)
+            : wxThread(wxTHREAD_JOINABLE),
+              m_pool(pool),
+              m_index(index),
+              m_generation(generation)
+        {
+        }
+
+    protected:
+        virtual void* Entry() override
+        {
+            gs_isPoolThread = true;
+
+            m_pool.WorkerLoop(m_index, m_generation);
+
+            return nullptr;
+        }
+
+    private:
+        wxThreadPoolImpl& m_pool;
+        const size_t m_index;
+        const unsigned m_generation;
+    };
+
+    // Main function of the worker threads, the arguments are the index of the
+    // thread in m_workers and the generation of the last job which this thread
+    // shouldn't take part in.
+    void WorkerLoop(size_t index, unsigned generation);
+
+    // Process the parts of the current job until there are no more of them
+    // left. Must be called with m_mutex locked, which is temporarily unlocked
+    // while calling the job function.
+    void ProcessParts();
+
+    // Make sure we have at least the given number of worker threads, return
+    // the number of the threads we actually have.
+    size_t EnsureWorkers(size_t count);
+
+
+    // Locked by the thread using the pool to ensure that only one job runs at
+    // any time.
+    wxMutex m_mutexJob;
+
+    // Protects all the fields below.
+    wxMutex m_mutex;
+
+    // Signalled when a new job is available or the threads should exit.
+    wxCondition m_condTask;
+
+    // Signalled when the last part of the job completes.
+    wxCondition m_condDone;
+
+    std::vector<Worker*> m_workers;
+
+    // Current job, if any.
+    const wxThreadPool::RangeFunc* m_func = nullptr;
+    int m_count = 0;
+    int m_numParts = 0;
+
+    // Number of worker threads allowed to take part in the current job: the
+    // pool may have more threads than this if it had been used with a bigger
+    // maximal number of threads before, but only the threads with the index
+    // less than this one process the job parts.
+    size_t m_numWorkers = 0;
+
+    // Index of the next part to process and the number of processed ones.
+    int m_nextPart = 0;
+    int m_partsDone = 0;
+
+    // Generation of the current job, allows the workers to only take part in
+    // the job once.
+    unsigned m_generation = 0;
+
+    bool m_exit = false;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolImpl);
+};
+
+size_t wxThreadPoolImpl::EnsureWorkers(size_t count)
+{
+    while ( m_workers.size() < count )
+    {
+        Worker* const worker = new Worker(*this, m_workers.size(), m_generation);
+        if ( worker->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete worker;
+            break;
+        }
+
+        m_workers.push_back(worker);
+    }
+
+    return m_workers.size();
+}
+
+void wxThreadPoolImpl::ProcessParts()
+{
+    while ( m_nextPart < m_numParts )
+    {
+        const int part = m_nextPart++;
+        const int from = static_cast<int>(
+            static_cast<wxLongLong_t>(m_count) * part / m_numParts);
+        const int to = static_cast<int>(
+            static_cast<wxLongLong_t>(m_count) * (part + 1) / m_numParts);
+        const wxThreadPool::RangeFunc& func = *m_func;
+
+        m_mutex.Unlock();
+        func(from, to);
+        m_mutex.Lock();
+
+        if ( ++m_partsDone == m_numParts )
+            m_condDone.Signal();
+    }
+}
+
+void wxThreadPoolImpl::WorkerLoop(size_t index, unsigned generation)
+{
+    wxMutexLocker lock(m_mutex);
+
+    for ( ;; )
+    {
+        while ( !m_exit &&
+                    (!m_func ||
+                        generation == m_generation ||
+                            index >= m_numWorkers) )
+            m_condTask.Wait();
+
+        if ( m_exit )
+            break;
+
+        generation = m_generation;
+
+        ProcessParts();
+    }
+}
+
+bool wxThreadPoolImpl::Run(int count, int maxThreads, int numParts,
+                           const wxThreadPool::RangeFunc& func)
+{
+    if ( m_mutexJob.TryLock() != wxMUTEX_NO_ERROR )
+        return false;
+
+    {
+        wxMutexLocker lock(m_mutex);
+
+        // The calling thread participates in the job too, so we need one
+        // fewer worker threads.
+        const size_t numWorkers = maxThreads - 1;
+        const size_t numAvailable = m_exit ? 0 : EnsureWorkers(numWorkers);
+        if ( !numAvailable )
+        {
+            m_mutexJob.Unlock();
+            return false;
+        }
+
+        m_numWorkers = wxMin(numWorkers, numAvailable);
+        m_func = &func;
+        m_count = count;
+        m_numParts = numParts;
+        m_nextPart = 0;
+        m_partsDone = 0;
+        m_generation++;
+
+        m_condTask.Broadcast();
+
+        ProcessParts();
+
+        while ( m_partsDone < m_numParts )
+            m_condDone.Wait();
+
+        m_func = nullptr;
+        m_numWorkers = 0;
+    }
+
+    m_mutexJob.Unlock();
+
+    return true;
+}
+
+void wxThreadPoolImpl::Stop()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+        m_exit = true;
+        m_condTask.Broadcast();
+    }
+
+    for ( auto worker : m_workers )
+    {
+        worker->Wait();
+        delete worker;
+    }
+
+    m_workers.clear();
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// wxThreadPool implementation
+// ============================================================================
+
+/* static */
+int wxThreadPool::GetThreadCount(int threads)
+{
+    if ( threads > 0 )
+        return threads;
+
+    const int cpus = wxThread::GetCPUCount();
+    return cpus > 0 ? cpus : 1;
+}
+
+/* static */
+void wxThreadPool::ParallelFor(int count,
+                               int maxThreads,
+                               const RangeFunc& func,
+                               int minItems)
+{
+    if ( count <= 0 )
+        return;
+
+    if ( minItems < 1 )
+        minItems = 1;
+
+    const int maxParts = count / minItems;
+    if ( maxThreads > maxParts )
+        maxThreads = maxParts;
+
+    if ( maxThreads > 1 && !gs_isPoolThread )
+    {
+        // Use more parts than threads to balance the load in case some
+        // parts take longer to process than the others, but not too many to
+        // avoid synchronization overhead.
+        int numParts = 4*maxThreads;
+        if ( numParts > maxParts )
+            numParts = maxParts;
+
+        // The calling thread executes some parts of the job too and must not
+        // try to use the pool again from them.
+        gs_isPoolThread = true;
+        const bool ran = wxThreadPoolImpl::Get().Run(count, maxThreads,
+                                                     numParts, func);
+        gs_isPoolThread = false;
+
+        if ( ran )
+            return;
+    }
+
+    func(0, count);
+}
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolModule: stops the pool threads on shutdown
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolModule : public wxModule
+{
+public:
+    wxThreadPoolModule()
+    {
+        // The pool threads must be stopped while the threads can still be
+        // used, i.e. before the module cleaning up threads support is.
+        AddDependency("wxThreadModule");
+    }
+
+    virtual bool OnInit() override { return true; }
+    virtual void OnExit() override { wxThreadPoolImpl::Get().Stop(); }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxThreadPoolModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxThreadPoolModule, wxModule);
+
+#else // !wxUSE_THREADS
+
+/* static */
+int wxThreadPool::GetThreadCount(int WXUNUSED(threads))
+{
+    return 1;
+}
+
+/* static */
+void wxThreadPool::ParallelFor(int count,
+                               int WXUNUSED(maxThreads),
+                               const RangeFunc& func,
+                               int WXUNUSED(minItems))
+{
+    if ( count > 0 )
+        func(0, count);
+}
+
+#endif // wxUSE_THREADS/!wxUSE_THREADS
@@ -26,8 +26,13 @@
 #include "wx/wfstream.h"
 #include "zlib.h"
 
+#include "wx/thread.h"
+#include "wx/private/threadpool.h"
+
+#include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 // value for the 'version needed to extract' field (20 means 2.0)
 enum {
@@ -1987,6 +1992,16 @@ bool wxZipInputStream::DoOpen(wxZipEntry *entry, bool raw)
     return IsOk();
 }
 
+bool wxZipInputStream::OpenCatalogEntry(wxZipEntry& entry)
+{
+    // The offsets of the entries read from the central directory have already
+    // been adjusted, so there is no need to load the end record again.
+    m_position = 0;
+    m_parentSeekable = true;
+
+    return DoOpen(&entry);
+}
+
 bool wxZipInputStream::OpenDecompressor(bool raw /*=false*/)
 {
     wxASSERT(AfterHeader());
@@ -2177,6 +2192,8 @@ void wxZipOutputStream::Init(int level)
     m_offsetAdjustment = wxInvalidOffset;
     m_endrecWritten = false;
     m_format = wxZIP_FORMAT_DEFAULT;
+    m_parallel = false;
+    m_parallelThreads = 0;
 }
 
 wxZipOutputStream::~wxZipOutputStream()
@@ -2355,6 +2372,9 @@ wxOutputStream *wxZipOutputStream::OpenCompressor(
             else
                 m_deflate->Open(stream);
 
+            if (m_parallel)
+                m_deflate->EnableParallel(m_parallelThreads);
+
             return m_deflate;
         }
 
@@ -2624,4 +2644,307 @@ size_t wxZipOutputStream::OnSysWrite(const void *buffer, size_t size)
     return m_comp->LastWrite();
 }
 
+#if wxUSE_FILE
+
+/////////////////////////////////////////////////////////////////////////////
+// Random access reader
+
+namespace
+{
+
+// Seekable stream reading the file using positional reads, so that several
+// streams can read from the same file concurrently.
+class wxZipPositionalInputStream : public wxInputStream
+{
+public:
+    wxZipPositionalInputStream(const wxFile& file, wxFileOffset length)
+        : m_file(file), m_length(length), m_pos(0)
+    {
+    }
+
+    wxFileOffset GetLength() const override { return m_length; }
+    bool IsSeekable() const override { return true; }
+
+protected:
+    size_t OnSysRead(void *buffer, size_t size) override
+    {
+        if (m_pos >= m_length) {
+            m_lasterror = wxSTREAM_EOF;
+            return 0;
+        }
+
+        if (static_cast<wxUint64>(size) > static_cast<wxUint64>(m_length - m_pos))
+            size = static_cast<size_t>(m_length - m_pos);
+
+        const ssize_t count = m_file.ReadAt(buffer, size, m_pos);
+        if (count == wxInvalidOffset) {
+            m_lasterror = wxSTREAM_READ_ERROR;
+            return 0;
+        }
+        if (count == 0) {
+            m_lasterror = wxSTREAM_EOF;
+            return 0;
+        }
+
+        m_pos += count;
+        return count;
+    }
+
+    wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) override
+    {
+        switch (mode) {
+            case wxFromCurrent: pos += m_pos;       break;
+            case wxFromEnd:     pos += m_length;    break;
+            case wxFromStart:                       break;
+        }
+
+        if (pos < 0)
+            return wxInvalidOffset;
+
+        return m_pos = pos;
+    }
+
+    wxFileOffset OnSysTell() const override { return m_pos; }
+
+private:
+    const wxFile& m_file;
+    const wxFileOffset m_length;
+    wxFileOffset m_pos;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipPositionalInputStream);
+};
+
+// Return the path to extract the entry with the given internal name to, or an
+// empty string if the name would result in a path outside of the directory or
+// contains characters which are not allowed in the file names on this system.
+wxString GetExtractPath(const wxString& dir, const wxString& name, bool isDir)
+{
+    const wxArrayString parts = wxSplit(name, '/', '\0');
+    if (parts.empty())
+        return wxString();
+
+    // Backslashes are path separators under Windows and could be used to
+    // escape from the directory there, so never allow them, even if they're
+    // valid in the file names under the other systems. Notice that the
+    // forbidden characters include ':' under Windows, which could be used to
+    // specify a drive or a stream there.
+    wxString forbidden = wxFileName::GetForbiddenChars();
+    forbidden += wxS('\\');
+
+    wxFileName fn;
+    fn.AssignDir(dir);
+    for (size_t n = 0; n < parts.size(); n++) {
+        const wxString& part = parts[n];
+        if (part.empty() || part == wxS(".."))
+            return wxString();
+        if (part.find_first_of(forbidden) != wxString::npos)
+            return wxString();
+
+        if (isDir || n + 1 < parts.size())
+            fn.AppendDir(part);
+        else
+            fn.SetFullName(part);
+    }
+
+    return fn.GetFullPath();
+}
+
+} // anonymous namespace
+
+class wxZipFileReaderImpl
+{
+public:
+    wxZipFileReaderImpl(const wxString& filename, wxMBConv& conv);
+
+    bool IsOk() const { return m_ok; }
+
+    const std::vector<wxZipEntry>& GetEntries() const { return m_entries; }
+
+    wxZipInputStream *OpenEntry(size_t n) const;
+
+    bool ExtractEntry(size_t n, const wxString& path) const;
+
+private:
+    wxFile m_file;
+    wxFileOffset m_length = 0;
+    wxMBConv& m_conv;
+    std::vector<wxZipEntry> m_entries;
+    bool m_ok = false;
+
+    // Protects the entries extra fields, which are shared with their copies
+    // using non-atomic reference counting.
+    wxCRIT_SECT_DECLARE_MEMBER(m_cs);
+
+    wxDECLARE_NO_COPY_CLASS(wxZipFileReaderImpl);
+};
+
+wxZipFileReaderImpl::wxZipFileReaderImpl(const wxString& filename,
+                                         wxMBConv& conv)
+    : m_conv(conv)
+{
+    if (!m_file.Open(filename))
+        return;
+
+    m_length = m_file.Length();
+    if (m_length == wxInvalidOffset)
+        return;
+
+    wxZipInputStream zip(new wxZipPositionalInputStream(m_file, m_length),
+                         m_conv);
+
+    const int total = zip.GetTotalEntries();
+    if (total > 0)
+        m_entries.reserve(total);
+
+    for (;;) {
+        std::unique_ptr<wxZipEntry> entry(zip.GetNextEntry());
+        if (!entry)
+            break;
+
+        m_entries.push_back(*entry);
+    }
+
+    m_ok = zip.Eof();
+}
+
+wxZipInputStream *wxZipFileReaderImpl::OpenEntry(size_t n) const
+{
+    wxCHECK_MSG(n < m_entries.size(), nullptr, "invalid zip entry index");
+
+    wxZipEntry entry;
+    {
+        wxCRIT_SECT_LOCKER(lock, const_cast<wxCriticalSection&>(m_cs));
+
+        const wxZipEntry& orig = m_entries[n];
+        entry = orig;
+        entry.SetExtra(orig.GetExtra(), orig.GetExtraLen());
+        entry.SetLocalExtra(orig.GetLocalExtra(), orig.GetLocalExtraLen());
+    }
+
+    std::unique_ptr<wxZipInputStream>
+        zip(new wxZipInputStream(new wxZipPositionalInputStream(m_file, m_length),
+                                 m_conv));
+    if (!zip->OpenCatalogEntry(entry))
+        return nullptr;
+
+    return zip.release();
+}
+
+bool wxZipFileReaderImpl::ExtractEntry(size_t n, const wxString& path) const
+{
+    std::unique_ptr<wxZipInputStream> in(OpenEntry(n));
+    if (!in)
+        return false;
+
+    wxFileOutputStream out(path);
+    if (!out.IsOk())
+        return false;
+
+    const size_t BUFSIZE = 65536;
+    wxCharBuffer buf(BUFSIZE);
+    while (in->IsOk()) {
+        const size_t count = in->Read(buf.data(), BUFSIZE).LastRead();
+        if (count && !out.WriteAll(buf.data(), count))
+            return false;
+    }
+
+    return in->Eof() && out.Close();
+}
+
+wxZipFileReader::wxZipFileReader(const wxString& filename,
+                                 wxMBConv& conv /*=wxConvLocal*/)
+  : m_impl(new wxZipFileReaderImpl(filename, conv))
+{
+}
+
+wxZipFileReader::~wxZipFileReader()
+{
+    delete m_impl;
+}
+
+bool wxZipFileReader::IsOk() const
+{
+    return m_impl->IsOk();
+}
+
+size_t wxZipFileReader::GetEntryCount() const
+{
+    return m_impl->GetEntries().size();
+}
+
+const wxZipEntry& wxZipFileReader::GetEntry(size_t n) const
+{
+    wxASSERT_MSG(n < GetEntryCount(), "invalid zip entry index");
+
+    return m_impl->GetEntries()[n];
+}
+
+wxZipInputStream *wxZipFileReader::OpenEntry(size_t n) const
+{
+    return m_impl->OpenEntry(n);
+}
+
+bool wxZipFileReader::Extract(const wxString& dir,
+                              const std::vector<size_t>& entries,
+                              unsigned numThreads /*=0*/) const
+{
+    wxCHECK_MSG(IsOk(), false, "zip file couldn't be read");
+
+    // Create all the directories first, so that the entries can be extracted
+    // in any order.
+    std::vector<std::pair<size_t, wxString>> files;
+    std::unordered_set<wxString> dirs;
+    for (size_t n : entries) {
+        wxCHECK_MSG(n < GetEntryCount(), false, "invalid zip entry index");
+
+        const wxZipEntry& entry = GetEntry(n);
+        const wxString path = GetExtractPath(dir,
+                                             entry.GetInternalName(),
+                                             entry.IsDir());
+        if (path.empty()) {
+            wxLogError(_("unsafe zip entry name \"%s\""),
+                       entry.GetInternalName());
+            return false;
+        }
+
+        const wxString entryDir = wxFileName(path).GetPath();
+        if (dirs.insert(entryDir).second &&
+                !wxFileName::Mkdir(entryDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+            return false;
+
+        if (!entry.IsDir())
+            files.emplace_back(n, path);
+    }
+
+    // The files are extracted by the shared thread pool, which runs the
+    // function in the calling thread only if threads are not available.
+    std::atomic<bool> ok(true);
+    wxThreadPool::ParallelFor
+    (
+        static_cast<int>(files.size()),
+        wxThreadPool::GetThreadCount(static_cast<int>(numThreads)),
+        [this, &files, &ok](int from, int to)
+        {
+            for (int i = from; i < to; i++) {
+                if (!m_impl->ExtractEntry(files[i].first, files[i].second))
+                    ok = false;
+            }
+        }
+    );
+
+    return ok;
+}
+
+bool wxZipFileReader::ExtractAll(const wxString& dir,
+                                 unsigned numThreads /*=0*/) const
+{
+    std::vector<size_t> entries(GetEntryCount());
+    for (size_t n = 0; n < entries.size(); n++)
+        entries[n] = n;
+
+    return Extract(dir, entries, numThreads);
+}
+
+#endif // wxUSE_FILE
+
 #endif // wxUSE_ZIPSTREAM
@@ -23,6 +23,12 @@
     #include "wx/utils.h"
 #endif
 
+#include "wx/thread.h"
+#include "wx/private/threadpool.h"
+
+#include <memory>
+#include <vector>
+
 
 // normally, the compiler options should contain -I../zlib, but it is
 // apparently not the case for all MSW makefiles and so, unless we use
@@ -274,6 +280,413 @@ bool wxZlibInputStream::SetDictionary(const wxMemoryBuffer &buf)
 }
 
 
+//////////////////////////
+// wxZlibParallelDeflate
+//////////////////////////
+
+#if wxUSE_THREADS
+
+enum {
+    // Default size of the blocks compressed in parallel, as used by pigz.
+    PARALLEL_BLOCK_SIZE  = 128*1024,
+
+    // Size of the end of the previous block used as the dictionary.
+    PARALLEL_WINDOW_SIZE = 32*1024
+};
+
+// Helper of wxZlibOutputStream compressing the data using several threads.
+//
+// Each block is compressed as raw deflate data ending with a sync flush,
+// except for the last one which ends the deflate stream, so the compressed
+// blocks can be simply concatenated. The blocks are accumulated and then
+// compressed in batches by the shared thread pool, after which the header,
+// the trailer, containing the checksum combined from the checksums of all
+// blocks, and the compressed blocks themselves, in order, are written by the
+// thread using the stream.
+class wxZlibParallelDeflate
+{
+public:
+    wxZlibParallelDeflate(int level, int flags,
+                          unsigned numThreads, size_t blockSize);
+    ~wxZlibParallelDeflate();
+
+    bool Matches(unsigned numThreads, size_t blockSize) const
+    {
+        return numThreads == m_numThreads && blockSize == m_blockSize;
+    }
+
+    // Allow writing a new stream, even an empty one, after the end of the
+    // previous one.
+    void Restart() { m_finished = false; }
+
+    bool Write(wxOutputStream& out, const void *buffer, size_t size);
+
+    // Compress all the pending data and write out all the blocks, ending the
+    // stream if final is true, in which case nothing more is written until
+    // Write() or Restart() is called.
+    bool Flush(wxOutputStream& out, bool final);
+
+private:
+    struct Job
+    {
+        std::vector<Bytef> input;
+        std::vector<Bytef> dict;
+        std::vector<Bytef> output;
+        uLong check = 0;
+        bool last = false;
+        bool ok = false;
+    };
+
+    bool InitStream(z_stream& z) const;
+    void Compress(z_stream& z, Job& job) const;
+
+    // Return a stream which can be used for compressing by the current
+    // thread, reusing an existing one if possible, or null if creating it
+    // failed. The stream must be given back with ReleaseStream().
+    z_stream* AcquireStream();
+    void ReleaseStream(z_stream* z);
+
+    uLong GetInitialCheck() const;
+
+    // Add the data accumulated in m_input as a new block to be compressed.
+    void Submit(bool last);
+
+    // Compress all the pending blocks and write them out.
+    bool WriteBlocks(wxOutputStream& out);
+
+    bool WriteHeader(wxOutputStream& out) const;
+    bool WriteTrailer(wxOutputStream& out) const;
+
+
+    const int m_level;
+    const int m_flags;
+    const unsigned m_numThreads;
+    const size_t m_blockSize;
+
+    // These fields are only used by the thread writing to the stream.
+    std::vector<Bytef> m_input;
+    std::vector<Bytef> m_window;
+    std::vector<std::unique_ptr<Job>> m_pending;
+    bool m_headerWritten = false;
+    bool m_finished = false;
+    bool m_error = false;
+    uLong m_check;
+    uLong m_totalSize = 0;
+
+    // The streams not currently used by any thread, protected by m_csStreams
+    // as they're used by the pool threads.
+    std::vector<z_stream*> m_streams;
+    wxCriticalSection m_csStreams;
+
+    wxDECLARE_NO_COPY_CLASS(wxZlibParallelDeflate);
+};
+
+wxZlibParallelDeflate::wxZlibParallelDeflate(int level, int flags,
+                                             unsigned numThreads,
+                                             size_t blockSize)
+    : m_level(level),
+      m_flags(flags),
+      m_numThreads(numThreads),
+      m_blockSize(blockSize),
+      m_check(GetInitialCheck())
+{
+    m_input.reserve(m_blockSize);
+}
+
+wxZlibParallelDeflate::~wxZlibParallelDeflate()
+{
+    for ( z_stream* z : m_streams )
+    {
+        deflateEnd(z);
+        delete z;
+    }
+}
+
+uLong wxZlibParallelDeflate::GetInitialCheck() const
+{
+    return m_flags == wxZLIB_GZIP ? crc32(0, nullptr, 0)
+                                  : adler32(0, nullptr, 0);
+}
+
+bool wxZlibParallelDeflate::InitStream(z_stream& z) const
+{
+    memset(&z, 0, sizeof(z));
+
+    return deflateInit2(&z, m_level, Z_DEFLATED, -MAX_WBITS,
+                        8, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+void wxZlibParallelDeflate::Compress(z_stream& z, Job& job) const
+{
+    job.ok = false;
+
+    if ( deflateReset(&z) != Z_OK )
+        return;
+
+    if ( !job.dict.empty() &&
+            deflateSetDictionary(&z, job.dict.data(), job.dict.size()) != Z_OK )
+        return;
+
+    // The bound doesn't account for the sync flush marker, so leave some
+    // extra space for it, but still grow the buffer if necessary.
+    job.output.resize(deflateBound(&z, job.input.size()) + 16);
+
+    z.next_in = job.input.data();
+    z.avail_in = job.input.size();
+
+    const int flush = job.last ? Z_FINISH : Z_SYNC_FLUSH;
+    for ( ;; )
+    {
+        z.next_out = job.output.data() + z.total_out;
+        z.avail_out = job.output.size() - z.total_out;
+
+        const int err = deflate(&z, flush);
+        if ( err == Z_STREAM_END || (err == Z_OK && z.avail_out != 0) )
+            break;
+
+        if ( err != Z_OK && err != Z_BUF_ERROR )
+            return;
+
+        job.output.resize(job.output.size() * 2);
+    }
+
+    job.output.resize(z.total_out);
+
+    if ( m_flags == wxZLIB_GZIP )
+        job.check = crc32(crc32(0, nullptr, 0),
+                          job.input.data(), job.input.size());
+    else if ( m_flags == wxZLIB_ZLIB )
+        job.check = adler32(adler32(0, nullptr, 0),
+                            job.input.data(), job.input.size());
+
+    job.ok = true;
+}
+
+z_stream* wxZlibParallelDeflate::AcquireStream()
+{
+    {
+        wxCriticalSectionLocker lock(m_csStreams);
+        if ( !m_streams.empty() )
+        {
+            z_stream* const z = m_streams.back();
+            m_streams.pop_back();
+            return z;
+        }
+    }
+
+    std::unique_ptr<z_stream> z(new z_stream);
+    if ( !InitStream(*z) )
+        return nullptr;
+
+    return z.release();
+}
+
+void wxZlibParallelDeflate::ReleaseStream(z_stream* z)
+{
+    wxCriticalSectionLocker lock(m_csStreams);
+    m_streams.push_back(z);
+}
+
+void wxZlibParallelDeflate::Submit(bool last)
+{
+    std::unique_ptr<Job> job(new Job);
+    job->last = last;
+    job->dict = m_window;
+
+    // Remember the end of this block to use it as dictionary for the next one.
+    const size_t windowSize = wxMin(m_input.size(),
+                                    static_cast<size_t>(PARALLEL_WINDOW_SIZE));
+    m_window.assign(m_input.end() - windowSize, m_input.end());
+
+    job->input.swap(m_input);
+    m_input.reserve(m_blockSize);
+
+    m_pending.push_back(std::move(job));
+}
+
+bool wxZlibParallelDeflate::WriteHeader(wxOutputStream& out) const
+{
+    unsigned char header[10];
+    size_t len = 0;
+
+    switch ( m_flags )
+    {
+        case wxZLIB_ZLIB:
+            {
+                // Use the same compression level flags as deflate() does.
+                unsigned levelFlags;
+                if ( m_level == Z_DEFAULT_COMPRESSION || m_level == 6 )
+                    levelFlags = 2;
+                else if ( m_level < 2 )
+                    levelFlags = 0;
+                else if ( m_level < 6 )
+                    levelFlags = 1;
+                else
+                    levelFlags = 3;
+
+                unsigned h = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8;
+                h |= levelFlags << 6;
+                h += 31 - h % 31;
+
+                header[len++] = static_cast<unsigned char>(h >> 8);
+                header[len++] = static_cast<unsigned char>(h & 0xff);
+            }
+            break;
+
+        case wxZLIB_GZIP:
+            header[len++] = 0x1f;
+            header[len++] = 0x8b;
+            header[len++] = Z_DEFLATED;
+            header[len++] = 0;      // flags
+            header[len++] = 0;      // modification time
+            header[len++] = 0;
+            header[len++] = 0;
+            header[len++] = 0;
+            header[len++] = m_level == 9 ? 2 : m_level == 1 ? 4 : 0;
+            header[len++] = 0xff;   // unknown OS
+            break;
+    }
+
+    return !len || out.WriteAll(header, len);
+}
+
+bool wxZlibParallelDeflate::WriteTrailer(wxOutputStream& out) const
+{
+    unsigned char trailer[8];
+    size_t len = 0;
+
+    switch ( m_flags )
+    {
+        case wxZLIB_ZLIB:
+            // Adler-32 checksum in big endian order.
+            for ( int shift = 24; shift >= 0; shift -= 8 )
+                trailer[len++] = static_cast<unsigned char>(m_check >> shift);
+            break;
+
+        case wxZLIB_GZIP:
+            // CRC-32 and the size modulo 2^32 in little endian order.
+            for ( int shift = 0; shift < 32; shift += 8 )
+                trailer[len++] = static_cast<unsigned char>(m_check >> shift);
+            for ( int shift = 0; shift < 32; shift += 8 )
+                trailer[len++] = static_cast<unsigned char>(m_totalSize >> shift);
+            break;
+    }
+
+    return !len || out.WriteAll(trailer, len);
+}
+
+bool wxZlibParallelDeflate::WriteBlocks(wxOutputStream& out)
+{
+    // Notice that this compresses the blocks in the current thread if the
+    // pool is busy or if there is only a single block, e.g. for small streams.
+    wxThreadPool::ParallelFor
+    (
+        static_cast<int>(m_pending.size()),
+        static_cast<int>(m_numThreads),
+        [this](int from, int to)
+        {
+            z_stream* const z = AcquireStream();
+            if ( !z )
+                return;
+
+            for ( int n = from; n < to; n++ )
+                Compress(*z, *m_pending[n]);
+
+            ReleaseStream(z);
+        }
+    );
+
+    for ( const auto& jobPtr : m_pending )
+    {
+        const Job& job = *jobPtr;
+
+        if ( !m_error )
+        {
+            if ( !job.ok )
+            {
+                wxLogError(_("Can't write to deflate stream: %s"),
+                           _("compressing data block failed"));
+                m_error = true;
+            }
+            else if ( !m_headerWritten && !WriteHeader(out) )
+            {
+                m_error = true;
+            }
+            else
+            {
+                m_headerWritten = true;
+                if ( !out.WriteAll(job.output.data(), job.output.size()) )
+                    m_error = true;
+            }
+        }
+
+        const uLong size = job.input.size();
+        if ( m_flags == wxZLIB_GZIP )
+            m_check = crc32_combine(m_check, job.check, size);
+        else if ( m_flags == wxZLIB_ZLIB )
+            m_check = adler32_combine(m_check, job.check, size);
+        m_totalSize += size;
+    }
+
+    m_pending.clear();
+
+    return !m_error;
+}
+
+bool wxZlibParallelDeflate::Write(wxOutputStream& out,
+                                  const void *buffer,
+                                  size_t size)
+{
+    m_finished = false;
+
+    const Bytef* p = static_cast<const Bytef*>(buffer);
+    while ( size )
+    {
+        const size_t len = wxMin(size, m_blockSize - m_input.size());
+        m_input.insert(m_input.end(), p, p + len);
+        p += len;
+        size -= len;
+
+        if ( m_input.size() == m_blockSize )
+        {
+            Submit(false);
+
+            // Give each thread two blocks to balance the load between them,
+            // while limiting the memory used by the blocks waiting for it.
+            if ( m_pending.size() == 2*m_numThreads && !WriteBlocks(out) )
+                return false;
+        }
+    }
+
+    return !m_error;
+}
+
+bool wxZlibParallelDeflate::Flush(wxOutputStream& out, bool final)
+{
+    if ( m_finished )
+        return !m_error;
+
+    if ( final || !m_input.empty() )
+        Submit(final);
+
+    const bool ok = WriteBlocks(out) && (!final || WriteTrailer(out));
+
+    if ( final )
+    {
+        // Prepare for writing another stream.
+        m_finished = true;
+        m_window.clear();
+        m_headerWritten = false;
+        m_error = false;
+        m_check = GetInitialCheck();
+        m_totalSize = 0;
+    }
+
+    return ok;
+}
+
+#endif // wxUSE_THREADS
+
 //////////////////////
 // wxZlibOutputStream
 //////////////////////
@@ -300,6 +713,7 @@ void wxZlibOutputStream::Init(int level, int flags)
   m_z_buffer = new unsigned char[ZSTREAM_BUFFER_SIZE];
   m_z_size = ZSTREAM_BUFFER_SIZE;
   m_pos = 0;
+  m_parallel = nullptr;
 
   if ( level == -1 )
   {
@@ -310,6 +724,9 @@ void wxZlibOutputStream::Init(int level, int flags)
     wxASSERT_MSG(level >= 0 && level <= 9, wxT("wxZlibOutputStream compression level must be between 0 and 9!"));
   }
 
+  m_level = level;
+  m_flags = flags;
+
   // if gzip is asked for but not supported...
   if (flags == wxZLIB_GZIP && !CanHandleGZip()) {
     wxLogError(_("Gzip not supported by this version of zlib"));
@@ -350,6 +767,9 @@ bool wxZlibOutputStream::Close()
    deflateEnd(m_deflate);
    wxDELETE(m_deflate);
    wxDELETEA(m_z_buffer);
+#if wxUSE_THREADS
+  wxDELETE(m_parallel);
+#endif // wxUSE_THREADS
 
   return wxFilterOutputStream::Close() && IsOk();
  }
@@ -361,6 +781,14 @@ void wxZlibOutputStream::DoFlush(bool final)
   if (!IsOk())
     return;
 
+#if wxUSE_THREADS
+  if (m_parallel) {
+    if (!m_parallel->Flush(*m_parent_o_stream, final))
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+    return;
+  }
+#endif // wxUSE_THREADS
+
   int err = Z_OK;
   bool done = false;
 
@@ -396,6 +824,18 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
   if (!IsOk() || !size)
     return 0;
 
+#if wxUSE_THREADS
+  if (m_parallel) {
+    if (!m_parallel->Write(*m_parent_o_stream, buffer, size)) {
+      m_lasterror = wxSTREAM_WRITE_ERROR;
+      return 0;
+    }
+
+    m_pos += size;
+    return size;
+  }
+#endif // wxUSE_THREADS
+
   int err = Z_OK;
   m_deflate->next_in = const_cast<unsigned char*>(static_cast<const unsigned char*>(buffer));
   m_deflate->avail_in = size;
@@ -436,6 +876,11 @@ size_t wxZlibOutputStream::OnSysWrite(const void *buffer, size_t size)
 
 bool wxZlibOutputStream::SetDictionary(const char *data, size_t datalen)
 {
+    // The blocks compressed in parallel use the end of the previous block as
+    // dictionary, so a custom one can't be used with them.
+    if ( m_parallel )
+        return false;
+
     return deflateSetDictionary(m_deflate, reinterpret_cast<const Bytef*>(data), datalen) == Z_OK;
 }
 
@@ -444,5 +889,42 @@ bool wxZlibOutputStream::SetDictionary(const wxMemoryBuffer &buf)
     return SetDictionary((char*)buf.GetData(), buf.GetDataLen());
 }
 
+bool wxZlibOutputStream::EnableParallel(unsigned numThreads, size_t blockSize)
+{
+#if wxUSE_THREADS
+    wxCHECK_MSG( m_pos == 0, false,
+                 "parallel compression must be enabled before writing" );
+
+    if ( !m_deflate || !IsOk() )
+        return false;
+
+    numThreads = wxThreadPool::GetThreadCount(static_cast<int>(numThreads));
+
+    if ( !blockSize )
+        blockSize = PARALLEL_BLOCK_SIZE;
+    else if ( blockSize < PARALLEL_WINDOW_SIZE )
+        blockSize = PARALLEL_WINDOW_SIZE;
+
+    // Reuse the existing compression streams if possible, as this stream can
+    // be reused, e.g. wxZipOutputStream does it for all its entries.
+    if ( m_parallel && m_parallel->Matches(numThreads, blockSize) )
+    {
+        m_parallel->Restart();
+        return true;
+    }
+
+    delete m_parallel;
+    m_parallel = new wxZlibParallelDeflate(m_level, m_flags,
+                                           numThreads, blockSize);
+
+    return true;
+#else // !wxUSE_THREADS
+    wxUnusedVar(numThreads);
+    wxUnusedVar(blockSize);
+
+    return false;
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
 #endif
   // wxUSE_ZLIB && wxUSE_STREAMS
@@ -592,9 +592,8 @@ void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale)
 
     const int w = image.GetWidth();
     const int h = image.GetHeight();
-    const guchar* alpha = image.GetAlpha();
     if (depth < 0)
-        depth = alpha ? 32 : 24;
+        depth = image.HasAlpha() ? 32 : 24;
     else if (depth != 1 && depth != 32)
         depth = 24;
     wxBitmapRefData* bmpData = new wxBitmapRefData(w, h, depth);
@@ -603,10 +602,23 @@ void wxBitmap::InitFromImage(const wxImage& image, int depth, double scale)
     GdkPixbuf* pixbuf_dst = gdk_pixbuf_new(GDK_COLORSPACE_RGB, depth == 32, 8, w, h);
     bmpData->m_pixbufNoMask = pixbuf_dst;
     wxASSERT(bmpData->m_bpp == 32 || !gdk_pixbuf_get_has_alpha(bmpData->m_pixbufNoMask));
-    const guchar* src = image.GetData();
 
     guchar* dst = gdk_pixbuf_get_pixels(pixbuf_dst);
     const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
+
+    // If the image is already stored in the same format as used by the
+    // pixbuf, we can just copy it row by row.
+    if (depth == 32 && image.HasRGBAStorage() && !image.HasMask())
+    {
+        // Use a shallow copy to get at the data: no conversion is needed
+        // here, so this doesn't copy anything.
+        wxImage imageRGBA(image);
+        CopyImageData(dst, 4, dstStride, imageRGBA.GetDataRGBA(), 4, 4 * w, w, h);
+        return;
+    }
+
+    const guchar* alpha = image.GetAlpha();
+    const guchar* src = image.GetData();
     CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
 
     if (depth == 32 && alpha)
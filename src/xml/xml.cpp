@@ -27,7 +27,11 @@
 #include "wx/strconv.h"
 #include "wx/versioninfo.h"
 
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "expat.h" // from Expat
 
@@ -42,10 +46,139 @@ wxIMPLEMENT_CLASS(wxXmlDocument, wxObject);
 static bool wxIsWhiteOnly(const wxString& buf);
 
 
+//-----------------------------------------------------------------------------
+//  wxXmlArena
+//-----------------------------------------------------------------------------
+
+// Simple bump allocator used for the nodes and attributes of the documents
+// loaded with wxXMLDOC_USE_ARENA: its memory is only freed when it's
+// destroyed.
+class wxXmlArena
+{
+public:
+    wxXmlArena() = default;
+
+    void *Alloc(size_t size)
+    {
+        // keep all the blocks aligned as the ones returned by operator new
+        const size_t align = alignof(std::max_align_t);
+        size = (size + align - 1) & ~(align - 1);
+
+        if ( size > m_left )
+        {
+            // allocate big objects separately to avoid wasting the space
+            // remaining in the current chunk
+            if ( size > CHUNK_SIZE / 4 )
+            {
+                m_chunks.emplace_back(new char[size]);
+                return m_chunks.back().get();
+            }
+
+            m_chunks.emplace_back(new char[CHUNK_SIZE]);
+            m_current = m_chunks.back().get();
+            m_left = CHUNK_SIZE;
+        }
+
+        void* const p = m_current;
+        m_current += size;
+        m_left -= size;
+
+        return p;
+    }
+
+private:
+    static const size_t CHUNK_SIZE = 64*1024;
+
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    char *m_current = nullptr;
+    size_t m_left = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlArena);
+};
+
+namespace
+{
+
+// Arena used for allocating the nodes in the current thread, if any.
+thread_local wxXmlArena *gs_xmlArena = nullptr;
+
+// Sets the arena to use for the lifetime of this object.
+class wxXmlArenaSetter
+{
+public:
+    explicit wxXmlArenaSetter(wxXmlArena *arena)
+        : m_arenaOld(gs_xmlArena)
+    {
+        gs_xmlArena = arena;
+    }
+
+    ~wxXmlArenaSetter()
+    {
+        gs_xmlArena = m_arenaOld;
+    }
+
+private:
+    wxXmlArena* const m_arenaOld;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlArenaSetter);
+};
+
+// The objects allocated by the functions below are preceded by a pointer to
+// the arena they were allocated from or null if they were allocated on the
+// heap.
+static_assert(alignof(wxXmlNode) <= sizeof(void*) &&
+                alignof(wxXmlAttribute) <= sizeof(void*),
+              "XML objects can't be aligned on pointer boundary");
+
+void *AllocXmlObject(size_t size)
+{
+    wxXmlArena* const arena = gs_xmlArena;
+
+    size += sizeof(void*);
+    void** const block = static_cast<void**>(arena ? arena->Alloc(size)
+                                                   : ::operator new(size));
+    *block = arena;
+
+    return block + 1;
+}
+
+void FreeXmlObject(void *p)
+{
+    if ( !p )
+        return;
+
+    // objects allocated from an arena are freed when it's destroyed
+    void** const block = static_cast<void**>(p) - 1;
+    if ( !*block )
+        ::operator delete(block);
+}
+
+} // anonymous namespace
+
+void *wxXmlAttribute::operator new(size_t size)
+{
+    return AllocXmlObject(size);
+}
+
+void wxXmlAttribute::operator delete(void *p)
+{
+    FreeXmlObject(p);
+}
+
 //-----------------------------------------------------------------------------
 //  wxXmlNode
 //-----------------------------------------------------------------------------
 
+void *wxXmlNode::operator new(size_t size)
+{
+    return AllocXmlObject(size);
+}
+
+void wxXmlNode::operator delete(void *p)
+{
+    FreeXmlObject(p);
+}
+
 wxXmlNode::wxXmlNode(wxXmlNode *parent,wxXmlNodeType type,
                      const wxString& name, const wxString& content,
                      wxXmlAttribute *attrs, wxXmlNode *next, int lineNo)
@@ -456,6 +589,8 @@ wxXmlDocument::wxXmlDocument(wxInputStream& stream)
     Load(stream);
 }
 
+wxXmlDocument::~wxXmlDocument() = default;
+
 wxXmlDocument::wxXmlDocument(const wxXmlDocument& doc)
               :wxObject()
 {
@@ -480,6 +615,9 @@ void wxXmlDocument::DoCopy(const wxXmlDocument& doc)
         m_docNode.reset(new wxXmlNode(*doc.m_docNode));
     else
         m_docNode.reset();
+
+    // the copy is allocated on the heap, so the arena is not needed any more
+    m_arena.reset();
 }
 
 bool wxXmlDocument::Load(const wxString& filename, int flags,
@@ -821,39 +959,24 @@ static int UnknownEncodingHnd(void * WXUNUSED(encodingHandlerData),
 
 } // extern "C"
 
-bool wxXmlDocument::Load(wxInputStream& stream, int flags,
-                         wxXmlParseError* err)
+// Feeds the entire stream contents to the parser, returns false on error.
+static bool ParseStream(XML_Parser parser, wxInputStream& stream,
+                        wxXmlParseError* err)
 {
     const size_t BUFSIZE = 16384;
     char buf[BUFSIZE];
-    wxXmlParsingContext ctx;
     bool done;
-    XML_Parser parser = XML_ParserCreate(nullptr);
-    wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
 
-    ctx.encoding = wxS("UTF-8"); // default in absence of encoding=""
-    ctx.doctype = &m_doctype;
-    ctx.removeWhiteOnlyNodes = (flags & wxXMLDOC_KEEP_WHITESPACE_NODES) == 0;
-    ctx.parser = parser;
-    ctx.node = root;
-
-    XML_SetUserData(parser, (void*)&ctx);
-    XML_SetElementHandler(parser, StartElementHnd, EndElementHnd);
-    XML_SetCharacterDataHandler(parser, TextHnd);
-    XML_SetCdataSectionHandler(parser, StartCdataHnd, EndCdataHnd);
-    XML_SetCommentHandler(parser, CommentHnd);
-    XML_SetProcessingInstructionHandler(parser, PIHnd);
-    XML_SetDoctypeDeclHandler(parser, StartDoctypeHnd, EndDoctypeHnd);
-    XML_SetDefaultHandler(parser, DefaultHnd);
-    XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, nullptr);
-
-    bool ok = true;
     do
     {
         size_t len = stream.Read(buf, BUFSIZE).LastRead();
         done = (len < BUFSIZE);
         if (!XML_Parse(parser, buf, len, done))
         {
+            // this is not an error, parsing was just stopped by wxXmlReader
+            if (XML_GetErrorCode(parser) == XML_ERROR_ABORTED)
+                break;
+
             if (err)
             {
                 err->message = XML_ErrorString(XML_GetErrorCode(parser));
@@ -869,11 +992,45 @@ bool wxXmlDocument::Load(wxInputStream& stream, int flags,
                            error.c_str(),
                            (int)XML_GetCurrentLineNumber(parser));
             }
-            ok = false;
-            break;
+            return false;
         }
     } while (!done);
 
+    return true;
+}
+
+bool wxXmlDocument::Load(wxInputStream& stream, int flags,
+                         wxXmlParseError* err)
+{
+    std::unique_ptr<wxXmlArena> arena;
+    if (flags & wxXMLDOC_USE_ARENA)
+        arena.reset(new wxXmlArena);
+
+    // allocate all nodes created while loading from the arena
+    wxXmlArenaSetter setArena(arena.get());
+
+    wxXmlParsingContext ctx;
+    XML_Parser parser = XML_ParserCreate(nullptr);
+    wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
+
+    ctx.encoding = wxS("UTF-8"); // default in absence of encoding=""
+    ctx.doctype = &m_doctype;
+    ctx.removeWhiteOnlyNodes = (flags & wxXMLDOC_KEEP_WHITESPACE_NODES) == 0;
+    ctx.parser = parser;
+    ctx.node = root;
+
+    XML_SetUserData(parser, (void*)&ctx);
+    XML_SetElementHandler(parser, StartElementHnd, EndElementHnd);
+    XML_SetCharacterDataHandler(parser, TextHnd);
+    XML_SetCdataSectionHandler(parser, StartCdataHnd, EndCdataHnd);
+    XML_SetCommentHandler(parser, CommentHnd);
+    XML_SetProcessingInstructionHandler(parser, PIHnd);
+    XML_SetDoctypeDeclHandler(parser, StartDoctypeHnd, EndDoctypeHnd);
+    XML_SetDefaultHandler(parser, DefaultHnd);
+    XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, nullptr);
+
+    const bool ok = ParseStream(parser, stream, err);
+
     if (ok)
     {
         if (!ctx.version.empty())
@@ -881,6 +1038,10 @@ bool wxXmlDocument::Load(wxInputStream& stream, int flags,
         if (!ctx.encoding.empty())
             SetFileEncoding(ctx.encoding);
         SetDocumentNode(root);
+
+        // the old nodes, if any, are deleted by now, so we can free the old
+        // arena
+        m_arena = std::move(arena);
     }
     else
     {
@@ -895,6 +1056,701 @@ bool wxXmlDocument::Load(wxInputStream& stream, int flags,
 
 
 
+//-----------------------------------------------------------------------------
+//  wxXmlDocument binary format
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// The binary format starts with this signature followed by the format version
+// byte. They are followed by the table of all distinct strings used in the
+// document, stored as the number of strings and then the length and UTF-8
+// contents of each of them, and then by the document itself:
+//
+//  - its version, encoding, doctype root name, system and public ids;
+//  - the document node, with each node stored as its type, name, content,
+//    line number plus one, no conversion flag, the number of attributes
+//    followed by their names and values and the number of children followed
+//    by the children themselves.
+//
+// All numbers are stored as LEB128-encoded unsigned integers and all strings
+// as indices in the strings table.
+const char BINARY_SIGNATURE[] = "wxXMLBIN";
+const size_t BINARY_SIGNATURE_LEN = sizeof(BINARY_SIGNATURE) - 1;
+const unsigned char BINARY_VERSION = 1;
+
+void AppendBinaryNumber(std::string& data, size_t n)
+{
+    while ( n >= 0x80 )
+    {
+        data += static_cast<char>((n & 0x7f) | 0x80);
+        n >>= 7;
+    }
+
+    data += static_cast<char>(n);
+}
+
+class wxXmlBinaryWriter
+{
+public:
+    wxXmlBinaryWriter() = default;
+
+    void WriteHeader(const wxXmlDocument& doc)
+    {
+        WriteString(doc.GetVersion());
+        WriteString(doc.GetFileEncoding());
+
+        const wxXmlDoctype& doctype = doc.GetDoctype();
+        WriteString(doctype.GetRootName());
+        WriteString(doctype.GetSystemId());
+        WriteString(doctype.GetPublicId());
+    }
+
+    void WriteNode(const wxXmlNode& node)
+    {
+        WriteNumber(node.GetType());
+        WriteString(node.GetName());
+        WriteString(node.GetContent());
+        WriteNumber(node.GetLineNumber() + 1);
+        WriteNumber(node.GetNoConversion());
+
+        size_t count = 0;
+        for ( wxXmlAttribute* attr = node.GetAttributes();
+              attr;
+              attr = attr->GetNext() )
+        {
+            count++;
+        }
+
+        WriteNumber(count);
+        for ( wxXmlAttribute* attr = node.GetAttributes();
+              attr;
+              attr = attr->GetNext() )
+        {
+            WriteString(attr->GetName());
+            WriteString(attr->GetValue());
+        }
+
+        count = 0;
+        for ( wxXmlNode* child = node.GetChildren();
+              child;
+              child = child->GetNext() )
+        {
+            count++;
+        }
+
+        WriteNumber(count);
+        for ( wxXmlNode* child = node.GetChildren();
+              child;
+              child = child->GetNext() )
+        {
+            WriteNode(*child);
+        }
+    }
+
+    bool Save(wxOutputStream& stream) const
+    {
+        std::string table;
+        AppendBinaryNumber(table, m_table.size());
+        for ( const wxString* s : m_table )
+        {
+            const wxScopedCharBuffer utf8 = s->utf8_str();
+            AppendBinaryNumber(table, utf8.length());
+            table.append(utf8.data(), utf8.length());
+        }
+
+        stream.Write(BINARY_SIGNATURE, BINARY_SIGNATURE_LEN);
+        stream.Write(&BINARY_VERSION, sizeof(BINARY_VERSION));
+        stream.Write(table.data(), table.size());
+        stream.Write(m_data.data(), m_data.size());
+
+        return stream.IsOk();
+    }
+
+private:
+    void WriteNumber(size_t n)
+    {
+        AppendBinaryNumber(m_data, n);
+    }
+
+    void WriteString(const wxString& s)
+    {
+        auto it = m_strings.find(s);
+        if ( it == m_strings.end() )
+        {
+            it = m_strings.emplace(s, m_table.size()).first;
+            m_table.push_back(&it->first);
+        }
+
+        WriteNumber(it->second);
+    }
+
+    // Document contents, without the strings table.
+    std::string m_data;
+
+    // Map of strings to their indices in the strings table and the strings
+    // themselves in the table order.
+    std::unordered_map<wxString, size_t> m_strings;
+    std::vector<const wxString*> m_table;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlBinaryWriter);
+};
+
+class wxXmlBinaryReader
+{
+public:
+    wxXmlBinaryReader(const char* p, const char* end)
+        : m_p(p), m_end(end)
+    {
+    }
+
+    bool ReadSignature()
+    {
+        if ( static_cast<size_t>(m_end - m_p) < BINARY_SIGNATURE_LEN + 1 ||
+                memcmp(m_p, BINARY_SIGNATURE, BINARY_SIGNATURE_LEN) != 0 )
+            return false;
+
+        m_p += BINARY_SIGNATURE_LEN;
+
+        return static_cast<unsigned char>(*m_p++) == BINARY_VERSION;
+    }
+
+    bool ReadTable()
+    {
+        size_t count;
+        if ( !ReadNumber(count) || count > static_cast<size_t>(m_end - m_p) )
+            return false;
+
+        m_table.reserve(count);
+        for ( size_t n = 0; n < count; n++ )
+        {
+            size_t len;
+            if ( !ReadNumber(len) || len > static_cast<size_t>(m_end - m_p) )
+                return false;
+
+            m_table.push_back(wxString::FromUTF8(m_p, len));
+            if ( m_table.back().empty() && len )
+                return false;
+
+            m_p += len;
+        }
+
+        return true;
+    }
+
+    bool ReadString(const wxString*& s)
+    {
+        size_t index;
+        if ( !ReadNumber(index) || index >= m_table.size() )
+            return false;
+
+        s = &m_table[index];
+
+        return true;
+    }
+
+    // Read the node and all its children, return null on error.
+    wxXmlNode* ReadNode()
+    {
+        size_t type, lineNo, noConversion;
+        const wxString *name, *content;
+        if ( !ReadNumber(type) ||
+                type < wxXML_ELEMENT_NODE ||
+                type > wxXML_HTML_DOCUMENT_NODE ||
+             !ReadString(name) ||
+             !ReadString(content) ||
+             !ReadNumber(lineNo) ||
+             !ReadNumber(noConversion) )
+            return nullptr;
+
+        std::unique_ptr<wxXmlNode> node(new wxXmlNode
+                                        (
+                                            static_cast<wxXmlNodeType>(type),
+                                            *name,
+                                            *content,
+                                            static_cast<int>(lineNo) - 1
+                                        ));
+        node->SetNoConversion(noConversion != 0);
+
+        size_t count;
+        if ( !ReadNumber(count) )
+            return nullptr;
+
+        for ( size_t n = 0; n < count; n++ )
+        {
+            const wxString *attrName, *attrValue;
+            if ( !ReadString(attrName) || !ReadString(attrValue) )
+                return nullptr;
+
+            node->AddAttribute(*attrName, *attrValue);
+        }
+
+        if ( !ReadNumber(count) )
+            return nullptr;
+
+        wxXmlNode* lastChild = nullptr;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            wxXmlNode* const child = ReadNode();
+            if ( !child )
+                return nullptr;
+
+            node->InsertChildAfter(child, lastChild);
+            lastChild = child;
+        }
+
+        return node.release();
+    }
+
+    bool IsAtEnd() const { return m_p == m_end; }
+
+private:
+    bool ReadNumber(size_t& n)
+    {
+        n = 0;
+        for ( unsigned shift = 0; shift < 8*sizeof(size_t); shift += 7 )
+        {
+            if ( m_p == m_end )
+                return false;
+
+            const unsigned char c = static_cast<unsigned char>(*m_p++);
+            n |= static_cast<size_t>(c & 0x7f) << shift;
+            if ( !(c & 0x80) )
+                return true;
+        }
+
+        return false;
+    }
+
+    const char* m_p;
+    const char* const m_end;
+
+    std::vector<wxString> m_table;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlBinaryReader);
+};
+
+} // anonymous namespace
+
+/* static */
+bool wxXmlDocument::IsBinaryFormat(wxInputStream& stream)
+{
+    char buf[BINARY_SIGNATURE_LEN];
+    const size_t len = stream.Read(buf, sizeof(buf)).LastRead();
+    if ( len )
+        stream.Ungetch(buf, len);
+
+    return len == sizeof(buf) && memcmp(buf, BINARY_SIGNATURE, len) == 0;
+}
+
+bool wxXmlDocument::LoadBinary(const wxString& filename, int flags)
+{
+    wxFileInputStream stream(filename);
+    if (!stream.IsOk())
+        return false;
+    return LoadBinary(stream, flags);
+}
+
+bool wxXmlDocument::LoadBinary(wxInputStream& stream, int flags)
+{
+    std::string data;
+
+    const wxFileOffset length = stream.GetLength();
+    if ( length != wxInvalidOffset )
+        data.reserve(static_cast<size_t>(length));
+
+    char buf[4096];
+    while ( stream.Read(buf, sizeof(buf)).LastRead() )
+        data.append(buf, stream.LastRead());
+
+    if ( stream.GetLastError() == wxSTREAM_READ_ERROR )
+        return false;
+
+    std::unique_ptr<wxXmlArena> arena;
+    if (flags & wxXMLDOC_USE_ARENA)
+        arena.reset(new wxXmlArena);
+
+    wxXmlArenaSetter setArena(arena.get());
+
+    wxXmlBinaryReader reader(data.data(), data.data() + data.size());
+
+    const wxString *version, *encoding, *rootName, *systemId, *publicId;
+    if ( !reader.ReadSignature() ||
+         !reader.ReadTable() ||
+         !reader.ReadString(version) ||
+         !reader.ReadString(encoding) ||
+         !reader.ReadString(rootName) ||
+         !reader.ReadString(systemId) ||
+         !reader.ReadString(publicId) )
+        return false;
+
+    std::unique_ptr<wxXmlNode> root(reader.ReadNode());
+    if ( !root || root->GetType() != wxXML_DOCUMENT_NODE || !reader.IsAtEnd() )
+        return false;
+
+    SetVersion(*version);
+    SetFileEncoding(*encoding);
+    SetDoctype(wxXmlDoctype(*rootName, *systemId, *publicId));
+    SetDocumentNode(root.release());
+
+    m_arena = std::move(arena);
+
+    return true;
+}
+
+bool wxXmlDocument::SaveBinary(const wxString& filename) const
+{
+    wxFileOutputStream stream(filename);
+    if (!stream.IsOk())
+        return false;
+    return SaveBinary(stream);
+}
+
+bool wxXmlDocument::SaveBinary(wxOutputStream& stream) const
+{
+    if ( !IsOk() )
+        return false;
+
+    wxXmlBinaryWriter writer;
+    writer.WriteHeader(*this);
+    writer.WriteNode(*GetDocumentNode());
+
+    return writer.Save(stream);
+}
+
+//-----------------------------------------------------------------------------
+//  wxXmlReader
+//-----------------------------------------------------------------------------
+
+wxString wxXmlReaderElement::GetName() const
+{
+    return wxString::FromUTF8Unchecked(m_name);
+}
+
+size_t wxXmlReaderElement::GetAttributeCount() const
+{
+    size_t count = 0;
+    for ( const char **a = m_attrs; *a; a += 2 )
+        count++;
+
+    return count;
+}
+
+wxString wxXmlReaderElement::GetAttributeName(size_t n) const
+{
+    wxCHECK_MSG( n < GetAttributeCount(), wxString(), "invalid index" );
+
+    return wxString::FromUTF8Unchecked(m_attrs[2*n]);
+}
+
+wxString wxXmlReaderElement::GetAttributeValue(size_t n) const
+{
+    wxCHECK_MSG( n < GetAttributeCount(), wxString(), "invalid index" );
+
+    return wxString::FromUTF8Unchecked(m_attrs[2*n + 1]);
+}
+
+int wxXmlReaderElement::FindAttribute(const wxString& attrName) const
+{
+    const wxScopedCharBuffer name = attrName.utf8_str();
+    for ( const char **a = m_attrs; *a; a += 2 )
+    {
+        if ( strcmp(*a, name) == 0 )
+            return a - m_attrs + 1;
+    }
+
+    return -1;
+}
+
+bool wxXmlReaderElement::HasAttribute(const wxString& attrName) const
+{
+    return FindAttribute(attrName) != -1;
+}
+
+bool
+wxXmlReaderElement::GetAttribute(const wxString& attrName, wxString *value) const
+{
+    wxCHECK_MSG( value, false, "value argument must not be null" );
+
+    const int n = FindAttribute(attrName);
+    if ( n == -1 )
+        return false;
+
+    *value = wxString::FromUTF8Unchecked(m_attrs[n]);
+    return true;
+}
+
+wxString
+wxXmlReaderElement::GetAttribute(const wxString& attrName,
+                                 const wxString& defaultVal) const
+{
+    wxString value;
+    return GetAttribute(attrName, &value) ? value : defaultVal;
+}
+
+struct wxXmlReaderContext
+{
+    wxXmlReaderContext(XML_Parser parser_,
+                       wxXmlReaderHandler& handler_,
+                       int flags)
+        : parser(parser_),
+          handler(handler_),
+          removeWhiteOnlyNodes((flags & wxXMLDOC_KEEP_WHITESPACE_NODES) == 0)
+    {
+        subtreeCtx.parser = parser;
+        subtreeCtx.removeWhiteOnlyNodes = removeWhiteOnlyNodes;
+    }
+
+    void StartElement(const char *name, const char **atts)
+    {
+        if ( IsInSubtree() )
+        {
+            subtreeDepth++;
+            StartElementHnd(&subtreeCtx, name, atts);
+            return;
+        }
+
+        if ( !FlushText() )
+            return;
+
+        const wxXmlReaderElement element(name, atts,
+                                         XML_GetCurrentLineNumber(parser),
+                                         depth);
+        depth++;
+
+        if ( !handler.OnStartElement(element) )
+        {
+            Stop();
+            return;
+        }
+
+        if ( element.m_loadSubtree )
+        {
+            // Reuse the same code as wxXmlDocument uses for building the tree
+            // by creating a temporary root node.
+            subtreeRoot.reset(new wxXmlNode(wxXML_DOCUMENT_NODE, wxString()));
+            subtreeCtx.node = subtreeRoot.get();
+            subtreeCtx.lastChild =
+            subtreeCtx.lastAsText = nullptr;
+
+            subtreeDepth = 1;
+            StartElementHnd(&subtreeCtx, name, atts);
+        }
+    }
+
+    void EndElement(const char *name)
+    {
+        if ( IsInSubtree() )
+        {
+            EndElementHnd(&subtreeCtx, name);
+            if ( --subtreeDepth )
+                return;
+
+            depth--;
+
+            wxXmlNode* const node = subtreeRoot->GetChildren();
+            subtreeRoot->RemoveChild(node);
+            subtreeRoot.reset();
+
+            if ( !handler.OnSubtree(std::unique_ptr<wxXmlNode>(node)) )
+                Stop();
+            return;
+        }
+
+        if ( !FlushText() )
+            return;
+
+        depth--;
+
+        if ( !handler.OnEndElement(wxString::FromUTF8Unchecked(name)) )
+            Stop();
+    }
+
+    void Text(const char *s, int len)
+    {
+        if ( IsInSubtree() )
+            TextHnd(&subtreeCtx, s, len);
+        else
+            text.append(s, len);
+    }
+
+    void StartCdata()
+    {
+        if ( IsInSubtree() )
+        {
+            StartCdataHnd(&subtreeCtx);
+            return;
+        }
+
+        if ( FlushText() )
+            inCdata = true;
+    }
+
+    void EndCdata()
+    {
+        if ( IsInSubtree() )
+        {
+            EndCdataHnd(&subtreeCtx);
+            return;
+        }
+
+        FlushText();
+        inCdata = false;
+    }
+
+    void Comment(const char *data)
+    {
+        if ( IsInSubtree() )
+            CommentHnd(&subtreeCtx, data);
+    }
+
+    void PI(const char *target, const char *data)
+    {
+        if ( IsInSubtree() )
+            PIHnd(&subtreeCtx, target, data);
+    }
+
+    bool IsInSubtree() const { return subtreeDepth != 0; }
+
+    // Passes the text accumulated so far to the handler, returns false if it
+    // asked to stop.
+    bool FlushText()
+    {
+        if ( text.empty() )
+            return true;
+
+        if ( removeWhiteOnlyNodes && !inCdata &&
+                text.find_first_not_of(" \t\r\n") == std::string::npos )
+        {
+            text.clear();
+            return true;
+        }
+
+        const wxString str = wxString::FromUTF8Unchecked(text);
+
+        // Note that clear() keeps the buffer allocated, so the memory used
+        // doesn't grow beyond the size of the longest text.
+        text.clear();
+
+        if ( !handler.OnText(str) )
+        {
+            Stop();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Stop()
+    {
+        // expat may still call some handlers after stopping, so make sure
+        // they don't do anything.
+        stopped = true;
+        XML_StopParser(parser, XML_FALSE);
+    }
+
+    XML_Parser const parser;
+    wxXmlReaderHandler& handler;
+    const bool removeWhiteOnlyNodes;
+
+    // depth of the current element
+    int depth = 0;
+
+    // text accumulated since the last element start or end, in UTF-8
+    std::string text;
+    bool inCdata = false;
+
+    bool stopped = false;
+
+    // used while loading a subtree only
+    wxXmlParsingContext subtreeCtx;
+    std::unique_ptr<wxXmlNode> subtreeRoot;
+    int subtreeDepth = 0;
+};
+
+extern "C" {
+
+#define wxXML_READER_CONTEXT(userData) \
+    wxXmlReaderContext* const ctx = static_cast<wxXmlReaderContext*>(userData); \
+    if ( ctx->stopped ) \
+        return
+
+static void ReaderStartElementHnd(void *userData, const char *name,
+                                  const char **atts)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->StartElement(name, atts);
+}
+
+static void ReaderEndElementHnd(void *userData, const char *name)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->EndElement(name);
+}
+
+static void ReaderTextHnd(void *userData, const char *s, int len)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->Text(s, len);
+}
+
+static void ReaderStartCdataHnd(void *userData)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->StartCdata();
+}
+
+static void ReaderEndCdataHnd(void *userData)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->EndCdata();
+}
+
+static void ReaderCommentHnd(void *userData, const char *data)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->Comment(data);
+}
+
+static void ReaderPIHnd(void *userData, const char *target, const char *data)
+{
+    wxXML_READER_CONTEXT(userData);
+    ctx->PI(target, data);
+}
+
+#undef wxXML_READER_CONTEXT
+
+} // extern "C"
+
+bool wxXmlReader::Parse(const wxString& filename, wxXmlParseError* err)
+{
+    wxFileInputStream stream(filename);
+    if (!stream.IsOk())
+        return false;
+    return Parse(stream, err);
+}
+
+bool wxXmlReader::Parse(wxInputStream& stream, wxXmlParseError* err)
+{
+    XML_Parser parser = XML_ParserCreate(nullptr);
+    wxXmlReaderContext ctx(parser, m_handler, m_flags);
+
+    XML_SetUserData(parser, &ctx);
+    XML_SetElementHandler(parser, ReaderStartElementHnd, ReaderEndElementHnd);
+    XML_SetCharacterDataHandler(parser, ReaderTextHnd);
+    XML_SetCdataSectionHandler(parser, ReaderStartCdataHnd, ReaderEndCdataHnd);
+    XML_SetCommentHandler(parser, ReaderCommentHnd);
+    XML_SetProcessingInstructionHandler(parser, ReaderPIHnd);
+    XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, nullptr);
+
+    const bool ok = ParseStream(parser, stream, err);
+
+    XML_ParserFree(parser);
+
+    return ok;
+}
+
 //-----------------------------------------------------------------------------
 //  wxXmlDocument saving routines
 //-----------------------------------------------------------------------------
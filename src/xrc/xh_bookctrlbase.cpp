@@ -23,6 +23,72 @@
 #include "wx/xrc/xh_bookctrlbase.h"
 
 #include "wx/bookctrl.h"
+#include "wx/dcclient.h"
+#include "wx/filesys.h"
+#include "wx/panel.h"
+#include "wx/sizer.h"
+#include "wx/xml/xml.h"
+
+#include <functional>
+#include <memory>
+
+// ============================================================================
+// LazyBookPage: page whose contents is only created when it's shown
+// ============================================================================
+
+namespace
+{
+
+class LazyBookPage : public wxPanel
+{
+public:
+    // The function creating the real page as child of the given parent.
+    typedef std::function<wxWindow* (wxWindow* parent)> Creator;
+
+    LazyBookPage(wxBookCtrlBase* book, const Creator& creator)
+        : wxPanel(book),
+          m_creator(creator)
+    {
+        Bind(wxEVT_PAINT, &LazyBookPage::OnPaint, this);
+    }
+
+private:
+    void OnPaint(wxPaintEvent& WXUNUSED(event))
+    {
+        wxPaintDC dc(this);
+
+        // Page is being shown for the first time, create its contents, but
+        // not from the paint handler itself, as creating windows from it
+        // doesn't work well with all ports.
+        if ( m_creator )
+            CallAfter(&LazyBookPage::CreateContents);
+    }
+
+    void CreateContents()
+    {
+        // We could have been painted more than once before getting here.
+        if ( !m_creator )
+            return;
+
+        const Creator creator = m_creator;
+        m_creator = nullptr;
+
+        wxWindow* const page = creator(this);
+        if ( !page )
+            return;
+
+        wxSizer* const sizer = new wxBoxSizer(wxVERTICAL);
+        sizer->Add(page, wxSizerFlags(1).Expand());
+        SetSizer(sizer);
+        Layout();
+    }
+
+    Creator m_creator;
+
+    wxDECLARE_NO_COPY_CLASS(LazyBookPage);
+};
+
+} // anonymous namespace
 
 // ============================================================================
 // wxBookCtrlXmlHandlerBase implementation
@@ -101,11 +167,54 @@ wxBookCtrlXmlHandlerBase::DoCreatePage(wxBookCtrlBase* book)
 
     if (n)
     {
-        bool old_ins = m_isInside;
-        m_isInside = false;
-        wxObject *item = CreateResFromNode(n, book, nullptr);
-        m_isInside = old_ins;
-        wxWindow *wnd = wxDynamicCast(item, wxWindow);
+        wxWindow *wnd;
+        const bool
+            lazy = GetBool(wxS("lazy"),
+                           (GetResource()->GetFlags() & wxXRC_LAZY_BOOK_PAGES) != 0);
+        if ( lazy )
+        {
+            // Use a copy of the node as the resources can be unloaded or
+            // reloaded before the page is shown.
+            std::shared_ptr<wxXmlNode> node(new wxXmlNode(*n));
+
+            // Remember the current path for the relative paths to work.
+#if wxUSE_FILESYSTEM
+            const wxString path = GetCurFileSystem().GetPath();
+#else // !wxUSE_FILESYSTEM
+            const wxString path;
+#endif // wxUSE_FILESYSTEM
+
+            wnd = new LazyBookPage(book, [this, node, path](wxWindow* parent)
+                                                                -> wxWindow*
+                {
+#if wxUSE_FILESYSTEM
+                    wxFileSystem& fs = GetCurFileSystem();
+                    const wxString pathOld = fs.GetPath();
+                    fs.ChangePathTo(path, true);
+#else // !wxUSE_FILESYSTEM
+                    wxUnusedVar(path);
+#endif // wxUSE_FILESYSTEM
+
+                    const bool old_ins = m_isInside;
+                    m_isInside = false;
+                    wxObject* const item = CreateResFromNode(node.get(), parent);
+                    m_isInside = old_ins;
+
+#if wxUSE_FILESYSTEM
+                    fs.ChangePathTo(pathOld, true);
+#endif // wxUSE_FILESYSTEM
+
+                    return wxDynamicCast(item, wxWindow);
+                });
+        }
+        else
+        {
+            bool old_ins = m_isInside;
+            m_isInside = false;
+            wxObject *item = CreateResFromNode(n, book, nullptr);
+            m_isInside = old_ins;
+            wnd = wxDynamicCast(item, wxWindow);
+        }
 
         if (wnd)
         {
@@ -46,6 +46,7 @@
 #include <locale.h>
 
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -126,11 +127,27 @@ public:
 
     ~wxXmlResourceDataRecord() = default;
 
+    // Return the named object nodes with the given name in the order in which
+    // DoFindResource() would find them, i.e. with all top-level nodes first,
+    // or null if there are none.
+    const std::vector<wxXmlNode*>* FindNodes(const wxString& name);
+
+    // Must be called whenever Doc changes.
+    void ResetIndex() { Index.reset(); }
+
     wxString File;
     std::unique_ptr<wxXmlDocument> Doc;
 #if wxUSE_DATETIME
     wxDateTime Time;
 #endif
+
+private:
+    void IndexNodes(wxXmlNode* parent);
+
+    // Map of the names of all object nodes in the document to the nodes with
+    // this name, only built when it's needed for the first time.
+    typedef std::unordered_map<wxString, std::vector<wxXmlNode*>> NameIndex;
+    std::unique_ptr<NameIndex> Index;
 };
 
 class wxXmlResourceDataRecords : public std::vector<wxXmlResourceDataRecord>
@@ -224,6 +241,34 @@ inline bool IsObjectNode(wxXmlNode *node)
                 node->GetName() == wxS("object_ref"));
 }
 
+// helper of DoFindResource() and GetResourceNodeAndLocation(): returns true if
+// the given object node is of the specified class or if classname is empty
+bool
+IsNodeOfClass(const wxXmlResource& res,
+              wxXmlNode *node,
+              const wxString& classname)
+{
+    // empty class name matches everything
+    if ( classname.empty() )
+        return true;
+
+    wxString cls(node->GetAttribute(wxS("class")));
+
+    // object_ref may not have 'class' attribute:
+    if (cls.empty() && node->GetName() == wxS("object_ref"))
+    {
+        wxString refName = node->GetAttribute(wxS("ref"));
+        if (refName.empty())
+            return false;
+
+        const wxXmlNode * const refNode = res.GetResourceNode(refName);
+        if ( refNode )
+            cls = refNode->GetAttribute(wxS("class"));
+    }
+
+    return cls == classname;
+}
+
 // special XML attribute with name of input file, see GetFileNameFromNode()
 const char *ATTR_INPUT_FILENAME = "__wx:filename";
 
@@ -267,6 +312,40 @@ GetFileNameFromNode(const wxXmlNode *node, const wxXmlResourceDataRecords& files
 
 } // anonymous namespace
 
+const std::vector<wxXmlNode*>*
+wxXmlResourceDataRecord::FindNodes(const wxString& name)
+{
+    if ( !Index )
+    {
+        Index.reset(new NameIndex);
+        if ( Doc && Doc->GetRoot() )
+            IndexNodes(Doc->GetRoot());
+    }
+
+    const NameIndex::const_iterator it = Index->find(name);
+
+    return it == Index->end() ? nullptr : &it->second;
+}
+
+void wxXmlResourceDataRecord::IndexNodes(wxXmlNode* parent)
+{
+    // use the same order as DoFindResource(): first all the children and only
+    // then their children
+    wxXmlNode *node;
+    for (node = parent->GetChildren(); node; node = node->GetNext())
+    {
+        wxString name;
+        if ( IsObjectNode(node) && node->GetAttribute(wxS("name"), &name) )
+            (*Index)[name].push_back(node);
+    }
+
+    for (node = parent->GetChildren(); node; node = node->GetNext())
+    {
+        if ( IsObjectNode(node) )
+            IndexNodes(node);
+    }
+}
+
 
 wxXmlResource *wxXmlResource::ms_instance = nullptr;
 
@@ -764,6 +843,7 @@ bool wxXmlResource::UpdateResources()
 
         // Replace the old resource contents with the new one.
         rec.Doc.reset(doc);
+        rec.ResetIndex();
 
         // And, now that we loaded it successfully, update the last load time.
 #if wxUSE_DATETIME
@@ -800,8 +880,12 @@ wxXmlDocument *wxXmlResource::DoLoadFile(const wxString& filename)
         return nullptr;
     }
 
+    // Also support the files precompiled by "wxrc --binary".
     std::unique_ptr<wxXmlDocument> doc(new wxXmlDocument);
-    if (!doc->Load(*stream))
+    const bool ok = wxXmlDocument::IsBinaryFormat(*stream)
+                        ? doc->LoadBinary(*stream)
+                        : doc->Load(*stream);
+    if (!ok)
     {
         wxLogError(_("Cannot load resources from file '%s'."), filename);
         return nullptr;
@@ -885,29 +969,9 @@ wxXmlNode *wxXmlResource::DoFindResource(wxXmlNode *parent,
     // where the resource is most commonly looked for):
     for (node = parent->GetChildren(); node; node = node->GetNext())
     {
-        if ( IsObjectNode(node) && node->GetAttribute(wxS("name")) == name )
-        {
-            // empty class name matches everything
-            if ( classname.empty() )
-                return node;
-
-            wxString cls(node->GetAttribute(wxS("class")));
-
-            // object_ref may not have 'class' attribute:
-            if (cls.empty() && node->GetName() == wxS("object_ref"))
-            {
-                wxString refName = node->GetAttribute(wxS("ref"));
-                if (refName.empty())
-                    continue;
-
-                const wxXmlNode * const refNode = GetResourceNode(refName);
-                if ( refNode )
-                    cls = refNode->GetAttribute(wxS("class"));
-            }
-
-            if ( cls == classname )
-                return node;
-        }
+        if ( IsObjectNode(node) && node->GetAttribute(wxS("name")) == name &&
+                IsNodeOfClass(*this, node, classname) )
+            return node;
     }
 
     // then recurse in child nodes
@@ -970,14 +1034,35 @@ wxXmlResource::GetResourceNodeAndLocation(const wxString& name,
     // reloading of XRC files
     const_cast<wxXmlResource *>(this)->UpdateResources();
 
-    for ( const wxXmlResourceDataRecord& rec : Data() )
+    for ( wxXmlResourceDataRecord& rec : Data() )
     {
         wxXmlDocument * const doc = rec.Doc.get();
         if ( !doc || !doc->GetRoot() )
             continue;
 
-        wxXmlNode * const
+        wxXmlNode *found = nullptr;
+        if ( name.empty() )
+        {
+            // nodes without names are not indexed, so look for them directly
             found = DoFindResource(doc->GetRoot(), name, classname, recursive);
+        }
+        else if ( const std::vector<wxXmlNode*>* const nodes = rec.FindNodes(name) )
+        {
+            for ( wxXmlNode* node : *nodes )
+            {
+                // top-level nodes come first, so we can stop at the first
+                // nested node if we're not looking for them
+                if ( !recursive && node->GetParent() != doc->GetRoot() )
+                    break;
+
+                if ( IsNodeOfClass(*this, node, classname) )
+                {
+                    found = node;
+                    break;
+                }
+            }
+        }
+
         if ( found )
         {
             if ( path )
@@ -15,8 +15,13 @@
 #if wxUSE_STREAMS && wxUSE_ZIPSTREAM
 
 #include "archivetest.h"
+#include "wx/ffile.h"
+#include "wx/mstream.h"
+#include "wx/wfstream.h"
 #include "wx/zipstrm.h"
 
+#include "testfile.h"
+
 #include <memory>
 
 using std::string;
@@ -203,6 +208,196 @@ void ZipPipeTestCase::runTest()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// wxZipFileReader tests
+
+namespace
+{
+
+wxString GetZipTestData(int n)
+{
+    wxString data;
+    for ( int i = 0; i < 1000 * n; i++ )
+        data << "line " << i << " of entry " << n << "\n";
+    return data;
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxZipFileReader", "[archive][zip]")
+{
+    TempFile zipfile(wxFileName::CreateTempFileName("wxziptest"));
+
+    const int NUM_ENTRIES = 20;
+    {
+        wxFileOutputStream out(zipfile.GetName());
+        wxZipOutputStream zip(out);
+        REQUIRE( zip.PutNextDirEntry("dir/empty") );
+        for ( int n = 0; n < NUM_ENTRIES; n++ )
+        {
+            // Use both compressed and stored entries.
+            zip.SetLevel(n % 2 ? 0 : 6);
+            REQUIRE( zip.PutNextEntry(wxString::Format("dir/sub%d/file%d.txt",
+                                                       n % 3, n)) );
+            const wxString data = GetZipTestData(n);
+            const wxScopedCharBuffer buf = data.utf8_str();
+            REQUIRE( zip.WriteAll(buf.data(), buf.length()) );
+        }
+        REQUIRE( zip.Close() );
+    }
+
+    wxZipFileReader reader(zipfile.GetName());
+    REQUIRE( reader.IsOk() );
+    REQUIRE( reader.GetEntryCount() == NUM_ENTRIES + 1 );
+    CHECK( reader.GetEntry(0).IsDir() );
+    CHECK( reader.GetEntry(3).GetName(wxPATH_UNIX) == "dir/sub2/file2.txt" );
+
+    SECTION("OpenEntry")
+    {
+        // Check that the streams are independent by reading from them in
+        // turns.
+        std::unique_ptr<wxZipInputStream> in1(reader.OpenEntry(5));
+        std::unique_ptr<wxZipInputStream> in2(reader.OpenEntry(6));
+        REQUIRE( in1 );
+        REQUIRE( in2 );
+
+        wxString data1, data2;
+        char buf[100];
+        while ( in1->CanRead() || in2->CanRead() )
+        {
+            data1 += wxString::FromUTF8(buf, in1->Read(buf, sizeof(buf)).LastRead());
+            data2 += wxString::FromUTF8(buf, in2->Read(buf, sizeof(buf)).LastRead());
+        }
+
+        CHECK( in1->Eof() );
+        CHECK( in2->Eof() );
+        CHECK( data1 == GetZipTestData(4) );
+        CHECK( data2 == GetZipTestData(5) );
+    }
+
+    SECTION("ExtractAll")
+    {
+        const wxString dir = wxFileName::CreateTempFileName("wxzipdir");
+        wxRemoveFile(dir);
+
+        const unsigned numThreads = GENERATE(1, 4);
+        INFO("Using " << numThreads << " threads");
+        CHECK( reader.ExtractAll(dir, numThreads) );
+
+        CHECK( wxDirExists(dir + "/dir/empty") );
+        for ( int n = 0; n < NUM_ENTRIES; n++ )
+        {
+            INFO("Entry " << n);
+
+            wxFFile file(wxString::Format("%s/dir/sub%d/file%d.txt",
+                                          dir, n % 3, n));
+            wxString data;
+            CHECK( file.ReadAll(&data, wxConvUTF8) );
+            CHECK( data == GetZipTestData(n) );
+        }
+
+        wxFileName::Rmdir(dir, wxPATH_RMDIR_RECURSIVE);
+    }
+}
+
+TEST_CASE("wxZipOutputStream::EnableParallel", "[archive][zip]")
+{
+    wxString data;
+    for ( int n = 0; n < 10; n++ )
+        data += GetZipTestData(n);
+    const wxScopedCharBuffer buf = data.utf8_str();
+
+    // Even the smallest entry must consist of several blocks of the default
+    // size of 128KiB for them to be compressed in parallel.
+    REQUIRE( buf.length() / 3 > 2*128*1024 );
+
+    wxMemoryOutputStream mos;
+    {
+        wxZipOutputStream zip(mos);
+        zip.EnableParallel(2);
+        for ( int n = 0; n < 3; n++ )
+        {
+            REQUIRE( zip.PutNextEntry(wxString::Format("file%d.txt", n)) );
+            REQUIRE( zip.WriteAll(buf.data(), buf.length() / (n + 1)) );
+        }
+        REQUIRE( zip.Close() );
+    }
+
+    wxMemoryInputStream mis(mos);
+    wxZipInputStream zip(mis);
+    for ( int n = 0; n < 3; n++ )
+    {
+        INFO("Entry " << n);
+
+        std::unique_ptr<wxZipEntry> entry(zip.GetNextEntry());
+        REQUIRE( entry );
+        CHECK( entry->GetMethod() == wxZIP_METHOD_DEFLATE );
+
+        const size_t len = buf.length() / (n + 1);
+        std::vector<char> result(len + 1);
+        CHECK( zip.Read(result.data(), result.size()).LastRead() == len );
+        CHECK( zip.Eof() );
+        CHECK( memcmp(result.data(), buf.data(), len) == 0 );
+    }
+}
+
+TEST_CASE("wxZipFileReader::UnsafeName", "[archive][zip]")
+{
+    TempFile zipfile(wxFileName::CreateTempFileName("wxziptest"));
+    {
+        wxFileOutputStream out(zipfile.GetName());
+        wxZipOutputStream zip(out);
+        REQUIRE( zip.PutNextEntry("dir/../../escaped.txt") );
+        REQUIRE( zip.WriteAll("data", 4) );
+        REQUIRE( zip.Close() );
+    }
+
+    wxZipFileReader reader(zipfile.GetName());
+    REQUIRE( reader.IsOk() );
+
+    const wxString dir = wxFileName::CreateTempFileName("wxzipdir");
+    wxRemoveFile(dir);
+
+    wxLogNull noLog;
+    CHECK_FALSE( reader.ExtractAll(dir) );
+    CHECK_FALSE( wxFileExists(wxFileName(dir).GetPath() + "/escaped.txt") );
+
+    wxFileName::Rmdir(dir, wxPATH_RMDIR_RECURSIVE);
+}
+
+TEST_CASE("wxZipFileReader::BackslashName", "[archive][zip]")
+{
+    // Backslashes are path separators under Windows, so the names containing
+    // them must be rejected everywhere.
+    TempFile zipfile(wxFileName::CreateTempFileName("wxziptest"));
+    {
+        wxFileOutputStream out(zipfile.GetName());
+        wxZipOutputStream zip(out);
+
+        wxZipEntry* const entry = new wxZipEntry;
+        entry->SetName("dir\\..\\..\\escaped.txt", wxPATH_UNIX);
+        REQUIRE( zip.PutNextEntry(entry) );
+        REQUIRE( zip.WriteAll("data", 4) );
+        REQUIRE( zip.Close() );
+    }
+
+    wxZipFileReader reader(zipfile.GetName());
+    REQUIRE( reader.IsOk() );
+    REQUIRE( reader.GetEntryCount() == 1 );
+    CHECK( reader.GetEntry(0).GetInternalName() == "dir\\..\\..\\escaped.txt" );
+
+    const wxString dir = wxFileName::CreateTempFileName("wxzipdir");
+    wxRemoveFile(dir);
+
+    wxLogNull noLog;
+    CHECK_FALSE( reader.ExtractAll(dir) );
+    CHECK_FALSE( wxFileExists(wxFileName(dir).GetPath() + "/escaped.txt") );
+    CHECK_FALSE( wxDirExists(dir) );
+
+    wxFileName::Rmdir(dir, wxPATH_RMDIR_RECURSIVE);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Zip suite
 
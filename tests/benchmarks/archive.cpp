@@ -0,0 +1,358 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/archive.cpp
+// Purpose:     Benchmarks for zip and tar archives
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/filename.h"
+#include "wx/fs_arc.h"
+#include "wx/mstream.h"
+#include "wx/tarstrm.h"
+#include "wx/wfstream.h"
+#include "wx/zipstrm.h"
+
+#include "bench.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#if wxUSE_ARCHIVE_STREAMS
+
+namespace
+{
+
+// Return the number of entries in the test archives, which can be changed
+// from the command line.
+size_t GetEntriesCount()
+{
+    return Bench::GetNumericParameter(500);
+}
+
+// Return the name of the entry with the given index: the entries are
+// distributed over several directories, like the files in a typical archive
+// containing the application resources or documentation.
+wxString GetEntryName(size_t n)
+{
+    static const char* const dirs[] = { "images", "help", "xrc", "data" };
+    static const char* const exts[] = { "png", "html", "xrc", "txt" };
+
+    const size_t kind = n % WXSIZEOF(dirs);
+
+    return wxString::Format("%s/sub%lu/file%lu.%s",
+                            dirs[kind],
+                            static_cast<unsigned long>(n / 50),
+                            static_cast<unsigned long>(n),
+                            exts[kind]);
+}
+
+// Return the text used for the contents of the archive entries.
+const std::string& GetEntriesText()
+{
+    static std::string s_text;
+    if ( s_text.empty() )
+    {
+        // Use the text which is compressible, but not too much.
+        unsigned seed = 1;
+        while ( s_text.size() < 64*1024 )
+        {
+            seed = seed*1103515245 + 12345;
+
+            char line[64];
+            snprintf(line, sizeof(line), "line %u: value=%x\n",
+                     seed % 1000, seed);
+            s_text += line;
+        }
+    }
+
+    return s_text;
+}
+
+// Create the archive with the test data using the given factory.
+std::vector<char> CreateArchive(const wxArchiveClassFactory& factory)
+{
+    const std::string& text = GetEntriesText();
+
+    wxMemoryOutputStream mos;
+    {
+        std::unique_ptr<wxArchiveOutputStream>
+            arc(factory.NewStream(mos));
+
+        const wxDateTime dt(1, wxDateTime::Jan, 2026);
+
+        unsigned seed = 1;
+        for ( size_t n = 0; n < GetEntriesCount(); n++ )
+        {
+            seed = seed*1103515245 + 12345;
+
+            // Use files of different sizes, from a hundred bytes to a few
+            // KiB, with different contents.
+            const size_t size = 100 + (seed >> 8) % (8*1024);
+            const size_t offset = (seed >> 4) % (text.size() - size);
+
+            arc->PutNextEntry(GetEntryName(n), dt, size);
+            arc->Write(text.data() + offset, size);
+        }
+    }
+
+    std::vector<char> data(mos.GetLength());
+    mos.CopyTo(data.data(), data.size());
+
+    return data;
+}
+
+#if wxUSE_ZIPSTREAM
+
+const wxZipClassFactory& GetZipFactory()
+{
+    static wxZipClassFactory s_factory;
+    return s_factory;
+}
+
+const std::vector<char>& GetZipData()
+{
+    static std::vector<char> s_data;
+    if ( s_data.empty() )
+        s_data = CreateArchive(GetZipFactory());
+
+    return s_data;
+}
+
+#if wxUSE_FILE
+
+// Temporary directory containing the zip file and the files extracted from it,
+// deleted on exit.
+class ZipTempDir
+{
+public:
+    ZipTempDir()
+    {
+        m_dir = wxFileName::CreateTempFileName("wxbench");
+        wxRemoveFile(m_dir);
+        wxFileName::Mkdir(m_dir);
+
+        const std::vector<char>& data = GetZipData();
+        wxFileOutputStream out(GetZipFile());
+        out.WriteAll(data.data(), data.size());
+    }
+
+    ~ZipTempDir()
+    {
+        wxFileName::Rmdir(m_dir, wxPATH_RMDIR_RECURSIVE);
+    }
+
+    wxString GetZipFile() const { return m_dir + "/bench.zip"; }
+    wxString GetExtractDir() const { return m_dir + "/extracted"; }
+
+private:
+    wxString m_dir;
+};
+
+const ZipTempDir& GetZipTempDir()
+{
+    static ZipTempDir s_dir;
+    return s_dir;
+}
+
+// Extract all entries of the zip file to the disk using the given number of
+// threads, with 0 meaning one per CPU.
+bool ExtractZipFile(unsigned numThreads)
+{
+    const ZipTempDir& dir = GetZipTempDir();
+
+    wxZipFileReader zip(dir.GetZipFile());
+    return zip.GetEntryCount() == GetEntriesCount() &&
+                zip.ExtractAll(dir.GetExtractDir(), numThreads);
+}
+
+#if wxUSE_FS_ARCHIVE
+
+// Open the entry with the given index using the archive file system handler,
+// which caches the catalog of the archive after the first call.
+bool OpenZipFSEntry(size_t n)
+{
+    static wxArchiveFSHandler s_handler;
+    static wxFileSystem s_fs;
+
+    const wxString location = wxFileSystem::FileNameToURL(
+                                GetZipTempDir().GetZipFile()) +
+                              "#zip:" + GetEntryName(n);
+
+    std::unique_ptr<wxFSFile> file(s_handler.OpenFile(s_fs, location));
+    return file && file->GetStream()->IsOk();
+}
+
+#endif // wxUSE_FS_ARCHIVE
+
+#endif // wxUSE_FILE
+
+#endif // wxUSE_ZIPSTREAM
+
+#if wxUSE_TARSTREAM
+
+const wxTarClassFactory& GetTarFactory()
+{
+    static wxTarClassFactory s_factory;
+    return s_factory;
+}
+
+const std::vector<char>& GetTarData()
+{
+    static std::vector<char> s_data;
+    if ( s_data.empty() )
+        s_data = CreateArchive(GetTarFactory());
+
+    return s_data;
+}
+
+#endif // wxUSE_TARSTREAM
+
+// Iterate over all entries and return their number, optionally reading their
+// data too.
+size_t ReadArchive(const wxArchiveClassFactory& factory,
+                   const std::vector<char>& data,
+                   bool readData)
+{
+    wxMemoryInputStream mis(data.data(), data.size());
+    std::unique_ptr<wxArchiveInputStream> arc(factory.NewStream(mis));
+
+    char buf[16384];
+    size_t count = 0;
+    for ( ;; )
+    {
+        std::unique_ptr<wxArchiveEntry> entry(arc->GetNextEntry());
+        if ( !entry )
+            break;
+
+        if ( readData )
+        {
+            while ( arc->Read(buf, sizeof(buf)).LastRead() )
+                ;
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+// Find the entry with the given name by iterating over all of them, as done
+// by wxArchiveFSHandler, and read it.
+bool FindEntry(const wxArchiveClassFactory& factory,
+               const std::vector<char>& data,
+               const wxString& name)
+{
+    wxMemoryInputStream mis(data.data(), data.size());
+    std::unique_ptr<wxArchiveInputStream> arc(factory.NewStream(mis));
+
+    for ( ;; )
+    {
+        std::unique_ptr<wxArchiveEntry> entry(arc->GetNextEntry());
+        if ( !entry )
+            return false;
+
+        if ( entry->GetName(wxPATH_UNIX) == name )
+        {
+            char buf[16384];
+            while ( arc->Read(buf, sizeof(buf)).LastRead() )
+                ;
+
+            return arc->Eof();
+        }
+    }
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// Zip archives
+// ----------------------------------------------------------------------------
+
+#if wxUSE_ZIPSTREAM
+
+BENCHMARK_FUNC(ZipCreate)
+{
+    return !CreateArchive(GetZipFactory()).empty();
+}
+
+BENCHMARK_FUNC(ZipListEntries)
+{
+    return ReadArchive(GetZipFactory(), GetZipData(), false) == GetEntriesCount();
+}
+
+BENCHMARK_FUNC(ZipExtractAll)
+{
+    return ReadArchive(GetZipFactory(), GetZipData(), true) == GetEntriesCount();
+}
+
+BENCHMARK_FUNC(ZipFindLastEntry)
+{
+    return FindEntry(GetZipFactory(), GetZipData(),
+                     GetEntryName(GetEntriesCount() - 1));
+}
+
+#if wxUSE_FILE
+
+BENCHMARK_FUNC(ZipFileExtractSerial)
+{
+    return ExtractZipFile(1);
+}
+
+BENCHMARK_FUNC(ZipFileExtractParallel)
+{
+    return ExtractZipFile(0);
+}
+
+#if wxUSE_FS_ARCHIVE
+
+// The time of opening any entry should be the same, whatever its position in
+// the archive.
+BENCHMARK_FUNC(ZipFSOpenFirstEntry)
+{
+    return OpenZipFSEntry(0);
+}
+
+BENCHMARK_FUNC(ZipFSOpenLastEntry)
+{
+    return OpenZipFSEntry(GetEntriesCount() - 1);
+}
+
+#endif // wxUSE_FS_ARCHIVE
+
+#endif // wxUSE_FILE
+
+#endif // wxUSE_ZIPSTREAM
+
+// ----------------------------------------------------------------------------
+// Tar archives
+// ----------------------------------------------------------------------------
+
+#if wxUSE_TARSTREAM
+
+BENCHMARK_FUNC(TarCreate)
+{
+    return !CreateArchive(GetTarFactory()).empty();
+}
+
+BENCHMARK_FUNC(TarListEntries)
+{
+    return ReadArchive(GetTarFactory(), GetTarData(), false) == GetEntriesCount();
+}
+
+BENCHMARK_FUNC(TarExtractAll)
+{
+    return ReadArchive(GetTarFactory(), GetTarData(), true) == GetEntriesCount();
+}
+
+BENCHMARK_FUNC(TarFindLastEntry)
+{
+    return FindEntry(GetTarFactory(), GetTarData(),
+                     GetEntryName(GetEntriesCount() - 1));
+}
+
+#endif // wxUSE_TARSTREAM
+
+#endif // wxUSE_ARCHIVE_STREAMS
@@ -16,12 +16,28 @@
 // ----------------------------------------------------------------------------
 
 #include <float.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
 
 #include "wx/app.h"
 #include "wx/cmdline.h"
+#include "wx/ffile.h"
 #include "wx/stopwatch.h"
+#include "wx/tokenzr.h"
 #include "wx/uilocale.h"
 
+#ifdef __WINDOWS__
+    #include "wx/msw/wrapwin.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
 #if wxUSE_GUI
     #include "wx/frame.h"
 #endif
@@ -39,6 +55,702 @@ static const char OPTION_RUN_TIME = 't';
 static const char OPTION_NUM_RUNS = 'n';
 static const char OPTION_NUMERIC_PARAM = 'p';
 static const char OPTION_STRING_PARAM = 's';
+static const char OPTION_WARMUP = 'w';
+
+static const char OPTION_JSON = 'j';
+static const char OPTION_CSV = 'c';
+static const char OPTION_COMPARE = 'C';
+static const char OPTION_THRESHOLD = 'T';
+
+// maximal number of samples kept for each benchmark
+static const size_t MAX_SAMPLES = 10000;
+
+// significance level used when comparing the results
+static const double SIGNIFICANCE_LEVEL = 0.05;
+
+// ----------------------------------------------------------------------------
+// helper classes
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Return the CPU time used by the process so far in microseconds.
+double GetCPUTimeInMicro()
+{
+#ifdef __WINDOWS__
+    FILETIME ftCreation, ftExit, ftKernel, ftUser;
+    if ( !::GetProcessTimes(::GetCurrentProcess(),
+                            &ftCreation, &ftExit, &ftKernel, &ftUser) )
+        return 0;
+
+    ULARGE_INTEGER kernel, user;
+    kernel.LowPart = ftKernel.dwLowDateTime;
+    kernel.HighPart = ftKernel.dwHighDateTime;
+    user.LowPart = ftUser.dwLowDateTime;
+    user.HighPart = ftUser.dwHighDateTime;
+
+    // FILETIME values are expressed in 100ns units.
+    return (kernel.QuadPart + user.QuadPart) / 10.;
+#elif defined(CLOCK_PROCESS_CPUTIME_ID)
+    timespec ts;
+    if ( clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0 )
+        return 0;
+
+    return ts.tv_sec*1e6 + ts.tv_nsec/1e3;
+#else
+    return clock()*1e6/CLOCKS_PER_SEC;
+#endif
+}
+
+// Format the time in microseconds for human-readable output, showing the
+// fractional part only for short times.
+wxString FormatMicro(double t)
+{
+    return wxString::Format(t < 10 ? "%.2fus" : "%.0fus", t);
+}
+
+// Summary statistics of a series of measurements, all times are in us.
+struct Stats
+{
+    long runs = 0;
+
+    double mean = 0,
+           median = 0,
+           p95 = 0,
+           stddev = 0,
+           min = 0,
+           max = 0;
+};
+
+// Accumulates the values of a single series of measurements.
+class Series
+{
+public:
+    Series() = default;
+
+    void Add(double x)
+    {
+        // We use the algorithm for iteratively computing the mean and the
+        // standard deviation of the sequence of values described in Knuth's
+        // "The Art of Computer Programming, Volume 2: Seminumerical
+        // Algorithms", section 4.2.2.
+        //
+        // The algorithm defines the sequences M(k) and S(k) as follows:
+        //
+        //  M(1) = x(1), M(k) = M(k-1) + (x(k) - M(k-1)) / k
+        //  S(1) = 0,    S(k) = S(k-1) + (x(k) - M(k-1))*(x(k) - M(k))
+        //
+        // where x(k) is the k-th value. Then the mean is simply the last
+        // value of the first sequence M(N) and the standard deviation is
+        // sqrt(S(N)/(N-1)).
+        m_count++;
+
+        const double lastM = m_mean;
+        m_mean += (x - lastM) / m_count;
+        m_s += (x - lastM)*(x - m_mean);
+
+        if ( x < m_min )
+            m_min = x;
+        if ( x > m_max )
+            m_max = x;
+    }
+
+    // Samples are stored separately as not all values are kept, see
+    // Measurements::Add().
+    std::vector<double>& Samples() { return m_samples; }
+    const std::vector<double>& Samples() const { return m_samples; }
+
+    Stats GetStats() const
+    {
+        Stats stats;
+        stats.runs = m_count;
+        if ( !m_count )
+            return stats;
+
+        stats.mean = m_mean;
+        stats.stddev = m_count > 1 ? sqrt(m_s / (m_count - 1)) : 0;
+        stats.min = m_min;
+        stats.max = m_max;
+
+        // The percentiles are computed from the stored samples only, which
+        // are a uniformly distributed subset of all values.
+        std::vector<double> sorted(m_samples);
+        std::sort(sorted.begin(), sorted.end());
+        stats.median = GetPercentile(sorted, 0.5);
+        stats.p95 = GetPercentile(sorted, 0.95);
+
+        return stats;
+    }
+
+private:
+    // Return the percentile using linear interpolation between the closest
+    // ranks.
+    static double GetPercentile(const std::vector<double>& sorted, double p)
+    {
+        if ( sorted.empty() )
+            return 0;
+
+        const double pos = p*(sorted.size() - 1);
+        const size_t lo = static_cast<size_t>(pos);
+        if ( lo + 1 >= sorted.size() )
+            return sorted.back();
+
+        return sorted[lo] + (pos - lo)*(sorted[lo + 1] - sorted[lo]);
+    }
+
+    long m_count = 0;
+    double m_mean = 0,
+           m_s = 0,
+           m_min = DBL_MAX,
+           m_max = 0;
+
+    std::vector<double> m_samples;
+};
+
+// Wall clock and CPU times of all runs of a benchmark.
+class Measurements
+{
+public:
+    Measurements() = default;
+
+    void Add(double wall, double cpu)
+    {
+        m_wall.Add(wall);
+        m_cpu.Add(cpu);
+
+        // Don't keep all the samples for very fast benchmarks, which can be
+        // run millions of times, but use reservoir sampling to keep a random
+        // subset of them of bounded size with the same distribution.
+        std::vector<double>& wallSamples = m_wall.Samples();
+        std::vector<double>& cpuSamples = m_cpu.Samples();
+        if ( wallSamples.size() < MAX_SAMPLES )
+        {
+            wallSamples.push_back(wall);
+            cpuSamples.push_back(cpu);
+        }
+        else
+        {
+            std::uniform_int_distribution<long> dist(0, m_count);
+            const size_t n = dist(m_random);
+            if ( n < MAX_SAMPLES )
+            {
+                wallSamples[n] = wall;
+                cpuSamples[n] = cpu;
+            }
+        }
+
+        m_count++;
+    }
+
+    long GetCount() const { return m_count; }
+
+    const Series& GetWall() const { return m_wall; }
+    const Series& GetCPU() const { return m_cpu; }
+
+private:
+    Series m_wall,
+           m_cpu;
+    long m_count = 0;
+
+    // Use fixed seed to make the results reproducible.
+    std::minstd_rand m_random;
+};
+
+// Results of running a single benchmark, either just measured or loaded from
+// a file, in which case the samples may be empty.
+struct Result
+{
+    wxString name;
+
+    Stats wall,
+          cpu;
+
+    std::vector<double> wallSamples,
+                        cpuSamples;
+};
+
+typedef std::vector<Result> Results;
+
+// ----------------------------------------------------------------------------
+// Saving and loading results
+// ----------------------------------------------------------------------------
+
+// All numbers are output using the C locale and with fixed precision, as
+// the results are meant to be read by programs.
+wxString FormatNumber(double x)
+{
+    return wxString::FromCDouble(x, 3);
+}
+
+// Names of the fields of Stats used in the files.
+const struct StatsField
+{
+    const char* name;
+    double Stats::*field;
+} STATS_FIELDS[] =
+{
+    { "mean",   &Stats::mean   },
+    { "median", &Stats::median },
+    { "p95",    &Stats::p95    },
+    { "stddev", &Stats::stddev },
+    { "min",    &Stats::min    },
+    { "max",    &Stats::max    },
+};
+
+wxString QuoteJSON(const wxString& s)
+{
+    wxString quoted('"');
+    for ( wxString::const_iterator it = s.begin(); it != s.end(); ++it )
+    {
+        const wxUniChar ch = *it;
+        if ( ch == '"' || ch == '\\' )
+            quoted += '\\';
+        quoted += ch;
+    }
+    quoted += '"';
+
+    return quoted;
+}
+
+wxString StatsToJSON(const Stats& stats)
+{
+    wxString json("{");
+    for ( const StatsField& f : STATS_FIELDS )
+    {
+        if ( json.length() > 1 )
+            json += ", ";
+        json += wxString::Format("\"%s\": %s",
+                                 f.name, FormatNumber(stats.*f.field));
+    }
+    json += "}";
+
+    return json;
+}
+
+wxString SamplesToJSON(const std::vector<double>& samples)
+{
+    wxString json("[");
+    for ( size_t n = 0; n < samples.size(); n++ )
+    {
+        if ( n )
+            json += ", ";
+        json += FormatNumber(samples[n]);
+    }
+    json += "]";
+
+    return json;
+}
+
+bool SaveResultsAsJSON(const wxString& filename, const Results& results)
+{
+    wxString json;
+    json << "{\n"
+         << "  \"build\": " << QuoteJSON(WX_BUILD_OPTIONS_SIGNATURE) << ",\n"
+         << "  \"unit\": \"us\",\n"
+         << "  \"benchmarks\": [";
+
+    for ( size_t n = 0; n < results.size(); n++ )
+    {
+        const Result& r = results[n];
+
+        if ( n )
+            json << ",";
+        json << "\n"
+             << "    {\n"
+             << "      \"name\": " << QuoteJSON(r.name) << ",\n"
+             << "      \"runs\": " << r.wall.runs << ",\n"
+             << "      \"wall\": " << StatsToJSON(r.wall) << ",\n"
+             << "      \"cpu\": " << StatsToJSON(r.cpu) << ",\n"
+             << "      \"samples\": {\n"
+             << "        \"wall\": " << SamplesToJSON(r.wallSamples) << ",\n"
+             << "        \"cpu\": " << SamplesToJSON(r.cpuSamples) << "\n"
+             << "      }\n"
+             << "    }";
+    }
+
+    json << "\n  ]\n}\n";
+
+    wxFFile file(filename, "w");
+    return file.IsOpened() && file.Write(json) && file.Close();
+}
+
+bool SaveResultsAsCSV(const wxString& filename, const Results& results)
+{
+    wxString csv("name,runs");
+    for ( const char* kind : { "wall", "cpu" } )
+    {
+        for ( const StatsField& f : STATS_FIELDS )
+            csv << "," << kind << "_" << f.name;
+    }
+    csv << "\n";
+
+    for ( const Result& r : results )
+    {
+        csv << r.name << "," << r.wall.runs;
+        for ( const Stats* stats : { &r.wall, &r.cpu } )
+        {
+            for ( const StatsField& f : STATS_FIELDS )
+                csv << "," << FormatNumber(stats->*f.field);
+        }
+        csv << "\n";
+    }
+
+    wxFFile file(filename, "w");
+    return file.IsOpened() && file.Write(csv) && file.Close();
+}
+
+// Minimal JSON parser only supporting what is needed for reading the files
+// created by SaveResultsAsJSON().
+class JSONValue
+{
+public:
+    enum Type { Null, Bool, Number, String, Array, Object };
+
+    JSONValue() = default;
+
+    Type GetType() const { return m_type; }
+    double GetNumber() const { return m_number; }
+    const wxString& GetString() const { return m_string; }
+    const std::vector<JSONValue>& GetItems() const { return m_items; }
+
+    // Return the member with the given name or a null value if not found.
+    const JSONValue& operator[](const char* name) const
+    {
+        static const JSONValue s_null;
+
+        for ( size_t n = 0; n < m_names.size(); n++ )
+        {
+            if ( m_names[n] == name )
+                return m_items[n];
+        }
+
+        return s_null;
+    }
+
+    // Parse the value starting at the given position and advance it.
+    bool Parse(const std::string& text, size_t& pos)
+    {
+        SkipSpace(text, pos);
+        if ( pos == text.length() )
+            return false;
+
+        switch ( text[pos] )
+        {
+            case '{':
+                m_type = Object;
+                return ParseItems(text, pos, '}');
+
+            case '[':
+                m_type = Array;
+                return ParseItems(text, pos, ']');
+
+            case '"':
+                m_type = String;
+                return ParseString(text, pos, m_string);
+
+            case 't':
+            case 'f':
+            case 'n':
+                for ( const char* word : { "true", "false", "null" } )
+                {
+                    if ( text.compare(pos, strlen(word), word) == 0 )
+                    {
+                        m_type = *word == 'n' ? Null : Bool;
+                        m_number = *word == 't';
+                        pos += strlen(word);
+                        return true;
+                    }
+                }
+                return false;
+        }
+
+        m_type = Number;
+
+        const size_t start = pos;
+        while ( pos < text.length() && strchr("+-.0123456789eE", text[pos]) )
+            pos++;
+
+        return wxString(text.substr(start, pos - start)).ToCDouble(&m_number);
+    }
+
+private:
+    static void SkipSpace(const std::string& text, size_t& pos)
+    {
+        while ( pos < text.length() && strchr(" \t\r\n", text[pos]) )
+            pos++;
+    }
+
+    static bool ParseString(const std::string& text, size_t& pos, wxString& str)
+    {
+        std::string s;
+        for ( pos++; pos < text.length(); pos++ )
+        {
+            char ch = text[pos];
+            if ( ch == '"' )
+            {
+                pos++;
+                str = wxString::FromUTF8(s);
+                return true;
+            }
+
+            // We don't produce any other escapes, so don't bother handling
+            // them.
+            if ( ch == '\\' )
+            {
+                if ( ++pos == text.length() )
+                    return false;
+                ch = text[pos];
+            }
+
+            s += ch;
+        }
+
+        return false;
+    }
+
+    bool ParseItems(const std::string& text, size_t& pos, char end)
+    {
+        pos++;
+        SkipSpace(text, pos);
+        if ( pos < text.length() && text[pos] == end )
+        {
+            pos++;
+            return true;
+        }
+
+        for ( ;; )
+        {
+            if ( m_type == Object )
+            {
+                wxString name;
+                SkipSpace(text, pos);
+                if ( pos == text.length() || text[pos] != '"' ||
+                        !ParseString(text, pos, name) )
+                    return false;
+
+                SkipSpace(text, pos);
+                if ( pos == text.length() || text[pos++] != ':' )
+                    return false;
+
+                m_names.push_back(name);
+            }
+
+            m_items.push_back(JSONValue());
+            if ( !m_items.back().Parse(text, pos) )
+                return false;
+
+            SkipSpace(text, pos);
+            if ( pos == text.length() )
+                return false;
+
+            const char ch = text[pos++];
+            if ( ch == end )
+                return true;
+            if ( ch != ',' )
+                return false;
+        }
+    }
+
+    Type m_type = Null;
+    double m_number = 0;
+    wxString m_string;
+    std::vector<wxString> m_names;
+    std::vector<JSONValue> m_items;
+};
+
+bool LoadResultsFromJSON(const std::string& text, Results& results)
+{
+    JSONValue root;
+    size_t pos = 0;
+    if ( !root.Parse(text, pos) || root.GetType() != JSONValue::Object )
+        return false;
+
+    const JSONValue& benchmarks = root["benchmarks"];
+    if ( benchmarks.GetType() != JSONValue::Array )
+        return false;
+
+    for ( const JSONValue& b : benchmarks.GetItems() )
+    {
+        Result r;
+        r.name = b["name"].GetString();
+        if ( r.name.empty() )
+            return false;
+
+        r.wall.runs =
+        r.cpu.runs = static_cast<long>(b["runs"].GetNumber());
+
+        for ( const StatsField& f : STATS_FIELDS )
+        {
+            r.wall.*f.field = b["wall"][f.name].GetNumber();
+            r.cpu.*f.field = b["cpu"][f.name].GetNumber();
+        }
+
+        for ( const JSONValue& v : b["samples"]["wall"].GetItems() )
+            r.wallSamples.push_back(v.GetNumber());
+        for ( const JSONValue& v : b["samples"]["cpu"].GetItems() )
+            r.cpuSamples.push_back(v.GetNumber());
+
+        results.push_back(r);
+    }
+
+    return true;
+}
+
+bool LoadResultsFromCSV(const std::string& text, Results& results)
+{
+    wxStringTokenizer lines(wxString::FromUTF8(text), "\r\n");
+
+    // Find the columns we need using the header line.
+    const wxArrayString header = wxSplit(lines.GetNextToken(), ',', '\0');
+    const int colName = header.Index("name");
+    const int colRuns = header.Index("runs");
+    if ( colName == wxNOT_FOUND || colRuns == wxNOT_FOUND )
+        return false;
+
+    while ( lines.HasMoreTokens() )
+    {
+        const wxArrayString values = wxSplit(lines.GetNextToken(), ',', '\0');
+        if ( values.size() != header.size() )
+            return false;
+
+        Result r;
+        r.name = values[colName];
+        if ( !values[colRuns].ToLong(&r.wall.runs) )
+            return false;
+        r.cpu.runs = r.wall.runs;
+
+        for ( const StatsField& f : STATS_FIELDS )
+        {
+            const int colWall = header.Index(wxString("wall_") + f.name);
+            const int colCPU = header.Index(wxString("cpu_") + f.name);
+            if ( colWall != wxNOT_FOUND )
+                values[colWall].ToCDouble(&(r.wall.*f.field));
+            if ( colCPU != wxNOT_FOUND )
+                values[colCPU].ToCDouble(&(r.cpu.*f.field));
+        }
+
+        results.push_back(r);
+    }
+
+    return true;
+}
+
+// Load the results from a file in either of the supported formats.
+bool LoadResults(const wxString& filename, Results& results)
+{
+    wxFFile file(filename, "rb");
+    if ( !file.IsOpened() )
+        return false;
+
+    std::string text;
+    char buf[4096];
+    size_t count;
+    while ( (count = file.Read(buf, sizeof(buf))) != 0 )
+        text.append(buf, count);
+
+    if ( file.Error() )
+        return false;
+
+    const size_t start = text.find_first_not_of(" \t\r\n");
+    if ( start != std::string::npos && text[start] == '{' )
+        return LoadResultsFromJSON(text, results);
+
+    return LoadResultsFromCSV(text, results);
+}
+
+// ----------------------------------------------------------------------------
+// Comparing results
+// ----------------------------------------------------------------------------
+
+// Evaluate the continued fraction for the incomplete beta function using the
+// modified Lentz's method, see "Numerical Recipes in C", section 6.4.
+double BetaContinuedFraction(double a, double b, double x)
+{
+    const double EPS = 1e-12;
+    const double TINY = 1e-300;
+
+    double c = 1,
+           d = 1 - (a + b)*x/(a + 1);
+    if ( fabs(d) < TINY )
+        d = TINY;
+    d = 1/d;
+
+    double h = d;
+    for ( int m = 1; m <= 300; m++ )
+    {
+        const int m2 = 2*m;
+
+        // Even step of the recurrence.
+        double aa = m*(b - m)*x/((a + m2 - 1)*(a + m2));
+        d = 1 + aa*d;
+        if ( fabs(d) < TINY )
+            d = TINY;
+        c = 1 + aa/c;
+        if ( fabs(c) < TINY )
+            c = TINY;
+        d = 1/d;
+        h *= d*c;
+
+        // Odd step.
+        aa = -(a + m)*(a + b + m)*x/((a + m2)*(a + m2 + 1));
+        d = 1 + aa*d;
+        if ( fabs(d) < TINY )
+            d = TINY;
+        c = 1 + aa/c;
+        if ( fabs(c) < TINY )
+            c = TINY;
+        d = 1/d;
+
+        const double del = d*c;
+        h *= del;
+        if ( fabs(del - 1) < EPS )
+            break;
+    }
+
+    return h;
+}
+
+// Return the regularized incomplete beta function I_x(a, b).
+double IncompleteBeta(double a, double b, double x)
+{
+    if ( x <= 0 )
+        return 0;
+    if ( x >= 1 )
+        return 1;
+
+    const double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) +
+                             a*log(x) + b*log(1 - x));
+
+    // Use the symmetry relation to ensure fast convergence.
+    if ( x < (a + 1)/(a + b + 2) )
+        return front*BetaContinuedFraction(a, b, x)/a;
+
+    return 1 - front*BetaContinuedFraction(b, a, 1 - x)/b;
+}
+
+// Return the two-sided p-value of Welch's t-test for the difference of the
+// means of two series, or a negative value if it can't be computed.
+double WelchTTest(const Stats& s1, const Stats& s2)
+{
+    if ( s1.runs < 2 || s2.runs < 2 )
+        return -1;
+
+    const double v1 = s1.stddev*s1.stddev/s1.runs,
+                 v2 = s2.stddev*s2.stddev/s2.runs;
+    const double v = v1 + v2;
+    if ( v == 0 )
+        return s1.mean == s2.mean ? 1 : 0;
+
+    const double t = (s2.mean - s1.mean)/sqrt(v);
+
+    // Welch-Satterthwaite approximation of the degrees of freedom.
+    const double df = v*v/(v1*v1/(s1.runs - 1) + v2*v2/(s2.runs - 1));
+
+    return IncompleteBeta(df/2, 0.5, df/(df + t*t));
+}
+
+} // anonymous namespace
 
 // ----------------------------------------------------------------------------
 // BenchApp declaration
@@ -74,12 +786,34 @@ private:
     // list all registered benchmarks
     void ListBenchmarks();
 
+    // save the results in the files specified on the command line, if any
+    bool SaveResults();
+
+    // compare the results in the two files and return false if there are any
+    // significant regressions or if comparing them failed
+    bool CompareResults(const wxString& oldFile, const wxString& newFile);
+
     // command lines options/parameters
     wxSortedArrayString m_toRun;
     long m_numRuns, // number of times to run a single benchmark or 0
          m_runTime, // minimum time to run a single benchmark if m_numRuns == 0
+         m_warmup,  // number of runs to perform before starting measuring
          m_numParam;
     wxString m_strParam;
+
+    // files to save the results to, if not empty
+    wxString m_jsonFile,
+             m_csvFile;
+
+    // files to compare if m_compare is true
+    bool m_compare;
+    wxArrayString m_toCompare;
+
+    // minimal change, in percents, considered to be a regression
+    double m_threshold;
+
+    // results of all benchmarks ran so far
+    Results m_results;
 };
 
 wxIMPLEMENT_APP_CONSOLE(BenchApp);
@@ -110,7 +844,10 @@ BenchApp::BenchApp()
 {
     m_numRuns = 0; // this means to use m_runTime
     m_runTime = 500; // default minimum
+    m_warmup = 1;
     m_numParam = 0;
+    m_compare = false;
+    m_threshold = 5;
 }
 
 bool BenchApp::OnInit()
@@ -177,7 +914,40 @@ void BenchApp::OnInitCmdLine(wxCmdLineParser& parser)
                      "(default: empty)",
                      wxCMD_LINE_VAL_STRING);
 
-    parser.AddParam("benchmark name",
+    parser.AddOption(OPTION_WARMUP,
+                     "warmup",
+                     wxString::Format
+                     (
+                         "number of times to run each benchmark before "
+                         "measuring it (default: %ld)",
+                         m_warmup
+                     ),
+                     wxCMD_LINE_VAL_NUMBER);
+
+    parser.AddOption(OPTION_JSON,
+                     "json",
+                     "save the results in JSON format to the given file",
+                     wxCMD_LINE_VAL_STRING);
+    parser.AddOption(OPTION_CSV,
+                     "csv",
+                     "save the results in CSV format to the given file",
+                     wxCMD_LINE_VAL_STRING);
+
+    parser.AddSwitch(OPTION_COMPARE,
+                     "compare",
+                     "compare the results in the two files given as "
+                     "parameters instead of running the benchmarks");
+    parser.AddOption(OPTION_THRESHOLD,
+                     "threshold",
+                     wxString::Format
+                     (
+                         "minimal slowdown in percents reported as regression "
+                         "when comparing (default: %g)",
+                         m_threshold
+                     ),
+                     wxCMD_LINE_VAL_DOUBLE);
+
+    parser.AddParam("benchmark name (or result file with --compare)",
                     wxCMD_LINE_VAL_STRING,
                     wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
 }
@@ -201,10 +971,36 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
         return false;
     }
 
+    if ( parser.Found(OPTION_COMPARE) )
+    {
+        if ( count != 2 )
+        {
+            wxFprintf(stderr, "Exactly two files must be specified to compare.\n");
+
+            return false;
+        }
+
+        m_compare = true;
+        m_toCompare.push_back(parser.GetParam(0));
+        m_toCompare.push_back(parser.GetParam(1));
+
+        if ( parser.Found(OPTION_THRESHOLD, &m_threshold) && m_threshold < 0 )
+        {
+            wxFprintf(stderr, "Threshold must be non-negative.\n");
+
+            return false;
+        }
+
+        return BenchAppBase::OnCmdLineParsed(parser);
+    }
+
     const bool runTimeSpecified = parser.Found(OPTION_RUN_TIME, &m_runTime);
     const bool numRunsSpecified = parser.Found(OPTION_NUM_RUNS, &m_numRuns);
     parser.Found(OPTION_NUMERIC_PARAM, &m_numParam);
     parser.Found(OPTION_STRING_PARAM, &m_strParam);
+    parser.Found(OPTION_JSON, &m_jsonFile);
+    parser.Found(OPTION_CSV, &m_csvFile);
+    const bool warmupSpecified = parser.Found(OPTION_WARMUP, &m_warmup);
     if ( parser.Found(OPTION_SINGLE) )
     {
         if ( runTimeSpecified || numRunsSpecified )
@@ -215,6 +1011,8 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
         }
 
         m_numRuns = 1;
+        if ( !warmupSpecified )
+            m_warmup = 0;
     }
     else if ( numRunsSpecified && !runTimeSpecified )
     {
@@ -248,6 +1046,12 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
 
 int BenchApp::OnRun()
 {
+    if ( m_compare )
+    {
+        return CompareResults(m_toCompare[0], m_toCompare[1]) ? EXIT_SUCCESS
+                                                               : EXIT_FAILURE;
+    }
+
     int rc = EXIT_SUCCESS;
 
     wxString params;
@@ -277,6 +1081,9 @@ int BenchApp::OnRun()
         }
     }
 
+    if ( !SaveResults() )
+        rc = EXIT_FAILURE;
+
     return rc;
 }
 
@@ -288,54 +1095,36 @@ bool BenchApp::RunSingleBenchmark(Bench::Function* func)
     wxPrintf("%-30s", wxString(func->GetName()) + ':');
     fflush(stdout);
 
-    // We use the algorithm for iteratively computing the mean and the
-    // standard deviation of the sequence of values described in Knuth's
-    // "The Art of Computer Programming, Volume 2: Seminumerical
-    // Algorithms", section 4.2.2.
-    //
-    // The algorithm defines the sequences M(k) and S(k) as follows:
-    //
-    //  M(1) = x(1), M(k) = M(k-1) + (x(k) - M(k-1)) / k
-    //  S(1) = 0,    S(k) = S(k-1) + (x(k) - M(k-1))*(x(k) - M(k))
-    //
-    // where x(k) is the k-th value. Then the mean is simply the last value
-    // of the first sequence M(N) and the standard deviation is
-    // sqrt(S(N)/(N-1)).
-
-    wxStopWatch swTotal;
-    if ( !func->Run() )
-        return false;
-
-    double timeMin = DBL_MAX,
-           timeMax = 0;
+    // Warm up the caches and let the benchmark perform any lazy
+    // initialization without taking it into account.
+    for ( long n = 0; n < m_warmup; n++ )
+    {
+        if ( !func->Run() )
+            return false;
+    }
 
-    double m = swTotal.TimeInMicro().ToDouble();
-    double s = 0;
+    Measurements measurements;
 
-    long n = 0;
+    wxStopWatch swTotal;
     for ( ;; )
     {
-        // One termination condition is reaching the maximum number of runs.
-        if ( ++n == m_numRuns )
-            break;
+        // Don't use wxStopWatch here as its resolution is insufficient for
+        // the benchmarks taking less than a microsecond.
+        typedef std::chrono::steady_clock Clock;
 
-        double t;
-        {
-            wxStopWatch swThis;
-            if ( !func->Run() )
-                return false;
+        const double cpuStart = GetCPUTimeInMicro();
+        const Clock::time_point start = Clock::now();
 
-            t = swThis.TimeInMicro().ToDouble();
-        }
+        if ( !func->Run() )
+            return false;
 
-        if ( t < timeMin )
-            timeMin = t;
-        if ( t > timeMax )
-            timeMax = t;
+        const std::chrono::duration<double, std::micro> t = Clock::now() - start;
 
-        const double lastM = m;
-        m += (t - lastM) / n;
-        s += (t - lastM)*(t - m);
+        measurements.Add(t.count(), GetCPUTimeInMicro() - cpuStart);
+
+        // One termination condition is reaching the maximum number of runs.
+        if ( measurements.GetCount() == m_numRuns )
+            break;
 
         // The other termination condition is that we are running for at least
         // m_runTime milliseconds.
@@ -345,25 +1134,138 @@ bool BenchApp::RunSingleBenchmark(Bench::Function* func)
 
     func->Done();
 
+    Result result;
+    result.name = func->GetName();
+    result.wall = measurements.GetWall().GetStats();
+    result.cpu = measurements.GetCPU().GetStats();
+    result.wallSamples = measurements.GetWall().Samples();
+    result.cpuSamples = measurements.GetCPU().Samples();
+
+    const Stats& w = result.wall;
+
     // For a single run there is no standard deviation and min/max don't make
     // much sense.
-    if ( n == 1 )
+    if ( w.runs == 1 )
     {
-        wxPrintf("single run took %.0fus\n", m);
+        wxPrintf("single run took %s (%s CPU)\n",
+                 FormatMicro(w.mean), FormatMicro(result.cpu.mean));
     }
     else
     {
-        s = sqrt(s / (n - 1));
-
         wxPrintf
         (
-            "%12ld runs, %.0fus avg, %.0f std dev (%.0f/%.0f min/max)\n",
-            n, m, s, timeMin, timeMax
+            "%12ld runs, %s avg, %s std dev (%s/%s min/max), "
+            "%s median, %s p95, %s CPU avg\n",
+            w.runs, FormatMicro(w.mean), FormatMicro(w.stddev),
+            FormatMicro(w.min), FormatMicro(w.max),
+            FormatMicro(w.median), FormatMicro(w.p95),
+            FormatMicro(result.cpu.mean)
         );
     }
 
     fflush(stdout);
 
+    m_results.push_back(result);
+
+    return true;
+}
+
+bool BenchApp::SaveResults()
+{
+    bool ok = true;
+
+    if ( !m_jsonFile.empty() && !SaveResultsAsJSON(m_jsonFile, m_results) )
+    {
+        wxFprintf(stderr, "Failed to save results to \"%s\".\n", m_jsonFile);
+        ok = false;
+    }
+
+    if ( !m_csvFile.empty() && !SaveResultsAsCSV(m_csvFile, m_results) )
+    {
+        wxFprintf(stderr, "Failed to save results to \"%s\".\n", m_csvFile);
+        ok = false;
+    }
+
+    return ok;
+}
+
+bool BenchApp::CompareResults(const wxString& oldFile, const wxString& newFile)
+{
+    Results oldResults;
+    if ( !LoadResults(oldFile, oldResults) )
+    {
+        wxFprintf(stderr, "Failed to load results from \"%s\".\n", oldFile);
+        return false;
+    }
+
+    Results newResults;
+    if ( !LoadResults(newFile, newResults) )
+    {
+        wxFprintf(stderr, "Failed to load results from \"%s\".\n", newFile);
+        return false;
+    }
+
+    std::map<wxString, const Result*> oldByName;
+    for ( const Result& r : oldResults )
+        oldByName[r.name] = &r;
+
+    wxPrintf("%-30s %12s %12s %9s %8s\n",
+             "Benchmark", "Old median", "New median", "Change", "p-value");
+
+    int numRegressions = 0;
+    for ( const Result& r : newResults )
+    {
+        const auto it = oldByName.find(r.name);
+        if ( it == oldByName.end() )
+        {
+            wxPrintf("%-30s %12s %12s (new)\n",
+                     r.name, "", FormatMicro(r.wall.median));
+            continue;
+        }
+
+        const Stats& o = it->second->wall;
+        const Stats& n = r.wall;
+
+        // Use the median for computing the change, as it is less sensitive
+        // to the outliers, but the mean for checking whether the difference
+        // is significant, as it's all we can do using just the summary.
+        const double change = o.median > 0 ? (n.median - o.median)*100/o.median
+                                           : 0;
+        const double p = WelchTTest(o, n);
+
+        // Also check that the medians and the means changed in the same
+        // direction, as otherwise the change can't be trusted.
+        const bool significant = p >= 0 && p < SIGNIFICANCE_LEVEL &&
+                                    fabs(change) >= m_threshold &&
+                                    ((change > 0 && n.mean > o.mean) ||
+                                     (change < 0 && n.mean < o.mean));
+
+        const char* verdict = "";
+        if ( significant )
+        {
+            if ( change > 0 )
+            {
+                verdict = "REGRESSION";
+                numRegressions++;
+            }
+            else
+            {
+                verdict = "improvement";
+            }
+        }
+
+        wxPrintf("%-30s %12s %12s %+8.1f%% %8s %s\n",
+                 r.name, FormatMicro(o.median), FormatMicro(n.median), change,
+                 p >= 0 ? wxString::Format("%.3f", p) : wxString("n/a"),
+                 verdict);
+    }
+
+    if ( numRegressions )
+    {
+        wxPrintf("%d significant regression(s) found.\n", numRegressions);
+        return false;
+    }
+
     return true;
 }
 
@@ -0,0 +1,283 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/config.cpp
+// Purpose:     wxFileConfig benchmarks
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/file.h"
+#include "wx/fileconf.h"
+#include "wx/mstream.h"
+#include "wx/sstream.h"
+
+#include "bench.h"
+
+#include <memory>
+
+#if wxUSE_CONFIG && wxUSE_FILECONFIG
+
+namespace
+{
+
+// Return the number of groups in the test file, which can be changed from
+// the command line.
+size_t GetGroupsCount()
+{
+    return Bench::GetNumericParameter(200);
+}
+
+// Number of entries in each group.
+const size_t ENTRIES_PER_GROUP = 20;
+
+wxString GetGroupName(size_t n)
+{
+    // Use nested groups, as most real configuration files do.
+    return wxString::Format("/Settings/Group%lu/Sub%lu",
+                            static_cast<unsigned long>(n / 10),
+                            static_cast<unsigned long>(n));
+}
+
+wxString GetEntryName(size_t n)
+{
+    static const char* const names[] =
+    {
+        "Width", "Height", "X", "Y", "Maximized", "Path", "LastFile",
+        "Font", "Colour", "Columns"
+    };
+
+    return wxString::Format("%s%lu",
+                            names[n % WXSIZEOF(names)],
+                            static_cast<unsigned long>(n));
+}
+
+// Return the contents of a typical configuration file.
+const wxString& GetConfigText()
+{
+    static wxString s_text;
+    if ( s_text.empty() )
+    {
+        s_text = "; Configuration file used for benchmarking\n"
+                 "Version=3\n";
+
+        for ( size_t g = 0; g < GetGroupsCount(); g++ )
+        {
+            s_text << "\n[" << GetGroupName(g).Mid(1) << "]\n";
+
+            for ( size_t n = 0; n < ENTRIES_PER_GROUP; n++ )
+            {
+                s_text << GetEntryName(n) << "=";
+                if ( n % 3 == 0 )
+                    s_text << g*n;
+                else
+                    s_text << "C:\\\\Users\\\\Somebody\\\\file " << g << ".txt";
+                s_text << "\n";
+            }
+        }
+    }
+
+    return s_text;
+}
+
+// Return the name of the n-th entry of a group with many entries, in a
+// pseudo-random order to avoid only testing the best case.
+wxString GetFlatEntryName(size_t n)
+{
+    return wxString::Format("Key%08lx",
+                            static_cast<unsigned long>((n * 2654435761u) % 4294967291u));
+}
+
+size_t GetFlatEntriesCount()
+{
+    return GetGroupsCount()*ENTRIES_PER_GROUP;
+}
+
+// Return the contents of a file with a single group with many entries, as
+// produced by importing a lot of keys.
+const wxString& GetFlatConfigText()
+{
+    static wxString s_text;
+    if ( s_text.empty() )
+    {
+        s_text = "[Keys]\n";
+        for ( size_t n = 0; n < GetFlatEntriesCount(); n++ )
+            s_text << GetFlatEntryName(n) << "=" << n << "\n";
+    }
+
+    return s_text;
+}
+
+wxFileConfig& GetFlatConfig()
+{
+    static std::unique_ptr<wxFileConfig> s_config;
+    if ( !s_config )
+    {
+        wxStringInputStream sis(GetFlatConfigText());
+        s_config.reset(new wxFileConfig(sis));
+    }
+
+    return *s_config;
+}
+
+wxFileConfig* CreateConfig()
+{
+    wxStringInputStream sis(GetConfigText());
+    return new wxFileConfig(sis);
+}
+
+wxFileConfig& GetConfig()
+{
+    static std::unique_ptr<wxFileConfig> s_config(CreateConfig());
+    return *s_config;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(FileConfigLoad)
+{
+    std::unique_ptr<wxFileConfig> config(CreateConfig());
+
+    return config->GetNumberOfGroups() == 1;
+}
+
+BENCHMARK_FUNC(FileConfigLoadFile)
+{
+    // Temporary file with the test configuration removed when the program
+    // exits.
+    class ConfigFile
+    {
+    public:
+        ConfigFile()
+            : m_path(wxFileName::CreateTempFileName("wxbench"))
+        {
+            wxFile file(m_path, wxFile::write);
+            file.Write(GetConfigText());
+        }
+
+        ~ConfigFile() { wxRemoveFile(m_path); }
+
+        const wxString m_path;
+    };
+
+    static ConfigFile s_file;
+
+    wxFileConfig config(wxString(), wxString(), s_file.m_path, wxString(),
+                        wxCONFIG_USE_LOCAL_FILE);
+
+    return config.GetNumberOfGroups() == 1;
+}
+
+BENCHMARK_FUNC(FileConfigRead)
+{
+    wxFileConfig& config = GetConfig();
+
+    long total = 0;
+    for ( size_t g = 0; g < GetGroupsCount(); g++ )
+    {
+        const wxString group = GetGroupName(g) + "/";
+        for ( size_t n = 0; n < ENTRIES_PER_GROUP; n += 3 )
+            total += config.ReadLong(group + GetEntryName(n), 0);
+    }
+
+    return total != 0;
+}
+
+BENCHMARK_FUNC(FileConfigReadSetPath)
+{
+    wxFileConfig& config = GetConfig();
+
+    long total = 0;
+    for ( size_t g = 0; g < GetGroupsCount(); g++ )
+    {
+        config.SetPath(GetGroupName(g));
+        for ( size_t n = 0; n < ENTRIES_PER_GROUP; n += 3 )
+            total += config.ReadLong(GetEntryName(n), 0);
+    }
+
+    config.SetPath("/");
+
+    return total != 0;
+}
+
+BENCHMARK_FUNC(FileConfigEnumerate)
+{
+    wxFileConfig& config = GetConfig();
+
+    size_t count = 0;
+    for ( size_t g = 0; g < GetGroupsCount(); g++ )
+    {
+        config.SetPath(GetGroupName(g));
+
+        wxString name;
+        long cookie;
+        for ( bool cont = config.GetFirstEntry(name, cookie);
+              cont;
+              cont = config.GetNextEntry(name, cookie) )
+        {
+            count++;
+        }
+    }
+
+    config.SetPath("/");
+
+    return count == GetGroupsCount()*ENTRIES_PER_GROUP;
+}
+
+BENCHMARK_FUNC(FileConfigWrite)
+{
+    wxStringInputStream sis("");
+    wxFileConfig config(sis);
+
+    for ( size_t g = 0; g < GetGroupsCount(); g++ )
+    {
+        const wxString group = GetGroupName(g) + "/";
+        for ( size_t n = 0; n < ENTRIES_PER_GROUP; n++ )
+            config.Write(group + GetEntryName(n), static_cast<long>(g*n));
+    }
+
+    return config.GetNumberOfGroups() == 1;
+}
+
+BENCHMARK_FUNC(FileConfigLoadFlat)
+{
+    wxStringInputStream sis(GetFlatConfigText());
+    wxFileConfig config(sis);
+
+    return config.GetNumberOfEntries(true) == GetFlatEntriesCount();
+}
+
+BENCHMARK_FUNC(FileConfigReadFlat)
+{
+    wxFileConfig& config = GetFlatConfig();
+    config.SetPath("/Keys");
+
+    long total = 0;
+    for ( size_t n = 0; n < GetFlatEntriesCount(); n++ )
+        total += config.ReadLong(GetFlatEntryName(n), 0);
+
+    config.SetPath("/");
+
+    return total != 0;
+}
+
+BENCHMARK_FUNC(FileConfigWriteFlat)
+{
+    wxStringInputStream sis("");
+    wxFileConfig config(sis);
+    config.SetPath("/Keys");
+
+    for ( size_t n = 0; n < GetFlatEntriesCount(); n++ )
+        config.Write(GetFlatEntryName(n), static_cast<long>(n));
+
+    return config.GetNumberOfEntries() == GetFlatEntriesCount();
+}
+
+BENCHMARK_FUNC(FileConfigSave)
+{
+    wxMemoryOutputStream mos;
+
+    return GetConfig().Save(mos) && mos.GetLength() != 0;
+}
+
+#endif // wxUSE_CONFIG && wxUSE_FILECONFIG
@@ -0,0 +1,231 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/containers.cpp
+// Purpose:     Benchmarks for wxHashMap, wxArrayString and wxVector
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/arrstr.h"
+#include "wx/hashmap.h"
+#include "wx/string.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+WX_DECLARE_STRING_HASH_MAP(int, BenchStringHashMap);
+
+namespace
+{
+
+// Return the number of elements to use, which can be changed from the
+// command line.
+size_t GetCount()
+{
+    return Bench::GetNumericParameter(10000);
+}
+
+// Return the keys looking like typical identifiers, e.g. config entry or
+// control names, in pseudo-random order.
+const wxArrayString& GetKeys()
+{
+    static wxArrayString s_keys;
+    if ( s_keys.empty() )
+    {
+        static const char* const words[] =
+        {
+            "button", "window", "frame", "panel", "text", "label", "value",
+            "size", "position", "colour", "font", "style", "name", "title",
+        };
+
+        const size_t count = GetCount();
+        s_keys.reserve(count);
+
+        // Use a simple LCG to get the same sequence on all platforms.
+        unsigned seed = 1234567;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            seed = seed*1103515245 + 12345;
+
+            s_keys.push_back(wxString::Format
+                             (
+                                "%s_%s_%lu",
+                                words[(seed >> 16) % WXSIZEOF(words)],
+                                words[(seed >> 8) % WXSIZEOF(words)],
+                                static_cast<unsigned long>(n)
+                             ));
+        }
+    }
+
+    return s_keys;
+}
+
+const BenchStringHashMap& GetHashMap()
+{
+    static BenchStringHashMap s_map;
+    if ( s_map.empty() )
+    {
+        const wxArrayString& keys = GetKeys();
+        for ( size_t n = 0; n < keys.size(); n++ )
+            s_map[keys[n]] = n;
+    }
+
+    return s_map;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxHashMap
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(HashMapInsert)
+{
+    const wxArrayString& keys = GetKeys();
+
+    BenchStringHashMap map;
+    for ( size_t n = 0; n < keys.size(); n++ )
+        map[keys[n]] = n;
+
+    return map.size() == keys.size();
+}
+
+BENCHMARK_FUNC(HashMapFind)
+{
+    const wxArrayString& keys = GetKeys();
+    const BenchStringHashMap& map = GetHashMap();
+
+    size_t found = 0;
+    for ( size_t n = 0; n < keys.size(); n++ )
+    {
+        if ( map.find(keys[n]) != map.end() )
+            found++;
+    }
+
+    return found == keys.size();
+}
+
+BENCHMARK_FUNC(HashMapIterate)
+{
+    const BenchStringHashMap& map = GetHashMap();
+
+    size_t sum = 0;
+    for ( BenchStringHashMap::const_iterator it = map.begin();
+          it != map.end();
+          ++it )
+    {
+        sum += it->second;
+    }
+
+    return sum != 0;
+}
+
+// ----------------------------------------------------------------------------
+// wxArrayString
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(ArrayStringAdd)
+{
+    const wxArrayString& keys = GetKeys();
+
+    wxArrayString a;
+    for ( size_t n = 0; n < keys.size(); n++ )
+        a.Add(keys[n]);
+
+    return a.size() == keys.size();
+}
+
+BENCHMARK_FUNC(ArrayStringSort)
+{
+    wxArrayString a(GetKeys());
+    a.Sort();
+
+    return a[0] < a[1];
+}
+
+BENCHMARK_FUNC(ArrayStringIndex)
+{
+    const wxArrayString& keys = GetKeys();
+
+    // Linear search is slow, so look up only some of the strings.
+    size_t found = 0;
+    for ( size_t n = 0; n < keys.size(); n += keys.size() / 16 + 1 )
+    {
+        if ( keys.Index(keys[n]) == static_cast<int>(n) )
+            found++;
+    }
+
+    return found != 0;
+}
+
+BENCHMARK_FUNC(SortedArrayStringAdd)
+{
+    const wxArrayString& keys = GetKeys();
+
+    wxSortedArrayString a;
+    for ( size_t n = 0; n < keys.size(); n++ )
+        a.Add(keys[n]);
+
+    return a.size() == keys.size();
+}
+
+BENCHMARK_FUNC(SortedArrayStringIndex)
+{
+    static wxSortedArrayString s_sorted;
+    const wxArrayString& keys = GetKeys();
+    if ( s_sorted.empty() )
+    {
+        for ( size_t n = 0; n < keys.size(); n++ )
+            s_sorted.Add(keys[n]);
+    }
+
+    size_t found = 0;
+    for ( size_t n = 0; n < keys.size(); n++ )
+    {
+        if ( s_sorted.Index(keys[n]) != wxNOT_FOUND )
+            found++;
+    }
+
+    return found == keys.size();
+}
+
+// ----------------------------------------------------------------------------
+// wxVector
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(VectorIntPushBack)
+{
+    const size_t count = GetCount();
+
+    wxVector<int> v;
+    for ( size_t n = 0; n < count; n++ )
+        v.push_back(static_cast<int>(n));
+
+    return v.size() == count;
+}
+
+BENCHMARK_FUNC(VectorStringPushBack)
+{
+    const wxArrayString& keys = GetKeys();
+
+    wxVector<wxString> v;
+    for ( size_t n = 0; n < keys.size(); n++ )
+        v.push_back(keys[n]);
+
+    return v.size() == keys.size();
+}
+
+BENCHMARK_FUNC(VectorStringInsertFront)
+{
+    const wxArrayString& keys = GetKeys();
+
+    // Inserting at the front is quadratic, so use fewer elements.
+    const size_t count = keys.size() / 10;
+
+    wxVector<wxString> v;
+    for ( size_t n = 0; n < count; n++ )
+        v.insert(v.begin(), keys[n]);
+
+    return v.size() == count;
+}
@@ -0,0 +1,223 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Event posting and dispatching benchmarks
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/event.h"
+#include "wx/thread.h"
+#include "wx/utils.h"
+
+#include "bench.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Dispatching events to the handlers bound using Bind()
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Event type used for the commands, which are bound to many different ids.
+wxDEFINE_EVENT(wxEVT_BENCH_COMMAND, wxThreadEvent);
+
+// Another event type, which is only used to have bindings for the events not
+// sent by the benchmark, as there are typically many of them too.
+wxDEFINE_EVENT(wxEVT_BENCH_OTHER, wxThreadEvent);
+
+// Event handler with many handlers bound to it, as a typical top level frame
+// has for all its menu and toolbar commands.
+class BindingsHandler : public wxEvtHandler
+{
+public:
+    explicit BindingsHandler(int numBindings)
+        : m_numCommands(wxMax(numBindings - 1, 1))
+    {
+        // Idle event handlers are typically bound first, when creating the
+        // frame, so they end up being the last ones in the list.
+        Bind(wxEVT_IDLE, &BindingsHandler::OnIdle, this);
+
+        for ( int n = 1; n < numBindings; n++ )
+        {
+            if ( n % 4 )
+                Bind(wxEVT_BENCH_COMMAND, &BindingsHandler::OnCommand, this, n);
+            else
+                Bind(wxEVT_BENCH_OTHER, &BindingsHandler::OnCommand, this, n);
+        }
+    }
+
+    // Dispatch the given number of idle and command events and return true
+    // if they were all handled.
+    bool Dispatch(int numEvents)
+    {
+        m_handled = 0;
+
+        for ( int n = 0; n < numEvents; n++ )
+        {
+            wxIdleEvent idle;
+            ProcessEventLocally(idle);
+
+            // Use only the ids of the command events, i.e. not multiples of 4.
+            int id = 1 + (n*7) % m_numCommands;
+            if ( id % 4 == 0 )
+                id--;
+
+            wxThreadEvent command(wxEVT_BENCH_COMMAND, id);
+            ProcessEventLocally(command);
+        }
+
+        return m_handled == 2*numEvents;
+    }
+
+private:
+    void OnIdle(wxIdleEvent&) { m_handled++; }
+    void OnCommand(wxThreadEvent&) { m_handled++; }
+
+    const int m_numCommands;
+    int m_handled = 0;
+};
+
+bool DispatchEvents(int numBindings)
+{
+    static std::map<int, std::unique_ptr<BindingsHandler>> s_handlers;
+
+    std::unique_ptr<BindingsHandler>& handler = s_handlers[numBindings];
+    if ( !handler )
+        handler.reset(new BindingsHandler(numBindings));
+
+    return handler->Dispatch(1000);
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(DispatchEvent10Bindings)
+{
+    return DispatchEvents(10);
+}
+
+BENCHMARK_FUNC(DispatchEvent100Bindings)
+{
+    return DispatchEvents(100);
+}
+
+BENCHMARK_FUNC(DispatchEvent1000Bindings)
+{
+    return DispatchEvents(1000);
+}
+
+BENCHMARK_FUNC(DispatchEvent10000Bindings)
+{
+    return DispatchEvents(10000);
+}
+
+// ----------------------------------------------------------------------------
+// Posting events from multiple threads
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Number of events posted by each thread.
+const int EVENTS_PER_THREAD = 10000;
+
+// Thread posting events to the given handler, as worker threads typically do
+// to notify the main thread about their progress. Each thread uses its own
+// event id, so that coalescing only replaces the events from the same thread.
+class EventPosterThread : public wxThread
+{
+public:
+    EventPosterThread(wxEvtHandler& handler, int id, bool replace)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_id(id),
+          m_replace(replace)
+    {
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        for ( int n = 0; n < EVENTS_PER_THREAD; n++ )
+        {
+            wxThreadEvent* const event = new wxThreadEvent(wxEVT_THREAD, m_id);
+            event->SetInt(n);
+
+            if ( m_replace )
+                m_handler.QueueOrReplaceEvent(event);
+            else
+                m_handler.QueueEvent(event);
+        }
+
+        return nullptr;
+    }
+
+private:
+    wxEvtHandler& m_handler;
+    const int m_id;
+    const bool m_replace;
+};
+
+// Post events from the given number of threads to a single handler while
+// processing them in the main thread, replacing the pending events from the
+// same thread if requested.
+bool PostFromThreads(int numThreads, bool replace = false)
+{
+    int received = 0;
+    int finished = 0;
+
+    wxEvtHandler handler;
+    handler.Bind(wxEVT_THREAD, [&](wxThreadEvent& event)
+        {
+            received++;
+
+            // The last event of each thread is never replaced.
+            if ( event.GetInt() == EVENTS_PER_THREAD - 1 )
+                finished++;
+        });
+
+    std::vector<std::unique_ptr<EventPosterThread>> threads;
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        threads.emplace_back(new EventPosterThread(handler, n, replace));
+        if ( threads.back()->Run() != wxTHREAD_NO_ERROR )
+            return false;
+    }
+
+    while ( finished < numThreads )
+        wxTheApp->ProcessPendingEvents();
+
+    for ( const auto& thread : threads )
+        thread->Wait();
+
+    return replace ? received <= numThreads*EVENTS_PER_THREAD
+                   : received == numThreads*EVENTS_PER_THREAD;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(QueueEventSingleThread)
+{
+    return PostFromThreads(1);
+}
+
+BENCHMARK_FUNC(QueueEventMultipleThreads)
+{
+    // Use 8 threads by default, as this is a typical number of workers.
+    return PostFromThreads(Bench::GetNumericParameter(8));
+}
+
+BENCHMARK_FUNC(QueueOrReplaceEventMultipleThreads)
+{
+    return PostFromThreads(Bench::GetNumericParameter(8), true);
+}
+
+#endif // wxUSE_THREADS
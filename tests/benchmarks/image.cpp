@@ -8,6 +8,8 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "wx/image.h"
+#include "wx/imagebatch.h"
+#include "wx/sysopt.h"
 
 #include "bench.h"
 
@@ -58,6 +60,71 @@ BENCHMARK_FUNC(LoadTIFF)
 }
 #endif // wxUSE_LIBTIFF
 
+// Load the thumbnail of the central part of the given image, this should be
+// much faster than loading the entire image for the handlers supporting it.
+static bool LoadThumbnail(const char* file)
+{
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_REGION_X, 50);
+    image.SetOption(wxIMAGE_OPTION_REGION_Y, 50);
+    image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, 100);
+    image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, 100);
+    image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 32);
+    return image.LoadFile(Bench::GetStringParameter(file));
+}
+
+BENCHMARK_FUNC(LoadJPEGThumbnail)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+
+    return LoadThumbnail("horse.jpg");
+}
+
+BENCHMARK_FUNC(LoadPNGThumbnail)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+        wxImage::AddHandler(new wxPNGHandler);
+
+    return LoadThumbnail("horse.png");
+}
+
+#if wxUSE_LIBTIFF
+BENCHMARK_FUNC(LoadTIFFThumbnail)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_TIFF) )
+        wxImage::AddHandler(new wxTIFFHandler);
+
+    return LoadThumbnail("horse.tif");
+}
+#endif // wxUSE_LIBTIFF
+
+// Load many copies of the same JPEG image using the given number of threads.
+static bool LoadBatch(int maxThreads)
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+
+    const wxString file = Bench::GetStringParameter("horse.jpg");
+
+    wxImageBatchLoader loader;
+    loader.SetMaxThreads(maxThreads);
+    for ( int n = 0; n < 16; n++ )
+        loader.AddFile(file, wxBITMAP_TYPE_JPEG);
+
+    return loader.Load();
+}
+
+BENCHMARK_FUNC(LoadBatchSerial)
+{
+    return LoadBatch(1);
+}
+
+BENCHMARK_FUNC(LoadBatchParallel)
+{
+    return LoadBatch(0);
+}
+
 static const wxImage& GetTestImage()
 {
     static wxImage s_image;
@@ -118,3 +185,323 @@ BENCHMARK_FUNC(ShrinkHighQuality)
     return image.Scale(factor*image.GetWidth(), factor*image.GetHeight(),
                        wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+BENCHMARK_FUNC(Blur)
+{
+    return GetTestImage().Blur(Bench::GetNumericParameter(10)).IsOk();
+}
+
+BENCHMARK_FUNC(GaussianBlur)
+{
+    return GetTestImage().GaussianBlur(Bench::GetNumericParameter(10)).IsOk();
+}
+
+// Return the test image with alpha channel stored in RGBA format.
+static wxImage& GetTestImageRGBA()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+    {
+        s_image = GetTestImage().Copy();
+        if ( s_image.IsOk() && !s_image.HasAlpha() )
+            s_image.InitAlpha();
+    }
+
+    return s_image;
+}
+
+// Get RGBA data of the image stored in RGBA format: this is what the code
+// converting wxImage to the native bitmaps (e.g. GdkPixbuf) does.
+BENCHMARK_FUNC(GetDataRGBA)
+{
+    wxImage& image = GetTestImageRGBA();
+    return image.GetDataRGBA() != nullptr;
+}
+
+// Same as above, but alternate with accessing RGB data, so that the image is
+// converted each time.
+BENCHMARK_FUNC(GetDataRGBAConvert)
+{
+    wxImage& image = GetTestImageRGBA();
+    return image.GetData() != nullptr && image.GetDataRGBA() != nullptr;
+}
+
+// Resampling functions use SIMD instructions by default if available, but this
+// can be disabled by setting "image.no-simd" option, which is used by the
+// benchmarks below to compare the vectorized and scalar implementations.
+class ScalarResampleSetter
+{
+public:
+    explicit ScalarResampleSetter(bool scalar)
+    {
+        wxSystemOptions::SetOption("image.no-simd", scalar);
+    }
+
+    ~ScalarResampleSetter()
+    {
+        wxSystemOptions::SetOption("image.no-simd", 0);
+    }
+};
+
+enum ResampleMethod
+{
+    Resample_Box,
+    Resample_Bilinear,
+    Resample_Bicubic
+};
+
+static wxImage
+DoResample(const wxImage& image, ResampleMethod method, bool scalar)
+{
+    ScalarResampleSetter setScalar(scalar);
+
+    const double factor = Bench::GetNumericParameter(method == Resample_Box
+                                                        ? 50 : 150) / 100.;
+    const int width = factor*image.GetWidth();
+    const int height = factor*image.GetHeight();
+
+    switch ( method )
+    {
+        case Resample_Box:
+            return image.ResampleBox(width, height);
+
+        case Resample_Bilinear:
+            return image.ResampleBilinear(width, height);
+
+        case Resample_Bicubic:
+            return image.ResampleBicubic(width, height);
+    }
+
+    return wxImage();
+}
+
+BENCHMARK_FUNC(ResampleBox)
+{
+    return DoResample(GetTestImage(), Resample_Box, false).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBoxScalar)
+{
+    return DoResample(GetTestImage(), Resample_Box, true).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBilinear)
+{
+    return DoResample(GetTestImage(), Resample_Bilinear, false).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBilinearScalar)
+{
+    return DoResample(GetTestImage(), Resample_Bilinear, true).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBicubic)
+{
+    return DoResample(GetTestImage(), Resample_Bicubic, false).IsOk();
+}
+
+BENCHMARK_FUNC(ResampleBicubicScalar)
+{
+    return DoResample(GetTestImage(), Resample_Bicubic, true).IsOk();
+}
+
+// This is not really a benchmark but a check that the vectorized and scalar
+// versions of the resampling functions produce the same results (which is
+// guaranteed for x86 but might be not the case for ARM, where the results may
+// differ by 1 due to the use of FMA instructions).
+BENCHMARK_FUNC(ResampleCompareScalar)
+{
+    wxImage image = GetTestImage();
+
+    for ( int withAlpha = 0; withAlpha < 2; withAlpha++ )
+    {
+        if ( withAlpha && !image.HasAlpha() )
+            image.InitAlpha();
+
+        const size_t numPixels = image.GetWidth()*image.GetHeight();
+        if ( withAlpha )
+        {
+            // Use some non-trivial alpha values.
+            unsigned char* const alpha = image.GetAlpha();
+            for ( size_t n = 0; n < numPixels; n++ )
+                alpha[n] = static_cast<unsigned char>(n*7);
+        }
+
+        for ( int method = Resample_Box; method <= Resample_Bicubic; method++ )
+        {
+            const ResampleMethod m = static_cast<ResampleMethod>(method);
+            const wxImage vec = DoResample(image, m, false);
+            const wxImage sca = DoResample(image, m, true);
+
+            const size_t numResult = vec.GetWidth()*vec.GetHeight();
+            if ( memcmp(vec.GetData(), sca.GetData(), 3*numResult) != 0 )
+                return false;
+
+            if ( vec.HasAlpha() != sca.HasAlpha() )
+                return false;
+
+            if ( vec.HasAlpha() &&
+                    memcmp(vec.GetAlpha(), sca.GetAlpha(), numResult) != 0 )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Image transformations are performed in the calling thread only by default,
+// but can use multiple threads if wxImage::SetMaxThreads() is called, which is
+// done by the benchmarks below to compare the serial and parallel versions.
+class MaxThreadsSetter
+{
+public:
+    explicit MaxThreadsSetter(int threads)
+        : m_threadsOld(wxImage::GetMaxThreads())
+    {
+        wxImage::SetMaxThreads(threads);
+    }
+
+    ~MaxThreadsSetter()
+    {
+        wxImage::SetMaxThreads(m_threadsOld);
+    }
+
+private:
+    const int m_threadsOld;
+};
+
+enum TransformOp
+{
+    Transform_Shrink,
+    Transform_Enlarge,
+    Transform_Blur,
+    Transform_Rotate,
+    Transform_Greyscale,
+    Transform_HSV
+};
+
+// Use 0 for threads to use as many threads as there are CPUs.
+static wxImage
+DoTransform(const wxImage& image, TransformOp op, int threads)
+{
+    MaxThreadsSetter setThreads(threads);
+
+    switch ( op )
+    {
+        case Transform_Shrink:
+            return image.Scale(image.GetWidth()/2, image.GetHeight()/2,
+                               wxIMAGE_QUALITY_BOX_AVERAGE);
+
+        case Transform_Enlarge:
+            return image.Scale(3*image.GetWidth()/2, 3*image.GetHeight()/2,
+                               wxIMAGE_QUALITY_BICUBIC);
+
+        case Transform_Blur:
+            return image.Blur(Bench::GetNumericParameter(10));
+
+        case Transform_Rotate:
+            return image.Rotate(0.5, wxPoint(image.GetWidth()/2,
+                                             image.GetHeight()/2));
+
+        case Transform_Greyscale:
+            return image.ConvertToGreyscale();
+
+        case Transform_HSV:
+            {
+                wxImage result = image.Copy();
+                result.ChangeHSV(0.25, -0.5, 0.1);
+                return result;
+            }
+    }
+
+    return wxImage();
+}
+
+BENCHMARK_FUNC(ShrinkSerial)
+{
+    return DoTransform(GetTestImage(), Transform_Shrink, 1).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkParallel)
+{
+    return DoTransform(GetTestImage(), Transform_Shrink, 0).IsOk();
+}
+
+BENCHMARK_FUNC(EnlargeSerial)
+{
+    return DoTransform(GetTestImage(), Transform_Enlarge, 1).IsOk();
+}
+
+BENCHMARK_FUNC(EnlargeParallel)
+{
+    return DoTransform(GetTestImage(), Transform_Enlarge, 0).IsOk();
+}
+
+BENCHMARK_FUNC(BlurSerial)
+{
+    return DoTransform(GetTestImage(), Transform_Blur, 1).IsOk();
+}
+
+BENCHMARK_FUNC(BlurParallel)
+{
+    return DoTransform(GetTestImage(), Transform_Blur, 0).IsOk();
+}
+
+BENCHMARK_FUNC(RotateSerial)
+{
+    return DoTransform(GetTestImage(), Transform_Rotate, 1).IsOk();
+}
+
+BENCHMARK_FUNC(RotateParallel)
+{
+    return DoTransform(GetTestImage(), Transform_Rotate, 0).IsOk();
+}
+
+BENCHMARK_FUNC(GreyscaleSerial)
+{
+    return DoTransform(GetTestImage(), Transform_Greyscale, 1).IsOk();
+}
+
+BENCHMARK_FUNC(GreyscaleParallel)
+{
+    return DoTransform(GetTestImage(), Transform_Greyscale, 0).IsOk();
+}
+
+BENCHMARK_FUNC(ChangeHSVSerial)
+{
+    return DoTransform(GetTestImage(), Transform_HSV, 1).IsOk();
+}
+
+BENCHMARK_FUNC(ChangeHSVParallel)
+{
+    return DoTransform(GetTestImage(), Transform_HSV, 0).IsOk();
+}
+
+// Check that using multiple threads doesn't change the results.
+BENCHMARK_FUNC(TransformCompareParallel)
+{
+    const wxImage& image = GetTestImage();
+
+    for ( int op = Transform_Shrink; op <= Transform_HSV; op++ )
+    {
+        const TransformOp t = static_cast<TransformOp>(op);
+        const wxImage ser = DoTransform(image, t, 1);
+        const wxImage par = DoTransform(image, t, 0);
+
+        if ( par.GetSize() != ser.GetSize() )
+            return false;
+
+        const size_t numResult = ser.GetWidth()*ser.GetHeight();
+        if ( memcmp(ser.GetData(), par.GetData(), 3*numResult) != 0 )
+            return false;
+
+        if ( ser.HasAlpha() != par.HasAlpha() )
+            return false;
+
+        if ( ser.HasAlpha() &&
+                memcmp(ser.GetAlpha(), par.GetAlpha(), numResult) != 0 )
+            return false;
+    }
+
+    return true;
+}
@@ -106,3 +106,21 @@ BENCHMARK_FUNC(LogTraceInactive)
 
     return true;
 }
+
+// This must be the last benchmark in this file as it changes wxLOG_COMPONENT.
+#undef wxLOG_COMPONENT
+#define wxLOG_COMPONENT "bench/disabled/sub"
+
+BENCHMARK_FUNC(LogComponentDisabled)
+{
+    static bool s_set = false;
+    if ( !s_set )
+    {
+        s_set = true;
+        wxLog::SetComponentLevel("bench/disabled", wxLOG_Warning);
+    }
+
+    wxLogMessage("Ignored message: %s", NotCreated().AsStr());
+
+    return true;
+}
@@ -42,6 +42,74 @@ bool ConvertToMB(const wxMBConv& conv)
     return conv.FromWChar(buf.data(), outlen, TEST_STRING) == outlen;
 }
 
+// Return the long UTF-8 text consisting of the copies of the test string,
+// with some non-ASCII characters in it if requested.
+const wxCharBuffer& GetUTF8Text(bool ascii)
+{
+    static wxCharBuffer s_texts[2];
+
+    wxCharBuffer& text = s_texts[ascii];
+    if ( !text.length() )
+    {
+        wxString s;
+        for ( int n = 0; n < 100; n++ )
+        {
+            s += TEST_STRING;
+            if ( !ascii )
+                s += L" \u00e9t\u00e9 \u0432\u0435\u0441\u043d\u0430 \u20ac";
+        }
+
+        text = s.utf8_str();
+    }
+
+    return text;
+}
+
+const wxWCharBuffer& GetWideText(bool ascii)
+{
+    static wxWCharBuffer s_texts[2];
+
+    wxWCharBuffer& text = s_texts[ascii];
+    if ( !text.length() )
+        text = wxConvUTF8.cMB2WC(GetUTF8Text(ascii));
+
+    return text;
+}
+
+bool ConvertUTF8ToWC(const wxMBConv& conv, bool ascii)
+{
+    const wxCharBuffer& text = GetUTF8Text(ascii);
+    const size_t len = GetWideText(ascii).length();
+
+    wxWCharBuffer buf(len);
+    return conv.ToWChar(buf.data(), len, text, text.length()) == len;
+}
+
+bool ConvertWCToUTF8(bool ascii)
+{
+    const wxWCharBuffer& text = GetWideText(ascii);
+    const size_t len = GetUTF8Text(ascii).length();
+
+    wxCharBuffer buf(len);
+    return wxConvUTF8.FromWChar(buf.data(), len, text, text.length()) == len;
+}
+
+bool CreateStringFromUTF8(bool ascii)
+{
+    const wxCharBuffer& text = GetUTF8Text(ascii);
+
+    const wxString s(text.data(), wxConvUTF8);
+    return s.length() == GetWideText(ascii).length();
+}
+
+bool ConvertStringToUTF8(bool ascii)
+{
+    // Use a new string every time as the result of the conversion is cached
+    // in it.
+    const wxString s(GetWideText(ascii));
+    return s.utf8_str().length() == GetUTF8Text(ascii).length();
+}
+
 } // anonymous namespace
 
 BENCHMARK_FUNC(UTF16InitWX)
@@ -76,3 +144,67 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+BENCHMARK_FUNC(UTF8ToWCharASCII)
+{
+    return ConvertUTF8ToWC(wxConvUTF8, true);
+}
+
+BENCHMARK_FUNC(UTF8ToWCharMixed)
+{
+    return ConvertUTF8ToWC(wxConvUTF8, false);
+}
+
+BENCHMARK_FUNC(UTF8ToWCharPUAASCII)
+{
+    return ConvertUTF8ToWC(wxMBConvUTF8(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA),
+                           true);
+}
+
+BENCHMARK_FUNC(UTF8ToWCharPUAMixed)
+{
+    return ConvertUTF8ToWC(wxMBConvUTF8(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA),
+                           false);
+}
+
+BENCHMARK_FUNC(UTF8FromWCharASCII)
+{
+    return ConvertWCToUTF8(true);
+}
+
+BENCHMARK_FUNC(UTF8FromWCharMixed)
+{
+    return ConvertWCToUTF8(false);
+}
+
+BENCHMARK_FUNC(UTF8StringCtorASCII)
+{
+    return CreateStringFromUTF8(true);
+}
+
+BENCHMARK_FUNC(UTF8StringCtorMixed)
+{
+    return CreateStringFromUTF8(false);
+}
+
+BENCHMARK_FUNC(UTF8StringToUTF8ASCII)
+{
+    return ConvertStringToUTF8(true);
+}
+
+BENCHMARK_FUNC(UTF8StringToUTF8Mixed)
+{
+    return ConvertStringToUTF8(false);
+}
+
+BENCHMARK_FUNC(UTF8cMB2WC)
+{
+    return wxConvUTF8.cMB2WC(GetUTF8Text(false)).length() ==
+                GetWideText(false).length();
+}
+
+BENCHMARK_FUNC(UTF8cWC2MB)
+{
+    return wxConvUTF8.cWC2MB(GetWideText(false)).length() ==
+                GetUTF8Text(false).length();
+}
@@ -0,0 +1,210 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/streams.cpp
+// Purpose:     Benchmarks for memory and zlib streams
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/mstream.h"
+#include "wx/thread.h"
+#include "wx/txtstrm.h"
+#include "wx/utils.h"
+#include "wx/zstream.h"
+
+#include "bench.h"
+
+#include <vector>
+
+namespace
+{
+
+// Return the data used by all benchmarks in this file: this is a mix of text
+// and binary data that compresses reasonably well, similar to the typical
+// resource files. Its size in KiB can be changed from the command line.
+const std::vector<char>& GetTestData()
+{
+    static std::vector<char> s_data;
+    if ( s_data.empty() )
+    {
+        const size_t size = Bench::GetNumericParameter(1024) * 1024;
+        s_data.reserve(size);
+
+        unsigned seed = 42;
+        while ( s_data.size() < size )
+        {
+            seed = seed*1103515245 + 12345;
+
+            char line[80];
+            const int len = snprintf
+                            (
+                                line, sizeof(line),
+                                "<object name=\"item%u\" size=\"%u,%u\"/>\n",
+                                seed % 1000, (seed >> 10) % 100,
+                                (seed >> 20) % 100
+                            );
+            s_data.insert(s_data.end(), line, line + len);
+
+            // Add some less compressible binary data too.
+            for ( int n = 0; n < 16; n++ )
+                s_data.push_back(static_cast<char>(seed >> (n % 24)));
+        }
+
+        s_data.resize(size);
+    }
+
+    return s_data;
+}
+
+#if wxUSE_ZLIB
+
+// Compress the data using the given number of threads if it is non-zero.
+std::vector<char> Compress(const std::vector<char>& data,
+                           int flags,
+                           unsigned numThreads = 0)
+{
+    wxMemoryOutputStream mos;
+    {
+        wxZlibOutputStream zos(mos, wxZ_DEFAULT_COMPRESSION, flags);
+        if ( numThreads )
+            zos.EnableParallel(numThreads);
+        zos.Write(data.data(), data.size());
+    }
+
+    std::vector<char> compressed(mos.GetLength());
+    mos.CopyTo(compressed.data(), compressed.size());
+
+    return compressed;
+}
+
+const std::vector<char>& GetCompressedData()
+{
+    static std::vector<char> s_data;
+    if ( s_data.empty() )
+        s_data = Compress(GetTestData(), wxZLIB_ZLIB);
+
+    return s_data;
+}
+
+// Read all data from the stream in chunks of the given size and return the
+// number of bytes read.
+size_t ReadAll(wxInputStream& is, size_t chunkSize)
+{
+    std::vector<char> buf(chunkSize);
+
+    size_t total = 0;
+    while ( is.Read(buf.data(), buf.size()).LastRead() )
+        total += is.LastRead();
+
+    return total;
+}
+
+#endif // wxUSE_ZLIB
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxMemoryInputStream and wxMemoryOutputStream
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(MemoryInputStreamRead)
+{
+    const std::vector<char>& data = GetTestData();
+    wxMemoryInputStream mis(data.data(), data.size());
+
+    char buf[4096];
+    size_t total = 0;
+    while ( mis.Read(buf, sizeof(buf)).LastRead() )
+        total += mis.LastRead();
+
+    return total == data.size();
+}
+
+BENCHMARK_FUNC(MemoryInputStreamGetC)
+{
+    const std::vector<char>& data = GetTestData();
+    wxMemoryInputStream mis(data.data(), data.size());
+
+    size_t total = 0;
+    while ( mis.GetC() != wxEOF )
+        total++;
+
+    return total == data.size();
+}
+
+BENCHMARK_FUNC(MemoryInputStreamReadLines)
+{
+    const std::vector<char>& data = GetTestData();
+    wxMemoryInputStream mis(data.data(), data.size());
+    wxTextInputStream tis(mis, " \t", wxConvISO8859_1);
+
+    size_t lines = 0;
+    while ( !mis.Eof() )
+    {
+        tis.ReadLine();
+        lines++;
+    }
+
+    return lines != 0;
+}
+
+BENCHMARK_FUNC(MemoryOutputStreamWrite)
+{
+    const std::vector<char>& data = GetTestData();
+    wxMemoryOutputStream mos;
+
+    // Write the data in small pieces, as it is usually done by the code
+    // serializing something, to make the cost of growing the buffer visible.
+    const size_t chunkSize = 64;
+    for ( size_t n = 0; n < data.size(); n += chunkSize )
+        mos.Write(&data[n], wxMin(chunkSize, data.size() - n));
+
+    return mos.GetLength() == static_cast<wxFileOffset>(data.size());
+}
+
+// ----------------------------------------------------------------------------
+// wxZlibInputStream and wxZlibOutputStream
+// ----------------------------------------------------------------------------
+
+#if wxUSE_ZLIB
+
+BENCHMARK_FUNC(ZlibInputStreamRead)
+{
+    const std::vector<char>& compressed = GetCompressedData();
+    wxMemoryInputStream mis(compressed.data(), compressed.size());
+    wxZlibInputStream zis(mis);
+
+    return ReadAll(zis, 16384) == GetTestData().size();
+}
+
+BENCHMARK_FUNC(ZlibInputStreamReadSmall)
+{
+    const std::vector<char>& compressed = GetCompressedData();
+    wxMemoryInputStream mis(compressed.data(), compressed.size());
+    wxZlibInputStream zis(mis);
+
+    return ReadAll(zis, 64) == GetTestData().size();
+}
+
+BENCHMARK_FUNC(ZlibOutputStreamWrite)
+{
+    return !Compress(GetTestData(), wxZLIB_ZLIB).empty();
+}
+
+BENCHMARK_FUNC(GzipOutputStreamWrite)
+{
+    return !Compress(GetTestData(), wxZLIB_GZIP).empty();
+}
+
+#if wxUSE_THREADS
+
+BENCHMARK_FUNC(GzipOutputStreamWriteParallel)
+{
+    const int cpus = wxThread::GetCPUCount();
+    return !Compress(GetTestData(), wxZLIB_GZIP, cpus > 0 ? cpus : 1).empty();
+}
+
+#endif // wxUSE_THREADS
+
+#endif // wxUSE_ZLIB
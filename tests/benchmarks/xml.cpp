@@ -0,0 +1,237 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/xml.cpp
+// Purpose:     wxXmlDocument benchmarks
+// Author:      wxWidgets development team
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/mstream.h"
+#include "wx/xml/xml.h"
+
+#include "bench.h"
+
+#include <string>
+
+#if wxUSE_XML
+
+namespace
+{
+
+// Return the number of top level objects in the test document, which can be
+// changed from the command line.
+size_t GetObjectsCount()
+{
+    return Bench::GetNumericParameter(100);
+}
+
+// Add a window with some controls to the XML document in XRC format, which
+// is the most common kind of XML loaded by wx applications.
+void AppendObject(std::string& xml, size_t n, int depth)
+{
+    const std::string indent(2*depth, ' ');
+    const std::string id = std::to_string(n);
+
+    xml += indent + "<object class=\"wxPanel\" name=\"panel_" + id + "\">\n";
+    xml += indent + "  <style>wxTAB_TRAVERSAL</style>\n";
+    xml += indent + "  <object class=\"wxBoxSizer\">\n";
+    xml += indent + "    <orient>wxVERTICAL</orient>\n";
+
+    for ( int i = 0; i < 5; i++ )
+    {
+        const std::string ctrl = id + "_" + std::to_string(i);
+
+        xml += indent + "    <object class=\"sizeritem\">\n";
+        xml += indent + "      <flag>wxALL|wxEXPAND</flag>\n";
+        xml += indent + "      <border>5</border>\n";
+        xml += indent + "      <object class=\"wxButton\" name=\"btn_" + ctrl + "\">\n";
+        xml += indent + "        <label>Button &amp; label " + ctrl + "</label>\n";
+        xml += indent + "        <tooltip>Tooltip for \xc3\xa9l\xc3\xa9ment " + ctrl + "</tooltip>\n";
+        xml += indent + "      </object>\n";
+        xml += indent + "    </object>\n";
+    }
+
+    // Add some nesting too.
+    if ( depth < 3 && n % 4 == 0 )
+    {
+        xml += indent + "    <object class=\"sizeritem\">\n";
+        AppendObject(xml, n + 1, depth + 3);
+        xml += indent + "    </object>\n";
+    }
+
+    xml += indent + "  </object>\n";
+    xml += indent + "</object>\n";
+}
+
+const std::string& GetTestXML()
+{
+    static std::string s_xml;
+    if ( s_xml.empty() )
+    {
+        s_xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<resource xmlns=\"http://www.wxwidgets.org/wxxrc\" version=\"2.5.3.0\">\n";
+
+        for ( size_t n = 0; n < GetObjectsCount(); n++ )
+            AppendObject(s_xml, n, 1);
+
+        s_xml += "</resource>\n";
+    }
+
+    return s_xml;
+}
+
+bool LoadDocument(wxXmlDocument& doc, int flags = wxXMLDOC_NONE)
+{
+    const std::string& xml = GetTestXML();
+    wxMemoryInputStream mis(xml.data(), xml.size());
+
+    return doc.Load(mis, flags);
+}
+
+const wxXmlDocument& GetDocument()
+{
+    static wxXmlDocument s_doc;
+    if ( !s_doc.IsOk() )
+        LoadDocument(s_doc);
+
+    return s_doc;
+}
+
+// Return the test document in binary format.
+const std::string& GetTestBinary()
+{
+    static std::string s_binary;
+    if ( s_binary.empty() )
+    {
+        wxMemoryOutputStream mos;
+        GetDocument().SaveBinary(mos);
+
+        s_binary.resize(mos.GetLength());
+        mos.CopyTo(&s_binary[0], s_binary.size());
+    }
+
+    return s_binary;
+}
+
+// Visit all nodes of the tree, as XRC does when creating the windows.
+size_t CountNodes(const wxXmlNode* node)
+{
+    size_t count = 0;
+    for ( ; node; node = node->GetNext() )
+    {
+        count++;
+
+        if ( node->GetType() == wxXML_ELEMENT_NODE )
+        {
+            for ( const wxXmlAttribute* attr = node->GetAttributes();
+                  attr;
+                  attr = attr->GetNext() )
+            {
+                if ( !attr->GetValue().empty() )
+                    count++;
+            }
+        }
+
+        count += CountNodes(node->GetChildren());
+    }
+
+    return count;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC(XmlLoad)
+{
+    wxXmlDocument doc;
+    return LoadDocument(doc);
+}
+
+BENCHMARK_FUNC(XmlLoadKeepWhitespace)
+{
+    wxXmlDocument doc;
+    return LoadDocument(doc, wxXMLDOC_KEEP_WHITESPACE_NODES);
+}
+
+BENCHMARK_FUNC(XmlLoadArena)
+{
+    wxXmlDocument doc;
+    return LoadDocument(doc, wxXMLDOC_USE_ARENA);
+}
+
+BENCHMARK_FUNC(XmlLoadBinary)
+{
+    const std::string& binary = GetTestBinary();
+    wxMemoryInputStream mis(binary.data(), binary.size());
+
+    wxXmlDocument doc;
+    return doc.LoadBinary(mis) &&
+            CountNodes(doc.GetRoot()) == CountNodes(GetDocument().GetRoot());
+}
+
+BENCHMARK_FUNC(XmlRead)
+{
+    // Count the elements and attributes, as CountNodes() does.
+    class CountingHandler : public wxXmlReaderHandler
+    {
+    public:
+        virtual bool OnStartElement(const wxXmlReaderElement& element) override
+        {
+            m_count += 1 + element.GetAttributeCount();
+            return true;
+        }
+
+        virtual bool OnText(const wxString& WXUNUSED(text)) override
+        {
+            m_count++;
+            return true;
+        }
+
+        size_t m_count = 0;
+    };
+
+    const std::string& xml = GetTestXML();
+    wxMemoryInputStream mis(xml.data(), xml.size());
+
+    CountingHandler handler;
+    return wxXmlReader(handler).Parse(mis) && handler.m_count != 0;
+}
+
+BENCHMARK_FUNC(XmlTraverse)
+{
+    return CountNodes(GetDocument().GetRoot()) != 0;
+}
+
+BENCHMARK_FUNC(XmlFindByName)
+{
+    // Look for the last top level object by name, as wxXmlResource does.
+    const wxString name = wxString::Format
+                          (
+                            "panel_%lu",
+                            static_cast<unsigned long>(GetObjectsCount() - 1)
+                          );
+
+    for ( const wxXmlNode* node = GetDocument().GetRoot()->GetChildren();
+          node;
+          node = node->GetNext() )
+    {
+        if ( node->GetAttribute("name") == name )
+            return true;
+    }
+
+    return false;
+}
+
+BENCHMARK_FUNC(XmlSave)
+{
+    wxMemoryOutputStream mos;
+    return GetDocument().Save(mos) && mos.GetLength() != 0;
+}
+
+BENCHMARK_FUNC(XmlCopy)
+{
+    wxXmlDocument doc(GetDocument());
+    return doc.IsOk();
+}
+
+#endif // wxUSE_XML
@@ -176,6 +176,97 @@ TEST_CASE("wxFileConfig::GetGroups", "[fileconfig][config]")
     CheckGroupSubgroups(fc, "/root/group2", 0);
 }
 
+TEST_CASE("wxFileConfig::ManyEntries", "[fileconfig][config]")
+{
+    wxStringInputStream sis("");
+    wxFileConfig fc(sis);
+
+    // Add the entries and groups in non-alphabetical order, they must still
+    // be enumerated in alphabetical order.
+    fc.Write("/many/c", 3);
+    fc.Write("/many/A", 1);
+    fc.Write("/many/b", 2);
+    fc.Write("/many/z/x", 0);
+    fc.Write("/many/y/x", 0);
+
+    CheckGroupEntries(fc, "/many", 3, "A", "b", "c");
+    CheckGroupSubgroups(fc, "/many", 2, "y", "z");
+
+    // But they must be saved in the order they were written.
+    wxVERIFY_FILECONFIG( "[many]\n"
+                         "c=3\n"
+                         "A=1\n"
+                         "b=2\n"
+                         "[many/z]\n"
+                         "x=0\n"
+                         "[many/y]\n"
+                         "x=0\n",
+                         fc );
+
+#if !wxCONFIG_CASE_SENSITIVE
+    CHECK( fc.ReadLong("/MANY/a", 0) == 1 );
+    CHECK( fc.HasGroup("/many/Y") );
+#endif
+
+    fc.SetPath("/many");
+    CHECK( fc.RenameGroup("z", "a") );
+    fc.SetPath("/");
+    CheckGroupSubgroups(fc, "/many", 2, "a", "y");
+
+    CHECK( fc.DeleteEntry("/many/b") );
+    CheckGroupEntries(fc, "/many", 2, "A", "c");
+
+    fc.Write("/many/B", 2);
+    CheckGroupEntries(fc, "/many", 3, "A", "B", "c");
+
+    // Check that many entries can be added, found and deleted.
+    fc.SetPath("/more");
+    for ( int n = 999; n >= 0; n-- )
+        fc.Write(wxString::Format("k%03d", n), n);
+
+    CHECK( fc.GetNumberOfEntries() == 1000 );
+    for ( int n = 0; n < 1000; n += 7 )
+        CHECK( fc.ReadLong(wxString::Format("k%03d", n), -1) == n );
+
+    for ( int n = 0; n < 1000; n += 2 )
+        CHECK( fc.DeleteEntry(wxString::Format("k%03d", n)) );
+
+    CHECK( fc.GetNumberOfEntries() == 500 );
+
+    wxString name;
+    long cookie;
+    REQUIRE( fc.GetFirstEntry(name, cookie) );
+    CHECK( name == "k001" );
+    CHECK( !fc.HasEntry("k002") );
+}
+
+TEST_CASE("wxFileConfig::Parse", "[fileconfig][config]")
+{
+    // Check that all kinds of line endings are handled and that empty lines
+    // and comments are preserved.
+    wxStringInputStream sis("; comment\r\n"
+                            "a=1\r"
+                            "\r\n"
+                            "[g] # group comment\n"
+                            "  b = 2 \n"
+                            "c=\"x\\ty\"\r\n"
+                            "\n");
+    wxFileConfig fc(sis);
+
+    CHECK( fc.ReadLong("/a", 0) == 1 );
+    CHECK( fc.ReadLong("/g/b", 0) == 2 );
+    CHECK( fc.Read("/g/c") == "x\ty" );
+
+    wxVERIFY_FILECONFIG( "; comment\n"
+                         "a=1\n"
+                         "\n"
+                         "[g] # group comment\n"
+                         "  b = 2 \n"
+                         "c=\"x\\ty\"\n"
+                         "\n",
+                         fc );
+}
+
 TEST_CASE("wxFileConfig::HasEntry", "[fileconfig][config]")
 {
     wxStringInputStream sis(testconfig);
@@ -658,6 +749,13 @@ TEST_CASE_METHOD(LogTestCase, "wxFileConfig::Error", "[fileconfig][error]")
 
     // Check that it's the second quote which is unexpected, not the first one.
     checkWarning(R"(foo="x"y)", R"(unexpected " at position 3)");
+
+    // Check that an unterminated group name is reported correctly.
+    wxStringInputStream sis("foo=1\n[bar\n");
+    wxFileConfig fc(sis);
+
+    CHECK_THAT( m_log->GetLog(wxLOG_Error).utf8_string(),
+                Catch::Contains("line 2: unexpected end of line") );
 }
 
 #endif // wxUSE_FILECONFIG
@@ -13,7 +13,13 @@
 #include "testprec.h"
 
 
+#include "wx/app.h"
 #include "wx/event.h"
+#include "wx/evtprofiler.h"
+#include "wx/thread.h"
+
+#include <memory>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 // test events and their handlers
@@ -510,6 +516,338 @@ TEST_CASE("Event::UnbindFromHandler", "[event][bind][unbind]")
     handler.ProcessEvent(e);
 }
 
+namespace
+{
+
+class ManyHandlers : public wxEvtHandler
+{
+public:
+    ManyHandlers()
+    {
+        // Bind enough handlers to use the index by event type.
+        for ( int n = 0; n < 100; n++ )
+        {
+            Bind(wxEVT_THREAD, &ManyHandlers::OnThread, this, n);
+            Bind(MyEventType, &ManyHandlers::OnMyEvent, this, n);
+        }
+    }
+
+    void OnThread(wxThreadEvent& event)
+    {
+        called.push_back(event.GetId());
+        event.Skip();
+    }
+
+    void OnThreadAgain(wxThreadEvent& event)
+    {
+        called.push_back(1000 + event.GetId());
+        event.Skip();
+    }
+
+    void OnUnbind(wxThreadEvent& event)
+    {
+        Unbind(wxEVT_THREAD, &ManyHandlers::OnThread, this, event.GetId());
+        called.push_back(-1);
+        event.Skip();
+    }
+
+    void OnMyEvent(MyEvent&)
+    {
+        FAIL( "Shouldn't be called" );
+    }
+
+    void Send(int id)
+    {
+        called.clear();
+
+        wxThreadEvent event(wxEVT_THREAD, id);
+        ProcessEvent(event);
+    }
+
+    std::vector<int> called;
+};
+
+} // anonymous namespace
+
+TEST_CASE("Event::BindMany", "[event][bind]")
+{
+    ManyHandlers handler;
+
+    handler.Send(17);
+    REQUIRE( handler.called.size() == 1 );
+    CHECK( handler.called[0] == 17 );
+
+    // The handlers bound later must be called first.
+    handler.Bind(wxEVT_THREAD, &ManyHandlers::OnThreadAgain, &handler, 5);
+    handler.Send(5);
+    REQUIRE( handler.called.size() == 2 );
+    CHECK( handler.called[0] == 1005 );
+    CHECK( handler.called[1] == 5 );
+
+    // Unbinding from inside the handler must work too.
+    handler.Bind(wxEVT_THREAD, &ManyHandlers::OnUnbind, &handler);
+    handler.Send(17);
+    REQUIRE( handler.called.size() == 1 );
+    CHECK( handler.called[0] == -1 );
+
+    CHECK( handler.Unbind(wxEVT_THREAD, &ManyHandlers::OnUnbind, &handler) );
+    handler.Send(17);
+    CHECK( handler.called.empty() );
+
+    // And the other handlers must still be called after the unbound ones
+    // were removed.
+    handler.Send(5);
+    REQUIRE( handler.called.size() == 2 );
+    CHECK( handler.called[0] == 1005 );
+    CHECK( handler.called[1] == 5 );
+
+    handler.Send(99);
+    REQUIRE( handler.called.size() == 1 );
+    CHECK( handler.called[0] == 99 );
+}
+
+TEST_CASE("Event::Profiler", "[event][profiler]")
+{
+    ManyHandlers handler;
+
+    // Nothing should be recorded while the profiler is disabled.
+    wxEventProfiler::Reset();
+    handler.Send(1);
+    CHECK( wxEventProfiler::GetEventTypeStats().empty() );
+    CHECK( wxEventProfiler::GetHandlerStats().empty() );
+
+    wxEventProfiler::Enable();
+    CHECK( wxEventProfiler::IsEnabled() );
+
+    handler.Bind(wxEVT_THREAD, &ManyHandlers::OnThreadAgain, &handler, 1);
+    handler.Send(1);
+    handler.Send(1);
+    handler.Send(2);
+
+    wxEventProfiler::Enable(false);
+
+    handler.Send(1);
+
+    const auto eventTypes = wxEventProfiler::GetEventTypeStats();
+    REQUIRE( eventTypes.size() == 1 );
+    CHECK( eventTypes[0].eventType == wxEVT_THREAD );
+    CHECK( eventTypes[0].eventClass == "wxThreadEvent" );
+    CHECK( eventTypes[0].count == 3 );
+    CHECK( eventTypes[0].maxTime <= eventTypes[0].totalTime );
+
+    // Each event is processed by OnThread(), so there must be 2 different
+    // handlers for it, for ids 1 and 2, and one more for OnThreadAgain().
+    const auto handlers = wxEventProfiler::GetHandlerStats();
+    REQUIRE( handlers.size() == 3 );
+
+    unsigned long total = 0;
+    for ( const auto& stats : handlers )
+    {
+        CHECK( stats.eventType == wxEVT_THREAD );
+        CHECK( stats.handlerClass == "wxEvtHandler" );
+        total += stats.count;
+    }
+
+    CHECK( total == 5 );
+
+    const wxString report = wxEventProfiler::GetReport();
+    CHECK( report.Contains("wxThreadEvent") );
+
+    const wxString json = wxEventProfiler::GetReportAsJSON();
+    CHECK( json.StartsWith("{") );
+    CHECK( json.Contains("\"class\": \"wxThreadEvent\"") );
+
+    wxEventProfiler::Reset();
+    CHECK( wxEventProfiler::GetEventTypeStats().empty() );
+    CHECK( wxEventProfiler::GetHandlerStats().empty() );
+}
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Thread posting the given number of events numbered sequentially.
+class EventPosterThread : public wxThread
+{
+public:
+    EventPosterThread(wxEvtHandler& handler, int index, int count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_index(index),
+          m_count(count)
+    {
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        for ( int n = 0; n < m_count; n++ )
+        {
+            wxThreadEvent* const event = new wxThreadEvent();
+            event->SetInt(n);
+            event->SetExtraLong(m_index);
+            m_handler.QueueEvent(event);
+        }
+
+        return nullptr;
+    }
+
+private:
+    wxEvtHandler& m_handler;
+    const int m_index;
+    const int m_count;
+};
+
+} // anonymous namespace
+
+TEST_CASE("Event::QueueFromThreads", "[event][queue][thread]")
+{
+    const int NUM_THREADS = 8;
+    const int NUM_EVENTS = 5000;
+
+    // Index of the next event expected from each thread.
+    std::vector<int> next(NUM_THREADS);
+    int received = 0;
+    bool outOfOrder = false;
+
+    wxEvtHandler handler;
+    handler.Bind(wxEVT_THREAD, [&](wxThreadEvent& event)
+        {
+            int& expected = next[event.GetExtraLong()];
+            if ( event.GetInt() != expected )
+                outOfOrder = true;
+
+            expected++;
+            received++;
+        });
+
+    std::vector<std::unique_ptr<EventPosterThread>> threads;
+    for ( int n = 0; n < NUM_THREADS; n++ )
+    {
+        threads.emplace_back(new EventPosterThread(handler, n, NUM_EVENTS));
+        REQUIRE( threads.back()->Run() == wxTHREAD_NO_ERROR );
+    }
+
+    // Process the events while they're being posted.
+    while ( received < NUM_THREADS*NUM_EVENTS )
+    {
+        wxTheApp->ProcessPendingEvents();
+
+        if ( outOfOrder )
+            break;
+    }
+
+    for ( const auto& thread : threads )
+        thread->Wait();
+
+    CHECK( !outOfOrder );
+    CHECK( received == NUM_THREADS*NUM_EVENTS );
+    CHECK( !wxTheApp->HasPendingEvents() );
+
+    // Check that posting more events from the main thread still works.
+    handler.QueueEvent(new wxThreadEvent());
+    CHECK( wxTheApp->HasPendingEvents() );
+    wxTheApp->ProcessPendingEvents();
+    CHECK( received == NUM_THREADS*NUM_EVENTS + 1 );
+}
+
+TEST_CASE("Event::QueueAndDelete", "[event][queue]")
+{
+    int received = 0;
+
+    wxEvtHandler* const handler = new wxEvtHandler;
+    handler->Bind(wxEVT_THREAD, [&](wxThreadEvent&) { received++; });
+
+    for ( int n = 0; n < 10; n++ )
+        handler->QueueEvent(new wxThreadEvent());
+
+    CHECK( wxTheApp->HasPendingEvents() );
+
+    // Deleting the handler must delete its queued events too.
+    delete handler;
+
+    CHECK( !wxTheApp->HasPendingEvents() );
+
+    wxTheApp->ProcessPendingEvents();
+    CHECK( received == 0 );
+}
+
+#endif // wxUSE_THREADS
+
+TEST_CASE("Event::QueueOrReplace", "[event][queue]")
+{
+    std::vector<int> received;
+
+    wxEvtHandler handler;
+    handler.Bind(wxEVT_THREAD, [&](wxThreadEvent& event)
+        {
+            received.push_back(event.GetId()*100 + event.GetInt());
+        });
+
+    const auto queue = [&handler](int id, int n, bool replace)
+    {
+        wxThreadEvent* const event = new wxThreadEvent(wxEVT_THREAD, id);
+        event->SetInt(n);
+
+        if ( replace )
+            handler.QueueOrReplaceEvent(event);
+        else
+            handler.QueueEvent(event);
+    };
+
+    const auto processAll = []()
+    {
+        while ( wxTheApp->HasPendingEvents() )
+            wxTheApp->ProcessPendingEvents();
+    };
+
+    SECTION("Explicit")
+    {
+        queue(1, 1, true);
+        queue(2, 1, true);
+        queue(1, 2, true);
+        queue(3, 1, false);
+        queue(1, 3, true);
+        queue(3, 2, false);
+
+        processAll();
+
+        // The replaced events keep their position in the queue.
+        REQUIRE( received.size() == 4 );
+        CHECK( received[0] == 103 );
+        CHECK( received[1] == 201 );
+        CHECK( received[2] == 301 );
+        CHECK( received[3] == 302 );
+
+        // Once the event was processed, it can't be replaced any more.
+        queue(1, 4, true);
+        processAll();
+
+        REQUIRE( received.size() == 5 );
+        CHECK( received[4] == 104 );
+    }
+
+    SECTION("ByType")
+    {
+        CHECK( !wxEvtHandler::IsEventTypeCoalesced(wxEVT_THREAD) );
+
+        wxEvtHandler::SetEventTypeCoalescing(wxEVT_THREAD);
+        CHECK( wxEvtHandler::IsEventTypeCoalesced(wxEVT_THREAD) );
+
+        for ( int n = 0; n < 10; n++ )
+            queue(1, n, false);
+
+        wxEvtHandler::SetEventTypeCoalescing(wxEVT_THREAD, false);
+        CHECK( !wxEvtHandler::IsEventTypeCoalesced(wxEVT_THREAD) );
+
+        processAll();
+
+        REQUIRE( received.size() == 1 );
+        CHECK( received[0] == 109 );
+    }
+}
+
 // This is a compilation-time-only test: just check that a class inheriting
 // from wxEvtHandler non-publicly can use Bind() with its method, this used to
 // result in compilation errors.
@@ -21,9 +21,12 @@
 
 #if wxUSE_FILESYSTEM
 
+#include "wx/fs_arc.h"
 #include "wx/fs_data.h"
 #include "wx/fs_mem.h"
+#include "wx/mstream.h"
 #include "wx/sstream.h"
+#include "wx/zipstrm.h"
 
 #include <memory>
 
@@ -49,6 +52,24 @@ public:
 
 };
 
+// Install wxMemoryFSHandler just for the duration of a test.
+class AutoMemoryFSHandler
+{
+public:
+    AutoMemoryFSHandler()
+        : m_handler(new wxMemoryFSHandler())
+    {
+        wxFileSystem::AddHandler(m_handler.get());
+    }
+
+    ~AutoMemoryFSHandler()
+    {
+        wxFileSystem::RemoveHandler(m_handler.get());
+    }
+
+private:
+    std::unique_ptr<wxMemoryFSHandler> const m_handler;
+};
 
 // ----------------------------------------------------------------------------
 // tests themselves
@@ -228,24 +249,7 @@ TEST_CASE("wxFileSystem::DataSchemeFSHandler", "[filesys][dataschemefshandler][o
 // this used to be broken, see https://github.com/wxWidgets/wxWidgets/issues/18744
 TEST_CASE("wxFileSystem::MemoryFSHandler", "[filesys][memoryfshandler][find]")
 {
-    // Install wxMemoryFSHandler just for the duration of this test.
-    class AutoMemoryFSHandler
-    {
-    public:
-        AutoMemoryFSHandler()
-            : m_handler(new wxMemoryFSHandler())
-        {
-            wxFileSystem::AddHandler(m_handler.get());
-        }
-
-        ~AutoMemoryFSHandler()
-        {
-            wxFileSystem::RemoveHandler(m_handler.get());
-        }
-
-    private:
-        std::unique_ptr<wxMemoryFSHandler> const m_handler;
-    } autoMemoryFSHandler;
+    AutoMemoryFSHandler autoMemoryFSHandler;
 
     wxMemoryFSHandler::AddFile("foo.txt", "foo contents");
     wxMemoryFSHandler::AddFile("bar.txt", "bar contents");
@@ -272,4 +276,85 @@ TEST_CASE("wxFileSystem::MemoryFSHandler", "[filesys][memoryfshandler][find]")
     CHECK( fs.FindNext() == "" );
 }
 
+#if wxUSE_FS_ARCHIVE && wxUSE_ZIPSTREAM
+
+// Add a zip file with the given entries, all containing their own names, to
+// the memory file system.
+static void AddMemoryZip(const wxString& name, const wxArrayString& entries)
+{
+    wxMemoryOutputStream mem;
+    {
+        wxZipOutputStream zip(mem);
+        for ( const wxString& entry : entries )
+        {
+            zip.PutNextEntry(entry);
+            zip.Write(entry.utf8_str(), entry.utf8_str().length());
+        }
+    }
+
+    wxMemoryFSHandler::AddFile(name, mem.GetOutputStreamBuffer()->GetBufferStart(),
+                               mem.GetSize());
+}
+
+static wxString ReadFSFile(wxArchiveFSHandler& handler,
+                           wxFileSystem& fs,
+                           const wxString& location)
+{
+    std::unique_ptr<wxFSFile> file(handler.OpenFile(fs, location));
+    if ( !file )
+        return wxString();
+
+    wxStringOutputStream out;
+    file->GetStream()->Read(out);
+    return out.GetString();
+}
+
+TEST_CASE("wxFileSystem::ArchiveFSHandler", "[filesys][archivefshandler]")
+{
+    AutoMemoryFSHandler autoMemoryFSHandler;
+
+    wxArrayString entries;
+    for ( int n = 0; n < 100; n++ )
+        entries.push_back(wxString::Format("dir%d/file%d.txt", n % 3, n));
+
+    AddMemoryZip("fsarc1.zip", entries);
+    AddMemoryZip("fsarc2.zip", entries);
+
+    wxArchiveFSHandler handler;
+    wxFileSystem fs;
+
+    // Use a small limit to check that the archives evicted from the cache
+    // can still be used.
+    handler.SetMaxCachedEntries(150);
+    CHECK( handler.GetMaxCachedEntries() == 150 );
+
+    for ( int n = 0; n < 3; n++ )
+    {
+        for ( const wxString& entry : { entries[99], entries[0], entries[50] } )
+        {
+            CHECK( ReadFSFile(handler, fs, "memory:fsarc1.zip#zip:" + entry) == entry );
+            CHECK( ReadFSFile(handler, fs, "memory:fsarc2.zip#zip:" + entry) == entry );
+        }
+    }
+
+    CHECK( ReadFSFile(handler, fs, "memory:fsarc1.zip#zip:nosuchfile") == "" );
+
+    // Check that iterating over the archive works even if it's removed from
+    // the cache in the meanwhile.
+    int count = 1;
+    wxString url = handler.FindFirst("memory:fsarc1.zip#zip:dir0/*.txt", wxFILE);
+    CHECK( url == "memory:fsarc1.zip#zip:dir0/file0.txt" );
+
+    CHECK( ReadFSFile(handler, fs, "memory:fsarc2.zip#zip:" + entries[1]) == entries[1] );
+
+    while ( !handler.FindNext().empty() )
+        count++;
+    CHECK( count == 34 );
+
+    wxMemoryFSHandler::RemoveFile("fsarc1.zip");
+    wxMemoryFSHandler::RemoveFile("fsarc2.zip");
+}
+
+#endif // wxUSE_FS_ARCHIVE && wxUSE_ZIPSTREAM
+
 #endif // wxUSE_FILESYSTEM
@@ -32,6 +32,8 @@
 #include "wx/clipbrd.h"
 #include "wx/dataobj.h"
 #include "wx/utils.h"
+#include "wx/imagebatch.h"
+#include "wx/sysopt.h"
 
 // Check if we can use wxDIB::ConvertToBitmap(), which only exists for MSW and
 // which assumes the target is little-endian (matching the file format)
@@ -43,6 +45,7 @@
 
 #include "testimage.h"
 
+#include <functional>
 #include <memory>
 
 #define CHECK_EQUAL_COLOUR_RGB(c1, c2) \
@@ -2491,6 +2494,621 @@ TEST_CASE("wxImage::Clear", "[image]")
     CHECK( image.GetRed(1, 1) == 0xff );
 }
 
+TEST_CASE("wxImage::GaussianBlur", "[image][blur]")
+{
+    SECTION("Uniform image")
+    {
+        wxImage image(5, 3);
+        for ( int y = 0; y < 3; y++ )
+        {
+            for ( int x = 0; x < 5; x++ )
+                image.SetRGB(x, y, 0x12, 0x34, 0x56);
+        }
+
+        const wxImage blurred = image.GaussianBlur(10);
+        CHECK( blurred.GetRed(0, 0) == 0x12 );
+        CHECK( blurred.GetGreen(2, 1) == 0x34 );
+        CHECK( blurred.GetBlue(4, 2) == 0x56 );
+    }
+
+    SECTION("Single point")
+    {
+        wxImage image(21, 21);
+        image.SetRGB(10, 10, 0xff, 0xff, 0xff);
+
+        const wxImage blurred = image.GaussianBlur(2);
+
+        // The result must be symmetric and decrease away from the centre.
+        CHECK( blurred.GetRed(10, 10) > blurred.GetRed(11, 10) );
+        CHECK( blurred.GetRed(11, 10) > blurred.GetRed(13, 10) );
+        CHECK( blurred.GetRed(8, 10) == blurred.GetRed(12, 10) );
+        CHECK( blurred.GetRed(10, 8) == blurred.GetRed(10, 12) );
+        CHECK( blurred.GetRed(12, 10) == blurred.GetRed(10, 12) );
+        CHECK( blurred.GetRed(0, 0) == 0 );
+
+        // And the original image must be left unchanged.
+        CHECK( image.GetRed(10, 10) == 0xff );
+        CHECK( image.GetRed(11, 10) == 0 );
+
+        wxImage inPlace = image.Copy();
+        inPlace.GaussianBlurInPlace(2);
+        CHECK( memcmp(inPlace.GetData(), blurred.GetData(), 21*21*3) == 0 );
+    }
+
+    SECTION("Alpha")
+    {
+        // Opaque red square on fully transparent green background: the colour
+        // of the transparent pixels must not bleed into the opaque ones.
+        wxImage image(30, 30);
+        image.SetAlpha();
+        for ( int y = 0; y < 30; y++ )
+        {
+            for ( int x = 0; x < 30; x++ )
+            {
+                const bool inside = x >= 10 && x < 20 && y >= 10 && y < 20;
+                image.SetRGB(x, y, inside ? 0xff : 0, inside ? 0 : 0xff, 0);
+                image.SetAlpha(x, y, inside ? wxIMAGE_ALPHA_OPAQUE
+                                            : wxIMAGE_ALPHA_TRANSPARENT);
+            }
+        }
+
+        const wxImage blurred = image.GaussianBlur(2);
+        REQUIRE( blurred.HasAlpha() );
+
+        CHECK( blurred.GetRed(10, 15) == 0xff );
+        CHECK( blurred.GetGreen(10, 15) == 0 );
+        CHECK( blurred.GetAlpha(10, 15) < wxIMAGE_ALPHA_OPAQUE );
+        CHECK( blurred.GetRed(9, 15) == 0xff );
+        CHECK( blurred.GetGreen(9, 15) == 0 );
+        CHECK( blurred.GetAlpha(9, 15) > wxIMAGE_ALPHA_TRANSPARENT );
+        CHECK( blurred.GetAlpha(0, 0) == wxIMAGE_ALPHA_TRANSPARENT );
+    }
+
+    SECTION("Almost transparent")
+    {
+        // The colours of the pixels with small alpha must not lose precision.
+        wxImage image(10, 10);
+        image.SetAlpha();
+        for ( int y = 0; y < 10; y++ )
+        {
+            for ( int x = 0; x < 10; x++ )
+            {
+                image.SetRGB(x, y, 200, 100, 50);
+                image.SetAlpha(x, y, 1);
+            }
+        }
+
+        wxImage blurred = image.Copy();
+        blurred.GaussianBlurInPlace(2);
+        CHECK( blurred.GetRed(5, 5) == 200 );
+        CHECK( blurred.GetGreen(5, 5) == 100 );
+        CHECK( blurred.GetBlue(5, 5) == 50 );
+        CHECK( blurred.GetAlpha(5, 5) == 1 );
+    }
+}
+
+TEST_CASE("wxImage::RGBA", "[image][rgba]")
+{
+    const unsigned char rgba[] =
+    {
+        0x01, 0x02, 0x03, 0x04,   0x11, 0x12, 0x13, 0x14,   0x21, 0x22, 0x23, 0x24,
+        0x31, 0x32, 0x33, 0x34,   0x41, 0x42, 0x43, 0x44,   0x51, 0x52, 0x53, 0x54,
+    };
+
+    wxImage image(3, 2);
+    image.SetDataRGBA(rgba);
+    CHECK( image.HasRGBAStorage() );
+    CHECK( image.HasAlpha() );
+    CHECK( image.GetWidth() == 3 );
+
+    // Getting RGBA data shouldn't need to convert it.
+    CHECK( memcmp(image.GetDataRGBA(), rgba, sizeof(rgba)) == 0 );
+    CHECK( image.HasRGBAStorage() );
+
+    // Copying the image preserves its storage format.
+    wxImage copy = image.Copy();
+    CHECK( copy.HasRGBAStorage() );
+
+    // But accessing RGB data unpacks it.
+    CHECK( image.GetRed(1, 0) == 0x11 );
+    CHECK( image.GetBlue(2, 1) == 0x53 );
+    CHECK( image.GetAlpha(0, 1) == 0x34 );
+    CHECK( !image.HasRGBAStorage() );
+
+    const unsigned char* const data = image.GetData();
+    CHECK( data[3] == 0x11 );
+    CHECK( image.GetAlpha()[5] == 0x54 );
+
+    // Modifications done via the planar data must be reflected in RGBA.
+    image.SetRGB(2, 1, 0xaa, 0xbb, 0xcc);
+    image.SetAlpha(2, 1, 0xdd);
+
+    const unsigned char* const rgbaNew = image.GetDataRGBA();
+    CHECK( image.HasRGBAStorage() );
+    CHECK( memcmp(rgbaNew, rgba, sizeof(rgba) - 4) == 0 );
+    CHECK( rgbaNew[20] == 0xaa );
+    CHECK( rgbaNew[21] == 0xbb );
+    CHECK( rgbaNew[22] == 0xcc );
+    CHECK( rgbaNew[23] == 0xdd );
+
+    // And the copy must not have been affected.
+    CHECK( copy.GetRed(2, 1) == 0x51 );
+
+    // Converting the image to RGBA must not affect the other images sharing
+    // its data, notably not invalidate the pointers to their data.
+    wxImage planar(3, 2);
+    planar.InitAlpha();
+    planar.SetRGB(1, 1, 0x12, 0x34, 0x56);
+    planar.SetAlpha(1, 1, 0x78);
+
+    wxImage shared = planar;
+    const unsigned char* const sharedData = shared.GetData();
+    const unsigned char* const sharedAlpha = shared.GetAlpha();
+
+    const unsigned char* const rgbaPlanar = planar.GetDataRGBA();
+    CHECK( planar.HasRGBAStorage() );
+    CHECK( rgbaPlanar[16] == 0x12 );
+    CHECK( rgbaPlanar[19] == 0x78 );
+
+    CHECK( !shared.HasRGBAStorage() );
+    CHECK( shared.GetData() == sharedData );
+    CHECK( shared.GetAlpha() == sharedAlpha );
+    CHECK( sharedData[12] == 0x12 );
+    CHECK( sharedData[14] == 0x56 );
+    CHECK( sharedAlpha[4] == 0x78 );
+
+    // Accessing the pixels of an image stored in RGBA format must not free
+    // this data either, as it may be still used by the images sharing it.
+    wxImage packed(3, 2);
+    packed.SetDataRGBA(rgba);
+
+    const wxImage packedShared = packed;
+    const unsigned char* const rgbaShared = packed.GetDataRGBA();
+    CHECK( packedShared.GetRed(1, 0) == 0x11 );
+    CHECK( packedShared.GetAlpha()[5] == 0x54 );
+    CHECK( !packed.HasRGBAStorage() );
+    CHECK( memcmp(rgbaShared, rgba, sizeof(rgba)) == 0 );
+
+    // RGBA data is not available for images without alpha.
+    wxImage rgb(3, 2);
+    WX_ASSERT_FAILS_WITH_ASSERT( rgb.GetDataRGBA() );
+    CHECK( !rgb.HasRGBAStorage() );
+}
+
+// Create an image of the given size with alpha and varying pixel values, used
+// to check that the different implementations of the same transformation
+// produce the same results.
+static wxImage CreateTestPatternImage(int width, int height)
+{
+    wxImage image(width, height, false);
+    image.SetAlpha();
+
+    unsigned char* data = image.GetData();
+    unsigned char* alpha = image.GetAlpha();
+
+    // Use a simple linear congruential generator to get the same "random"
+    // values on all platforms.
+    unsigned seed = 17;
+    for ( int n = 0; n < width*height; n++ )
+    {
+        for ( int i = 0; i < 3; i++ )
+        {
+            seed = seed*1103515245 + 12345;
+            *data++ = static_cast<unsigned char>(seed >> 16);
+        }
+
+        seed = seed*1103515245 + 12345;
+        *alpha++ = static_cast<unsigned char>(seed >> 16);
+    }
+
+    return image;
+}
+
+TEST_CASE("wxImage::Parallel", "[image][threads]")
+{
+    // Make sure the original value is restored even if the test fails.
+    class MaxThreadsRestorer
+    {
+    public:
+        MaxThreadsRestorer() : m_maxThreads(wxImage::GetMaxThreads()) { }
+        ~MaxThreadsRestorer() { wxImage::SetMaxThreads(m_maxThreads); }
+
+    private:
+        const int m_maxThreads;
+    } restoreMaxThreads;
+
+    // The image must be big enough for the work to be split between threads.
+    const wxImage image = CreateTestPatternImage(640, 480);
+
+    using Transform = std::function<wxImage (const wxImage&)>;
+    const struct
+    {
+        const char* name;
+        Transform func;
+    } transforms[] =
+    {
+        { "Nearest",
+          [](const wxImage& i) { return i.Scale(900, 700, wxIMAGE_QUALITY_NEAREST); } },
+        { "Bilinear",
+          [](const wxImage& i) { return i.Scale(900, 700, wxIMAGE_QUALITY_BILINEAR); } },
+        { "Bicubic",
+          [](const wxImage& i) { return i.Scale(900, 700, wxIMAGE_QUALITY_BICUBIC); } },
+        { "Box",
+          [](const wxImage& i) { return i.Scale(213, 160, wxIMAGE_QUALITY_BOX_AVERAGE); } },
+        { "Blur",
+          [](const wxImage& i) { return i.Blur(5); } },
+        { "BlurHorizontal",
+          [](const wxImage& i) { return i.BlurHorizontal(5); } },
+        { "BlurVertical",
+          [](const wxImage& i) { return i.BlurVertical(5); } },
+        { "GaussianBlur",
+          [](const wxImage& i) { return i.GaussianBlur(3); } },
+        { "Rotate",
+          [](const wxImage& i) { return i.Rotate(0.3, wxPoint(320, 240)); } },
+        { "RotateNoInterpolation",
+          [](const wxImage& i) { return i.Rotate(0.3, wxPoint(320, 240), false); } },
+        { "Greyscale",
+          [](const wxImage& i) { return i.ConvertToGreyscale(); } },
+        { "ChangeHSV",
+          [](const wxImage& i)
+          {
+            wxImage copy = i.Copy();
+            copy.ChangeHSV(0.1, -0.2, 0.1);
+            return copy;
+          }
+        },
+    };
+
+    for ( const auto& t : transforms )
+    {
+        INFO("Transform: " << t.name);
+
+        wxImage::SetMaxThreads(1);
+        const wxImage serial = t.func(image);
+
+        wxImage::SetMaxThreads(4);
+        const wxImage parallel = t.func(image);
+
+        CHECK_THAT( parallel, RGBASameAs(serial) );
+    }
+}
+
+TEST_CASE("wxImage::RescaleSIMD", "[image][simd]")
+{
+    // The vectorized resampling code must produce the same results as the
+    // scalar one, except that they may differ by 1 when using NEON, see the
+    // comment before wxIMAGE_RESAMPLE_USE_SIMD definition in image.cpp.
+#if defined(__aarch64__) || defined(_M_ARM64)
+    const int tolerance = 1;
+#else
+    const int tolerance = 0;
+#endif
+
+    const bool withAlpha = GENERATE(false, true);
+
+    wxImage image = CreateTestPatternImage(101, 67);
+    if ( !withAlpha )
+        image.ClearAlpha();
+
+    // Use odd sizes to check that the last pixels of each row, which may be
+    // handled separately by the vectorized code, are processed correctly.
+    const wxSize sizes[] =
+    {
+        wxSize(1, 1),
+        wxSize(37, 23),
+        wxSize(99, 67),
+        wxSize(203, 131),
+        wxSize(15, 301),
+    };
+
+    const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_NEAREST,
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+    };
+
+    for ( const auto& size : sizes )
+    {
+        for ( const auto quality : qualities )
+        {
+            wxINFO_FMT("Scaling %s image to %dx%d with quality %d",
+                       withAlpha ? "RGBA" : "RGB",
+                       size.x, size.y, quality);
+
+            wxSystemOptions::SetOption("image.no-simd", 1);
+            const wxImage scalar = image.Scale(size.x, size.y, quality);
+
+            wxSystemOptions::SetOption("image.no-simd", 0);
+            const wxImage vectorized = image.Scale(size.x, size.y, quality);
+
+            CHECK_THAT( vectorized, RGBASimilarTo(scalar, tolerance) );
+        }
+    }
+}
+
+// Load the image from the given stream with the given region and maximal size.
+static wxImage
+LoadImageRegion(wxInputStream& stream,
+                wxBitmapType type,
+                const wxRect& region,
+                int maxWidth = 0)
+{
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_REGION_X, region.x);
+    image.SetOption(wxIMAGE_OPTION_REGION_Y, region.y);
+    image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, region.width);
+    image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, region.height);
+    if ( maxWidth )
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, maxWidth);
+
+    stream.SeekI(0);
+    if ( !image.LoadFile(stream, type) )
+        return wxImage();
+
+    return image;
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadRegion", "[image][region]")
+{
+    const wxImage full("horse.png");
+    REQUIRE( full.IsOk() );
+
+    const wxRect region(30, 40, 50, 20);
+    const wxImage expected = full.GetSubImage(region);
+
+    // Test both the handlers supporting loading the region directly (the
+    // images saved by wxPNGHandler are not interlaced and so can be loaded
+    // row by row) and those for which wxImage crops the image after loading.
+    const wxBitmapType types[] =
+    {
+        wxBITMAP_TYPE_PNG,
+        wxBITMAP_TYPE_BMP,
+#if wxUSE_LIBTIFF
+        wxBITMAP_TYPE_TIFF,
+#endif // wxUSE_LIBTIFF
+    };
+
+    for ( const auto type : types )
+    {
+        wxMemoryOutputStream memOut;
+        REQUIRE( full.SaveFile(memOut, type) );
+
+        wxMemoryInputStream memIn(memOut);
+
+        wxINFO_FMT("Loading region of image of type %d", type);
+
+        wxImage image = LoadImageRegion(memIn, type, region);
+        REQUIRE( image.IsOk() );
+        CHECK_THAT( image, RGBSameAs(expected) );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == full.GetWidth() );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == full.GetHeight() );
+
+        // The other options, such as the resolution, must be preserved too.
+        wxImage fullLoaded;
+        memIn.SeekI(0);
+        REQUIRE( fullLoaded.LoadFile(memIn, type) );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_RESOLUTIONX) ==
+                fullLoaded.GetOptionInt(wxIMAGE_OPTION_RESOLUTIONX) );
+        CHECK( image.GetOptionInt(wxIMAGE_OPTION_RESOLUTIONUNIT) ==
+                fullLoaded.GetOptionInt(wxIMAGE_OPTION_RESOLUTIONUNIT) );
+
+        // And so must be the load flags, which are not the default ones here.
+        wxImage imageNoVerbose;
+        imageNoVerbose.SetLoadFlags(0);
+        imageNoVerbose.SetOption(wxIMAGE_OPTION_REGION_X, region.x);
+        imageNoVerbose.SetOption(wxIMAGE_OPTION_REGION_Y, region.y);
+        imageNoVerbose.SetOption(wxIMAGE_OPTION_REGION_WIDTH, region.width);
+        imageNoVerbose.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, region.height);
+        memIn.SeekI(0);
+        REQUIRE( imageNoVerbose.LoadFile(memIn, type) );
+        CHECK( imageNoVerbose.GetSize() == region.GetSize() );
+        CHECK( imageNoVerbose.GetLoadFlags() == 0 );
+
+        // Zero size means that the region extends up to the image edge.
+        image = LoadImageRegion(memIn, type, wxRect(150, 170, 0, 0));
+        REQUIRE( image.IsOk() );
+        CHECK_THAT( image, RGBSameAs(full.GetSubImage(wxRect(150, 170, 50, 30))) );
+
+        // Region not intersecting the image is ignored.
+        image = LoadImageRegion(memIn, type, wxRect(300, 0, 10, 10));
+        REQUIRE( image.IsOk() );
+        CHECK_THAT( image, RGBSameAs(full) );
+        CHECK( !image.HasOption(wxIMAGE_OPTION_ORIGINAL_WIDTH) );
+
+        // Maximal size applies to the region.
+        image = LoadImageRegion(memIn, type, region, 20);
+        REQUIRE( image.IsOk() );
+        CHECK( image.GetWidth() <= 20 );
+        CHECK( image.GetWidth() >= 10 );
+    }
+
+    // JPEG is lossy and the pixels near the region edges may differ slightly.
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_REGION_X, region.x);
+    image.SetOption(wxIMAGE_OPTION_REGION_Y, region.y);
+    image.SetOption(wxIMAGE_OPTION_REGION_WIDTH, region.width);
+    image.SetOption(wxIMAGE_OPTION_REGION_HEIGHT, region.height);
+    REQUIRE( image.LoadFile("horse.jpg") );
+    CHECK_THAT( image, RGBSimilarTo(wxImage("horse.jpg").GetSubImage(region), 8) );
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImage::LoadRegionScaled", "[image][region]")
+{
+    // Create an image in which each 2*2 block contains an opaque red pixel,
+    // a transparent green one and 2 semi-transparent blue ones.
+    wxImage image(8, 8);
+    image.SetAlpha();
+    for ( int y = 0; y < 8; y++ )
+    {
+        for ( int x = 0; x < 8; x++ )
+        {
+            if ( y % 2 == 0 )
+            {
+                if ( x % 2 == 0 )
+                {
+                    image.SetRGB(x, y, 0xff, 0, 0);
+                    image.SetAlpha(x, y, 0xff);
+                }
+                else
+                {
+                    image.SetRGB(x, y, 0, 0xff, 0);
+                    image.SetAlpha(x, y, 0);
+                }
+            }
+            else
+            {
+                image.SetRGB(x, y, 0, 0, 0xff);
+                image.SetAlpha(x, y, 0x80);
+            }
+        }
+    }
+
+    wxMemoryOutputStream memOut;
+    REQUIRE( image.SaveFile(memOut, wxBITMAP_TYPE_PNG) );
+    wxMemoryInputStream memIn(memOut);
+
+    // Load the central part of the image at half size: the transparent green
+    // pixels must not affect the colour of the result.
+    const wxImage small = LoadImageRegion(memIn, wxBITMAP_TYPE_PNG,
+                                          wxRect(2, 2, 4, 4), 2);
+    REQUIRE( small.IsOk() );
+    REQUIRE( small.GetWidth() == 2 );
+    REQUIRE( small.GetHeight() == 2 );
+    REQUIRE( small.HasAlpha() );
+
+    CHECK( small.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 8 );
+
+    for ( int y = 0; y < 2; y++ )
+    {
+        for ( int x = 0; x < 2; x++ )
+        {
+            // Red has weight 0xff and blue 2*0x80.
+            CHECK( small.GetRed(x, y) == 0x7f );
+            CHECK( small.GetGreen(x, y) == 0 );
+            CHECK( small.GetBlue(x, y) == 0x80 );
+            CHECK( small.GetAlpha(x, y) == 0x80 );
+        }
+    }
+}
+
+TEST_CASE_METHOD(ImageHandlersInit, "wxImageBatchLoader", "[image][batch]")
+{
+    // Handlers which are documented to be reentrant.
+    const char* const files[] =
+    {
+        "horse.png",
+        "horse.jpg",
+#if wxUSE_LIBTIFF
+        "horse.tif",
+#endif // wxUSE_LIBTIFF
+#if wxUSE_GIF
+        "horse.gif",
+#endif // wxUSE_GIF
+#if wxUSE_LIBWEBP
+        "horse.webp",
+#endif // wxUSE_LIBWEBP
+    };
+
+    std::vector<wxImage> expected;
+    for ( const auto file : files )
+    {
+        expected.push_back(wxImage(file));
+        REQUIRE( expected.back().IsOk() );
+    }
+
+    // Load each image many times, alternating between using files and
+    // streams, and interleaving the different formats to maximize the
+    // chances of using different handlers concurrently.
+    const int numCopies = 8;
+
+    wxImageBatchLoader loader;
+    loader.SetMaxThreads(4);
+
+    for ( int copy = 0; copy < numCopies; copy++ )
+    {
+        for ( const auto file : files )
+        {
+            if ( copy % 2 )
+                loader.AddStream(new wxFileInputStream(file));
+            else
+                loader.AddFile(file);
+        }
+    }
+
+    const size_t numGood = loader.GetCount();
+
+    static const char garbage[] = "This is not an image";
+    loader.AddStream(new wxMemoryInputStream(garbage, sizeof(garbage)));
+    loader.AddFile("no-such-file.png", wxBITMAP_TYPE_PNG);
+
+    const auto checkResults = [&]()
+    {
+        for ( size_t n = 0; n < numGood; n++ )
+        {
+            wxINFO_FMT("Image #%zu", n);
+
+            REQUIRE( loader.IsOk(n) );
+            CHECK( loader.GetError(n).empty() );
+            CHECK_THAT( loader.GetImage(n),
+                        RGBASameAs(expected[n % WXSIZEOF(files)]) );
+        }
+
+        for ( size_t n = numGood; n < loader.GetCount(); n++ )
+        {
+            CHECK( !loader.IsOk(n) );
+            CHECK( !loader.GetImage(n).IsOk() );
+            CHECK( !loader.GetError(n).empty() );
+        }
+    };
+
+    SECTION("Synchronous")
+    {
+        // Do it several times to stress test the handlers.
+        for ( int n = 0; n < 3; n++ )
+        {
+            CHECK( !loader.Load() );
+            checkResults();
+        }
+    }
+
+    SECTION("Asynchronous")
+    {
+        wxEvtHandler handler;
+
+        int numLoaded = -1;
+        handler.Bind(wxEVT_IMAGE_BATCH_LOADED,
+                     [&numLoaded](wxThreadEvent& event)
+                     {
+                        numLoaded = event.GetInt();
+                     });
+
+        CHECK( loader.Start(&handler) );
+        CHECK( !loader.Wait() );
+        CHECK( !loader.IsRunning() );
+        checkResults();
+
+        handler.ProcessPendingEvents();
+        CHECK( numLoaded == static_cast<int>(numGood) );
+    }
+
+    SECTION("Options")
+    {
+        wxImageBatchLoader thumbnails;
+        thumbnails.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 50);
+        for ( const auto file : files )
+            thumbnails.AddFile(file);
+
+        CHECK( thumbnails.Load() );
+        for ( size_t n = 0; n < thumbnails.GetCount(); n++ )
+        {
+            CHECK( thumbnails.GetImage(n).GetWidth() <= 50 );
+            CHECK( thumbnails.GetImage(n).GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == 200 );
+        }
+    }
+}
+
 TEST_CASE("wxImage::SizeLimits", "[image]")
 {
 #if SIZEOF_VOID_P == 8
@@ -18,7 +18,14 @@
     #include "wx/filefn.h"
 #endif // WX_PRECOMP
 
+#include "wx/crt.h"
+#include "wx/logasync.h"
 #include "wx/scopeguard.h"
+#include "wx/thread.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #if wxUSE_LOG
 
@@ -102,6 +109,59 @@ TEST_CASE_METHOD(LogTestCase, "wxLog::Component", "[log]")
     #define wxLOG_COMPONENT "test"
 }
 
+TEST_CASE("wxLog::ComponentLevel", "[log]")
+{
+    static const char* const component = "test/level/sub";
+
+    CHECK( wxLog::GetComponentLevel(component) == wxLog::GetLogLevel() );
+
+    wxLog::SetComponentLevel("test/level", wxLOG_Warning);
+    CHECK( wxLog::GetComponentLevel(component) == wxLOG_Warning );
+    CHECK( wxLog::GetComponentLevel(wxString(component)) == wxLOG_Warning );
+    CHECK( wxLog::IsLevelEnabled(wxLOG_Error, component) );
+    CHECK_FALSE( wxLog::IsLevelEnabled(wxLOG_Info, component) );
+
+    // Changing the level must be taken into account even if the previous one
+    // was cached.
+    wxLog::SetComponentLevel(component, wxLOG_Info);
+    CHECK( wxLog::IsLevelEnabled(wxLOG_Info, component) );
+
+    // The same buffer may be reused for a different component.
+    char buf[32];
+    strcpy(buf, "test/level");
+    CHECK( wxLog::GetComponentLevel(buf) == wxLOG_Warning );
+    strcpy(buf, "test/level/sub");
+    CHECK( wxLog::GetComponentLevel(buf) == wxLOG_Info );
+    strcpy(buf, "test/other");
+    CHECK( wxLog::GetComponentLevel(buf) == wxLog::GetLogLevel() );
+
+#if wxUSE_THREADS
+    // Check that the level is also used by the other threads.
+    class LevelThread : public wxThread
+    {
+    public:
+        LevelThread() : wxThread(wxTHREAD_JOINABLE) { }
+
+        wxLogLevel m_level = 0;
+
+    protected:
+        virtual void* Entry() override
+        {
+            m_level = wxLog::GetComponentLevel(component);
+            return nullptr;
+        }
+    };
+
+    LevelThread thread;
+    REQUIRE( thread.Run() == wxTHREAD_NO_ERROR );
+    thread.Wait();
+    CHECK( thread.m_level == wxLOG_Info );
+#endif // wxUSE_THREADS
+
+    wxLog::SetComponentLevel("test/level", wxLOG_Max);
+    wxLog::SetComponentLevel(component, wxLOG_Max);
+}
+
 #if wxDEBUG_LEVEL
 
 namespace
@@ -252,6 +312,301 @@ void macroCompilabilityTest()
         wxLogDebug("hello debug %d", 42);
 }
 
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Log target storing all messages, optionally blocking until it's allowed to
+// proceed after receiving the first one.
+class CollectingLog : public wxLog
+{
+public:
+    CollectingLog() = default;
+
+    void BlockFirst()
+    {
+        m_block = true;
+    }
+
+    void WaitUntilBlocked()
+    {
+        m_blocked.Wait();
+    }
+
+    void Unblock()
+    {
+        m_unblock.Post();
+    }
+
+    std::vector<wxString> messages;
+
+protected:
+    virtual void DoLogRecord(wxLogLevel WXUNUSED(level),
+                             const wxString& msg,
+                             const wxLogRecordInfo& WXUNUSED(info)) override
+    {
+        messages.push_back(msg);
+
+        if ( m_block )
+        {
+            m_block = false;
+            m_blocked.Post();
+            m_unblock.Wait();
+        }
+    }
+
+private:
+    bool m_block = false;
+    wxSemaphore m_blocked,
+                m_unblock;
+};
+
+class LoggingThread : public wxThread
+{
+public:
+    LoggingThread(int index, int count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_index(index),
+          m_count(count)
+    {
+    }
+
+protected:
+    virtual void* Entry() override
+    {
+        for ( int n = 0; n < m_count; n++ )
+            wxLogMessage("%d %d", m_index, n);
+
+        return nullptr;
+    }
+
+private:
+    const int m_index;
+    const int m_count;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxLogAsync", "[log][thread]")
+{
+    const int NUM_THREADS = 4;
+    const int NUM_MESSAGES = 1000;
+
+    CollectingLog* const target = new CollectingLog;
+
+    wxLogAsync logAsync(target, 16);
+    wxLog* const logOld = wxLog::SetActiveTarget(&logAsync);
+    wxON_BLOCK_EXIT1(wxLog::SetActiveTarget, logOld);
+
+    wxLogMessage("Main");
+
+    std::vector<std::unique_ptr<LoggingThread>> threads;
+    for ( int n = 0; n < NUM_THREADS; n++ )
+    {
+        threads.emplace_back(new LoggingThread(n, NUM_MESSAGES));
+        REQUIRE( threads.back()->Run() == wxTHREAD_NO_ERROR );
+    }
+
+    for ( const auto& thread : threads )
+        thread->Wait();
+
+    logAsync.Sync();
+
+    // All messages must have been logged, as the default policy is to block
+    // when the buffer is full, and in order for each thread.
+    const std::vector<wxString>& messages = target->messages;
+    REQUIRE( messages.size() == NUM_THREADS*NUM_MESSAGES + 1 );
+    CHECK( messages[0] == "Main" );
+    CHECK( logAsync.GetDroppedCount() == 0 );
+
+    std::vector<int> next(NUM_THREADS);
+    for ( size_t n = 1; n < messages.size(); n++ )
+    {
+        int index = -1,
+            count = -1;
+        REQUIRE( wxSscanf(messages[n], "%d %d", &index, &count) == 2 );
+        REQUIRE( index >= 0 );
+        REQUIRE( index < NUM_THREADS );
+        CHECK( count == next[index]++ );
+    }
+}
+
+TEST_CASE("wxLogAsync::Drop", "[log][thread]")
+{
+    CollectingLog* const target = new CollectingLog;
+    target->BlockFirst();
+
+    wxLogAsync logAsync(target, 4, wxLOG_ASYNC_DROP);
+    wxLog* const logOld = wxLog::SetActiveTarget(&logAsync);
+    wxON_BLOCK_EXIT1(wxLog::SetActiveTarget, logOld);
+
+    // Wait until the background thread is blocked writing the first message,
+    // so that the next ones remain in the buffer.
+    wxLogMessage("First");
+    target->WaitUntilBlocked();
+
+    for ( int n = 0; n < 7; n++ )
+        wxLogMessage("Message %d", n);
+
+    CHECK( logAsync.GetDroppedCount() == 3 );
+
+    target->Unblock();
+    logAsync.Sync();
+
+    const std::vector<wxString>& messages = target->messages;
+    REQUIRE( messages.size() == 5 );
+    CHECK( messages[0] == "First" );
+    CHECK( messages[1] == "Message 0" );
+    CHECK( messages[4] == "Message 3" );
+}
+
+TEST_CASE("wxLogAsync::ShortLivedThreads", "[log][thread]")
+{
+    const int NUM_BATCHES = 50;
+    const int NUM_THREADS = 4;
+    const int NUM_MESSAGES = 10;
+
+    CollectingLog* const target = new CollectingLog;
+
+    wxLogAsync logAsync(target, 4);
+    wxLog* const logOld = wxLog::SetActiveTarget(&logAsync);
+    wxON_BLOCK_EXIT1(wxLog::SetActiveTarget, logOld);
+
+    // The buffers of the threads which exited are deleted, check that this
+    // doesn't lose any messages, including when the new threads reuse the
+    // same ids.
+    for ( int batch = 0; batch < NUM_BATCHES; batch++ )
+    {
+        std::vector<std::unique_ptr<LoggingThread>> threads;
+        for ( int n = 0; n < NUM_THREADS; n++ )
+        {
+            threads.emplace_back(new LoggingThread(n, NUM_MESSAGES));
+            REQUIRE( threads.back()->Run() == wxTHREAD_NO_ERROR );
+        }
+
+        for ( const auto& thread : threads )
+            thread->Wait();
+
+        if ( batch % 10 == 0 )
+            logAsync.Sync();
+    }
+
+    logAsync.Sync();
+
+    CHECK( target->messages.size() == NUM_BATCHES*NUM_THREADS*NUM_MESSAGES );
+}
+
+TEST_CASE("wxLogAsync::ChangeTarget", "[log][thread]")
+{
+    const int NUM_THREADS = 4;
+    const int NUM_MESSAGES = 2000;
+
+    // Log target counting the messages in an external variable, which can be
+    // shared by several targets.
+    class CountingLog : public wxLog
+    {
+    public:
+        explicit CountingLog(std::atomic<int>& count)
+            : m_count(count)
+        {
+        }
+
+    protected:
+        virtual void DoLogRecord(wxLogLevel WXUNUSED(level),
+                                 const wxString& WXUNUSED(msg),
+                                 const wxLogRecordInfo& WXUNUSED(info)) override
+        {
+            ++m_count;
+        }
+
+    private:
+        std::atomic<int>& m_count;
+    };
+
+    std::atomic<int> count{0};
+
+    wxLog* const logOld =
+        wxLog::SetActiveTarget(new wxLogAsync(new CountingLog(count), 16));
+
+    std::vector<std::unique_ptr<LoggingThread>> threads;
+    for ( int n = 0; n < NUM_THREADS; n++ )
+    {
+        threads.emplace_back(new LoggingThread(n, NUM_MESSAGES));
+        REQUIRE( threads.back()->Run() == wxTHREAD_NO_ERROR );
+    }
+
+    // Replace and delete the targets while the threads are using them: this
+    // must neither crash nor lose any messages.
+    for ( ;; )
+    {
+        bool anyAlive = false;
+        for ( const auto& thread : threads )
+        {
+            if ( thread->IsAlive() )
+                anyAlive = true;
+        }
+
+        if ( !anyAlive )
+            break;
+
+        delete wxLog::SetActiveTarget(
+                    new wxLogAsync(new CountingLog(count), 16));
+
+        wxMilliSleep(1);
+    }
+
+    for ( const auto& thread : threads )
+        thread->Wait();
+
+    delete wxLog::SetActiveTarget(logOld);
+
+    CHECK( count == NUM_THREADS*NUM_MESSAGES );
+}
+
+TEST_CASE("wxLogAsync::FlushOnExit", "[log][thread]")
+{
+    // Log target storing the messages in an external vector, to be able to
+    // check them after the target is destroyed.
+    class ExternalLog : public wxLog
+    {
+    public:
+        explicit ExternalLog(std::vector<wxString>& messages)
+            : m_messages(messages)
+        {
+        }
+
+    protected:
+        virtual void DoLogRecord(wxLogLevel WXUNUSED(level),
+                                 const wxString& msg,
+                                 const wxLogRecordInfo& WXUNUSED(info)) override
+        {
+            m_messages.push_back(msg);
+        }
+
+    private:
+        std::vector<wxString>& m_messages;
+    };
+
+    std::vector<wxString> messages;
+
+    {
+        wxLogAsync logAsync(new ExternalLog(messages));
+        wxLog* const logOld = wxLog::SetActiveTarget(&logAsync);
+        wxON_BLOCK_EXIT1(wxLog::SetActiveTarget, logOld);
+
+        for ( int n = 0; n < 100; n++ )
+            wxLogMessage("Message %d", n);
+    }
+
+    // All messages must have been written when wxLogAsync was destroyed.
+    REQUIRE( messages.size() == 100 );
+    CHECK( messages[0] == "Message 0" );
+    CHECK( messages[99] == "Message 99" );
+}
+
+#endif // wxUSE_THREADS
+
 // This allows to check wxLogTrace() interactively by running this test with
 // WXTRACE=logtest.
 TEST_CASE("wxLog::WXTRACE", "[log][.]")
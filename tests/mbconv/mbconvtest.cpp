@@ -1485,6 +1485,13 @@ TEST_CASE("wxMBConv::cWC2MB", "[mbconv][wc2mb]")
     CHECK( convUTF16.cWC2MB(L"Hi").length() == 4 );
     CHECK( convUTF16.cWC2MB(wxWCharBuffer::CreateNonOwned(L"Hi")).length() == 4 );
 
+    // The buffer length includes all but the last trailing NUL here.
+    size_t len;
+    CHECK( convUTF16.cWC2MB(L"Hi", wxNO_LEN, &len).length() == 7 );
+    CHECK( len == 4 );
+    CHECK( convUTF16.cWC2MB(L"Hi", 2, &len).length() == 5 );
+    CHECK( len == 4 );
+
     CHECK( wxConvUTF7.cWC2MB(L"").length() == 0 );
     CHECK( wxConvUTF7.cWC2MB(wxWCharBuffer()).length() == 0 );
     CHECK( wxConvUTF7.cWC2MB(L"\xa3").length() == 5 );
@@ -1508,3 +1515,122 @@ TEST_CASE("wxMBConv::cMB2WC", "[mbconv][mb2wc]")
     CHECK( wxConvUTF7.cMB2WC(wxCharBuffer()).length() == 0 );
     CHECK( wxConvUTF7.cMB2WC("+AKM-").length() == 1 );
 }
+
+TEST_CASE("wxMBConv::ToWCharBuffer", "[mbconv][mb2wc]")
+{
+    // The result must be the same whether the input is converted in a single
+    // pass (UTF-8) or not (UTF-7).
+    const char* const utf8 = "\xd0\x9f\xe3\x81\x82 and \xf0\x9f\x98\x80";
+
+    wxWCharBuffer buf;
+    size_t len = wxConvUTF8.ToWCharBuffer(buf, utf8);
+    REQUIRE( len != wxCONV_FAILED );
+    CHECK( buf.length() == len );
+    CHECK( buf[len - 1] == L'\0' );
+    CHECK( wxString(buf.data()) == wxString::FromUTF8(utf8) );
+
+    // Notice that wxMBConvUTF7 doesn't support characters outside of BMP.
+    const wchar_t* const bmp = L"\x41f\x3042 and \xe9";
+    const wxCharBuffer utf7 = wxConvUTF7.cWC2MB(bmp);
+    wxWCharBuffer buf7;
+    CHECK( wxConvUTF7.ToWCharBuffer(buf7, utf7) == wxWcslen(bmp) + 1 );
+    CHECK( wxStrcmp(buf7, bmp) == 0 );
+
+    // Explicit length and the trailing NUL.
+    CHECK( wxConvUTF8.ToWCharBuffer(buf, utf8, 2) == 1 );
+    CHECK( buf.length() == 1 );
+    CHECK( buf[0] == 0x41f );
+    CHECK( buf[1] == L'\0' );
+
+    // Invalid input.
+    buf = wxWCharBuffer::CreateNonOwned(L"unchanged");
+    CHECK( wxConvUTF8.ToWCharBuffer(buf, "\xd0") == wxCONV_FAILED );
+    CHECK( wxStrcmp(buf, L"unchanged") == 0 );
+
+    wxMBConvUTF8 convPUA(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA);
+    CHECK( convPUA.ToWCharBuffer(buf, "a\xd0z", 3) == 3 );
+
+    wxMBConvUTF8 convOctal(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+    CHECK( convOctal.ToWCharBuffer(buf, "a\xd0z", 3) == 6 );
+    CHECK( wxString(buf.data(), 6) == "a\\320z" );
+
+    CHECK( wxMBConvUTF16LE().ToWCharBuffer(buf, "H\0i\0\0", 4) == 2 );
+    CHECK( wxMBConvUTF32BE().ToWCharBuffer(buf, "\0\0\0H\0\0\0i", 8) == 2 );
+    CHECK( wxString(buf.data(), 2) == "Hi" );
+}
+
+TEST_CASE("wxMBConv::FromWCharBuffer", "[mbconv][wc2mb]")
+{
+    const wxString s = wxString::FromUTF8("\xd0\x9f\xe3\x81\x82 and \xf0\x9f\x98\x80");
+
+    wxCharBuffer buf;
+    size_t len = wxConvUTF8.FromWCharBuffer(buf, s.wc_str());
+    CHECK( len == 15 );
+    CHECK( buf.length() == len );
+    CHECK( strcmp(buf, "\xd0\x9f\xe3\x81\x82 and \xf0\x9f\x98\x80") == 0 );
+
+    const wxString bmp = s.BeforeLast(' ');
+    wxCharBuffer buf7;
+    len = wxConvUTF7.FromWCharBuffer(buf7, bmp.wc_str());
+    REQUIRE( len != wxCONV_FAILED );
+    CHECK( buf7.length() == len );
+    CHECK( wxString(buf7.data(), wxConvUTF7) == bmp );
+
+    CHECK( wxConvUTF8.FromWCharBuffer(buf, L"Hi", 2) == 2 );
+    CHECK( buf.length() == 2 );
+    CHECK( buf[2] == '\0' );
+
+    // Multiple NULs must be present even if they're not counted.
+    wxMBConvUTF32LE convUTF32;
+    CHECK( convUTF32.FromWCharBuffer(buf, L"Hi", 2) == 8 );
+    CHECK( buf.length() == 8 );
+    CHECK( memcmp(buf.data(), "H\0\0\0i\0\0\0\0\0\0\0", 12) == 0 );
+
+    CHECK( convUTF32.FromWCharBuffer(buf, L"Hi") == 12 );
+    CHECK( buf.length() == 12 );
+
+    // Using wxCSConv with an encoding without a known bound.
+    wxCSConv convLatin1(wxFONTENCODING_ISO8859_1);
+    CHECK( convLatin1.FromWCharBuffer(buf, L"caf\xe9") == 5 );
+    CHECK( strcmp(buf, "caf\xe9") == 0 );
+}
+
+TEST_CASE("wxString::utf8_str", "[mbconv][string]")
+{
+    wxString s("Hello");
+    const char* p = s.utf8_str();
+    CHECK( strcmp(p, "Hello") == 0 );
+
+    // The same buffer is reused if the length doesn't change.
+    s[0] = 'J';
+    CHECK( s.utf8_str().data() == p );
+    CHECK( strcmp(p, "Jello") == 0 );
+
+    // It must still work if the string becomes longer...
+    s += wxString::FromUTF8("\xc3\xa9 world");
+    CHECK( strcmp(s.utf8_str(), "Jello\xc3\xa9 world") == 0 );
+    CHECK( s.utf8_str().length() == 13 );
+
+    // ... or shorter.
+    s = "Hi";
+    CHECK( strcmp(s.utf8_str(), "Hi") == 0 );
+    CHECK( s.utf8_str().length() == 2 );
+}
+
+TEST_CASE("wxString::mb_str::NonStrictUTF8", "[mbconv][string]")
+{
+    // Converting with the non-strict UTF-8 converters after caching a shorter
+    // result used to truncate the output, as they don't fail if the buffer is
+    // too small.
+    const int options = GENERATE(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA,
+                                 wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+    INFO("Options: " << options);
+
+    wxString s("Hello");
+    CHECK( strcmp(s.utf8_str(), "Hello") == 0 );
+
+    s += " world";
+    const wxScopedCharBuffer buf = s.mb_str(wxMBConvUTF8(options));
+    CHECK( buf.length() == 11 );
+    CHECK( strcmp(buf, "Hello world") == 0 );
+}
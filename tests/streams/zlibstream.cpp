@@ -548,3 +548,56 @@ void zlibStream::genExtTestData(wxTextOutputStream &out, const char *buf, int fl
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(zlibStream)
 
+
+#if wxUSE_THREADS
+
+TEST_CASE("wxZlibOutputStream::Parallel", "[stream][zlib]")
+{
+    const int flags = GENERATE(wxZLIB_NO_HEADER, wxZLIB_ZLIB, wxZLIB_GZIP);
+    const int level = GENERATE(wxZ_DEFAULT_COMPRESSION,
+                               wxZ_NO_COMPRESSION,
+                               wxZ_BEST_COMPRESSION);
+    const size_t size = GENERATE(0, 1000, 1000000);
+
+    INFO("Flags " << flags << ", level " << level << ", size " << size);
+
+    // Use data which is compressible, but not trivially so.
+    std::vector<char> data(size);
+    unsigned seed = 1;
+    for ( size_t n = 0; n < size; n++ )
+    {
+        seed = seed*1103515245 + 12345;
+        data[n] = "abcdefgh"[(seed >> 16) % 8];
+    }
+
+    wxMemoryOutputStream mos;
+    {
+        wxZlibOutputStream zos(mos, level, flags);
+        REQUIRE( zos.EnableParallel(3, 64*1024) );
+
+        // Write the data in chunks not aligned with the blocks and flush the
+        // stream in the middle to check that it doesn't break anything.
+        const size_t chunk = 10007;
+        for ( size_t n = 0; n < size; n += chunk )
+        {
+            REQUIRE( zos.WriteAll(&data[n], wxMin(chunk, size - n)) );
+            if ( n == 50*chunk )
+                zos.Sync();
+        }
+
+        CHECK( zos.GetLength() == static_cast<wxFileOffset>(size) );
+        CHECK( zos.Close() );
+    }
+
+    wxMemoryInputStream mis(mos);
+    wxZlibInputStream zis(mis, flags);
+
+    std::vector<char> result(size + 1);
+    CHECK( zis.Read(result.data(), result.size()).LastRead() == size );
+    CHECK( zis.Eof() );
+
+    result.resize(size);
+    CHECK( result == data );
+}
+
+#endif // wxUSE_THREADS
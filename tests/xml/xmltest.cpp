@@ -19,6 +19,7 @@
 
 #include "wx/xml/xml.h"
 #include "wx/sstream.h"
+#include "wx/mstream.h"
 
 #include <stdarg.h>
 
@@ -610,6 +611,289 @@ void XmlTestCase::Doctype()
     CPPUNIT_ASSERT( !dt.IsValid() );
 }
 
+namespace
+{
+
+// Handler recording all the events as strings.
+class RecordingHandler : public wxXmlReaderHandler
+{
+public:
+    explicit RecordingHandler(const wxString& stopAt = wxString(),
+                              const wxString& loadSubtree = wxString())
+        : m_stopAt(stopAt),
+          m_loadSubtree(loadSubtree)
+    {
+    }
+
+    virtual bool OnStartElement(const wxXmlReaderElement& element) override
+    {
+        m_events += wxString::Format("<%s", element.GetName());
+        for ( size_t n = 0; n < element.GetAttributeCount(); n++ )
+        {
+            m_events += wxString::Format(" %s=%s",
+                                         element.GetAttributeName(n),
+                                         element.GetAttributeValue(n));
+        }
+        m_events += wxString::Format(":%d>", element.GetDepth());
+
+        if ( element.GetName() == m_loadSubtree )
+            element.LoadSubtree();
+
+        return element.GetName() != m_stopAt;
+    }
+
+    virtual bool OnEndElement(const wxString& name) override
+    {
+        m_events += "</" + name + ">";
+        return true;
+    }
+
+    virtual bool OnText(const wxString& text) override
+    {
+        m_events += "[" + text + "]";
+        return true;
+    }
+
+    virtual bool OnSubtree(std::unique_ptr<wxXmlNode> node) override
+    {
+        m_events += "{" + node->GetName() + "}";
+        m_subtree = std::move(node);
+        return true;
+    }
+
+    wxString m_events;
+    std::unique_ptr<wxXmlNode> m_subtree;
+
+private:
+    const wxString m_stopAt;
+    const wxString m_loadSubtree;
+};
+
+const char* const readerXml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<root a=\"1\" b=\"&lt;2&gt;\">\n"
+    "  <item id=\"x\">Hello &amp; <![CDATA[<bye>]]></item>\n"
+    "  <sub><inner k=\"v\">text</inner><!-- comment --></sub>\n"
+    "  <last/>\n"
+    "</root>\n";
+
+} // anonymous namespace
+
+TEST_CASE("XML::Reader", "[xml]")
+{
+    SECTION("Events")
+    {
+        RecordingHandler handler;
+        wxStringInputStream sis(readerXml);
+        REQUIRE( wxXmlReader(handler).Parse(sis) );
+
+        CHECK( handler.m_events ==
+                "<root a=1 b=<2>:0>"
+                "<item id=x:1>[Hello & ][<bye>]</item>"
+                "<sub:1><inner k=v:2>[text]</inner></sub>"
+                "<last:1></last>"
+                "</root>" );
+    }
+
+    SECTION("Whitespace")
+    {
+        RecordingHandler handler;
+        wxStringInputStream sis("<r> <e/>\n</r>");
+        REQUIRE( wxXmlReader(handler, wxXMLDOC_KEEP_WHITESPACE_NODES).Parse(sis) );
+
+        CHECK( handler.m_events == "<r:0>[ ]<e:1></e>[\n]</r>" );
+    }
+
+    SECTION("Stop")
+    {
+        RecordingHandler handler("sub");
+        wxStringInputStream sis(readerXml);
+        REQUIRE( wxXmlReader(handler).Parse(sis) );
+
+        CHECK( handler.m_events ==
+                "<root a=1 b=<2>:0>"
+                "<item id=x:1>[Hello & ][<bye>]</item>"
+                "<sub:1>" );
+    }
+
+    SECTION("Subtree")
+    {
+        RecordingHandler handler(wxString(), "sub");
+        wxStringInputStream sis(readerXml);
+        REQUIRE( wxXmlReader(handler).Parse(sis) );
+
+        CHECK( handler.m_events ==
+                "<root a=1 b=<2>:0>"
+                "<item id=x:1>[Hello & ][<bye>]</item>"
+                "<sub:1>{sub}"
+                "<last:1></last>"
+                "</root>" );
+
+        const wxXmlNode* const sub = handler.m_subtree.get();
+        REQUIRE( sub );
+        CHECK( sub->GetParent() == nullptr );
+        CHECK( sub->GetNext() == nullptr );
+
+        const wxXmlNode* const inner = sub->GetChildren();
+        REQUIRE( inner );
+        CHECK( inner->GetName() == "inner" );
+        CHECK( inner->GetAttribute("k") == "v" );
+        CHECK( inner->GetNodeContent() == "text" );
+
+        const wxXmlNode* const comment = inner->GetNext();
+        REQUIRE( comment );
+        CHECK( comment->GetType() == wxXML_COMMENT_NODE );
+        CHECK( comment->GetNext() == nullptr );
+    }
+
+    SECTION("Attributes")
+    {
+        class AttrHandler : public wxXmlReaderHandler
+        {
+        public:
+            virtual bool OnStartElement(const wxXmlReaderElement& element) override
+            {
+                if ( element.GetName() == "root" )
+                {
+                    CHECK( element.HasAttribute("a") );
+                    CHECK( !element.HasAttribute("c") );
+                    CHECK( element.GetAttribute("b") == "<2>" );
+                    CHECK( element.GetAttribute("c", "def") == "def" );
+                    CHECK( element.GetLineNumber() == 2 );
+                    m_checked = true;
+                }
+
+                return true;
+            }
+
+            bool m_checked = false;
+        };
+
+        AttrHandler handler;
+        wxStringInputStream sis(readerXml);
+        REQUIRE( wxXmlReader(handler).Parse(sis) );
+        CHECK( handler.m_checked );
+    }
+
+    SECTION("Error")
+    {
+        RecordingHandler handler;
+        wxStringInputStream sis("<root><unclosed></root>");
+
+        wxXmlParseError err;
+        CHECK( !wxXmlReader(handler).Parse(sis, &err) );
+        CHECK( err.line == 1 );
+    }
+}
+
+TEST_CASE("XML::Arena", "[xml]")
+{
+    const char *xmlText =
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+"<root a=\"1\">\n"
+"  <first b=\"2\" c=\"3\">Text</first>\n"
+"  <second/>\n"
+"</root>\n"
+    ;
+
+    wxXmlDocument doc;
+    wxStringInputStream sis(xmlText);
+    REQUIRE( doc.Load(sis, wxXMLDOC_USE_ARENA) );
+
+    wxXmlNode* const root = doc.GetRoot();
+    REQUIRE( root );
+    CHECK( root->GetAttribute("a") == "1" );
+
+    wxXmlNode* const first = root->GetChildren();
+    REQUIRE( first );
+    CHECK( first->GetAttribute("c") == "3" );
+    CHECK( first->GetNodeContent() == "Text" );
+
+    SECTION("Save")
+    {
+        wxStringOutputStream sos;
+        REQUIRE( doc.Save(sos) );
+        CHECK( sos.GetString() == xmlText );
+    }
+
+    SECTION("Modify")
+    {
+        // Nodes allocated on the heap can be mixed with the arena ones.
+        wxXmlNode* const third = new wxXmlNode(wxXML_ELEMENT_NODE, "third");
+        root->AddChild(third);
+        first->DeleteAttribute("b");
+        root->RemoveChild(third);
+        delete third;
+
+        root->RemoveChild(first);
+        delete first;
+
+        CHECK( root->GetChildren()->GetName() == "second" );
+    }
+
+    SECTION("Copy")
+    {
+        wxXmlDocument doc2(doc);
+
+        // Loading another document frees the arena, the copy is unaffected.
+        wxStringInputStream sis2("<other/>");
+        REQUIRE( doc.Load(sis2, wxXMLDOC_USE_ARENA) );
+        CHECK( doc.GetRoot()->GetName() == "other" );
+
+        wxStringOutputStream sos;
+        REQUIRE( doc2.Save(sos) );
+        CHECK( sos.GetString() == xmlText );
+    }
+}
+
+TEST_CASE("XML::Binary", "[xml]")
+{
+    const char *xmlText =
+"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+"<!DOCTYPE resource PUBLIC \"Public-ID\" \"System'ID'\">\n"
+"<!-- prolog -->\n"
+"<root a=\"1\">\n"
+"  <first b=\"2\" c=\"&lt;3&gt;\">Text</first>\n"
+"  <second><![CDATA[<data>]]></second>\n"
+"  <second/>\n"
+"  <?pi target?>\n"
+"</root>\n"
+    ;
+
+    wxXmlDocument doc;
+    wxStringInputStream sis(xmlText);
+    REQUIRE( doc.Load(sis) );
+
+    wxMemoryOutputStream mos;
+    REQUIRE( doc.SaveBinary(mos) );
+
+    wxMemoryInputStream mis(mos);
+    CHECK( wxXmlDocument::IsBinaryFormat(mis) );
+
+    wxXmlDocument doc2;
+    REQUIRE( doc2.LoadBinary(mis, wxXMLDOC_USE_ARENA) );
+
+    CHECK( doc2.GetRoot()->GetChildren()->GetLineNumber() == 5 );
+
+    wxStringOutputStream sos, sos2;
+    REQUIRE( doc.Save(sos) );
+    REQUIRE( doc2.Save(sos2) );
+    CHECK( sos2.GetString() == sos.GetString() );
+
+    // XML is not in binary format, but can still be loaded after checking.
+    wxStringInputStream sis2(xmlText);
+    CHECK( !wxXmlDocument::IsBinaryFormat(sis2) );
+    CHECK( doc2.Load(sis2) );
+
+    // Truncated data must be rejected.
+    wxMemoryInputStream misTrunc(mos.GetOutputStreamBuffer()->GetBufferStart(),
+                                 mos.GetLength() - 1);
+    CHECK( !doc2.LoadBinary(misTrunc) );
+
+    wxStringInputStream sis3(xmlText);
+    CHECK( !doc2.LoadBinary(sis3) );
+}
+
 // This test is disabled by default as it requires the environment variable
 // below to be defined to point to a XML file to load.
 TEST_CASE("XML::Load", "[xml][.]")
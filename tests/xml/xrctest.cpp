@@ -21,6 +21,7 @@
 
 #include "wx/fs_inet.h"
 #include "wx/imagxpm.h"
+#include "wx/notebook.h"
 #include "wx/xml/xml.h"
 #include "wx/sstream.h"
 #include "wx/wfstream.h"
@@ -32,6 +33,7 @@
 #include <memory>
 
 #include "testfile.h"
+#include "waitfor.h"
 
 // ----------------------------------------------------------------------------
 // helpers to create/save some xrc
@@ -328,6 +330,93 @@ TEST_CASE("XRC::EnvVarInPath", "[xrc]")
     CHECK( impl->GetBitmapBundle().IsOk() );
 }
 
+TEST_CASE("XRC::Binary", "[xrc]")
+{
+    wxStringInputStream sis(R"(<?xml version="1.0" ?>
+<resource>
+  <object class="wxDialog" name="dialog">
+    <object class="wxPanel" name="panel"/>
+    <object class="wxButton" name="button"/>
+  </object>
+  <object class="wxFrame" name="panel"/>
+</resource>
+    )");
+    wxXmlDocument xmlDoc(sis);
+    REQUIRE( xmlDoc.IsOk() );
+
+    TempFile xrcFile("binary.xrc");
+    REQUIRE( xmlDoc.SaveBinary(xrcFile.GetName()) );
+
+    wxXmlResource xrc;
+    REQUIRE( xrc.LoadFile(wxFileName(xrcFile.GetName())) );
+
+    const wxXmlNode* node = xrc.GetResourceNode("dialog");
+    REQUIRE( node );
+    CHECK( node->GetAttribute("class") == "wxDialog" );
+    CHECK( node->GetLineNumber() == 3 );
+
+    // Top-level resources are found before the nested ones.
+    node = xrc.GetResourceNode("panel");
+    REQUIRE( node );
+    CHECK( node->GetAttribute("class") == "wxFrame" );
+
+    node = xrc.GetResourceNode("button");
+    REQUIRE( node );
+    CHECK( node->GetAttribute("class") == "wxButton" );
+
+    CHECK( !xrc.GetResourceNode("nonexistent") );
+
+    CHECK( xrc.Unload(xrcFile.GetName()) );
+    CHECK( !xrc.GetResourceNode("dialog") );
+}
+
+TEST_CASE("XRC::LazyBookPages", "[xrc]")
+{
+    wxXmlResource::Get()->InitAllHandlers();
+
+    LoadXrcFrom(R"(<?xml version="1.0" ?>
+<resource>
+  <object class="wxPanel" name="lazy_panel">
+    <object class="wxNotebook" name="lazy_book">
+      <size>300,200</size>
+      <object class="notebookpage">
+        <label>Eager</label>
+        <object class="wxButton" name="eager_button"/>
+      </object>
+      <object class="notebookpage">
+        <label>Lazy</label>
+        <lazy>1</lazy>
+        <object class="wxButton" name="lazy_button"/>
+      </object>
+    </object>
+  </object>
+</resource>
+    )");
+
+    std::unique_ptr<wxPanel> panel(wxXmlResource::Get()->
+        LoadPanel(wxTheApp->GetTopWindow(), "lazy_panel"));
+    REQUIRE( panel );
+
+    wxNotebook* const book = XRCCTRL(*panel, "lazy_book", wxNotebook);
+    REQUIRE( book );
+    CHECK( book->GetPageCount() == 2 );
+    CHECK( XRCCTRL(*panel, "eager_button", wxButton) );
+    CHECK( !XRCCTRL(*panel, "lazy_button", wxButton) );
+
+    // The page contents is created when it's shown for the first time.
+    book->SetSelection(1);
+    WaitFor("lazy page creation", [&panel]()
+        {
+            return XRCCTRL(*panel, "lazy_button", wxButton) != nullptr;
+        });
+
+    wxButton* const button = XRCCTRL(*panel, "lazy_button", wxButton);
+    REQUIRE( button );
+    CHECK( button->GetParent() == book->GetPage(1) );
+
+    CHECK( wxXmlResource::Get()->Unload(TEST_XRC_FILE) );
+}
+
 // This test is disabled by default as it requires the environment variable
 // below to be defined to point to a HTTP URL with the file to load.
 //
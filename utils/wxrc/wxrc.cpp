@@ -197,7 +197,7 @@ private:
 
     bool Validate();
 
-    bool flagVerbose, flagCPP, flagPython, flagGettext, flagValidate, flagValidateOnly;
+    bool flagVerbose, flagCPP, flagPython, flagGettext, flagBinary, flagValidate, flagValidateOnly;
     wxString parOutput, parFuncname, parOutputPath, parSchemaFile;
     wxArrayString parFiles;
     int retCode;
@@ -221,6 +221,7 @@ int XmlResApp::OnRun()
         { wxCMD_LINE_SWITCH, "c", "cpp-code",  "output C++ source rather than .rsc file" },
         { wxCMD_LINE_SWITCH, "p", "python-code",  "output wxPython source rather than .rsc file" },
         { wxCMD_LINE_SWITCH, "g", "gettext",  "output list of translatable strings (to stdout or file if -o used)" },
+        { wxCMD_LINE_SWITCH, "b", "binary",  "precompile XRC files to binary format" },
         { wxCMD_LINE_OPTION, "n", "function",  "C++/Python function name (with -c or -p) [InitXmlResource]" },
         { wxCMD_LINE_OPTION, "o", "output",  "output file [resource.xrs/cpp]" },
         { wxCMD_LINE_SWITCH, "",  "validate", "check XRC correctness (in addition to other processing)" },
@@ -275,6 +276,7 @@ void XmlResApp::ParseParams(const wxCmdLineParser& cmdline)
     flagVerbose = cmdline.Found("v");
     flagCPP = cmdline.Found("c");
     flagPython = cmdline.Found("p");
+    flagBinary = cmdline.Found("b");
     flagH = flagCPP && cmdline.Found("e");
     flagValidateOnly = cmdline.Found("validate-only");
     flagValidate = flagValidateOnly || cmdline.Found("validate");
@@ -411,7 +413,11 @@ wxArrayString XmlResApp::PrepareTempFiles()
         }
         wxString internalName = GetInternalFileName(parFiles[i], flist);
 
-        doc.Save(parOutputPath + wxFILE_SEP_PATH + internalName);
+        const wxString outputName = parOutputPath + wxFILE_SEP_PATH + internalName;
+        if (flagBinary)
+            doc.SaveBinary(outputName);
+        else
+            doc.Save(outputName);
         flist.Add(internalName);
     }
 